@@ -0,0 +1,236 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Benchmarks for subvertpy.
+
+Run with ``make bench`` or ``python -m benchmarks``. All fixtures are
+created locally, so no network access is needed.
+
+A benchmark is a function that takes an ``Environment`` and returns a
+callable without arguments; only the callable is timed. Benchmarks are
+registered with the ``benchmark`` decorator.
+"""
+
+__docformat__ = "restructuredText"
+
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+
+RESULTS_VERSION = 1
+
+try:
+    _timer = time.perf_counter
+except AttributeError:  # Python 2
+    _timer = time.time
+
+_registry = []
+
+
+class SkipBenchmark(Exception):
+    """Raised by a benchmark that can not run in this environment."""
+
+
+def benchmark(name, number=1, repeat=5):
+    """Register a benchmark.
+
+    :param name: Dotted name of the benchmark
+    :param number: Number of calls per measurement
+    :param repeat: Number of measurements
+    """
+    def register(fn):
+        _registry.append((name, fn, number, repeat))
+        return fn
+    return register
+
+
+def load_benchmarks():
+    """Import all benchmark modules, registering their benchmarks."""
+    from benchmarks import (  # noqa: F401
+        bench_delta,
+        bench_marshall,
+        bench_ra,
+        bench_server,
+        bench_wc,
+        )
+    return list(_registry)
+
+
+def _median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    if len(values) % 2:
+        return values[mid]
+    return (values[mid - 1] + values[mid]) / 2.0
+
+
+def measure(fn, number, repeat):
+    """Time fn.
+
+    :return: Dictionary with the minimum, median and mean time per call in
+        seconds
+    """
+    fn()
+    timings = []
+    for i in range(repeat):
+        start = _timer()
+        for j in range(number):
+            fn()
+        timings.append((_timer() - start) / number)
+    return {
+        "min": min(timings),
+        "median": _median(timings),
+        "mean": sum(timings) / len(timings),
+        "number": number,
+        "repeat": repeat,
+        }
+
+
+def _git_revision():
+    try:
+        output = subprocess.check_output(
+            ["git", "rev-parse", "HEAD"],
+            cwd=os.path.dirname(os.path.abspath(__file__)),
+            stderr=subprocess.STDOUT)
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    return output.strip().decode("ascii")
+
+
+def metadata():
+    """Describe the environment the benchmarks run in."""
+    import subvertpy
+    from subvertpy import ra
+    return {
+        "version": RESULTS_VERSION,
+        "subvertpy": ".".join(str(x) for x in subvertpy.__version__),
+        "svn": ".".join(str(x) for x in ra.version()[:3]),
+        "python": platform.python_version(),
+        "implementation": platform.python_implementation(),
+        "platform": platform.platform(),
+        "revision": _git_revision(),
+        "date": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+        }
+
+
+def run(env, benchmarks, repeat=None, log=None):
+    """Run benchmarks.
+
+    :param env: Environment with the fixtures
+    :param benchmarks: List of registered benchmarks
+    :param repeat: Override for the number of measurements
+    :param log: Optional file to report progress to
+    :return: Dictionary mapping benchmark names to results
+    """
+    results = {}
+    for (name, factory, number, default_repeat) in benchmarks:
+        try:
+            fn = factory(env)
+            result = measure(fn, number, repeat or default_repeat)
+        except SkipBenchmark as e:
+            result = {"skipped": str(e)}
+        results[name] = result
+        if log is not None:
+            if "skipped" in result:
+                log.write("%-40s skipped: %s\n" % (name, result["skipped"]))
+            else:
+                log.write("%-40s %10.3f ms\n" % (
+                    name, result["median"] * 1000))
+            log.flush()
+    return results
+
+
+def save(path, results):
+    with open(path, "w") as f:
+        json.dump({"metadata": metadata(), "results": results}, f,
+                  indent=2, sort_keys=True)
+
+
+def load(path):
+    with open(path, "r") as f:
+        return json.load(f)
+
+
+def compare(old, new, threshold=0.1):
+    """Compare two sets of results.
+
+    :param old: Results to compare against, as returned by ``run``
+    :param new: New results
+    :param threshold: Relative slowdown to flag as a regression
+    :return: List of (name, old median, new median, ratio, regressed)
+    """
+    ret = []
+    for name in sorted(new):
+        if name not in old:
+            continue
+        if "median" not in old[name] or "median" not in new[name]:
+            continue
+        ratio = new[name]["median"] / old[name]["median"]
+        ret.append((name, old[name]["median"], new[name]["median"], ratio,
+                    ratio > 1 + threshold))
+    return ret
+
+
+def write_comparison(f, comparison):
+    for (name, old, new, ratio, regressed) in comparison:
+        f.write("%-40s %10.3f ms %10.3f ms %6.2fx%s\n" % (
+            name, old * 1000, new * 1000, ratio,
+            "  REGRESSION" if regressed else ""))
+
+
+def main(argv=None):
+    import argparse
+    from benchmarks.fixtures import Environment
+    parser = argparse.ArgumentParser(prog="python -m benchmarks")
+    parser.add_argument("-o", "--output", default="benchmark.json",
+                        help="File to write the results to.")
+    parser.add_argument("-c", "--compare", metavar="FILE",
+                        help="Earlier results to compare against.")
+    parser.add_argument("-k", "--filter", action="append", default=[],
+                        help="Only run benchmarks containing this string.")
+    parser.add_argument("-r", "--repeat", type=int,
+                        help="Number of measurements per benchmark.")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="Relative slowdown reported as a regression.")
+    parser.add_argument("--quick", action="store_true",
+                        help="Use smaller fixtures.")
+    args = parser.parse_args(argv)
+
+    benchmarks = load_benchmarks()
+    if args.filter:
+        benchmarks = [b for b in benchmarks
+                      if any(f in b[0] for f in args.filter)]
+
+    if args.quick:
+        env = Environment(revisions=20, files=10)
+    else:
+        env = Environment()
+    try:
+        results = run(env, benchmarks, args.repeat, sys.stdout)
+    finally:
+        env.cleanup()
+    save(args.output, results)
+    sys.stdout.write("Results written to %s\n" % args.output)
+
+    if args.compare:
+        comparison = compare(load(args.compare)["results"], results,
+                             args.threshold)
+        write_comparison(sys.stdout, comparison)
+        if any(c[4] for c in comparison):
+            return 1
+    return 0
@@ -0,0 +1,53 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+"""Benchmarks for svndiff encoding and decoding."""
+
+from io import BytesIO
+import random
+
+from subvertpy.delta import (
+    apply_txdelta_window,
+    pack_svndiff0,
+    send_stream,
+    unpack_svndiff0,
+    )
+
+from benchmarks import benchmark
+from benchmarks.fixtures import make_text
+
+
+def _windows(size):
+    text = make_text(random.Random(0), size // 28)
+    windows = []
+    send_stream(BytesIO(text), windows.append)
+    return [w for w in windows if w is not None]
+
+
+@benchmark("delta.pack_svndiff0", number=10)
+def bench_pack_svndiff0(env):
+    windows = _windows(1024 * 1024)
+    return lambda: pack_svndiff0(windows)
+
+
+@benchmark("delta.unpack_svndiff0", number=10)
+def bench_unpack_svndiff0(env):
+    data = pack_svndiff0(_windows(1024 * 1024))
+    return lambda: list(unpack_svndiff0(data))
+
+
+@benchmark("delta.apply_txdelta_window", number=10)
+def bench_apply_txdelta_window(env):
+    windows = _windows(1024 * 1024)
+    return lambda: [apply_txdelta_window(b"", w) for w in windows]
@@ -0,0 +1,56 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+"""Benchmarks for the svn protocol codec."""
+
+from subvertpy.marshall import (
+    literal,
+    marshall,
+    unmarshall,
+    )
+
+from benchmarks import benchmark
+
+
+def _log_entries(count):
+    """Log entries as sent by svnserve in response to a log request."""
+    return [
+        [[(b"/trunk/dir%d/file%d" % (i % 10, i), literal("M"), ()),
+          (b"/trunk/dir%d" % (i % 10), literal("M"), ())],
+         i, [b"jelmer"], [b"2010-05-31T08:49:22.430000Z"],
+         [b"Change %d" % i]]
+        for i in range(count)]
+
+
+@benchmark("marshall.marshall_log", number=10)
+def bench_marshall_log(env):
+    entries = _log_entries(1000)
+    return lambda: [marshall(entry) for entry in entries]
+
+
+@benchmark("marshall.unmarshall_log", number=10)
+def bench_unmarshall_log(env):
+    data = b"".join(marshall(entry) for entry in _log_entries(1000))
+
+    def unmarshall_all():
+        rest = data
+        while rest:
+            (rest, item) = unmarshall(rest)
+    return unmarshall_all
+
+
+@benchmark("marshall.marshall_string", number=100)
+def bench_marshall_string(env):
+    item = [literal("textdelta-chunk"), b"c1", b"x" * 102400]
+    return lambda: marshall(item)
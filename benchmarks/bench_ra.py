@@ -0,0 +1,120 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+"""Benchmarks for the RemoteAccess hot paths, against a local repository."""
+
+from io import BytesIO
+
+from benchmarks import benchmark
+
+LOG_REVPROPS = ["svn:author", "svn:date", "svn:log"]
+
+
+class NullFileEditor(object):
+
+    def change_prop(self, name, value):
+        pass
+
+    def apply_textdelta(self, base_checksum=None):
+        return lambda window: None
+
+    def close(self, checksum=None):
+        pass
+
+
+class NullDirEditor(object):
+
+    def open_directory(self, *args):
+        return NullDirEditor()
+
+    def add_directory(self, *args):
+        return NullDirEditor()
+
+    def open_file(self, *args):
+        return NullFileEditor()
+
+    def add_file(self, *args):
+        return NullFileEditor()
+
+    def change_prop(self, name, value):
+        pass
+
+    def delete_entry(self, *args):
+        pass
+
+    def close(self):
+        pass
+
+
+class NullEditor(object):
+
+    def set_target_revision(self, revnum):
+        pass
+
+    def open_root(self, base_revnum=-1):
+        return NullDirEditor()
+
+    def close(self):
+        pass
+
+    def abort(self):
+        pass
+
+
+@benchmark("ra.iter_log")
+def bench_iter_log(env):
+    conn = env.open_ra()
+    return lambda: list(conn.iter_log(
+        None, 0, env.revisions, discover_changed_paths=True,
+        revprops=LOG_REVPROPS))
+
+
+@benchmark("ra.get_log")
+def bench_get_log(env):
+    conn = env.open_ra()
+
+    def get_log():
+        entries = []
+        conn.get_log(lambda *args: entries.append(args), None, 0,
+                     env.revisions, discover_changed_paths=True,
+                     revprops=LOG_REVPROPS)
+        return entries
+    return get_log
+
+
+@benchmark("ra.replay_range")
+def bench_replay_range(env):
+    conn = env.open_ra()
+    cbs = (lambda revnum, revprops: NullEditor(),
+           lambda revnum, revprops, editor: None)
+    return lambda: conn.replay_range(1, env.revisions, 0, cbs, True)
+
+
+@benchmark("ra.get_dir", number=100)
+def bench_get_dir(env):
+    conn = env.open_ra()
+    revnum = env.revisions
+    return lambda: conn.get_dir("trunk/dir0", revnum)
+
+
+@benchmark("ra.get_file")
+def bench_get_file(env):
+    conn = env.open_ra()
+    revnum = env.revisions
+    paths = list(env.paths)
+
+    def get_files():
+        for path in paths:
+            conn.get_file(path, BytesIO(), revnum)
+    return get_files
@@ -0,0 +1,84 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+"""Benchmarks for round trips to the pure-Python svn:// server."""
+
+import threading
+
+from subvertpy import (
+    SubversionException,
+    )
+from subvertpy.ra_svn import TCPSVNServer
+from subvertpy.server import (
+    ServerBackend,
+    ServerRepositoryBackend,
+    )
+
+from benchmarks import (
+    SkipBenchmark,
+    benchmark,
+    )
+
+
+class RemoteAccessRepositoryBackend(ServerRepositoryBackend):
+    """Serve a repository by forwarding to a local RemoteAccess."""
+
+    def __init__(self, conn):
+        self.conn = conn
+
+    def get_uuid(self):
+        return self.conn.get_uuid()
+
+    def get_latest_revnum(self):
+        return self.conn.get_latest_revnum()
+
+    def check_path(self, path, revnum):
+        if revnum is None:
+            revnum = -1
+        return self.conn.check_path(path, revnum)
+
+    def rev_proplist(self, revnum):
+        return self.conn.rev_proplist(revnum)
+
+
+class RemoteAccessBackend(ServerBackend):
+
+    def __init__(self, conn):
+        self.conn = conn
+
+    def open_repository(self, location):
+        return (RemoteAccessRepositoryBackend(self.conn), location)
+
+
+@benchmark("server.round_trip", number=10)
+def bench_round_trip(env):
+    server = TCPSVNServer(RemoteAccessBackend(env.open_ra()),
+                          ("127.0.0.1", 0))
+    # The connection is only closed on exit, so the server thread is left
+    # running rather than shut down.
+    thread = threading.Thread(target=server.serve)
+    thread.daemon = True
+    thread.start()
+    env.add_cleanup(server.server_close)
+    try:
+        conn = env.open_ra("svn://127.0.0.1:%d/" % server.server_address[1])
+    except SubversionException as e:
+        raise SkipBenchmark("unable to connect: %s" % e.args[0])
+    revnum = env.revisions
+
+    def round_trip():
+        conn.get_latest_revnum()
+        conn.check_path("trunk", revnum)
+        conn.rev_proplist(revnum)
+    return round_trip
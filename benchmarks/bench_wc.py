@@ -0,0 +1,37 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+"""Benchmarks for working copy operations."""
+
+from subvertpy import wc
+
+from benchmarks import (
+    SkipBenchmark,
+    benchmark,
+    )
+
+
+@benchmark("wc.walk_status")
+def bench_walk_status(env):
+    if wc.api_version() < (1, 7):
+        raise SkipBenchmark("walk_status requires Subversion >= 1.7")
+    path = env.checkout
+    context = wc.Context()
+
+    def walk_status():
+        statuses = []
+        context.walk_status(path, lambda path, status: statuses.append(
+            status))
+        return statuses
+    return walk_status
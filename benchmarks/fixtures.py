@@ -0,0 +1,162 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Fixtures for the benchmarks.
+
+Repositories are built with the same helpers as the test suite, from a
+fixed random seed, so that every run works on identical data.
+"""
+
+import os
+import random
+import sys
+import tempfile
+
+from subvertpy import (
+    client,
+    ra,
+    repos,
+    )
+from subvertpy.ra import (
+    Auth,
+    RemoteAccess,
+    )
+from subvertpy.tests import (
+    TestCommitEditor,
+    rmtree_with_readonly,
+    )
+
+try:
+    from urllib.request import pathname2url
+except ImportError:
+    from urllib import pathname2url
+
+
+def make_text(rnd, lines):
+    """Create a file text with the given number of lines."""
+    return "".join(
+        "line %d: %08x %08x\n" % (i, rnd.getrandbits(32), rnd.getrandbits(32))
+        for i in range(lines)).encode("ascii")
+
+
+def change_text(rnd, text):
+    """Change a few lines of a file text."""
+    lines = text.splitlines(True)
+    for i in range(3):
+        idx = rnd.randrange(len(lines))
+        lines[idx] = ("changed %d: %08x\n" % (
+            idx, rnd.getrandbits(32))).encode("ascii")
+    return b"".join(lines)
+
+
+class Environment(object):
+    """Lazily created fixtures, shared between benchmarks.
+
+    :param revisions: Number of revisions in the fixture repository
+    :param files: Number of files in the fixture repository
+    :param lines: Number of lines per file
+    :param seed: Seed for the contents of the repository
+    """
+
+    def __init__(self, revisions=200, files=50, lines=400, seed=0):
+        self.revisions = revisions
+        self.files = files
+        self.lines = lines
+        self.seed = seed
+        self.test_dir = tempfile.mkdtemp(prefix="subvertpy-bench-")
+        self._repos_url = None
+        self._checkout = None
+        self._cleanups = []
+        self.paths = []
+
+    def add_cleanup(self, fn):
+        """Call fn when the benchmarks have finished."""
+        self._cleanups.append(fn)
+
+    def cleanup(self):
+        for fn in reversed(self._cleanups):
+            fn()
+        rmtree_with_readonly(self.test_dir)
+
+    def path_to_url(self, path):
+        if sys.platform == 'win32':
+            return 'file:%s' % pathname2url(path)
+        return "file://%s" % path
+
+    def open_ra(self, url=None):
+        if url is None:
+            url = self.repos_url
+        return RemoteAccess(url, auth=Auth([ra.get_username_provider()]))
+
+    @property
+    def repos_url(self):
+        """URL of the fixture repository.
+
+        Revision 1 adds ``files`` files below ``trunk``, spread over ten
+        directories; every later revision changes a few lines in three of
+        them.
+        """
+        if self._repos_url is None:
+            self._repos_url = self._create_repository()
+        return self._repos_url
+
+    def _create_repository(self):
+        rnd = random.Random(self.seed)
+        path = os.path.join(self.test_dir, "repos")
+        repos.create(path)
+        url = self.path_to_url(path)
+        conn = self.open_ra(url)
+        texts = {}
+        with self._commit_editor(conn, "Initial import") as root:
+            trunk = root.add_dir("trunk")
+            # The editor helpers close a directory once its sibling is
+            # opened, so add the files one directory at a time.
+            for d in range(min(10, self.files)):
+                dirname = "trunk/dir%d" % d
+                dir_editor = trunk.add_dir(dirname)
+                for i in range(d, self.files, 10):
+                    filename = "%s/file%d" % (dirname, i)
+                    texts[filename] = make_text(rnd, self.lines)
+                    dir_editor.add_file(filename).modify(texts[filename])
+                    self.paths.append(filename)
+        for revnum in range(2, self.revisions + 1):
+            changed = sorted(rnd.sample(self.paths, min(3, len(self.paths))))
+            with self._commit_editor(conn, "Change %d" % revnum) as root:
+                trunk = root.open_dir("trunk")
+                dirs = {}
+                for filename in changed:
+                    dirname = os.path.dirname(filename)
+                    if dirname not in dirs:
+                        dirs[dirname] = trunk.open_dir(dirname)
+                    texts[filename] = change_text(rnd, texts[filename])
+                    dirs[dirname].open_file(filename).modify(texts[filename])
+        return url
+
+    def _commit_editor(self, conn, message):
+        return TestCommitEditor(
+            conn.get_commit_editor({"svn:log": message}), conn.url,
+            conn.get_latest_revnum())
+
+    @property
+    def checkout(self):
+        """Path to a working copy of trunk in the fixture repository."""
+        if self._checkout is None:
+            url = self.repos_url
+            path = os.path.join(self.test_dir, "checkout")
+            client_ctx = client.Client()
+            client_ctx.auth = Auth([ra.get_username_provider()])
+            client_ctx.checkout(url + "/trunk", path, "HEAD")
+            self._checkout = path
+        return self._checkout
@@ -397,24 +397,28 @@ def subvertpy_modules():
             "subvertpy.client",
             [source_path(n)
                 for n in ("client.c", "editor.c", "util.c", "_ra.c", "wc.c",
-                          "wc_adm.c")],
-            libraries=["svn_client-1", "svn_subr-1", "svn_ra-1", "svn_wc-1"]),
+                          "wc_adm.c", "blame.c", "stats.c")],
+            libraries=["svn_client-1", "svn_subr-1", "svn_ra-1", "svn_wc-1",
+                       "svn_diff-1"]),
         SvnExtension(
             "subvertpy._ra",
-            [source_path(n) for n in ("_ra.c", "util.c", "editor.c")],
-            libraries=["svn_ra-1", "svn_delta-1", "svn_subr-1"]),
+            [source_path(n) for n in ("_ra.c", "util.c", "editor.c",
+                                      "blame.c", "stats.c")],
+            libraries=["svn_ra-1", "svn_delta-1", "svn_subr-1",
+                       "svn_diff-1"]),
         SvnExtension(
-            "subvertpy.repos", [source_path(n) for n in ("repos.c", "util.c")],
+            "subvertpy.repos",
+            [source_path(n) for n in ("repos.c", "util.c", "stats.c")],
             libraries=["svn_repos-1", "svn_subr-1", "svn_fs-1"]),
         SvnExtension(
             "subvertpy.wc",
             [source_path(n) for n in
-                ["wc.c", "wc_adm.c", "util.c", "editor.c"]],
+                ["wc.c", "wc_adm.c", "util.c", "editor.c", "stats.c"]],
             libraries=["svn_wc-1", "svn_subr-1"]),
         SvnExtension(
             "subvertpy.subr",
             [source_path(n)
-                for n in ["util.c", "subr.c"]],
+                for n in ["util.c", "subr.c", "mergeinfo.c", "stats.c"]],
             libraries=["svn_subr-1"]),
         ]
 
@@ -440,7 +444,8 @@ if __name__ == "__main__":
           """,
           packages=['subvertpy', 'subvertpy.tests'],
           ext_modules=subvertpy_modules(),
-          scripts=['bin/subvertpy-fast-export'],
+          scripts=['bin/subvertpy-fast-export',
+                   'bin/subvertpy-generate-repo'],
           cmdclass=cmdclass,
           classifiers=[
               'Development Status :: 4 - Beta',
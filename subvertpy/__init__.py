@@ -131,3 +131,78 @@ try:
             break
 except ImportError as e:
     raise ImportError("Unable to load subvertpy extensions: %s" % e)
+
+
+_STATS_MODULES = ("_ra", "client", "repos", "wc")
+
+
+def _stats_modules():
+    import sys
+    for name in _STATS_MODULES:
+        mod = sys.modules.get("subvertpy.%s" % name)
+        if mod is not None:
+            yield mod
+
+
+def enable_stats(enabled=True, span_callback=None):
+    """Enable or disable collection of operation metrics.
+
+    When enabled, the time taken by each Subversion call made by a
+    RemoteAccess object is recorded, as well as the time spent in the
+    Python editor and stream callbacks invoked by Subversion.
+
+    :param enabled: Whether to collect metrics
+    :param span_callback: Optional callable, called as
+        ``span_callback(name, start_ns, end_ns, attributes)`` after each
+        instrumented call; start_ns and end_ns are nanoseconds since the
+        epoch. Suitable for exporting OpenTelemetry-style spans.
+    """
+    for mod in _stats_modules():
+        mod._stats_configure(enabled, span_callback)
+
+
+def reset_stats():
+    """Reset all metrics collected so far."""
+    for mod in _stats_modules():
+        mod._stats_reset()
+
+
+def _merge_stats(into, stats):
+    for key, value in stats.items():
+        if key == "max":
+            into[key] = max(into.get(key, 0), value)
+        elif key == "histogram":
+            into[key] = tuple(
+                a + b for (a, b) in zip(into.get(key, (0,) * len(value)),
+                                        value))
+        else:
+            into[key] = into.get(key, 0) + value
+
+
+def stats():
+    """Return a snapshot of the metrics collected so far.
+
+    :return: Dictionary with:
+
+        * ``operations``: per Subversion call made by RemoteAccess objects
+        * ``callbacks``: per editor and stream callback into Python
+
+      both mapping names to dictionaries with ``calls``, ``errors``,
+      ``time`` and ``max`` (in seconds), ``bytes`` and ``histogram``,
+      where ``histogram[i]`` is the number of calls that took less than
+      2**i microseconds; and ``pools``, mapping extension module names to
+      their APR pool counters (see e.g. ``subvertpy.ra.pool_stats()``).
+
+      Scratch files used by Subversion to spool data are counted as the
+      ``scratch_memory`` and ``scratch_disk`` operations, with the time
+      each file was kept open and its final size in bytes (see
+      ``subvertpy.ra.set_tmp_file_options()``).
+    """
+    ret = {"operations": {}, "callbacks": {}, "pools": {}}
+    for mod in _stats_modules():
+        snapshot = mod._stats()
+        for kind in ("operations", "callbacks"):
+            for name, values in snapshot[kind].items():
+                _merge_stats(ret[kind].setdefault(name, {}), values)
+        ret["pools"][mod.__name__.split(".")[-1]] = snapshot["pools"]
+    return ret
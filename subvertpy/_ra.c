@@ -23,22 +23,23 @@
 #include <svn_ra.h>
 #include <svn_path.h>
 #include <svn_props.h>
+#include <svn_pools.h>
 #include <apr_file_io.h>
 #include <apr_portable.h>
 
 #include <structmember.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include "editor.h"
 #include "util.h"
 #include "ra.h"
-
-#if ONLY_SINCE_SVN(1, 5)
-#define REPORTER_T svn_ra_reporter3_t
-#else
-#define REPORTER_T svn_ra_reporter2_t
-#endif
-
-static PyObject *busy_exc;
+#include "mergeinfo.h"
+#include "blame.h"
+#include "stats.h"
 
 static PyTypeObject Reporter_Type;
 static PyTypeObject RemoteAccess_Type;
@@ -110,29 +111,6 @@ static svn_error_t *py_lock_func (void *baton, const char *path, int do_lock,
 	return NULL;
 }
 
-/** Connection to a remote Subversion repository. */
-typedef struct {
-	PyObject_VAR_HEAD
-	svn_ra_session_t *ra;
-	apr_pool_t *pool;
-	const char *url;
-	PyObject *progress_func;
-	AuthObject *auth;
-	bool busy;
-	PyObject *client_string_func;
-	PyObject *open_tmp_file_func;
-	const char *root;
-	const char *corrected_url;
-} RemoteAccessObject;
-
-typedef struct {
-	PyObject_VAR_HEAD
-	const REPORTER_T *reporter;
-	void *report_baton;
-	apr_pool_t *pool;
-	RemoteAccessObject *ra;
-} ReporterObject;
-
 static PyObject *reporter_set_path(PyObject *self, PyObject *args)
 {
 	char *path;
@@ -233,7 +211,7 @@ static PyObject *reporter_finish(PyObject *self)
 		return NULL;
 	}
 
-	reporter->ra->busy = false;
+	subvertpy_flag_clear(&reporter->ra->busy);
 
 	RUN_SVN(reporter->reporter->finish_report(
 		reporter->report_baton, reporter->pool));
@@ -255,7 +233,7 @@ static PyObject *reporter_abort(PyObject *self)
 		return NULL;
 	}
 
-	reporter->ra->busy = false;
+	subvertpy_flag_clear(&reporter->ra->busy);
 
 	RUN_SVN(reporter->reporter->abort_report(reporter->report_baton,
 													 reporter->pool));
@@ -291,7 +269,7 @@ static void reporter_dealloc(PyObject *self)
 		apr_pool_destroy(reporter->pool);
 		Py_DECREF(reporter->ra);
 	}
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyTypeObject Reporter_Type = {
@@ -433,7 +411,7 @@ static void ra_done_handler(void *_ra)
 {
 	RemoteAccessObject *ra = (RemoteAccessObject *)_ra;
 
-	ra->busy = false;
+	subvertpy_flag_clear(&ra->busy);
 
 	Py_DECREF(ra);
 }
@@ -441,26 +419,34 @@ static void ra_done_handler(void *_ra)
 #define RUN_RA_WITH_POOL(pool, ra, cmd) { \
 	svn_error_t *err; \
 	PyThreadState *_save; \
+	apr_off_t _bytes = subvertpy_counter_get(&ra->progress.bytes); \
+	STATS_TIMER; \
+	apr_time_t _start = apr_time_now(); \
 	_save = PyEval_SaveThread(); \
 	err = (cmd); \
 	PyEval_RestoreThread(_save); \
+	subvertpy_counter_add(&ra->progress.requests, 1); \
+	subvertpy_counter_add(&ra->progress.elapsed, apr_time_now() - _start); \
+	STATS_TIMER_STOP(STATS_OPERATION, \
+					 subvertpy_counter_get(&ra->progress.bytes) - _bytes, \
+					 err != NULL); \
 	if (err != NULL) { \
 		handle_svn_error(err); \
 		svn_error_clear(err); \
-		apr_pool_destroy(pool); \
-		ra->busy = false; \
+		scratch_pool_release(&ra->scratch, pool); \
+		subvertpy_flag_clear(&ra->busy); \
 		return NULL; \
 	} \
-	ra->busy = false; \
+	subvertpy_flag_clear(&ra->busy); \
 }
 
 static bool ra_check_busy(RemoteAccessObject *raobj)
 {
-	if (raobj->busy) {
-		PyErr_SetString(busy_exc, "Remote access object already in use");
+	if (subvertpy_flag_test_and_set(&raobj->busy)) {
+		PyErr_SetString(subvertpy_state()->busy_exc,
+						"Remote access object already in use");
 		return true;
 	}
-	raobj->busy = true;
 	return false;
 }
 
@@ -490,32 +476,179 @@ static svn_error_t *py_get_client_string(void *baton, const char **name, apr_poo
 }
 #endif
 
-/* Based on svn_swig_py_make_file() from Subversion */
-static svn_error_t *py_open_tmp_file(apr_file_t **fp, void *callback,
-									 apr_pool_t *pool)
+/* Scratch files that libsvn asks for when no open_tmp_file_func was
+ * given are kept in memory (where memfd_create() is available) while the
+ * session has less than scratch_memory_limit bytes in memory files, and
+ * are created in scratch_dir after that. Sessions copy these settings
+ * when they are opened. The limit is only checked when a file is opened;
+ * libsvn writes to the apr_file_t directly, so a memory file that is
+ * already open keeps growing past it. */
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+#define SUBVERTPY_MEMORY_SCRATCH
+#endif
+
+static subvertpy_mutex_t scratch_lock;
+static apr_off_t scratch_memory_limit = 16 * 1024 * 1024;
+/* NULL for a subvertpy directory in the Subversion temp directory. */
+static const char *scratch_dir = NULL;
+static apr_pool_t *scratch_dir_pool = NULL;
+
+struct ra_scratch_file {
+	apr_file_t *file;
+	bool in_memory;
+	apr_time_t opened;
+	RemoteAccessObject *ra;
+	struct ra_scratch_file *prev, *next;
+};
+
+static apr_off_t scratch_file_size(apr_file_t *file)
 {
-	RemoteAccessObject *self = (RemoteAccessObject *)callback;
-	PyObject *ret;
+	apr_finfo_t finfo;
+
+	if (apr_file_info_get(&finfo, APR_FINFO_SIZE, file) != APR_SUCCESS)
+		return 0;
+	return finfo.size;
+}
+
+/* Sum of the current sizes of the memory files of a session. Scratch
+ * files are only opened while the session is busy, so the list is never
+ * used by two threads at once. */
+static apr_off_t scratch_memory_in_use(RemoteAccessObject *ra)
+{
+	struct ra_scratch_file *f;
+	apr_off_t total = 0;
+
+	for (f = ra->scratch_files; f != NULL; f = f->next)
+		total += scratch_file_size(f->file);
+	return total;
+}
+
+/* Record a scratch file in the stats when it is released: as one call
+ * lasting as long as the file was open, with its final size as the
+ * number of bytes. */
+static apr_status_t scratch_file_cleanup(void *baton)
+{
+	struct ra_scratch_file *f = baton;
+	static stats_op_t *memory_op = NULL, *disk_op = NULL;
+
+	if (stats_enabled) {
+		apr_off_t size = scratch_file_size(f->file);
+		/* The pool may be destroyed with or without the GIL held, on
+		 * any thread; the stats belong to the session's interpreter. */
+		PyThreadState *tstate = subvertpy_thread_ensure(f->ra->interp);
+		if (f->in_memory) {
+			stats_record(&memory_op, "scratch_memory", STATS_OPERATION,
+						 f->opened, size, false);
+		} else {
+			stats_record(&disk_op, "scratch_disk", STATS_OPERATION,
+						 f->opened, size, false);
+		}
+		subvertpy_thread_release(tstate);
+	}
+
+	if (f->in_memory) {
+		if (f->prev != NULL)
+			f->prev->next = f->next;
+		else
+			f->ra->scratch_files = f->next;
+		if (f->next != NULL)
+			f->next->prev = f->prev;
+		apr_file_close(f->file);
+	}
+	return APR_SUCCESS;
+}
+
+#ifdef SUBVERTPY_MEMORY_SCRATCH
+/* Open a memory file, or set *fp to NULL if the kernel does not support
+ * them. */
+static svn_error_t *open_memory_scratch_file(apr_file_t **fp,
+											 apr_pool_t *pool)
+{
+	apr_os_file_t fd;
 	apr_status_t status;
-	PyGILState_STATE state;
 
-	if (self->open_tmp_file_func == Py_None) {
-		const char *path;
+	*fp = NULL;
+	fd = memfd_create("subvertpy", MFD_CLOEXEC);
+	if (fd == -1) {
+		if (errno == ENOSYS || errno == EINVAL)
+			return NULL;
+		return svn_error_wrap_apr(APR_FROM_OS_ERROR(errno),
+								  "Unable to create memory file");
+	}
+
+	status = apr_os_file_put(fp, &fd, APR_FOPEN_READ | APR_FOPEN_WRITE,
+							 pool);
+	if (status != APR_SUCCESS) {
+		close(fd);
+		*fp = NULL;
+		return svn_error_wrap_apr(status, "Unable to open memory file");
+	}
+	return NULL;
+}
+#endif
+
+static svn_error_t *open_scratch_file(apr_file_t **fp,
+									  RemoteAccessObject *self,
+									  apr_pool_t *pool)
+{
+	struct ra_scratch_file *f;
+	const char *path;
+
+	f = apr_pcalloc(pool, sizeof(struct ra_scratch_file));
+	f->ra = self;
+	f->opened = apr_time_now();
+
+#ifdef SUBVERTPY_MEMORY_SCRATCH
+	if (scratch_memory_in_use(self) < self->scratch_memory_limit) {
+		SVN_ERR(open_memory_scratch_file(&f->file, pool));
+	}
+	if (f->file != NULL) {
+		f->in_memory = true;
+		f->next = self->scratch_files;
+		if (f->next != NULL)
+			f->next->prev = f;
+		self->scratch_files = f;
+		apr_pool_cleanup_register(pool, f, scratch_file_cleanup,
+								  apr_pool_cleanup_null);
+		*fp = f->file;
+		return NULL;
+	}
+#endif
 
+	if (self->scratch_dir != NULL) {
+		path = self->scratch_dir;
+	} else {
 		SVN_ERR (svn_io_temp_dir (&path, pool));
 #if ONLY_SINCE_SVN(1, 7)
 		path = svn_dirent_join (path, "subvertpy", pool);
 #else
 		path = svn_path_join (path, "subvertpy", pool);
 #endif
+	}
 #if ONLY_SINCE_SVN(1, 6)
-		SVN_ERR (svn_io_open_unique_file3(fp, NULL, path, svn_io_file_del_on_pool_cleanup, pool, pool));
+	SVN_ERR (svn_io_open_unique_file3(&f->file, NULL, path, svn_io_file_del_on_pool_cleanup, pool, pool));
 #else
-		SVN_ERR (svn_io_open_unique_file (fp, NULL, path, ".tmp", TRUE, pool));
+	SVN_ERR (svn_io_open_unique_file (&f->file, NULL, path, ".tmp", TRUE, pool));
 #endif
+	/* Registered after the cleanup that removes the file, so it runs
+	 * first. */
+	apr_pool_cleanup_register(pool, f, scratch_file_cleanup,
+							  apr_pool_cleanup_null);
+	*fp = f->file;
+	return NULL;
+}
 
-		return NULL;
-	}
+/* Based on svn_swig_py_make_file() from Subversion */
+static svn_error_t *py_open_tmp_file(apr_file_t **fp, void *callback,
+									 apr_pool_t *pool)
+{
+	RemoteAccessObject *self = (RemoteAccessObject *)callback;
+	PyObject *ret;
+	apr_status_t status;
+	PyGILState_STATE state;
+
+	if (self->open_tmp_file_func == Py_None)
+		return open_scratch_file(fp, self, pool);
 
 	state = PyGILState_Ensure();
 
@@ -561,16 +694,59 @@ fail:
 	return py_svn_error();
 }
 
-static void py_progress_func(apr_off_t progress, apr_off_t total, void *baton, apr_pool_t *pool)
+static PyObject *set_tmp_file_options(PyObject *self, PyObject *args,
+										PyObject *kwargs)
 {
-	PyGILState_STATE state = PyGILState_Ensure();
-	RemoteAccessObject *ra = (RemoteAccessObject *)baton;
-	PyObject *fn = (PyObject *)ra->progress_func, *ret;
-	if (fn != Py_None) {
-		ret = PyObject_CallFunction(fn, "LL", progress, total);
-		Py_XDECREF(ret);
+	char *kwnames[] = { "memory_limit", "directory", NULL };
+	PY_LONG_LONG memory_limit;
+	PyObject *py_dir = Py_None;
+	apr_pool_t *pool = NULL, *old_pool;
+	const char *dir = NULL;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "L|O", kwnames,
+									 &memory_limit, &py_dir))
+		return NULL;
+
+	if (memory_limit < 0) {
+		PyErr_SetString(PyExc_ValueError,
+						"memory_limit can not be negative");
+		return NULL;
 	}
-	PyGILState_Release(state);
+
+	if (py_dir != Py_None) {
+		pool = Pool(NULL);
+		if (pool == NULL)
+			return NULL;
+		dir = py_object_to_svn_abspath(py_dir, pool);
+		if (dir == NULL) {
+			apr_pool_destroy(pool);
+			return NULL;
+		}
+	}
+
+	subvertpy_mutex_lock(&scratch_lock);
+	scratch_memory_limit = memory_limit;
+	scratch_dir = dir;
+	old_pool = scratch_dir_pool;
+	scratch_dir_pool = pool;
+	subvertpy_mutex_unlock(&scratch_lock);
+
+	/* Sessions have their own copy of the directory. */
+	if (old_pool != NULL)
+		apr_pool_destroy(old_pool);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *get_tmp_file_options(PyObject *self)
+{
+	PyObject *ret;
+
+	subvertpy_mutex_lock(&scratch_lock);
+	ret = Py_BuildValue("(Lz)", (PY_LONG_LONG)scratch_memory_limit,
+						scratch_dir);
+	subvertpy_mutex_unlock(&scratch_lock);
+	return ret;
 }
 
 static PyObject *ra_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
@@ -596,21 +772,27 @@ static PyObject *ra_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 									 &uuid))
 		return NULL;
 
-	ret = PyObject_New(RemoteAccessObject, &RemoteAccess_Type);
+	ret = PyObject_New(RemoteAccessObject, SUBVERTPY_TYPE(RemoteAccess_Type));
 	if (ret == NULL)
 		return NULL;
 
 	ret->client_string_func = client_string_func;
 	ret->open_tmp_file_func = open_tmp_file_func;
 	Py_INCREF(client_string_func);
+	Py_INCREF(open_tmp_file_func);
+	ret->scratch_files = NULL;
+	ret->scratch_dir = NULL;
 
-	Py_INCREF(progress_cb);
-	ret->progress_func = progress_cb;
+	progress_init(&ret->progress, progress_cb);
 
 	ret->auth = NULL;
 	ret->corrected_url = NULL;
 
 	ret->root = NULL;
+	scratch_pool_init(&ret->scratch);
+	ret->async_head = ret->async_tail = NULL;
+	ret->async_running = false;
+	ret->interp = subvertpy_current_interp();
 	ret->pool = Pool(NULL);
 	if (ret->pool == NULL) {
 		Py_DECREF(ret);
@@ -623,10 +805,16 @@ static PyObject *ra_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 		return NULL;
 	}
 
+	subvertpy_mutex_lock(&scratch_lock);
+	ret->scratch_memory_limit = scratch_memory_limit;
+	if (scratch_dir != NULL)
+		ret->scratch_dir = apr_pstrdup(ret->pool, scratch_dir);
+	subvertpy_mutex_unlock(&scratch_lock);
+
 	if ((PyObject *)auth == Py_None) {
 		ret->auth = NULL;
 		svn_auth_open(&auth_baton, apr_array_make(ret->pool, 0, sizeof(svn_auth_provider_object_t *)), ret->pool);
-	} else if (PyObject_TypeCheck(auth, &Auth_Type)) {
+	} else if (PyObject_TypeCheck(auth, SUBVERTPY_TYPE(Auth_Type))) {
 		Py_INCREF(auth);
 		ret->auth = auth;
 		auth_baton = ret->auth->auth_baton;
@@ -644,7 +832,7 @@ static PyObject *ra_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 		return NULL;
 	}
 
-	callbacks2->progress_baton = (void *)ret;
+	callbacks2->progress_baton = (void *)&ret->progress;
 	callbacks2->progress_func = py_progress_func;
 	callbacks2->auth_baton = auth_baton;
 	callbacks2->open_tmp_file = py_open_tmp_file;
@@ -681,7 +869,7 @@ static PyObject *ra_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 		Py_DECREF(ret);
 		return NULL;
 	}
-	ret->busy = false;
+	subvertpy_flag_clear(&ret->busy);
 	return (PyObject *)ret;
 }
 
@@ -698,7 +886,7 @@ static PyObject *ra_get_uuid(PyObject *self)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 #if ONLY_SINCE_SVN(1, 5)
@@ -707,7 +895,7 @@ static PyObject *ra_get_uuid(PyObject *self)
 	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_uuid(ra->ra, &uuid, temp_pool));
 #endif
 	ret = PyUnicode_FromString(uuid);
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return ret;
 }
 
@@ -724,12 +912,12 @@ static PyObject *ra_reparent(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 	ra->url = py_object_to_svn_uri(py_url, ra->pool);
 	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_reparent(ra->ra, ra->url, temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	Py_RETURN_NONE;
 }
 
@@ -745,12 +933,12 @@ static PyObject *ra_get_latest_revnum(PyObject *self)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 	RUN_RA_WITH_POOL(temp_pool, ra,
 				  svn_ra_get_latest_revnum(ra->ra, &latest_revnum, temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return py_from_svn_revnum(latest_revnum);
 }
 
@@ -818,7 +1006,7 @@ apr_array_header_t **apr_paths, apr_array_header_t **apr_revprops)
 fail_prep:
 	apr_pool_destroy(*pool);
 fail_pool:
-	ra->busy = false;
+	subvertpy_flag_clear(&ra->busy);
 fail_busy:
 	return false;
 }
@@ -879,7 +1067,7 @@ static PyObject *ra_get_repos_root(PyObject *self)
 		if (ra_check_busy(ra))
 			return NULL;
 
-		temp_pool = Pool(NULL);
+		temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 		if (temp_pool == NULL)
 			return NULL;
 #if ONLY_SINCE_SVN(1, 5)
@@ -890,7 +1078,7 @@ static PyObject *ra_get_repos_root(PyObject *self)
 						  svn_ra_get_repos_root(ra->ra, &root, temp_pool));
 #endif
 		ra->root = svn_uri_canonicalize(root, ra->pool);
-		apr_pool_destroy(temp_pool);
+		scratch_pool_release(&ra->scratch, temp_pool);
 	}
 
 	return PyUnicode_FromString(ra->root);
@@ -920,14 +1108,14 @@ static PyObject *ra_get_session_url(PyObject *self)
 		return NULL;
 
 #if ONLY_SINCE_SVN(1, 5)
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 
 	RUN_RA_WITH_POOL(temp_pool, ra,
 						svn_ra_get_session_url(ra->ra, &url, temp_pool));
 
 	r = PyUnicode_FromString(url);
 
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 
 	return r;
 #else
@@ -946,6 +1134,8 @@ static PyObject *ra_do_update(PyObject *self, PyObject *args)
 	bool recurse;
 	bool ignore_ancestry = true;
 	PyObject *update_editor;
+	const svn_delta_editor_t *editor;
+	void *edit_baton;
 	const REPORTER_T *reporter;
 	void *report_baton;
 	svn_error_t *err;
@@ -964,25 +1154,26 @@ static PyObject *ra_do_update(PyObject *self, PyObject *args)
 #if ONLY_BEFORE_SVN(1, 8)
 	if (!ignore_ancestry) {
 		PyErr_SetString(PyExc_NotImplementedError, "ignore_ancestry only supported on svn >= 1.8");
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 #endif
 
 	temp_pool = Pool(NULL);
 	if (temp_pool == NULL) {
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 
 	result_pool = Pool(NULL);
 	if (result_pool == NULL) {
 		apr_pool_destroy(temp_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 
 	Py_INCREF(update_editor);
+	py_object_to_editor(update_editor, result_pool, &editor, &edit_baton);
 #if ONLY_SINCE_SVN(1, 8)
 	Py_BEGIN_ALLOW_THREADS
 	err = svn_ra_do_update3(ra->ra, &reporter,
@@ -991,7 +1182,7 @@ static PyObject *ra_do_update(PyObject *self, PyObject *args)
 												  update_target, recurse?svn_depth_infinity:svn_depth_files,
 												  send_copyfrom_args,
 												  ignore_ancestry,
-												  &py_editor, update_editor,
+												  editor, edit_baton,
 												  result_pool, temp_pool);
 #elif ONLY_SINCE_SVN(1, 5)
 	Py_BEGIN_ALLOW_THREADS
@@ -1000,21 +1191,21 @@ static PyObject *ra_do_update(PyObject *self, PyObject *args)
 												  revision_to_update_to,
 												  update_target, recurse?svn_depth_infinity:svn_depth_files,
 												  send_copyfrom_args,
-												  &py_editor, update_editor,
+												  editor, edit_baton,
 												  result_pool);
 #else
 	if (send_copyfrom_args) {
 		PyErr_SetString(PyExc_NotImplementedError, "send_copyfrom_args only supported for svn >= 1.5");
 		apr_pool_destroy(temp_pool);
 		apr_pool_destroy(result_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 	Py_BEGIN_ALLOW_THREADS
 	err = svn_ra_do_update(ra->ra, &reporter,
 		&report_baton, revision_to_update_to,
 		update_target, recurse,
-		&py_editor, update_editor,
+		editor, edit_baton,
 		result_pool);
 
 #endif
@@ -1024,14 +1215,14 @@ static PyObject *ra_do_update(PyObject *self, PyObject *args)
 		handle_svn_error(err);
 		svn_error_clear(err);
 		apr_pool_destroy(result_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 
-	ret = PyObject_New(ReporterObject, &Reporter_Type);
+	ret = PyObject_New(ReporterObject, SUBVERTPY_TYPE(Reporter_Type));
 	if (ret == NULL) {
 		apr_pool_destroy(result_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 	ret->reporter = reporter;
@@ -1052,6 +1243,8 @@ static PyObject *ra_do_switch(PyObject *self, PyObject *args)
 	bool ignore_ancestry = true;
 	const char *switch_url;
 	PyObject *update_editor;
+	const svn_delta_editor_t *editor;
+	void *edit_baton;
 	const REPORTER_T *reporter;
 	void *report_baton;
 	apr_pool_t *temp_pool, *result_pool;
@@ -1067,25 +1260,26 @@ static PyObject *ra_do_switch(PyObject *self, PyObject *args)
 
 	temp_pool = Pool(NULL);
 	if (temp_pool == NULL) {
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 
 	switch_url = py_object_to_svn_uri(py_switch_url, temp_pool);
 	if (switch_url == NULL) {
 		apr_pool_destroy(temp_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 
 	result_pool = Pool(NULL);
 	if (result_pool == NULL) {
 		apr_pool_destroy(temp_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 
 	Py_INCREF(update_editor);
+	py_object_to_editor(update_editor, result_pool, &editor, &edit_baton);
 	Py_BEGIN_ALLOW_THREADS
 
 #if ONLY_SINCE_SVN(1, 8)
@@ -1094,19 +1288,19 @@ static PyObject *ra_do_switch(PyObject *self, PyObject *args)
 						revision_to_update_to, update_target,
 						recurse?svn_depth_infinity:svn_depth_files, switch_url,
 						send_copyfrom_args, ignore_ancestry,
-						&py_editor, update_editor, result_pool, temp_pool);
+						editor, edit_baton, result_pool, temp_pool);
 #elif ONLY_SINCE_SVN(1, 5)
 	err = svn_ra_do_switch2(
 						ra->ra, &reporter, &report_baton,
 						revision_to_update_to, update_target,
-						recurse?svn_depth_infinity:svn_depth_files, switch_url, &py_editor,
-						update_editor, result_pool);
+						recurse?svn_depth_infinity:svn_depth_files, switch_url, editor,
+						edit_baton, result_pool);
 #else
 	err = svn_ra_do_switch(
 						ra->ra, &reporter, &report_baton,
 						revision_to_update_to, update_target,
-						recurse, switch_url, &py_editor,
-						update_editor, result_pool);
+						recurse, switch_url, editor,
+						edit_baton, result_pool);
 #endif
 
 	Py_END_ALLOW_THREADS
@@ -1116,13 +1310,13 @@ static PyObject *ra_do_switch(PyObject *self, PyObject *args)
 		handle_svn_error(err);
 		svn_error_clear(err);
 		apr_pool_destroy(result_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
-	ret = PyObject_New(ReporterObject, &Reporter_Type);
+	ret = PyObject_New(ReporterObject, SUBVERTPY_TYPE(Reporter_Type));
 	if (ret == NULL) {
 		apr_pool_destroy(result_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 	ret->reporter = reporter;
@@ -1138,6 +1332,8 @@ static PyObject *ra_do_diff(PyObject *self, PyObject *args)
 	svn_revnum_t revision_to_update_to;
 	char *diff_target, *versus_url;
 	PyObject *diff_editor;
+	const svn_delta_editor_t *editor;
+	void *edit_baton;
 	const REPORTER_T *reporter;
 	void *report_baton;
 	svn_error_t *err;
@@ -1157,6 +1353,7 @@ static PyObject *ra_do_diff(PyObject *self, PyObject *args)
 		return NULL;
 
 	Py_INCREF(diff_editor);
+	py_object_to_editor(diff_editor, temp_pool, &editor, &edit_baton);
 	Py_BEGIN_ALLOW_THREADS
 #if ONLY_SINCE_SVN(1, 5)
 	err = svn_ra_do_diff3(ra->ra, &reporter, &report_baton,
@@ -1165,7 +1362,7 @@ static PyObject *ra_do_diff(PyObject *self, PyObject *args)
 												  ignore_ancestry,
 												  text_deltas,
 												  versus_url,
-												  &py_editor, diff_editor,
+												  editor, edit_baton,
 												  temp_pool);
 #else
 	err = svn_ra_do_diff2(ra->ra, &reporter, &report_baton,
@@ -1174,7 +1371,7 @@ static PyObject *ra_do_diff(PyObject *self, PyObject *args)
 												  ignore_ancestry,
 												  text_deltas,
 												  versus_url,
-												  &py_editor, diff_editor,
+												  editor, edit_baton,
 												  temp_pool);
 #endif
 	Py_END_ALLOW_THREADS
@@ -1182,11 +1379,11 @@ static PyObject *ra_do_diff(PyObject *self, PyObject *args)
 		handle_svn_error(err);
 		svn_error_clear(err);
 		apr_pool_destroy(temp_pool);
-		ra->busy = false;
+		subvertpy_flag_clear(&ra->busy);
 		return NULL;
 	}
 
-	ret = PyObject_New(ReporterObject, &Reporter_Type);
+	ret = PyObject_New(ReporterObject, SUBVERTPY_TYPE(Reporter_Type));
 	if (ret == NULL)
 		return NULL;
 	ret->reporter = reporter;
@@ -1203,6 +1400,8 @@ static PyObject *ra_replay(PyObject *self, PyObject *args)
 	apr_pool_t *temp_pool;
 	svn_revnum_t revision, low_water_mark;
 	PyObject *update_editor;
+	const svn_delta_editor_t *editor;
+	void *edit_baton;
 	bool send_deltas = true;
 
 	if (!PyArg_ParseTuple(args, "llO|b:replay", &revision, &low_water_mark, &update_editor, &send_deltas))
@@ -1211,16 +1410,17 @@ static PyObject *ra_replay(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
-	/* Only INCREF here, py_editor takes care of the DECREF */
+	/* Only INCREF here, the editor takes care of the DECREF */
 	Py_INCREF(update_editor);
+	py_object_to_editor(update_editor, temp_pool, &editor, &edit_baton);
 	RUN_RA_WITH_POOL(temp_pool, ra,
 					  svn_ra_replay(ra->ra, revision, low_water_mark,
-									send_deltas, &py_editor, update_editor,
+									send_deltas, editor, edit_baton,
 									temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 
 	Py_RETURN_NONE;
 }
@@ -1238,8 +1438,7 @@ static svn_error_t *py_revstart_cb(svn_revnum_t revision, void *replay_baton,
 	ret = PyObject_CallFunction(py_start_fn, "lO", revision, py_revprops);
 	CB_CHECK_PYRETVAL(ret);
 
-	*editor = &py_editor;
-	*edit_baton = ret;
+	py_object_to_editor(ret, pool, editor, edit_baton);
 
 	PyGILState_Release(state);
 	return NULL;
@@ -1286,7 +1485,7 @@ static PyObject *ra_replay_range(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -1295,7 +1494,7 @@ static PyObject *ra_replay_range(PyObject *self, PyObject *args)
 					  svn_ra_replay_range(ra->ra, start_revision, end_revision, low_water_mark,
 									send_deltas, py_revstart_cb, py_revfinish_cb, cbs,
 									temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 
 	Py_RETURN_NONE;
 #else
@@ -1305,26 +1504,32 @@ static PyObject *ra_replay_range(PyObject *self, PyObject *args)
 #endif
 }
 
-static PyObject *ra_rev_proplist(PyObject *self, PyObject *args)
+static PyObject *ra_rev_proplist(PyObject *self, PyObject *args, PyObject *kwargs)
 {
+	char *kwnames[] = { "revnum", "lazy", NULL };
 	apr_pool_t *temp_pool;
 	apr_hash_t *props;
 	RemoteAccessObject *ra = (RemoteAccessObject *)self;
 	svn_revnum_t rev;
+	bool lazy = false;
 	PyObject *py_props;
-	if (!PyArg_ParseTuple(args, "l:rev_proplist", &rev))
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l|b:rev_proplist",
+									 kwnames, &rev, &lazy))
 		return NULL;
 
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 	RUN_RA_WITH_POOL(temp_pool, ra,
 					  svn_ra_rev_proplist(ra->ra, rev, &props, temp_pool));
-	py_props = prop_hash_to_dict(props);
-	apr_pool_destroy(temp_pool);
+	if (lazy)
+		py_props = prop_hash_to_propdict(props);
+	else
+		py_props = prop_hash_to_dict(props);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return py_props;
 }
 
@@ -1425,11 +1630,11 @@ static PyObject *get_commit_editor(PyObject *self, PyObject *args, PyObject *kwa
 
 	Py_INCREF(ra);
 	return new_editor_object(NULL, editor, edit_baton, pool,
-			  &Editor_Type, ra_done_handler, ra, commit_callback);
+			  SUBVERTPY_TYPE(Editor_Type), ra_done_handler, ra, commit_callback);
 
 fail_prep:
 	Py_DECREF(commit_callback);
-	ra->busy = false;
+	subvertpy_flag_clear(&ra->busy);
 	apr_pool_destroy(pool);
 fail_pool:
 	return NULL;
@@ -1455,7 +1660,7 @@ static PyObject *ra_change_rev_prop(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 	val_string = svn_string_ncreate(value, vallen, temp_pool);
@@ -1463,8 +1668,8 @@ static PyObject *ra_change_rev_prop(PyObject *self, PyObject *args)
 	if (oldvallen != -2) {
 		PyErr_SetString(PyExc_NotImplementedError,
 						"Atomic revision property updates only supported on svn >= 1.7");
-		ra->busy = false;
-		apr_pool_destroy(temp_pool);
+		subvertpy_flag_clear(&ra->busy);
+		scratch_pool_release(&ra->scratch, temp_pool);
 		return NULL;
 	}
 #else
@@ -1488,7 +1693,7 @@ static PyObject *ra_change_rev_prop(PyObject *self, PyObject *args)
 					  svn_ra_change_rev_prop(ra->ra, rev, name, val_string,
 											 temp_pool));
 #endif
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	Py_RETURN_NONE;
 }
 
@@ -1514,7 +1719,7 @@ static PyObject *ra_get_dir(PyObject *self, PyObject *args, PyObject *kwargs)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -1545,12 +1750,12 @@ static PyObject *ra_get_dir(PyObject *self, PyObject *args, PyObject *kwargs)
 	if (py_props == NULL) {
 		goto fail;
 	}
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return Py_BuildValue("(NlN)", py_dirents, fetch_rev, py_props);
 
 fail:
 	Py_XDECREF(py_dirents);
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return NULL;
 }
 
@@ -1572,7 +1777,7 @@ static PyObject *ra_get_file(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -1581,17 +1786,22 @@ static PyObject *ra_get_file(PyObject *self, PyObject *args)
 
 	path = py_object_to_svn_relpath(py_path, temp_pool);
 	if (path == NULL) {
-		apr_pool_destroy(temp_pool);
+		scratch_pool_release(&ra->scratch, temp_pool);
 		return NULL;
 	}
 
 	/* Yuck. Subversion doesn't like leading slashes.. */
 	while (*path == '/') path++;
 
-	stream = new_py_stream(temp_pool, py_stream);
-	if (stream == NULL) {
-		apr_pool_destroy(temp_pool);
-		return NULL;
+	/* Without a stream only the properties are fetched. */
+	if (py_stream == Py_None) {
+		stream = NULL;
+	} else {
+		stream = new_py_stream(temp_pool, py_stream);
+		if (stream == NULL) {
+			scratch_pool_release(&ra->scratch, temp_pool);
+			return NULL;
+		}
 	}
 
 	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_file(ra->ra, path, revision,
@@ -1600,11 +1810,11 @@ static PyObject *ra_get_file(PyObject *self, PyObject *args)
 
 	py_props = prop_hash_to_dict(props);
 	if (py_props == NULL) {
-		apr_pool_destroy(temp_pool);
+		scratch_pool_release(&ra->scratch, temp_pool);
 		return NULL;
 	}
 
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 
 	return Py_BuildValue("(lN)", fetch_rev, py_props);
 }
@@ -1623,19 +1833,19 @@ static PyObject *ra_get_lock(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
 	path = py_object_to_svn_relpath(py_path, temp_pool);
 	if (path == NULL) {
-		apr_pool_destroy(temp_pool);
+		scratch_pool_release(&ra->scratch, temp_pool);
 		return NULL;
 	}
 
 	RUN_RA_WITH_POOL(temp_pool, ra,
 				  svn_ra_get_lock(ra->ra, &lock, path, temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 
     if (lock == NULL) {
         Py_RETURN_NONE;
@@ -1658,7 +1868,7 @@ static PyObject *ra_check_path(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -1672,7 +1882,7 @@ static PyObject *ra_check_path(PyObject *self, PyObject *args)
 	RUN_RA_WITH_POOL(temp_pool, ra,
 					  svn_ra_check_path(ra->ra, path, revision, &kind,
 					 temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 #if PY_MAJOR_VERSION < 3
 	return PyInt_FromLong(kind);
 #else
@@ -1695,7 +1905,7 @@ static PyObject *ra_stat(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -1710,7 +1920,7 @@ static PyObject *ra_stat(PyObject *self, PyObject *args)
 					  svn_ra_stat(ra->ra, path, revision, &dirent,
 					 temp_pool));
 	ret = py_dirent(dirent, SVN_DIRENT_ALL);
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return ret;
 }
 
@@ -1728,12 +1938,12 @@ static PyObject *ra_has_capability(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 	RUN_RA_WITH_POOL(temp_pool, ra,
 					  svn_ra_has_capability(ra->ra, &has, capability, temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return PyBool_FromLong(has);
 #else
 	PyErr_SetString(PyExc_NotImplementedError, "has_capability is only supported in Subversion >= 1.5");
@@ -1756,7 +1966,7 @@ static PyObject *ra_unlock(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		goto fail_busy;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		goto fail_pool;
 	hash_path_tokens = apr_hash_make(temp_pool);
@@ -1780,13 +1990,13 @@ static PyObject *ra_unlock(PyObject *self, PyObject *args)
 	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_unlock(ra->ra, hash_path_tokens, break_lock,
 					 py_lock_func, lock_func, temp_pool));
 
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	Py_RETURN_NONE;
 
 fail_dict:
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 fail_pool:
-	ra->busy = false;
+	subvertpy_flag_clear(&ra->busy);
 fail_busy:
 	return NULL;
 }
@@ -1810,7 +2020,7 @@ static PyObject *ra_lock(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		goto fail_busy;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		goto fail_pool;
 	if (path_revs == Py_None) {
@@ -1833,13 +2043,13 @@ static PyObject *ra_lock(PyObject *self, PyObject *args)
 	}
 	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_lock(ra->ra, hash_path_revs, comment, steal_lock,
 					 py_lock_func, lock_func, temp_pool));
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	Py_RETURN_NONE;
 
 fail_prep:
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 fail_pool:
-	ra->busy = false;
+	subvertpy_flag_clear(&ra->busy);
 fail_busy:
 	return NULL;
 }
@@ -1864,7 +2074,7 @@ static PyObject *ra_get_locks(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -1889,7 +2099,7 @@ static PyObject *ra_get_locks(PyObject *self, PyObject *args)
 
 	ret = PyDict_New();
 	if (ret == NULL) {
-		apr_pool_destroy(temp_pool);
+		scratch_pool_release(&ra->scratch, temp_pool);
 		return NULL;
 	}
 	for (idx = apr_hash_first(temp_pool, hash_locks); idx != NULL;
@@ -1899,11 +2109,11 @@ static PyObject *ra_get_locks(PyObject *self, PyObject *args)
 		pyval = pyify_lock(lock);
 		if (pyval == NULL) {
 			Py_DECREF(ret);
-			apr_pool_destroy(temp_pool);
+			scratch_pool_release(&ra->scratch, temp_pool);
 			return NULL;
 		}
 		if (PyDict_SetItemString(ret, key, pyval) != 0) {
-			apr_pool_destroy(temp_pool);
+			scratch_pool_release(&ra->scratch, temp_pool);
 			Py_DECREF(pyval);
 			Py_DECREF(ret);
 			return NULL;
@@ -1911,7 +2121,51 @@ static PyObject *ra_get_locks(PyObject *self, PyObject *args)
 		Py_DECREF(pyval);
 	}
 
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
+	return ret;
+}
+
+/**
+ * Convert a revision number to path hash, as returned by
+ * svn_ra_get_locations(), to a dictionary.
+ */
+static PyObject *locations_hash_to_dict(apr_hash_t *hash_locations,
+										apr_pool_t *pool)
+{
+	apr_hash_index_t *idx;
+	svn_revnum_t *key;
+	apr_ssize_t klen;
+	char *val;
+	PyObject *ret;
+
+	ret = PyDict_New();
+	if (ret == NULL)
+		return NULL;
+
+	for (idx = apr_hash_first(pool, hash_locations); idx != NULL;
+		idx = apr_hash_next(idx)) {
+		PyObject *py_key, *py_val;
+		int err;
+		apr_hash_this(idx, (const void **)&key, &klen, (void **)&val);
+		py_key = py_from_svn_revnum(*key);
+		if (py_key == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+		py_val = PyUnicode_FromString(val);
+		if (py_val == NULL) {
+			Py_DECREF(py_key);
+			Py_DECREF(ret);
+			return NULL;
+		}
+		err = PyDict_SetItem(ret, py_key, py_val);
+		Py_DECREF(py_key);
+		Py_DECREF(py_val);
+		if (err != 0) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+	}
 	return ret;
 }
 
@@ -1924,11 +2178,7 @@ static PyObject *ra_get_locations(PyObject *self, PyObject *args)
 	PyObject *location_revisions;
 	apr_pool_t *temp_pool;
 	apr_hash_t *hash_locations;
-	apr_hash_index_t *idx;
-	svn_revnum_t *key;
 	PyObject *ret;
-	apr_ssize_t klen;
-	char *val;
 
 	if (!PyArg_ParseTuple(args, "OlO:get_locations", &py_path, &peg_revision, &location_revisions))
 		goto fail_busy;
@@ -1936,7 +2186,7 @@ static PyObject *ra_get_locations(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		goto fail_busy;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		goto fail_pool;
 
@@ -1951,109 +2201,129 @@ static PyObject *ra_get_locations(PyObject *self, PyObject *args)
 					path, peg_revision,
 					revnum_list_to_apr_array(temp_pool, location_revisions),
 					temp_pool));
-	ret = PyDict_New();
-	if (ret == NULL) {
-		goto fail_dict;
-	}
-
-	for (idx = apr_hash_first(temp_pool, hash_locations); idx != NULL;
-		idx = apr_hash_next(idx)) {
-		PyObject *py_key, *py_val;
-		apr_hash_this(idx, (const void **)&key, &klen, (void **)&val);
-		py_key = py_from_svn_revnum(*key);
-		if (py_key == NULL) {
-			goto fail_conv;
-		}
-		py_val = PyUnicode_FromString(val);
-		if (py_val == NULL) {
-			goto fail_conv;
-		}
-		if (PyDict_SetItem(ret, py_key, py_val) != 0) {
-			goto fail_conv;
-		}
-	}
-	apr_pool_destroy(temp_pool);
+	ret = locations_hash_to_dict(hash_locations, temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return ret;
 
-fail_conv:
-	Py_DECREF(ret);
 fail_dict:
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 fail_pool:
-	ra->busy = false;
+	subvertpy_flag_clear(&ra->busy);
 fail_busy:
 	return NULL;
 }
 
-#if ONLY_SINCE_SVN(1, 5)
-static PyObject *range_to_tuple(svn_merge_range_t *range)
+typedef struct {
+	const char *path;
+	svn_revnum_t peg_revision;
+	apr_array_header_t *revisions;
+	apr_hash_t *locations;
+} locations_request_t;
+
+static svn_error_t *get_locations_batch(svn_ra_session_t *session,
+										apr_array_header_t *requests,
+										apr_pool_t *pool)
 {
-	return Py_BuildValue("(llb)", range->start, range->end, range->inheritable?true:false);
+	int i;
+
+	for (i = 0; i < requests->nelts; i++) {
+		locations_request_t *req = &APR_ARRAY_IDX(requests, i,
+												  locations_request_t);
+		SVN_ERR(svn_ra_get_locations(session, &req->locations, req->path,
+									 req->peg_revision, req->revisions,
+									 pool));
+	}
+	return NULL;
 }
 
-static PyObject *merge_rangelist_to_list(apr_array_header_t *rangelist)
+static PyObject *ra_get_locations_many(PyObject *self, PyObject *args)
 {
-	PyObject *ret;
-	int i;
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	PyObject *py_requests, *seq, *ret;
+	apr_array_header_t *requests;
+	apr_pool_t *temp_pool;
+	Py_ssize_t i, n;
 
-	ret = PyList_New(rangelist->nelts);
-	if (ret == NULL)
+	if (!PyArg_ParseTuple(args, "O:get_locations_many", &py_requests))
 		return NULL;
 
-	for (i = 0; i < rangelist->nelts; i++) {
-		PyObject *pyval;
-		pyval = range_to_tuple(APR_ARRAY_IDX(rangelist, i, svn_merge_range_t *));
-		if (pyval == NULL) {
-			Py_DECREF(ret);
-			return NULL;
-		}
-		if (PyList_SetItem(ret, i, pyval) != 0) {
-			Py_DECREF(ret);
-			Py_DECREF(pyval);
-			return NULL;
-		}
+	seq = PySequence_Fast(py_requests, "expected sequence of requests");
+	if (seq == NULL)
+		return NULL;
+
+	if (ra_check_busy(ra)) {
+		Py_DECREF(seq);
+		return NULL;
 	}
 
-	return ret;
-}
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
+	if (temp_pool == NULL) {
+		Py_DECREF(seq);
+		subvertpy_flag_clear(&ra->busy);
+		return NULL;
+	}
 
-static PyObject *mergeinfo_to_dict(svn_mergeinfo_t mergeinfo, apr_pool_t *temp_pool)
-{
-	PyObject *ret;
-	char *key;
-	apr_ssize_t klen;
-	apr_hash_index_t *idx;
-	apr_array_header_t *range;
+	n = PySequence_Fast_GET_SIZE(seq);
+	requests = apr_array_make(temp_pool, n, sizeof(locations_request_t));
+	for (i = 0; i < n; i++) {
+		locations_request_t *req = apr_array_push(requests);
+		PyObject *py_path, *py_revisions, *revisions;
 
-	ret = PyDict_New();
+		if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i),
+							  "OlO:get_locations_many", &py_path,
+							  &req->peg_revision, &py_revisions))
+			goto fail;
+
+		req->path = py_object_to_svn_relpath(py_path, temp_pool);
+		if (req->path == NULL || ra_check_svn_path(req->path))
+			goto fail;
+
+		revisions = PySequence_List(py_revisions);
+		if (revisions == NULL)
+			goto fail;
+		req->revisions = revnum_list_to_apr_array(temp_pool, revisions);
+		Py_DECREF(revisions);
+		if (req->revisions == NULL)
+			goto fail;
+		req->locations = NULL;
+	}
+	Py_DECREF(seq);
+
+	/* All requests are sent while the GIL is released. */
+	RUN_RA_WITH_POOL(temp_pool, ra, get_locations_batch(ra->ra, requests,
+														temp_pool));
+
+	ret = PyList_New(requests->nelts);
 	if (ret == NULL) {
+		scratch_pool_release(&ra->scratch, temp_pool);
 		return NULL;
 	}
-
-	for (idx = apr_hash_first(temp_pool, mergeinfo); idx != NULL;
-		idx = apr_hash_next(idx)) {
-		PyObject *pyval;
-		apr_hash_this(idx, (const void **)&key, &klen, (void **)&range);
-		pyval = merge_rangelist_to_list(range);
-		if (pyval == NULL) {
-			Py_DECREF(ret);
-			return NULL;
-		}
-		if (PyDict_SetItemString(ret, key, pyval) != 0) {
+	for (i = 0; i < requests->nelts; i++) {
+		PyObject *locations = locations_hash_to_dict(
+			APR_ARRAY_IDX(requests, i, locations_request_t).locations,
+			temp_pool);
+		if (locations == NULL) {
 			Py_DECREF(ret);
-			Py_DECREF(pyval);
+			scratch_pool_release(&ra->scratch, temp_pool);
 			return NULL;
 		}
-		Py_DECREF(pyval);
+		PyList_SET_ITEM(ret, i, locations);
 	}
-
+	scratch_pool_release(&ra->scratch, temp_pool);
 	return ret;
+
+fail:
+	Py_DECREF(seq);
+	scratch_pool_release(&ra->scratch, temp_pool);
+	subvertpy_flag_clear(&ra->busy);
+	return NULL;
 }
-#endif
 
-static PyObject *ra_mergeinfo(PyObject *self, PyObject *args)
+static PyObject *ra_mergeinfo(PyObject *self, PyObject *args, PyObject *kwargs)
 {
 #if ONLY_SINCE_SVN(1, 5)
+	char *kwnames[] = { "paths", "revision", "inherit", "include_descendants",
+		"lazy", NULL };
 	RemoteAccessObject *ra = (RemoteAccessObject *)self;
 	apr_array_header_t *apr_paths;
 	apr_pool_t *temp_pool;
@@ -2066,9 +2336,12 @@ static PyObject *ra_mergeinfo(PyObject *self, PyObject *args)
 	svn_revnum_t revision = -1;
 	PyObject *paths;
 	svn_mergeinfo_inheritance_t inherit = svn_mergeinfo_explicit;
-	bool include_descendants;
+	char include_descendants = false;
+	char lazy = false;
 
-	if (!PyArg_ParseTuple(args, "O|lib:mergeinfo", &paths, &revision, &inherit, &include_descendants))
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|libb:mergeinfo", kwnames,
+									 &paths, &revision, &inherit,
+									 &include_descendants, &lazy))
 		return NULL;
 
 	temp_pool = Pool(NULL);
@@ -2085,6 +2358,11 @@ static PyObject *ra_mergeinfo(PyObject *self, PyObject *args)
 					 include_descendants,
                      temp_pool));
 
+	if (lazy) {
+		/* The catalog object takes over the pool. */
+		return mergeinfo_api->catalog_new(catalog, temp_pool);
+	}
+
 	ret = PyDict_New();
 	if (ret == NULL) {
 		apr_pool_destroy(temp_pool);
@@ -2096,7 +2374,7 @@ static PyObject *ra_mergeinfo(PyObject *self, PyObject *args)
 			idx = apr_hash_next(idx)) {
 			PyObject *pyval;
 			apr_hash_this(idx, (const void **)&key, &klen, (void **)&val);
-			pyval = mergeinfo_to_dict(val, temp_pool);
+			pyval = mergeinfo_api->from_svn(val, temp_pool);
 			if (pyval == NULL) {
 				apr_pool_destroy(temp_pool);
 				Py_DECREF(ret);
@@ -2122,6 +2400,262 @@ static PyObject *ra_mergeinfo(PyObject *self, PyObject *args)
 #endif
 }
 
+#if ONLY_SINCE_SVN(1, 5)
+/* Location segment receiver that records the history of a node as
+ * svn_mergeinfo_t, in the pool of the hash passed as baton. */
+static svn_error_t *mergeinfo_segment_receiver(svn_location_segment_t *segment, void *baton, apr_pool_t *pool)
+{
+	apr_hash_t *history = baton;
+	apr_pool_t *hash_pool = apr_hash_pool_get(history);
+	apr_array_header_t *rangelist;
+	svn_merge_range_t *range;
+	const char *path;
+
+	/* Gaps in the history and r0 can not be merged. */
+	if (segment->path == NULL || segment->range_end < 1)
+		return NULL;
+
+	path = apr_pstrcat(hash_pool, "/", segment->path, NULL);
+	rangelist = apr_hash_get(history, path, APR_HASH_KEY_STRING);
+	if (rangelist == NULL) {
+		rangelist = apr_array_make(hash_pool, 1, sizeof(svn_merge_range_t *));
+		apr_hash_set(history, path, APR_HASH_KEY_STRING, rangelist);
+	}
+
+	range = apr_pcalloc(hash_pool, sizeof(*range));
+	range->start = ((segment->range_start > 1)?segment->range_start:1) - 1;
+	range->end = segment->range_end;
+	range->inheritable = TRUE;
+	APR_ARRAY_PUSH(rangelist, svn_merge_range_t *) = range;
+
+	return NULL;
+}
+
+/* Log receiver that collects revision numbers in the array passed as
+ * baton. */
+static svn_error_t *mergeinfo_log_receiver(void *baton, svn_log_entry_t *log_entry, apr_pool_t *pool)
+{
+	apr_array_header_t *revs = baton;
+
+	APR_ARRAY_PUSH(revs, svn_revnum_t) = log_entry->revision;
+	return NULL;
+}
+
+static int mergeinfo_compare_revnums(const void *a, const void *b)
+{
+	svn_revnum_t rev_a = *(const svn_revnum_t *)a;
+	svn_revnum_t rev_b = *(const svn_revnum_t *)b;
+
+	return (rev_a < rev_b)?-1:(rev_a > rev_b);
+}
+
+/* Restrict the history of a node to the revisions in revs, which is
+ * sorted. */
+static apr_hash_t *mergeinfo_filter_history(apr_hash_t *history,
+											const apr_array_header_t *revs,
+											apr_pool_t *pool)
+{
+	apr_hash_t *ret = apr_hash_make(pool);
+	apr_hash_index_t *idx;
+
+	for (idx = apr_hash_first(pool, history); idx != NULL;
+		 idx = apr_hash_next(idx)) {
+		const void *path;
+		apr_array_header_t *rangelist, *filtered;
+		int i, lo, hi;
+
+		apr_hash_this(idx, &path, NULL, (void **)&rangelist);
+		filtered = apr_array_make(pool, 1, sizeof(svn_merge_range_t *));
+		for (i = 0; i < rangelist->nelts; i++) {
+			svn_merge_range_t *range = APR_ARRAY_IDX(rangelist, i,
+													 svn_merge_range_t *);
+
+			/* Find the first revision after the (exclusive) start. */
+			lo = 0;
+			hi = revs->nelts;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (APR_ARRAY_IDX(revs, mid, svn_revnum_t) <= range->start)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			/* Single revision ranges are merged again when converted. */
+			for (; lo < revs->nelts &&
+				   APR_ARRAY_IDX(revs, lo, svn_revnum_t) <= range->end; lo++) {
+				svn_merge_range_t *operative = apr_pcalloc(pool,
+														   sizeof(*operative));
+				operative->end = APR_ARRAY_IDX(revs, lo, svn_revnum_t);
+				operative->start = operative->end - 1;
+				operative->inheritable = TRUE;
+				APR_ARRAY_PUSH(filtered, svn_merge_range_t *) = operative;
+			}
+		}
+		if (filtered->nelts > 0)
+			apr_hash_set(ret, path, APR_HASH_KEY_STRING, filtered);
+	}
+
+	return ret;
+}
+#endif
+
+static PyObject *ra_eligible_revisions(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if ONLY_SINCE_SVN(1, 5)
+	char *kwnames[] = { "source_path", "target_path", "revision", NULL };
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	PyObject *py_source, *py_target;
+	PyObject *source_history, *target_history, *merged = NULL;
+	PyObject *unmerged, *ret;
+	const char *source, *target;
+	svn_revnum_t revision = SVN_INVALID_REVNUM;
+	apr_hash_t *source_segments, *target_segments;
+	apr_array_header_t *apr_paths, *source_paths, *source_revs;
+	apr_hash_index_t *idx;
+	svn_revnum_t youngest = 0;
+	svn_mergeinfo_catalog_t catalog;
+	apr_pool_t *temp_pool;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|l:eligible_revisions",
+									 kwnames, &py_source, &py_target,
+									 &revision))
+		return NULL;
+
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
+	if (temp_pool == NULL)
+		return NULL;
+
+	source = py_object_to_svn_relpath(py_source, temp_pool);
+	target = py_object_to_svn_relpath(py_target, temp_pool);
+	if (source == NULL || target == NULL) {
+		scratch_pool_release(&ra->scratch, temp_pool);
+		return NULL;
+	}
+
+	if (ra_check_svn_path(source) || ra_check_svn_path(target)) {
+		scratch_pool_release(&ra->scratch, temp_pool);
+		return NULL;
+	}
+
+	source_segments = apr_hash_make(temp_pool);
+	target_segments = apr_hash_make(temp_pool);
+	apr_paths = apr_array_make(temp_pool, 1, sizeof(char *));
+	APR_ARRAY_PUSH(apr_paths, const char *) = target;
+
+	if (ra_check_busy(ra)) {
+		scratch_pool_release(&ra->scratch, temp_pool);
+		return NULL;
+	}
+
+	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_location_segments(ra->ra,
+					 source, revision, revision, SVN_INVALID_REVNUM,
+					 mergeinfo_segment_receiver, source_segments, temp_pool));
+
+	/* The history of the source includes revisions that did not change
+	 * it, which are not worth merging; the log of the source (following
+	 * copies, like the location segments) has the ones that did. */
+	for (idx = apr_hash_first(temp_pool, source_segments); idx != NULL;
+		 idx = apr_hash_next(idx)) {
+		apr_array_header_t *rangelist;
+		int i;
+
+		apr_hash_this(idx, NULL, NULL, (void **)&rangelist);
+		for (i = 0; i < rangelist->nelts; i++) {
+			svn_merge_range_t *range = APR_ARRAY_IDX(rangelist, i,
+													 svn_merge_range_t *);
+			if (range->end > youngest)
+				youngest = range->end;
+		}
+	}
+
+	source_revs = apr_array_make(temp_pool, 16, sizeof(svn_revnum_t));
+	if (youngest > 0) {
+		source_paths = apr_array_make(temp_pool, 1, sizeof(char *));
+		APR_ARRAY_PUSH(source_paths, const char *) = source;
+
+		if (ra_check_busy(ra)) {
+			scratch_pool_release(&ra->scratch, temp_pool);
+			return NULL;
+		}
+
+		RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_log2(ra->ra,
+						 source_paths, youngest, 1, 0, FALSE, FALSE, FALSE,
+						 apr_array_make(temp_pool, 0, sizeof(char *)),
+						 mergeinfo_log_receiver, source_revs, temp_pool));
+
+		qsort(source_revs->elts, source_revs->nelts, source_revs->elt_size,
+			  mergeinfo_compare_revnums);
+	}
+	source_segments = mergeinfo_filter_history(source_segments, source_revs,
+											   temp_pool);
+
+	if (ra_check_busy(ra)) {
+		scratch_pool_release(&ra->scratch, temp_pool);
+		return NULL;
+	}
+
+	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_location_segments(ra->ra,
+					 target, revision, revision, SVN_INVALID_REVNUM,
+					 mergeinfo_segment_receiver, target_segments, temp_pool));
+
+	if (ra_check_busy(ra)) {
+		scratch_pool_release(&ra->scratch, temp_pool);
+		return NULL;
+	}
+
+	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_mergeinfo(ra->ra,
+					 &catalog, apr_paths, revision, svn_mergeinfo_inherited,
+					 FALSE, temp_pool));
+
+	source_history = mergeinfo_api->from_svn(source_segments, temp_pool);
+	if (source_history == NULL) {
+		scratch_pool_release(&ra->scratch, temp_pool);
+		return NULL;
+	}
+
+	/* Revisions in the history of the target itself (e.g. before a branch
+	 * was copied from the source) are never eligible. */
+	target_history = mergeinfo_api->from_svn(target_segments, temp_pool);
+	if (target_history == NULL) {
+		Py_DECREF(source_history);
+		scratch_pool_release(&ra->scratch, temp_pool);
+		return NULL;
+	}
+
+	if (catalog != NULL && apr_hash_count(catalog) > 0) {
+		apr_hash_index_t *idx = apr_hash_first(temp_pool, catalog);
+		svn_mergeinfo_t mergeinfo;
+		apr_hash_this(idx, NULL, NULL, (void **)&mergeinfo);
+		merged = mergeinfo_api->from_svn(mergeinfo, temp_pool);
+		if (merged == NULL) {
+			Py_DECREF(source_history);
+			Py_DECREF(target_history);
+			scratch_pool_release(&ra->scratch, temp_pool);
+			return NULL;
+		}
+	}
+
+	scratch_pool_release(&ra->scratch, temp_pool);
+
+	unmerged = mergeinfo_api->subtract(source_history, target_history, false);
+	Py_DECREF(source_history);
+	Py_DECREF(target_history);
+	if (unmerged == NULL || merged == NULL) {
+		Py_XDECREF(merged);
+		return unmerged;
+	}
+
+	ret = mergeinfo_api->subtract(unmerged, merged, false);
+	Py_DECREF(unmerged);
+	Py_DECREF(merged);
+	return ret;
+#else
+	PyErr_SetString(PyExc_NotImplementedError, "mergeinfo is only supported in Subversion >= 1.5");
+	return NULL;
+#endif
+}
+
 #if ONLY_SINCE_SVN(1, 5)
 static svn_error_t *py_location_segment_receiver(svn_location_segment_t *segment, void *baton, apr_pool_t *pool)
 {
@@ -2150,7 +2684,7 @@ static PyObject *ra_get_location_segments(PyObject *self, PyObject *args)
 			&peg_revision, &start_revision, &end_revision, &py_rcvr))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -2166,7 +2700,7 @@ static PyObject *ra_get_location_segments(PyObject *self, PyObject *args)
 					 py_location_segment_receiver,
 					 py_rcvr, temp_pool));
 
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 	Py_RETURN_NONE;
 #else
 	PyErr_SetString(PyExc_NotImplementedError, "mergeinfo is only supported in Subversion >= 1.5");
@@ -2194,7 +2728,7 @@ static PyObject *ra_get_file_revs(PyObject *self, PyObject *args)
 	if (ra_check_busy(ra))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
 	if (temp_pool == NULL)
 		return NULL;
 
@@ -2207,26 +2741,142 @@ static PyObject *ra_get_file_revs(PyObject *self, PyObject *args)
 	if (include_merged_revisions) {
 		PyErr_SetString(PyExc_NotImplementedError,
 						"include_merged_revisions only supported with svn >= 1.5");
-		apr_pool_destroy(temp_pool);
+		scratch_pool_release(&ra->scratch, temp_pool);
 		return NULL;
 	}
 	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_file_revs(ra->ra, path, start, end,
 				py_ra_file_rev_handler, (void *)file_rev_handler, temp_pool));
 #endif
 
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&ra->scratch, temp_pool);
 
 	Py_RETURN_NONE;
 }
 
+#if ONLY_SINCE_SVN(1, 5)
+struct ra_blame_baton {
+	blame_t *blame;
+	apr_pool_t *text_pool[2];
+	int cur;
+	svn_stringbuf_t *text;
+	svn_stringbuf_t *next_text;
+	svn_revnum_t revision;
+	int author;
+	svn_txdelta_window_handler_t apply_handler;
+	void *apply_baton;
+	apr_pool_t *scratch_pool;
+};
+
+static svn_error_t *ra_blame_window_handler(svn_txdelta_window_t *window, void *baton)
+{
+	struct ra_blame_baton *b = baton;
+	svn_string_t original, modified;
+
+	SVN_ERR(b->apply_handler(window, b->apply_baton));
+	if (window != NULL)
+		return NULL;
+
+	original.data = b->text->data;
+	original.len = b->text->len;
+	modified.data = b->next_text->data;
+	modified.len = b->next_text->len;
+
+	apr_pool_clear(b->scratch_pool);
+	SVN_ERR(blame_apply_diff(b->blame, &original, &modified, b->revision,
+							 b->author, b->scratch_pool));
+
+	b->cur = !b->cur;
+	b->text = b->next_text;
+	return NULL;
+}
+
+/* Runs without the GIL; the line map is only converted to Python objects
+ * once all revisions have been processed. */
+static svn_error_t *ra_blame_file_rev_handler(void *baton, const char *path, svn_revnum_t rev, apr_hash_t *rev_props, svn_boolean_t result_of_merge, svn_txdelta_window_handler_t *delta_handler, void **delta_baton, apr_array_header_t *prop_diffs, apr_pool_t *pool)
+{
+	struct ra_blame_baton *b = baton;
+	const svn_string_t *author;
+	apr_pool_t *next_pool;
+
+	if (delta_handler == NULL || delta_baton == NULL) {
+		/* Text did not change */
+		return NULL;
+	}
+
+	author = apr_hash_get(rev_props, SVN_PROP_REVISION_AUTHOR,
+						  APR_HASH_KEY_STRING);
+	b->revision = rev;
+	b->author = blame_author(b->blame, author == NULL?NULL:author->data);
+
+	next_pool = b->text_pool[!b->cur];
+	apr_pool_clear(next_pool);
+	b->next_text = svn_stringbuf_create("", next_pool);
+	svn_txdelta_apply(svn_stream_from_stringbuf(b->text, next_pool),
+					  svn_stream_from_stringbuf(b->next_text, next_pool),
+					  NULL, NULL, next_pool, &b->apply_handler, &b->apply_baton);
+
+	*delta_handler = ra_blame_window_handler;
+	*delta_baton = b;
+	return NULL;
+}
+#endif
+
+static PyObject *ra_blame(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if ONLY_SINCE_SVN(1, 5)
+	char *kwnames[] = { "path", "end", "start", NULL };
+	char *path;
+	svn_revnum_t start = 0, end;
+	apr_pool_t *temp_pool;
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	struct ra_blame_baton baton;
+	PyObject *ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sl|l:blame", kwnames,
+									 &path, &end, &start))
+		return NULL;
+
+	if (ra_check_svn_path(path))
+		return NULL;
+
+	if (ra_check_busy(ra))
+		return NULL;
+
+	temp_pool = scratch_pool_acquire(&ra->scratch, ra->pool);
+	if (temp_pool == NULL) {
+		subvertpy_flag_clear(&ra->busy);
+		return NULL;
+	}
+
+	baton.blame = blame_create(temp_pool);
+	baton.text_pool[0] = svn_pool_create(temp_pool);
+	baton.text_pool[1] = svn_pool_create(temp_pool);
+	baton.scratch_pool = svn_pool_create(temp_pool);
+	baton.cur = 0;
+	baton.text = svn_stringbuf_create("", baton.text_pool[0]);
+
+	RUN_RA_WITH_POOL(temp_pool, ra, svn_ra_get_file_revs2(ra->ra, path, start, end,
+				FALSE, ra_blame_file_rev_handler, &baton, temp_pool));
+
+	ret = blame_to_python(baton.blame);
+	scratch_pool_release(&ra->scratch, temp_pool);
+	return ret;
+#else
+	PyErr_SetString(PyExc_NotImplementedError,
+		"blame is only supported in Subversion >= 1.5");
+	return NULL;
+#endif
+}
+
 static void ra_dealloc(PyObject *self)
 {
 	RemoteAccessObject *ra = (RemoteAccessObject *)self;
 	Py_XDECREF(ra->client_string_func);
-	Py_XDECREF(ra->progress_func);
+	Py_XDECREF(ra->open_tmp_file_func);
+	Py_XDECREF(ra->progress.func);
 	Py_XDECREF(ra->auth);
 	apr_pool_destroy(ra->pool);
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyObject *ra_repr(PyObject *self)
@@ -2238,40 +2888,129 @@ static PyObject *ra_repr(PyObject *self)
 static int ra_set_progress_func(PyObject *self, PyObject *value, void *closure)
 {
 	RemoteAccessObject *ra = (RemoteAccessObject *)self;
-	Py_XDECREF(ra->progress_func);
-	ra->progress_func = value;
-	Py_INCREF(ra->progress_func);
+	if (value == NULL)
+		value = Py_None;
+	progress_set_func(&ra->progress, value);
 	return 0;
 }
 
+static PyObject *ra_get_progress_interval(PyObject *self, void *closure)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	return progress_get_interval(&ra->progress);
+}
+
+static int ra_set_progress_interval(PyObject *self, PyObject *value, void *closure)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	return progress_set_interval(&ra->progress, value);
+}
+
+static PyObject *ra_get_progress_min_bytes(PyObject *self, void *closure)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	return progress_get_min_bytes(&ra->progress);
+}
+
+static int ra_set_progress_min_bytes(PyObject *self, PyObject *value, void *closure)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	return progress_set_min_bytes(&ra->progress, value);
+}
+
+static PyObject *ra_get_counters(PyObject *self, void *closure)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	return progress_counters(&ra->progress);
+}
+
+static PyObject *ra_get_busy(PyObject *self, void *closure)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	return PyBool_FromLong(subvertpy_flag_is_set(&ra->busy));
+}
+
 static PyGetSetDef ra_getsetters[] = {
+	{ "busy", ra_get_busy, NULL,
+		"Whether this connection is in use at the moment" },
 	{ "progress_func", NULL, ra_set_progress_func, NULL },
+	{ "progress_interval", ra_get_progress_interval, ra_set_progress_interval,
+		"Minimum number of seconds between calls to progress_func." },
+	{ "progress_min_bytes", ra_get_progress_min_bytes, ra_set_progress_min_bytes,
+		"Minimum number of bytes transferred between calls to progress_func." },
+	{ "counters", ra_get_counters, NULL,
+		"Cumulative transfer counters: bytes transferred, number of requests\n"
+		"and time spent in them (in seconds)." },
     { "url", ra_get_url, NULL, NULL },
 	{ NULL }
 };
 
+#include "_ra_async.c"
 #include "_ra_iter_log.c"
+#include "_ra_iter_queue.c"
+#include "_ra_iter_file_revs.c"
+#include "_ra_iter_location_segments.c"
+#include "_ra_commit_tree.c"
 
 static PyMethodDef ra_methods[] = {
     { "get_session_url", (PyCFunction)ra_get_session_url, METH_NOARGS,
         "S.get_session_url() -> url" },
 	{ "get_file_revs", ra_get_file_revs, METH_VARARGS,
 		"S.get_file_revs(path, start_rev, end_revs, handler)" },
+	{ "blame", (PyCFunction)ra_blame, METH_VARARGS|METH_KEYWORDS,
+		"S.blame(path, end, start=0) -> (revisions, author_indices, authors)\n"
+		"Annotate the lines of a file as of end with the revision in\n"
+		"which they were last changed, stopping at start.\n"
+		"revisions and author_indices are arrays with an entry per line;\n"
+		"author_indices are indexes into the authors list, or -1 for\n"
+		"revisions without an author.\n" },
+	{ "iter_file_revs", (PyCFunction)ra_iter_file_revs, METH_VARARGS|METH_KEYWORDS,
+		"S.iter_file_revs(path, start_rev, end_rev, include_merged_revisions=False, fulltext=True, max_queue=16) -> iterator\n"
+		"Iterate over the revisions in which a file changed, yielding\n"
+		"(revnum, path, revprops, text, prop_diffs) tuples. text is the full\n"
+		"text of the file in that revision, or, if fulltext is False, the\n"
+		"svndiff against the previous revision (None if the text did not\n"
+		"change). prop_diffs is a list of (name, value) tuples with the file\n"
+		"properties changed in that revision; value is None for deleted\n"
+		"properties.\n"
+		"Revisions are retrieved in the background; at most max_queue\n"
+		"of them are buffered. The session can be used again once the\n"
+		"iterator has been exhausted, closed or released.\n" },
 	{ "get_locations", ra_get_locations, METH_VARARGS,
 		"S.get_locations(path, peg_revision, location_revisions)" },
+	{ "get_locations_many", ra_get_locations_many, METH_VARARGS,
+		"S.get_locations_many(requests) -> list of dictionaries\n"
+		"Look up the locations of several paths, each given as a\n"
+		"(path, peg_revision, location_revisions) tuple. The requests are\n"
+		"sent one after another without returning to Python; the result\n"
+		"has a dictionary as returned by get_locations() per request.\n" },
 	{ "get_locks", ra_get_locks, METH_VARARGS,
 		"S.get_locks(path, depth=DEPTH_INFINITY)" },
 	{ "lock", ra_lock, METH_VARARGS,
 		"S.lock(path_revs, comment, steal_lock, lock_func)\n" },
 	{ "unlock", ra_unlock, METH_VARARGS,
 		"S.unlock(path_tokens, break_lock, lock_func)\n" },
-	{ "mergeinfo", ra_mergeinfo, METH_VARARGS,
-		"S.mergeinfo(paths, revision, inherit, include_descendants)\n" },
+	{ "mergeinfo", (PyCFunction)ra_mergeinfo, METH_VARARGS|METH_KEYWORDS,
+		"S.mergeinfo(paths, revision, inherit, include_descendants, lazy=False) -> dict\n"
+		"Returns a dictionary mapping paths to MergeInfo objects.\n"
+		"If lazy is True, a MergeInfoCatalog is returned instead, which "
+		"converts entries when they are accessed." },
+	{ "eligible_revisions", (PyCFunction)ra_eligible_revisions, METH_VARARGS|METH_KEYWORDS,
+		"S.eligible_revisions(source_path, target_path, revision=-1) -> MergeInfo\n"
+		"Returns the revisions that changed source_path (or its history) "
+		"and have not yet been merged into target_path." },
 	{ "get_location_segments", ra_get_location_segments, METH_VARARGS,
 		"S.get_location_segments(path, peg_revision, start_revision, "
 			"end_revision, rcvr)\n"
 		"The receiver is called as rcvr(range_start, range_end, path)\n"
 	},
+	{ "iter_location_segments", (PyCFunction)ra_iter_location_segments, METH_VARARGS|METH_KEYWORDS,
+		"S.iter_location_segments(path, peg_revision, start_revision, end_revision, max_queue=16) -> iterator\n"
+		"Iterate over the location segments of a path, yielding\n"
+		"(range_start, range_end, path) tuples. Segments are retrieved in\n"
+		"the background; at most max_queue of them are buffered. The\n"
+		"session can be used again once the iterator has been exhausted,\n"
+		"closed or released.\n" },
 	{ "has_capability", ra_has_capability, METH_VARARGS,
 		"S.has_capability(name) -> bool\n"
 		"Check whether the specified capability is supported by the client and server" },
@@ -2288,16 +3027,31 @@ static PyMethodDef ra_methods[] = {
 		"Get the contents of a directory. "},
 	{ "get_file", ra_get_file, METH_VARARGS,
 		"S.get_file(path, stream, revnum=-1) -> (fetched_rev, properties)\n"
-		"Fetch a file. The contents will be written to stream." },
+		"Fetch a file. The contents will be written to stream; if stream is\n"
+		"None, only the properties are fetched." },
 	{ "change_rev_prop", ra_change_rev_prop, METH_VARARGS,
 		"S.change_rev_prop(revnum, name, value)\n"
 		"Change a revision property" },
 	{ "get_commit_editor", (PyCFunction)get_commit_editor, METH_VARARGS|METH_KEYWORDS,
 		"S.get_commit_editor(revprops, commit_callback, lock_tokens, keep_locks) -> editor\n"
 	},
-	{ "rev_proplist", ra_rev_proplist, METH_VARARGS,
-		"S.rev_proplist(revnum) -> properties\n"
-		"Return a dictionary with the properties set on the specified revision" },
+	{ "commit_tree", (PyCFunction)ra_commit_tree, METH_VARARGS|METH_KEYWORDS,
+		"S.commit_tree(local_root, base_rev, revprops, jobs=4) -> (revnum, date, author)\n"
+		"Commit a local directory tree, so that the tree at the session URL\n"
+		"matches it. Files and directories that are not present locally are\n"
+		"deleted; symbolic links and .svn directories are ignored.\n"
+		"Text deltas against the base texts are computed by jobs worker\n"
+		"threads (or inline if jobs is 0) and sent in path order.\n"
+		"Before the commit, each directory of the base tree is listed with\n"
+		"a separate request. Files present in both trees are compared by\n"
+		"size and checksum, and only the base texts of files that differ\n"
+		"are downloaded.\n"
+		"Returns None if the commit did not create a revision.\n" },
+	{ "rev_proplist", (PyCFunction)ra_rev_proplist, METH_VARARGS|METH_KEYWORDS,
+		"S.rev_proplist(revnum, lazy=False) -> properties\n"
+		"Return a dictionary with the properties set on the specified revision\n"
+		"If lazy is True, a read-only PropDict is returned instead, which\n"
+		"only converts values as they are accessed." },
 	{ "replay", ra_replay, METH_VARARGS,
 		"S.replay(revision, low_water_mark, update_editor, send_deltas=True)\n"
 		"Replay a revision, reporting changes to update_editor." },
@@ -2331,9 +3085,10 @@ static PyMethodDef ra_methods[] = {
 	{ "iter_log", (PyCFunction)ra_iter_log, METH_VARARGS|METH_KEYWORDS,
 		"S.iter_log(paths, start, end, limit=0, "
 		"discover_changed_paths=False, strict_node_history=True, "
-		"include_merged_revisions=False, revprops=None)\n"
+		"include_merged_revisions=False, revprops=None, lazy_revprops=False)\n"
 		"Yields tuples of three or four elements:\n"
 		"(changed_paths, revision, revprops[, has_children])\n"
+		"If lazy_revprops is True, revprops is a read-only PropDict.\n"
 		"The changed_paths element may be None, or a dictionary mapping each\n"
 		"path to a tuple:\n"
 		"(action, from_path, from_rev, node_kind)\n"
@@ -2342,6 +3097,31 @@ static PyMethodDef ra_methods[] = {
 		"iterator to exhaustion (i.e. until StopIteration is raised, the \"for\"\n"
 		"loop finishes, etc).\n"
 	},
+#if PY_VERSION_HEX >= 0x03050000
+	{ "aiter_log", (PyCFunction)ra_aiter_log, METH_VARARGS|METH_KEYWORDS,
+		"S.aiter_log(paths, start, end, ...) -> async iterator\n"
+		"Asynchronous variant of iter_log(), for use with \"async for\".\n"
+		"The same restriction applies: exhaust the iterator before calling\n"
+		"any further methods.\n"
+	},
+#endif
+	RA_ASYNC_METHOD_DEF(get_latest_revnum),
+	RA_ASYNC_METHOD_DEF(get_uuid),
+	RA_ASYNC_METHOD_DEF(get_repos_root),
+	RA_ASYNC_METHOD_DEF(reparent),
+	RA_ASYNC_METHOD_DEF(get_file),
+	RA_ASYNC_METHOD_DEF(get_dir),
+	RA_ASYNC_METHOD_DEF(check_path),
+	RA_ASYNC_METHOD_DEF(stat),
+	RA_ASYNC_METHOD_DEF(rev_proplist),
+	RA_ASYNC_METHOD_DEF(change_rev_prop),
+	RA_ASYNC_METHOD_DEF(get_log),
+	RA_ASYNC_METHOD_DEF(get_locations),
+	RA_ASYNC_METHOD_DEF(get_location_segments),
+	RA_ASYNC_METHOD_DEF(mergeinfo),
+	RA_ASYNC_METHOD_DEF(has_capability),
+	RA_ASYNC_METHOD_DEF(get_lock),
+	RA_ASYNC_METHOD_DEF(get_locks),
 	{ "get_latest_revnum", (PyCFunction)ra_get_latest_revnum, METH_NOARGS,
 		"S.get_latest_revnum() -> int\n"
 		"Return the last revision committed in the repository." },
@@ -2355,8 +3135,6 @@ static PyMethodDef ra_methods[] = {
 };
 
 static PyMemberDef ra_members[] = {
-	{ "busy", T_BYTE, offsetof(RemoteAccessObject, busy), READONLY,
-		"Whether this connection is in use at the moment" },
 	{ "corrected_url", T_STRING, offsetof(RemoteAccessObject, corrected_url), READONLY,
 		"Corrected URL" },
 	{ NULL, }
@@ -2446,7 +3224,7 @@ static void auth_provider_dealloc(PyObject *self)
 	Py_XDECREF(auth_provider->callback);
 	auth_provider->callback = NULL;
 	apr_pool_destroy(auth_provider->pool);
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyTypeObject AuthProvider_Type = {
@@ -2473,7 +3251,7 @@ static PyObject *auth_init(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwnames, &providers))
 		return NULL;
 
-	ret = PyObject_New(AuthObject, &Auth_Type);
+	ret = PyObject_New(AuthObject, SUBVERTPY_TYPE(Auth_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -2506,7 +3284,7 @@ static PyObject *auth_init(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 		AuthProviderObject *provider;
 		el = (svn_auth_provider_object_t **)apr_array_push(c_providers);
 		provider = (AuthProviderObject *)PySequence_GetItem(providers, i);
-		if (!PyObject_TypeCheck(provider, &AuthProvider_Type)) {
+		if (!PyObject_TypeCheck(provider, SUBVERTPY_TYPE(AuthProvider_Type))) {
 			PyErr_SetString(PyExc_TypeError, "Invalid auth provider");
 			Py_DECREF(ret);
 			return NULL;
@@ -2598,7 +3376,7 @@ static PyObject *auth_first_credentials(PyObject *self, PyObject *args)
 	RUN_SVN_WITH_POOL(pool,
 					  svn_auth_first_credentials(&creds, &state, cred_kind, realmstring, auth->auth_baton, pool));
 
-	ret = PyObject_New(CredentialsIterObject, &CredentialsIter_Type);
+	ret = PyObject_New(CredentialsIterObject, SUBVERTPY_TYPE(CredentialsIter_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -2614,7 +3392,7 @@ static void credentials_iter_dealloc(PyObject *self)
 {
 	CredentialsIterObject *credsiter = (CredentialsIterObject *)self;
 	apr_pool_destroy(credsiter->pool);
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyObject *credentials_iter_next(CredentialsIterObject *iterator)
@@ -2687,7 +3465,7 @@ static void auth_dealloc(PyObject *self)
 	AuthObject *auth = (AuthObject *)self;
 	apr_pool_destroy(auth->pool);
 	Py_XDECREF(auth->providers);
-	PyObject_Del(auth);
+	py_object_del(auth);
 }
 
 static PyTypeObject Auth_Type = {
@@ -2820,7 +3598,7 @@ static PyObject *get_username_prompt_provider(PyObject *self, PyObject *args)
 	if (!PyArg_ParseTuple(args, "Oi:get_username_prompt_provider",
 			  &prompt_func, &retry_limit))
 		return NULL;
-	auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->pool = Pool(NULL);
@@ -2895,7 +3673,7 @@ static PyObject *get_simple_prompt_provider(PyObject *self, PyObject *args)
 	if (!PyArg_ParseTuple(args, "Oi", &prompt_func, &retry_limit))
 		return NULL;
 
-	auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	auth->pool = Pool(NULL);
 	if (auth->pool == NULL)
 		return NULL;
@@ -2957,7 +3735,7 @@ static PyObject *get_ssl_server_trust_prompt_provider(PyObject *self, PyObject *
 	if (!PyArg_ParseTuple(args, "O", &prompt_func))
 		return NULL;
 
-	auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->pool = Pool(NULL);
@@ -3046,7 +3824,7 @@ static PyObject *get_ssl_client_cert_pw_prompt_provider(PyObject *self, PyObject
 	if (!PyArg_ParseTuple(args, "Oi", &prompt_func, &retry_limit))
 		return NULL;
 
-	auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->pool = Pool(NULL);
@@ -3067,7 +3845,7 @@ static PyObject *get_ssl_client_cert_prompt_provider(PyObject *self, PyObject *a
 	if (!PyArg_ParseTuple(args, "Oi", &prompt_func, &retry_limit))
 		return NULL;
 
-	auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->pool = Pool(NULL);
@@ -3082,13 +3860,13 @@ static PyObject *get_ssl_client_cert_prompt_provider(PyObject *self, PyObject *a
 static PyObject *get_username_provider(PyObject *self)
 {
 	AuthProviderObject *auth;
-	auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->pool = Pool(NULL);
 	auth->callback = NULL;
 	if (auth->pool == NULL) {
-		PyObject_Del(auth);
+		py_object_del(auth);
 		return NULL;
 	}
 	svn_auth_get_username_provider(&auth->provider, auth->pool);
@@ -3134,7 +3912,7 @@ static PyObject *get_simple_provider(PyObject *self, PyObject *args)
 	pool = Pool(NULL);
 	if (pool == NULL)
 		return NULL;
-	auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL) {
 		apr_pool_destroy(pool);
 		return NULL;
@@ -3161,7 +3939,7 @@ static PyObject *get_simple_provider(PyObject *self, PyObject *args)
 
 static PyObject *get_ssl_server_trust_file_provider(PyObject *self)
 {
-	AuthProviderObject *auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	AuthProviderObject *auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->callback = NULL;
@@ -3174,7 +3952,7 @@ static PyObject *get_ssl_server_trust_file_provider(PyObject *self)
 
 static PyObject *get_ssl_client_cert_file_provider(PyObject *self)
 {
-	AuthProviderObject *auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	AuthProviderObject *auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->callback = NULL;
@@ -3187,7 +3965,7 @@ static PyObject *get_ssl_client_cert_file_provider(PyObject *self)
 
 static PyObject *get_ssl_client_cert_pw_file_provider(PyObject *self)
 {
-	AuthProviderObject *auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	AuthProviderObject *auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->callback = NULL;
@@ -3230,7 +4008,7 @@ static PyObject *print_modules(PyObject *self)
 #if defined(WIN32) || defined(__CYGWIN__)
 static PyObject *get_windows_simple_provider(PyObject* self)
 {
-	AuthProviderObject *auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	AuthProviderObject *auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->callback = NULL;
@@ -3244,7 +4022,7 @@ static PyObject *get_windows_simple_provider(PyObject* self)
 #if ONLY_SINCE_SVN(1, 5)
 static PyObject *get_windows_ssl_server_trust_provider(PyObject *self)
 {
-	AuthProviderObject *auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	AuthProviderObject *auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->callback = NULL;
@@ -3260,7 +4038,7 @@ static PyObject *get_windows_ssl_server_trust_provider(PyObject *self)
 #if defined(SVN_KEYCHAIN_PROVIDER_AVAILABLE)
 static PyObject *get_keychain_simple_provider(PyObject* self)
 {
-	AuthProviderObject *auth = PyObject_New(AuthProviderObject, &AuthProvider_Type);
+	AuthProviderObject *auth = PyObject_New(AuthProviderObject, SUBVERTPY_TYPE(AuthProvider_Type));
 	if (auth == NULL)
 		return NULL;
 	auth->callback = NULL;
@@ -3306,7 +4084,7 @@ static PyObject *get_platform_specific_client_providers(PyObject *self)
 															pool));
 
 			auth = PyObject_New(AuthProviderObject,
-								&AuthProvider_Type);
+								SUBVERTPY_TYPE(AuthProvider_Type));
 
 			if (c_provider == NULL || auth == NULL) {
 				apr_pool_destroy(pool);
@@ -3371,6 +4149,26 @@ static PyMethodDef ra_module_methods[] = {
 		"api_version() -> (major, minor, patch, tag)\n\n"
 		"Version of libsvn_ra Subvertpy was compiled against."
 	},
+	{ "pool_stats", (PyCFunction)py_pool_stats, METH_NOARGS,
+		"pool_stats() -> dict\n\n"
+		"Counts of APR pools created, currently live, live at the same time\n"
+		"at most and reused as scratch pools by this module." },
+	STATS_METHODS,
+	{ "set_tmp_file_options", (PyCFunction)set_tmp_file_options,
+		METH_VARARGS|METH_KEYWORDS,
+		"set_tmp_file_options(memory_limit, directory=None)\n\n"
+		"Configure the scratch files Subversion uses to spool data for\n"
+		"sessions opened without an open_tmp_file_func. They are kept in\n"
+		"memory while a session has less than memory_limit bytes in such\n"
+		"files (on platforms with memfd_create), and created in directory\n"
+		"after that. A directory of None means a subvertpy directory in\n"
+		"the Subversion temporary directory. Affects sessions opened\n"
+		"afterwards.\n"
+		"The limit is only checked when a scratch file is opened, so a\n"
+		"single file that is kept in memory may grow beyond it." },
+	{ "get_tmp_file_options", (PyCFunction)get_tmp_file_options, METH_NOARGS,
+		"get_tmp_file_options() -> (memory_limit, directory)\n\n"
+		"Current scratch file settings; see set_tmp_file_options()." },
 	{ "get_ssl_client_cert_pw_file_provider", (PyCFunction)get_ssl_client_cert_pw_file_provider, METH_NOARGS, NULL },
 	{ "get_ssl_client_cert_file_provider", (PyCFunction)get_ssl_client_cert_file_provider, METH_NOARGS, NULL },
 	{ "get_ssl_server_trust_file_provider", (PyCFunction)get_ssl_server_trust_file_provider, METH_NOARGS, NULL },
@@ -3399,80 +4197,87 @@ static PyMethodDef ra_module_methods[] = {
 	{ NULL, }
 };
 
-static PyObject *
-moduleinit(void)
-{
-	static apr_pool_t *pool;
-	PyObject *mod;
-
-	if (PyType_Ready(&RemoteAccess_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&Editor_Type) < 0)
-		return NULL;
+const subvertpy_type_def_t ra_types[] = {
+	{ Reporter_Type_ID, &Reporter_Type },
+	{ RemoteAccess_Type_ID, &RemoteAccess_Type },
+	{ AuthProvider_Type_ID, &AuthProvider_Type },
+	{ CredentialsIter_Type_ID, &CredentialsIter_Type },
+	{ Auth_Type_ID, &Auth_Type },
+	{ LogIterator_Type_ID, &LogIterator_Type },
+	{ FileRevsIterator_Type_ID, &FileRevsIterator_Type },
+	{ SegmentsIterator_Type_ID, &SegmentsIterator_Type },
+	{ 0, NULL }
+};
 
-	if (PyType_Ready(&FileEditor_Type) < 0)
-		return NULL;
+const mergeinfo_api_t *mergeinfo_api;
 
-	if (PyType_Ready(&DirectoryEditor_Type) < 0)
-		return NULL;
+int mergeinfo_api_import(void)
+{
+	PyObject *subr, *capsule;
+
+	if (mergeinfo_api != NULL)
+		return 0;
+
+	subr = PyImport_ImportModule("subvertpy.subr");
+	if (subr == NULL)
+		return -1;
+	capsule = PyObject_GetAttrString(subr, "_mergeinfo_api");
+	Py_DECREF(subr);
+	if (capsule == NULL)
+		return -1;
+	mergeinfo_api = PyCapsule_GetPointer(capsule, MERGEINFO_API_CAPSULE);
+	Py_DECREF(capsule);
+	if (mergeinfo_api == NULL)
+		return -1;
+	return 0;
+}
 
-	if (PyType_Ready(&Reporter_Type) < 0)
-		return NULL;
+static int ra_exec(PyObject *mod)
+{
+	subvertpy_state_t *state;
 
-	if (PyType_Ready(&TxDeltaWindowHandler_Type) < 0)
-		return NULL;
+	if (subvertpy_state_init(mod) < 0)
+		return -1;
 
-	if (PyType_Ready(&Auth_Type) < 0)
-		return NULL;
+	if (subvertpy_add_types(mod, util_types) < 0)
+		return -1;
 
-	if (PyType_Ready(&CredentialsIter_Type) < 0)
-		return NULL;
+	if (subvertpy_add_types(mod, editor_types) < 0)
+		return -1;
 
-	if (PyType_Ready(&AuthProvider_Type) < 0)
-		return NULL;
+	if (mergeinfo_api_import() < 0)
+		return -1;
 
-	if (PyType_Ready(&LogIterator_Type) < 0)
-		return NULL;
+	if (subvertpy_add_types(mod, ra_types) < 0)
+		return -1;
 
-	apr_initialize();
-	pool = Pool(NULL);
-	if (pool == NULL)
-		return NULL;
-	svn_ra_initialize(pool);
+	if (!subvertpy_global_init(svn_ra_initialize))
+		return -1;
 	PyEval_InitThreads();
 
+	state = subvertpy_state();
 
-#if PY_MAJOR_VERSION >= 3
-	static struct PyModuleDef moduledef = {
-	  PyModuleDef_HEAD_INIT,
-	  "_ra",         /* m_name */
-	  "Remote Access",            /* m_doc */
-	  -1,              /* m_size */
-	  ra_module_methods, /* m_methods */
-	  NULL,            /* m_reload */
-	  NULL,            /* m_traverse */
-	  NULL,            /* m_clear*/
-	  NULL,            /* m_free */
-	};
-	mod = PyModule_Create(&moduledef);
-#else
-	mod = Py_InitModule3("_ra", ra_module_methods, "Remote Access");
-#endif
-	if (mod == NULL)
-		return NULL;
+	PyModule_AddObject(mod, "RemoteAccess", (PyObject *)SUBVERTPY_TYPE(RemoteAccess_Type));
+	Py_INCREF(SUBVERTPY_TYPE(RemoteAccess_Type));
+
+	PyModule_AddObject(mod, "Auth", (PyObject *)SUBVERTPY_TYPE(Auth_Type));
+	Py_INCREF(SUBVERTPY_TYPE(Auth_Type));
 
-	PyModule_AddObject(mod, "RemoteAccess", (PyObject *)&RemoteAccess_Type);
-	Py_INCREF(&RemoteAccess_Type);
+	PyModule_AddObject(mod, "Editor", (PyObject *)SUBVERTPY_TYPE(Editor_Type));
+	Py_INCREF(SUBVERTPY_TYPE(Editor_Type));
 
-	PyModule_AddObject(mod, "Auth", (PyObject *)&Auth_Type);
-	Py_INCREF(&Auth_Type);
+	PyModule_AddObject(mod, "PropDict", (PyObject *)SUBVERTPY_TYPE(PropDict_Type));
+	Py_INCREF(SUBVERTPY_TYPE(PropDict_Type));
 
-	PyModule_AddObject(mod, "Editor", (PyObject *)&Editor_Type);
-	Py_INCREF(&Editor_Type);
+	state->busy_exc = PyErr_NewException("_ra.BusyException", NULL, NULL);
+	if (state->busy_exc == NULL)
+		return -1;
+	PyModule_AddObject(mod, "BusyException", state->busy_exc);
+	Py_INCREF(state->busy_exc);
 
-	busy_exc = PyErr_NewException("_ra.BusyException", NULL, NULL);
-	PyModule_AddObject(mod, "BusyException", busy_exc);
+	state->async_complete_func = PyCFunction_New(&async_complete_def, NULL);
+	if (state->async_complete_func == NULL)
+		return -1;
 
 #if ONLY_SINCE_SVN(1, 5)
 	PyModule_AddIntConstant(mod, "DEPTH_UNKNOWN", svn_depth_unknown);
@@ -3501,19 +4306,56 @@ moduleinit(void)
 	PyModule_AddIntConstant(mod, "SVN_REVISION", SVN_VER_REVISION);
 #endif
 
-	return mod;
+	return 0;
 }
 
+#if PY_VERSION_HEX >= 0x03050000
+static PyModuleDef_Slot ra_module_slots[] = {
+	{ Py_mod_exec, ra_exec },
+	SUBVERTPY_MODULE_SLOTS
+	{ 0, NULL }
+};
+#endif
+
 #if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef moduledef = {
+	PyModuleDef_HEAD_INIT,
+	"_ra",         /* m_name */
+	"Remote Access",            /* m_doc */
+	SUBVERTPY_STATE_SIZE,              /* m_size */
+	ra_module_methods, /* m_methods */
+#if PY_VERSION_HEX >= 0x03050000
+	ra_module_slots, /* m_slots */
+#else
+	NULL,            /* m_reload */
+#endif
+	subvertpy_state_traverse, /* m_traverse */
+	subvertpy_state_clear, /* m_clear*/
+	subvertpy_state_free, /* m_free */
+};
+#endif
+
+#if PY_VERSION_HEX >= 0x03050000
 PyMODINIT_FUNC
 PyInit__ra(void)
 {
-	return moduleinit();
+	return PyModuleDef_Init(&moduledef);
+}
+#elif PY_MAJOR_VERSION >= 3
+PyMODINIT_FUNC
+PyInit__ra(void)
+{
+	PyObject *mod = PyModule_Create(&moduledef);
+	if (mod != NULL && ra_exec(mod) < 0)
+		Py_CLEAR(mod);
+	return mod;
 }
 #else
 PyMODINIT_FUNC
 init_ra(void)
 {
-	moduleinit();
+	PyObject *mod = Py_InitModule3("_ra", ra_module_methods, "Remote Access");
+	if (mod != NULL)
+		ra_exec(mod);
 }
 #endif
@@ -0,0 +1,322 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#include <pythread.h>
+
+/*
+ * Awaitable variants of RemoteAccess methods.
+ *
+ * Calls are queued on the RemoteAccess object and run in order by a worker
+ * thread, which is started when the first call is queued and exits once
+ * the queue is empty. Since a session can only run one call at a time,
+ * this also keeps async callers from running into BusyException. Results
+ * are handed back to the event loop with loop.call_soon_threadsafe().
+ */
+
+struct ra_async_call {
+	PyObject *method;
+	PyObject *args;
+	PyObject *kwargs;
+	PyObject *loop;
+	PyObject *future;
+	struct ra_async_call *next;
+};
+
+/**
+ * Resolve a future; runs on the event loop thread.
+ *
+ * Takes (future, exception, result); exception is None on success.
+ */
+static PyObject *async_complete(PyObject *self, PyObject *args)
+{
+	PyObject *future, *exc, *result, *done, *ret;
+	int is_done;
+
+	if (!PyArg_ParseTuple(args, "OOO", &future, &exc, &result))
+		return NULL;
+
+	/* The caller may have cancelled the future in the mean time. */
+	done = PyObject_CallMethod(future, "done", NULL);
+	if (done == NULL)
+		return NULL;
+	is_done = PyObject_IsTrue(done);
+	Py_DECREF(done);
+	if (is_done == -1)
+		return NULL;
+	if (is_done)
+		Py_RETURN_NONE;
+
+	if (exc != Py_None)
+		ret = PyObject_CallMethod(future, "set_exception", "O", exc);
+	else
+		ret = PyObject_CallMethod(future, "set_result", "O", result);
+	return ret;
+}
+
+static PyMethodDef async_complete_def = {
+	"_async_complete", async_complete, METH_VARARGS, NULL
+};
+
+/**
+ * Obtain the event loop futures should be attached to.
+ *
+ * This is the running loop if there is one, and the current thread's
+ * event loop otherwise (as for asyncio.ensure_future()).
+ */
+static PyObject *async_get_loop(void)
+{
+	PyObject *asyncio_mod, *loop;
+
+	asyncio_mod = PyImport_ImportModule("asyncio");
+	if (asyncio_mod == NULL)
+		return NULL;
+
+	if (PyObject_HasAttrString(asyncio_mod, "get_running_loop")) {
+		loop = PyObject_CallMethod(asyncio_mod, "get_running_loop", NULL);
+		if (loop != NULL || !PyErr_ExceptionMatches(PyExc_RuntimeError)) {
+			Py_DECREF(asyncio_mod);
+			return loop;
+		}
+		PyErr_Clear();
+	}
+
+	loop = PyObject_CallMethod(asyncio_mod, "get_event_loop", NULL);
+	Py_DECREF(asyncio_mod);
+	return loop;
+}
+
+/**
+ * Arrange for future to be resolved on its event loop.
+ *
+ * Must be called with the GIL held. Steals no references. If the
+ * loop has already been closed there is nobody left to tell, so the
+ * error is reported as unraisable.
+ */
+static void async_schedule(PyObject *loop, PyObject *future, PyObject *exc,
+						   PyObject *result)
+{
+	PyObject *ret;
+
+	ret = PyObject_CallMethod(loop, "call_soon_threadsafe", "OOOO",
+							  subvertpy_state()->async_complete_func, future,
+							  exc == NULL?Py_None:exc,
+							  result == NULL?Py_None:result);
+	if (ret == NULL) {
+		PyErr_WriteUnraisable(future);
+		return;
+	}
+	Py_DECREF(ret);
+}
+
+/**
+ * Fetch the current exception as an exception instance, clearing it.
+ */
+static PyObject *async_fetch_exception(void)
+{
+	PyObject *type, *value, *tb;
+
+	PyErr_Fetch(&type, &value, &tb);
+	PyErr_NormalizeException(&type, &value, &tb);
+	if (value == NULL) {
+		value = Py_None;
+		Py_INCREF(value);
+	}
+#if PY_MAJOR_VERSION >= 3
+	if (tb != NULL)
+		PyException_SetTraceback(value, tb);
+#endif
+	Py_XDECREF(type);
+	Py_XDECREF(tb);
+	return value;
+}
+
+static void async_call_free(struct ra_async_call *call)
+{
+	Py_DECREF(call->method);
+	Py_DECREF(call->args);
+	Py_XDECREF(call->kwargs);
+	Py_DECREF(call->loop);
+	Py_DECREF(call->future);
+	PyMem_Free(call);
+}
+
+static void async_call_run(struct ra_async_call *call)
+{
+	PyObject *done, *ret, *exc = NULL;
+	int is_done;
+
+	done = PyObject_CallMethod(call->future, "done", NULL);
+	if (done == NULL) {
+		PyErr_WriteUnraisable(call->future);
+		return;
+	}
+	is_done = PyObject_IsTrue(done);
+	Py_DECREF(done);
+	if (is_done) {
+		/* Cancelled before it got a chance to run. */
+		return;
+	}
+
+	ret = PyObject_Call(call->method, call->args, call->kwargs);
+	if (ret == NULL)
+		exc = async_fetch_exception();
+
+	async_schedule(call->loop, call->future, exc, ret);
+	Py_XDECREF(exc);
+	Py_XDECREF(ret);
+}
+
+static void ra_async_worker(void *baton)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)baton;
+	PyThreadState *tstate;
+
+	tstate = subvertpy_thread_attach(ra->interp);
+
+	while (true) {
+		struct ra_async_call *call;
+
+		/* The queue is shared with ra_async_call(), which may run
+		 * concurrently on free-threaded builds. */
+		Py_BEGIN_CRITICAL_SECTION(ra);
+		call = ra->async_head;
+		if (call != NULL) {
+			ra->async_head = call->next;
+			if (ra->async_head == NULL)
+				ra->async_tail = NULL;
+		} else {
+			ra->async_running = false;
+		}
+		Py_END_CRITICAL_SECTION();
+
+		if (call == NULL)
+			break;
+
+		async_call_run(call);
+		async_call_free(call);
+	}
+
+	Py_DECREF(ra);
+	subvertpy_thread_detach(tstate);
+}
+
+/**
+ * Queue a call to the named method and return a future for its result.
+ */
+static PyObject *ra_async_call(PyObject *self, const char *name,
+							   PyObject *args, PyObject *kwargs)
+{
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	struct ra_async_call *call;
+	PyObject *loop, *future, *method;
+	bool started = true;
+
+	loop = async_get_loop();
+	if (loop == NULL)
+		return NULL;
+
+	method = PyObject_GetAttrString(self, name);
+	if (method == NULL) {
+		Py_DECREF(loop);
+		return NULL;
+	}
+
+	future = PyObject_CallMethod(loop, "create_future", NULL);
+	if (future == NULL) {
+		Py_DECREF(method);
+		Py_DECREF(loop);
+		return NULL;
+	}
+
+	call = PyMem_Malloc(sizeof(struct ra_async_call));
+	if (call == NULL) {
+		Py_DECREF(future);
+		Py_DECREF(method);
+		Py_DECREF(loop);
+		return PyErr_NoMemory();
+	}
+
+	call->method = method;
+	call->args = args;
+	Py_INCREF(args);
+	call->kwargs = kwargs;
+	Py_XINCREF(kwargs);
+	call->loop = loop;
+	call->future = future;
+	Py_INCREF(future);
+	call->next = NULL;
+
+	Py_BEGIN_CRITICAL_SECTION(ra);
+	if (ra->async_tail == NULL) {
+		ra->async_head = call;
+	} else {
+		ra->async_tail->next = call;
+	}
+	ra->async_tail = call;
+
+	if (!ra->async_running) {
+		ra->async_running = true;
+		Py_INCREF(ra);
+		if (PyThread_start_new_thread(ra_async_worker, ra) == -1) {
+			ra->async_running = false;
+			ra->async_head = ra->async_tail = NULL;
+			started = false;
+		}
+	}
+	Py_END_CRITICAL_SECTION();
+
+	if (!started) {
+		async_call_free(call);
+		Py_DECREF(ra);
+		Py_DECREF(future);
+		PyErr_SetString(PyExc_RuntimeError,
+						"Unable to start worker thread");
+		return NULL;
+	}
+
+	return future;
+}
+
+#define RA_ASYNC_METHOD(name) \
+static PyObject *ra_a ## name(PyObject *self, PyObject *args, PyObject *kwargs) \
+{ \
+	return ra_async_call(self, #name, args, kwargs); \
+}
+
+RA_ASYNC_METHOD(get_latest_revnum)
+RA_ASYNC_METHOD(get_uuid)
+RA_ASYNC_METHOD(get_repos_root)
+RA_ASYNC_METHOD(reparent)
+RA_ASYNC_METHOD(get_file)
+RA_ASYNC_METHOD(get_dir)
+RA_ASYNC_METHOD(check_path)
+RA_ASYNC_METHOD(stat)
+RA_ASYNC_METHOD(rev_proplist)
+RA_ASYNC_METHOD(change_rev_prop)
+RA_ASYNC_METHOD(get_log)
+RA_ASYNC_METHOD(get_locations)
+RA_ASYNC_METHOD(get_location_segments)
+RA_ASYNC_METHOD(mergeinfo)
+RA_ASYNC_METHOD(has_capability)
+RA_ASYNC_METHOD(get_lock)
+RA_ASYNC_METHOD(get_locks)
+
+#define RA_ASYNC_METHOD_DEF(name) \
+	{ "a" #name, (PyCFunction)ra_a ## name, METH_VARARGS|METH_KEYWORDS, \
+		"S.a" #name "(...) -> Future\n" \
+		"Awaitable variant of " #name "()." }
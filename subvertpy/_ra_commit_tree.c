@@ -0,0 +1,830 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#include <apr_thread_proc.h>
+#include <apr_thread_mutex.h>
+#include <apr_thread_cond.h>
+
+/*
+ * Commit of a local directory tree.
+ *
+ * The whole commit runs without the GIL. The local tree and the tree at
+ * the base revision are compared up front, which gives a list of editor
+ * operations in path order; this lists each directory that exists in
+ * the base tree with a separate request. Files that exist in both are
+ * compared by size and checksum against the base tree, whose checksums
+ * are fetched without the texts by a single diff drive, and the base
+ * texts of the files that differ are spooled to temporary files by a
+ * single update drive. Both happen before the commit editor is opened,
+ * since most RA layers do not allow other requests during a commit.
+ * Worker threads then write the text deltas to temporary files, at most
+ * a window of files ahead of the file that is being sent, while the main
+ * thread drives the commit editor and streams the deltas from those
+ * files.
+ */
+
+#if ONLY_SINCE_SVN(1, 6)
+
+typedef enum {
+	COMMIT_TREE_DELETE,
+	COMMIT_TREE_ADD_DIR,
+	COMMIT_TREE_OPEN_DIR,
+	COMMIT_TREE_CLOSE_DIR,
+	COMMIT_TREE_ADD_FILE,
+	COMMIT_TREE_MODIFY_FILE,
+} commit_tree_action_t;
+
+typedef struct {
+	commit_tree_action_t action;
+	const char *relpath;
+	const char *local_path;
+	const char *base_path;
+	const char *base_checksum;
+	svn_filesize_t base_size;
+
+	/* Set by whoever computed the delta; ready is protected by the
+	 * mutex. */
+	bool ready;
+	bool unchanged;
+	apr_pool_t *pool;
+	const char *delta_path;
+	const char *checksum;
+	svn_error_t *err;
+} commit_tree_node_t;
+
+typedef struct {
+	svn_ra_session_t *session;
+	svn_revnum_t base_rev;
+	apr_pool_t *pool;
+	apr_array_header_t *nodes;
+	apr_array_header_t *files;
+	svn_commit_info_t *commit_info;
+
+	/* Only used if there are worker threads */
+	apr_array_header_t *threads;
+	int window;
+	apr_thread_mutex_t *mutex;
+	apr_thread_cond_t *cond;
+	int next_file;
+	int consumed;
+	bool cancelled;
+} commit_tree_t;
+
+static const char *commit_tree_relpath_join(const char *base,
+											const char *name,
+											apr_pool_t *pool)
+{
+#if ONLY_SINCE_SVN(1, 7)
+	return svn_relpath_join(base, name, pool);
+#else
+	return svn_path_join(base, name, pool);
+#endif
+}
+
+static int commit_tree_compare_names(const void *a, const void *b)
+{
+	return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+static apr_array_header_t *commit_tree_sorted_names(apr_hash_t *hash,
+													apr_pool_t *pool)
+{
+	apr_array_header_t *names;
+	apr_hash_index_t *idx;
+
+	names = apr_array_make(pool, apr_hash_count(hash), sizeof(const char *));
+	for (idx = apr_hash_first(pool, hash); idx != NULL;
+		 idx = apr_hash_next(idx)) {
+		const void *key;
+		apr_hash_this(idx, &key, NULL, NULL);
+		APR_ARRAY_PUSH(names, const char *) = key;
+	}
+	qsort(names->elts, names->nelts, names->elt_size,
+		  commit_tree_compare_names);
+	return names;
+}
+
+static commit_tree_node_t *commit_tree_push(commit_tree_t *ct,
+											 commit_tree_action_t action,
+											 const char *relpath,
+											 const char *local_path)
+{
+	commit_tree_node_t *node = apr_array_push(ct->nodes);
+
+	memset(node, 0, sizeof(*node));
+	node->action = action;
+	node->relpath = relpath;
+	node->local_path = local_path;
+	node->base_size = SVN_INVALID_FILESIZE;
+	if (action == COMMIT_TREE_ADD_FILE || action == COMMIT_TREE_MODIFY_FILE)
+		APR_ARRAY_PUSH(ct->files, int) = ct->nodes->nelts - 1;
+	return node;
+}
+
+/**
+ * Add the operations that turn the directory relpath at the base revision
+ * into local_path.
+ *
+ * Special files (symbolic links) and .svn directories are ignored: they
+ * are not added, and the base entries they shadow are not deleted.
+ */
+static svn_error_t *commit_tree_build(commit_tree_t *ct, const char *relpath,
+									  const char *local_path, bool in_base,
+									  apr_pool_t *scratch_pool)
+{
+	apr_hash_t *local, *base = NULL;
+	apr_array_header_t *names;
+	apr_pool_t *iterpool;
+	int i;
+
+	SVN_ERR(svn_io_get_dirents2(&local, local_path, scratch_pool));
+	apr_hash_set(local, ".svn", APR_HASH_KEY_STRING, NULL);
+	if (in_base) {
+		SVN_ERR(svn_ra_get_dir2(ct->session, &base, NULL, NULL, relpath,
+								ct->base_rev, SVN_DIRENT_KIND|SVN_DIRENT_SIZE,
+								scratch_pool));
+	}
+
+	if (base != NULL) {
+		/* Entries that are gone or have changed kind are deleted first. */
+		names = commit_tree_sorted_names(base, scratch_pool);
+		for (i = 0; i < names->nelts; i++) {
+			const char *name = APR_ARRAY_IDX(names, i, const char *);
+			svn_dirent_t *dirent = apr_hash_get(base, name,
+												APR_HASH_KEY_STRING);
+			svn_io_dirent_t *io = apr_hash_get(local, name,
+											   APR_HASH_KEY_STRING);
+			if (io != NULL && io->special)
+				continue;
+			if (io == NULL || io->kind != dirent->kind) {
+				commit_tree_push(ct, COMMIT_TREE_DELETE,
+					commit_tree_relpath_join(relpath, name, ct->pool), NULL);
+			}
+		}
+	}
+
+	iterpool = svn_pool_create(scratch_pool);
+	names = commit_tree_sorted_names(local, scratch_pool);
+	for (i = 0; i < names->nelts; i++) {
+		const char *name = APR_ARRAY_IDX(names, i, const char *);
+		svn_io_dirent_t *io = apr_hash_get(local, name, APR_HASH_KEY_STRING);
+		svn_dirent_t *dirent = NULL;
+		const char *child_relpath, *child_path;
+		bool existed;
+
+		if (io->special)
+			continue;
+
+		svn_pool_clear(iterpool);
+		if (base != NULL)
+			dirent = apr_hash_get(base, name, APR_HASH_KEY_STRING);
+		existed = (dirent != NULL && dirent->kind == io->kind);
+		child_relpath = commit_tree_relpath_join(relpath, name, ct->pool);
+		child_path = svn_dirent_join(local_path, name, ct->pool);
+
+		if (io->kind == svn_node_dir) {
+			commit_tree_push(ct, existed?COMMIT_TREE_OPEN_DIR:COMMIT_TREE_ADD_DIR,
+							 child_relpath, child_path);
+			SVN_ERR(commit_tree_build(ct, child_relpath, child_path, existed,
+									  iterpool));
+			commit_tree_push(ct, COMMIT_TREE_CLOSE_DIR, child_relpath, NULL);
+		} else if (io->kind == svn_node_file) {
+			commit_tree_node_t *node = commit_tree_push(ct,
+				existed?COMMIT_TREE_MODIFY_FILE:COMMIT_TREE_ADD_FILE,
+				child_relpath, child_path);
+			if (existed)
+				node->base_size = dirent->size;
+		}
+	}
+	svn_pool_destroy(iterpool);
+	return NULL;
+}
+
+/* The spool editor receives the checksums of the base tree from a diff
+ * drive without text deltas, and then the base texts that are needed
+ * from an update drive; its directory batons are all the edit baton. */
+typedef struct {
+	commit_tree_t *ct;
+	apr_hash_t *files;
+	bool fetch_texts;
+} commit_tree_spool_t;
+
+typedef struct {
+	commit_tree_t *ct;
+	commit_tree_node_t *node;
+	unsigned char digest[APR_MD5_DIGESTSIZE];
+	bool fetch_text;
+	bool applied;
+} commit_tree_spool_file_t;
+
+static svn_error_t *commit_tree_spool_open_root(void *edit_baton,
+												svn_revnum_t base_revision,
+												apr_pool_t *pool,
+												void **root_baton)
+{
+	*root_baton = edit_baton;
+	return NULL;
+}
+
+static svn_error_t *commit_tree_spool_add_directory(
+	const char *path, void *parent_baton, const char *copyfrom_path,
+	svn_revnum_t copyfrom_revision, apr_pool_t *pool, void **child_baton)
+{
+	*child_baton = parent_baton;
+	return NULL;
+}
+
+static svn_error_t *commit_tree_spool_open_directory(
+	const char *path, void *parent_baton, svn_revnum_t base_revision,
+	apr_pool_t *pool, void **child_baton)
+{
+	*child_baton = parent_baton;
+	return NULL;
+}
+
+static svn_error_t *commit_tree_spool_add_file(
+	const char *path, void *parent_baton, const char *copyfrom_path,
+	svn_revnum_t copyfrom_revision, apr_pool_t *pool, void **file_baton)
+{
+	commit_tree_spool_t *spool = parent_baton;
+	commit_tree_spool_file_t *fb = apr_pcalloc(pool, sizeof(*fb));
+
+	fb->ct = spool->ct;
+	fb->node = apr_hash_get(spool->files, path, APR_HASH_KEY_STRING);
+	fb->fetch_text = spool->fetch_texts;
+	*file_baton = fb;
+	return NULL;
+}
+
+static svn_error_t *commit_tree_spool_apply_textdelta(
+	void *file_baton, const char *base_checksum, apr_pool_t *pool,
+	svn_txdelta_window_handler_t *handler, void **handler_baton)
+{
+	commit_tree_spool_file_t *fb = file_baton;
+	svn_stream_t *stream;
+	const char *path;
+
+	if (fb->node == NULL || !fb->fetch_text) {
+		*handler = svn_delta_noop_window_handler;
+		*handler_baton = NULL;
+		return NULL;
+	}
+
+	SVN_ERR(svn_stream_open_unique(&stream, &path, NULL,
+								   svn_io_file_del_none, fb->ct->pool, pool));
+	fb->node->base_path = path;
+	fb->applied = true;
+	/* Closes stream once the last window has been applied. */
+	svn_txdelta_apply(svn_stream_empty(pool), stream, fb->digest, NULL, pool,
+					  handler, handler_baton);
+	return NULL;
+}
+
+static svn_error_t *commit_tree_spool_close_file(void *file_baton,
+												 const char *text_checksum,
+												 apr_pool_t *pool)
+{
+	commit_tree_spool_file_t *fb = file_baton;
+	svn_checksum_t *checksum;
+
+	if (fb->node == NULL)
+		return NULL;
+
+	if (text_checksum != NULL) {
+		fb->node->base_checksum = apr_pstrdup(fb->ct->pool, text_checksum);
+	} else if (fb->applied) {
+		checksum = svn_checksum_create(svn_checksum_md5, pool);
+		memcpy((unsigned char *)checksum->digest, fb->digest,
+			   APR_MD5_DIGESTSIZE);
+		fb->node->base_checksum = svn_checksum_to_cstring(checksum,
+														  fb->ct->pool);
+	}
+	return NULL;
+}
+
+/**
+ * Run an update drive (or a diff drive without text deltas, if the texts
+ * are not needed) of the base tree into the spool editor.
+ *
+ * For the update drive, the base tree is reported as present apart from
+ * the files whose texts are needed, so that only those are sent.
+ */
+static svn_error_t *commit_tree_spool_drive(commit_tree_spool_t *spool,
+											apr_pool_t *pool)
+{
+	commit_tree_t *ct = spool->ct;
+	svn_delta_editor_t *editor;
+	const svn_ra_reporter3_t *reporter;
+	void *report_baton;
+	apr_hash_index_t *idx;
+	const char *url;
+	svn_error_t *err;
+
+	editor = svn_delta_default_editor(pool);
+	editor->open_root = commit_tree_spool_open_root;
+	editor->add_directory = commit_tree_spool_add_directory;
+	editor->open_directory = commit_tree_spool_open_directory;
+	editor->add_file = commit_tree_spool_add_file;
+	editor->apply_textdelta = commit_tree_spool_apply_textdelta;
+	editor->close_file = commit_tree_spool_close_file;
+
+	if (spool->fetch_texts) {
+		SVN_ERR(svn_ra_do_update2(ct->session, &reporter, &report_baton,
+								  ct->base_rev, "", svn_depth_infinity, FALSE,
+								  editor, spool, pool));
+	} else {
+		SVN_ERR(svn_ra_get_session_url(ct->session, &url, pool));
+		SVN_ERR(svn_ra_do_diff3(ct->session, &reporter, &report_baton,
+								ct->base_rev, "", svn_depth_infinity, TRUE,
+								FALSE, url, editor, spool, pool));
+	}
+
+	err = reporter->set_path(report_baton, "", ct->base_rev,
+							 svn_depth_infinity, !spool->fetch_texts, NULL,
+							 pool);
+	if (spool->fetch_texts) {
+		for (idx = apr_hash_first(pool, spool->files);
+			 idx != NULL && err == NULL; idx = apr_hash_next(idx)) {
+			const void *relpath;
+			apr_hash_this(idx, &relpath, NULL, NULL);
+			err = reporter->delete_path(report_baton, relpath, pool);
+		}
+	}
+	if (err == NULL)
+		return reporter->finish_report(report_baton, pool);
+	svn_error_clear(reporter->abort_report(report_baton, pool));
+	return err;
+}
+
+/**
+ * Find the modified files that are unchanged, and fetch the base texts
+ * of the others into temporary files.
+ *
+ * Files are compared by size first, and then by checksum; the checksums
+ * of the base tree come from a single drive without texts, and the base
+ * texts from another single drive, rather than from a request per file.
+ */
+static svn_error_t *commit_tree_spool_base(commit_tree_t *ct)
+{
+	commit_tree_spool_t spool;
+	apr_pool_t *pool, *iterpool;
+	svn_error_t *err;
+	int i;
+
+	spool.ct = ct;
+	spool.files = apr_hash_make(ct->pool);
+	for (i = 0; i < ct->files->nelts; i++) {
+		commit_tree_node_t *node = &APR_ARRAY_IDX(ct->nodes,
+			APR_ARRAY_IDX(ct->files, i, int), commit_tree_node_t);
+
+		if (node->action == COMMIT_TREE_MODIFY_FILE)
+			apr_hash_set(spool.files, node->relpath, APR_HASH_KEY_STRING,
+						 node);
+	}
+
+	if (apr_hash_count(spool.files) == 0)
+		return NULL;
+
+	pool = svn_pool_create(ct->pool);
+	spool.fetch_texts = false;
+	err = commit_tree_spool_drive(&spool, pool);
+
+	iterpool = svn_pool_create(pool);
+	for (i = 0; i < ct->files->nelts && err == NULL; i++) {
+		commit_tree_node_t *node = &APR_ARRAY_IDX(ct->nodes,
+			APR_ARRAY_IDX(ct->files, i, int), commit_tree_node_t);
+		svn_checksum_t *checksum;
+		apr_finfo_t finfo;
+
+		if (node->action != COMMIT_TREE_MODIFY_FILE ||
+			node->base_checksum == NULL)
+			continue;
+
+		svn_pool_clear(iterpool);
+		err = svn_io_stat(&finfo, node->local_path, APR_FINFO_SIZE,
+						  iterpool);
+		if (err != NULL || (node->base_size != SVN_INVALID_FILESIZE &&
+							finfo.size != node->base_size))
+			continue;
+		err = svn_io_file_checksum2(&checksum, node->local_path,
+									svn_checksum_md5, iterpool);
+		if (err == NULL &&
+			!strcmp(node->base_checksum,
+					svn_checksum_to_cstring(checksum, iterpool))) {
+			node->unchanged = true;
+			apr_hash_set(spool.files, node->relpath, APR_HASH_KEY_STRING,
+						 NULL);
+		}
+	}
+	svn_pool_destroy(iterpool);
+
+	if (err == NULL && apr_hash_count(spool.files) > 0) {
+		spool.fetch_texts = true;
+		err = commit_tree_spool_drive(&spool, pool);
+	}
+	svn_pool_destroy(pool);
+	return err;
+}
+
+/**
+ * Write the delta of a file against its base text to a temporary file,
+ * in svndiff format, unless the file is unchanged.
+ *
+ * Doesn't use any state shared with other threads, and allocates from
+ * a new top-level pool that is destroyed once the file has been sent.
+ */
+static svn_error_t *commit_tree_delta(commit_tree_node_t *node)
+{
+	svn_stream_t *source, *target, *output;
+	svn_txdelta_stream_t *delta;
+	svn_txdelta_window_handler_t handler;
+	void *handler_baton;
+	svn_checksum_t *checksum;
+	apr_pool_t *pool;
+
+	if (node->unchanged)
+		return NULL;
+
+	pool = node->pool = svn_pool_create(NULL);
+
+	SVN_ERR(svn_stream_open_readonly(&target, node->local_path, pool, pool));
+	if (node->base_path != NULL) {
+		SVN_ERR(svn_stream_open_readonly(&source, node->base_path, pool,
+										 pool));
+	} else {
+		source = svn_stream_empty(pool);
+	}
+	SVN_ERR(svn_stream_open_unique(&output, &node->delta_path, NULL,
+								   svn_io_file_del_none, pool, pool));
+
+	svn_txdelta(&delta, source, target, pool);
+	/* The svndiff writer closes output after the last window. */
+	svn_txdelta_to_svndiff2(&handler, &handler_baton, output, 0, pool);
+	SVN_ERR(svn_txdelta_send_txstream(delta, handler, handler_baton, pool));
+	SVN_ERR(svn_stream_close(target));
+	SVN_ERR(svn_stream_close(source));
+
+	checksum = svn_checksum_create(svn_checksum_md5, pool);
+	memcpy((unsigned char *)checksum->digest, svn_txdelta_md5_digest(delta),
+		   APR_MD5_DIGESTSIZE);
+	node->checksum = svn_checksum_to_cstring(checksum, pool);
+	return NULL;
+}
+
+static void * APR_THREAD_FUNC commit_tree_worker(apr_thread_t *thread,
+												 void *baton)
+{
+	commit_tree_t *ct = baton;
+
+	apr_thread_mutex_lock(ct->mutex);
+	while (!ct->cancelled && ct->next_file < ct->files->nelts) {
+		commit_tree_node_t *node;
+
+		if (ct->next_file >= ct->consumed + ct->window) {
+			apr_thread_cond_wait(ct->cond, ct->mutex);
+			continue;
+		}
+		node = &APR_ARRAY_IDX(ct->nodes,
+			APR_ARRAY_IDX(ct->files, ct->next_file, int), commit_tree_node_t);
+		ct->next_file++;
+		apr_thread_mutex_unlock(ct->mutex);
+
+		node->err = commit_tree_delta(node);
+
+		apr_thread_mutex_lock(ct->mutex);
+		node->ready = true;
+		apr_thread_cond_broadcast(ct->cond);
+	}
+	apr_thread_mutex_unlock(ct->mutex);
+	apr_thread_exit(thread, APR_SUCCESS);
+	return NULL;
+}
+
+static svn_error_t *commit_tree_start_workers(commit_tree_t *ct, int jobs)
+{
+	apr_status_t status;
+	int i;
+
+	ct->window = jobs * 4;
+	status = apr_thread_mutex_create(&ct->mutex, APR_THREAD_MUTEX_DEFAULT,
+									 ct->pool);
+	if (status == APR_SUCCESS)
+		status = apr_thread_cond_create(&ct->cond, ct->pool);
+	if (status != APR_SUCCESS)
+		return svn_error_wrap_apr(status, "Unable to create mutex");
+
+	ct->threads = apr_array_make(ct->pool, jobs, sizeof(apr_thread_t *));
+	for (i = 0; i < jobs; i++) {
+		apr_thread_t *thread;
+		status = apr_thread_create(&thread, NULL, commit_tree_worker, ct,
+								   ct->pool);
+		if (status != APR_SUCCESS)
+			return svn_error_wrap_apr(status, "Unable to start worker thread");
+		APR_ARRAY_PUSH(ct->threads, apr_thread_t *) = thread;
+	}
+	return NULL;
+}
+
+static void commit_tree_stop_workers(commit_tree_t *ct)
+{
+	apr_status_t retval;
+	int i;
+
+	if (ct->threads == NULL)
+		return;
+
+	apr_thread_mutex_lock(ct->mutex);
+	ct->cancelled = true;
+	apr_thread_cond_broadcast(ct->cond);
+	apr_thread_mutex_unlock(ct->mutex);
+
+	for (i = 0; i < ct->threads->nelts; i++)
+		apr_thread_join(&retval, APR_ARRAY_IDX(ct->threads, i, apr_thread_t *));
+	ct->threads = NULL;
+}
+
+/**
+ * Wait for the delta of a file to be computed, or compute it if there
+ * are no worker threads.
+ */
+static svn_error_t *commit_tree_wait(commit_tree_t *ct,
+									 commit_tree_node_t *node)
+{
+	if (ct->threads == NULL) {
+		node->err = commit_tree_delta(node);
+	} else {
+		apr_thread_mutex_lock(ct->mutex);
+		while (!node->ready)
+			apr_thread_cond_wait(ct->cond, ct->mutex);
+		apr_thread_mutex_unlock(ct->mutex);
+	}
+	if (node->err != NULL) {
+		svn_error_t *err = node->err;
+		node->err = NULL;
+		return err;
+	}
+	return NULL;
+}
+
+static void commit_tree_release(commit_tree_t *ct, commit_tree_node_t *node)
+{
+	if (node->delta_path != NULL) {
+		apr_file_remove(node->delta_path, ct->pool);
+		node->delta_path = NULL;
+	}
+	if (node->pool != NULL) {
+		svn_pool_destroy(node->pool);
+		node->pool = NULL;
+	}
+	if (node->base_path != NULL) {
+		apr_file_remove(node->base_path, ct->pool);
+		node->base_path = NULL;
+	}
+	if (ct->threads != NULL) {
+		apr_thread_mutex_lock(ct->mutex);
+		ct->consumed++;
+		apr_thread_cond_broadcast(ct->cond);
+		apr_thread_mutex_unlock(ct->mutex);
+	}
+}
+
+static svn_error_t *commit_tree_send_file(commit_tree_t *ct,
+										  const svn_delta_editor_t *editor,
+										  void *parent,
+										  commit_tree_node_t *node,
+										  apr_pool_t *pool)
+{
+	svn_txdelta_window_handler_t handler;
+	void *file_baton, *handler_baton;
+	svn_stream_t *delta, *parser;
+
+	SVN_ERR(commit_tree_wait(ct, node));
+
+	if (!node->unchanged) {
+		if (node->action == COMMIT_TREE_ADD_FILE) {
+			SVN_ERR(editor->add_file(node->relpath, parent, NULL,
+									 SVN_INVALID_REVNUM, pool, &file_baton));
+		} else {
+			SVN_ERR(editor->open_file(node->relpath, parent, ct->base_rev,
+									  pool, &file_baton));
+		}
+		SVN_ERR(editor->apply_textdelta(file_baton, node->base_checksum, pool,
+										&handler, &handler_baton));
+		/* Windows are parsed and sent one at a time; closing the parser
+		 * sends the final NULL window. */
+		SVN_ERR(svn_stream_open_readonly(&delta, node->delta_path, pool,
+										 pool));
+		parser = svn_txdelta_parse_svndiff(handler, handler_baton, TRUE,
+										   pool);
+		SVN_ERR(svn_stream_copy3(delta, parser, NULL, NULL, pool));
+		SVN_ERR(editor->close_file(file_baton, node->checksum, pool));
+	}
+
+	commit_tree_release(ct, node);
+	return NULL;
+}
+
+static svn_error_t *commit_tree_drive(commit_tree_t *ct,
+									  const svn_delta_editor_t *editor,
+									  void *edit_baton)
+{
+	apr_array_header_t *stack;
+	apr_pool_t *iterpool;
+	void *root, *baton;
+	int i;
+
+	stack = apr_array_make(ct->pool, 16, sizeof(void *));
+	iterpool = svn_pool_create(ct->pool);
+
+	SVN_ERR(editor->open_root(edit_baton, ct->base_rev, ct->pool, &root));
+	APR_ARRAY_PUSH(stack, void *) = root;
+
+	for (i = 0; i < ct->nodes->nelts; i++) {
+		commit_tree_node_t *node = &APR_ARRAY_IDX(ct->nodes, i,
+												  commit_tree_node_t);
+		void *parent = APR_ARRAY_IDX(stack, stack->nelts - 1, void *);
+
+		svn_pool_clear(iterpool);
+		switch (node->action) {
+			case COMMIT_TREE_DELETE:
+				SVN_ERR(editor->delete_entry(node->relpath, ct->base_rev,
+											 parent, iterpool));
+				break;
+			case COMMIT_TREE_ADD_DIR:
+				SVN_ERR(editor->add_directory(node->relpath, parent, NULL,
+											  SVN_INVALID_REVNUM, ct->pool,
+											  &baton));
+				APR_ARRAY_PUSH(stack, void *) = baton;
+				break;
+			case COMMIT_TREE_OPEN_DIR:
+				SVN_ERR(editor->open_directory(node->relpath, parent,
+											   ct->base_rev, ct->pool,
+											   &baton));
+				APR_ARRAY_PUSH(stack, void *) = baton;
+				break;
+			case COMMIT_TREE_CLOSE_DIR:
+				SVN_ERR(editor->close_directory(parent, iterpool));
+				apr_array_pop(stack);
+				break;
+			case COMMIT_TREE_ADD_FILE:
+			case COMMIT_TREE_MODIFY_FILE:
+				SVN_ERR(commit_tree_send_file(ct, editor, parent, node,
+											  iterpool));
+				break;
+		}
+	}
+	svn_pool_destroy(iterpool);
+
+	SVN_ERR(editor->close_directory(root, ct->pool));
+	return editor->close_edit(edit_baton, ct->pool);
+}
+
+static svn_error_t *commit_tree_commit_callback(
+	const svn_commit_info_t *commit_info, void *baton, apr_pool_t *pool)
+{
+	commit_tree_t *ct = baton;
+
+	ct->commit_info = svn_commit_info_dup(commit_info, ct->pool);
+	return NULL;
+}
+
+static svn_error_t *commit_tree_run(commit_tree_t *ct, const char *local_root,
+									apr_hash_t *revprops, int jobs)
+{
+	const svn_delta_editor_t *editor;
+	void *edit_baton;
+	svn_node_kind_t kind;
+	svn_error_t *err;
+	int i;
+
+	SVN_ERR(svn_io_check_path(local_root, &kind, ct->pool));
+	if (kind != svn_node_dir)
+		return svn_error_createf(SVN_ERR_NODE_UNEXPECTED_KIND, NULL,
+								 "'%s' is not a directory", local_root);
+
+	SVN_ERR(svn_ra_check_path(ct->session, "", ct->base_rev, &kind,
+							  ct->pool));
+	if (kind == svn_node_file)
+		return svn_error_create(SVN_ERR_NODE_UNEXPECTED_KIND, NULL,
+								"Session URL is a file");
+
+	SVN_ERR(commit_tree_build(ct, "", local_root, kind == svn_node_dir,
+							  ct->pool));
+
+	err = commit_tree_spool_base(ct);
+
+	if (err == NULL && jobs > 0 && ct->files->nelts > 0)
+		err = commit_tree_start_workers(ct, jobs);
+
+	if (err == NULL)
+		err = svn_ra_get_commit_editor3(ct->session, &editor, &edit_baton,
+										revprops, commit_tree_commit_callback,
+										ct, NULL, FALSE, ct->pool);
+
+	if (err == NULL) {
+		err = commit_tree_drive(ct, editor, edit_baton);
+		if (err != NULL)
+			svn_error_clear(editor->abort_edit(edit_baton, ct->pool));
+	}
+
+	commit_tree_stop_workers(ct);
+
+	for (i = 0; i < ct->files->nelts; i++) {
+		commit_tree_node_t *node = &APR_ARRAY_IDX(ct->nodes,
+			APR_ARRAY_IDX(ct->files, i, int), commit_tree_node_t);
+		svn_error_clear(node->err);
+		commit_tree_release(ct, node);
+	}
+
+	return err;
+}
+
+#endif
+
+PyObject *ra_commit_tree(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if ONLY_SINCE_SVN(1, 6)
+	char *kwnames[] = { "local_root", "base_rev", "revprops", "jobs", NULL };
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	PyObject *py_local_root, *revprops;
+	svn_revnum_t base_rev;
+	int jobs = 4;
+	const char *local_root;
+	apr_hash_t *hash_revprops;
+	apr_pool_t *temp_pool;
+	commit_tree_t ct;
+	PyObject *ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OlO|i:commit_tree",
+									 kwnames, &py_local_root, &base_rev,
+									 &revprops, &jobs))
+		return NULL;
+
+	if (jobs < 0) {
+		PyErr_SetString(PyExc_ValueError, "jobs should not be negative");
+		return NULL;
+	}
+
+#if !APR_HAS_THREADS
+	jobs = 0;
+#endif
+
+	if (ra_check_busy(ra))
+		return NULL;
+
+	temp_pool = Pool(NULL);
+	if (temp_pool == NULL) {
+		subvertpy_flag_clear(&ra->busy);
+		return NULL;
+	}
+
+	local_root = py_object_to_svn_dirent(py_local_root, temp_pool);
+	hash_revprops = NULL;
+	if (local_root != NULL)
+		hash_revprops = prop_dict_to_hash(temp_pool, revprops);
+	if (hash_revprops == NULL) {
+		apr_pool_destroy(temp_pool);
+		subvertpy_flag_clear(&ra->busy);
+		return NULL;
+	}
+
+	memset(&ct, 0, sizeof(ct));
+	ct.session = ra->ra;
+	ct.base_rev = base_rev;
+	ct.pool = temp_pool;
+	ct.nodes = apr_array_make(temp_pool, 64, sizeof(commit_tree_node_t));
+	ct.files = apr_array_make(temp_pool, 64, sizeof(int));
+
+	RUN_RA_WITH_POOL(temp_pool, ra, commit_tree_run(&ct, local_root,
+													hash_revprops, jobs));
+
+	if (ct.commit_info == NULL) {
+		ret = Py_None;
+		Py_INCREF(ret);
+	} else {
+		ret = Py_BuildValue("(lzz)", ct.commit_info->revision,
+							ct.commit_info->date, ct.commit_info->author);
+	}
+	apr_pool_destroy(temp_pool);
+	return ret;
+#else
+	PyErr_SetString(PyExc_NotImplementedError,
+					"commit_tree is only supported in Subversion >= 1.6");
+	return NULL;
+#endif
+}
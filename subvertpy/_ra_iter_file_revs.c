@@ -0,0 +1,309 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+/*
+ * Iterator over the revisions of a file.
+ *
+ * svn_ra_get_file_revs2() runs on a worker thread feeding a queue (see
+ * _ra_iter_queue.c). Text deltas are applied (or encoded as svndiff)
+ * natively, so Python is only involved once per revision rather than
+ * once per delta window. The worker blocks once max_queue revisions are
+ * waiting to be consumed, which bounds the memory used to two full texts
+ * plus the queued revisions.
+ */
+
+struct file_revs_queue {
+	ra_iter_queue_t queue;
+	const char *path;
+	svn_revnum_t start, end;
+	svn_boolean_t include_merged_revisions;
+	svn_boolean_t fulltext;
+
+	/* Only used by the worker thread */
+	apr_pool_t *text_pool[2];
+	int cur;
+	svn_stringbuf_t *text;
+	svn_stringbuf_t *next_text;
+	svn_txdelta_window_handler_t delta_handler;
+	void *delta_baton;
+	svn_revnum_t pending_rev;
+	PyObject *pending_path;
+	PyObject *pending_props;
+	PyObject *pending_prop_diffs;
+	PyObject *py_text;
+};
+
+PyTypeObject FileRevsIterator_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "_ra.FileRevsIterator",
+	.tp_basicsize = sizeof(RaIterObject),
+	.tp_dealloc = (destructor)ra_iter_dealloc,
+#if PY_MAJOR_VERSION < 3
+	.tp_flags = Py_TPFLAGS_HAVE_ITER,
+#endif
+	.tp_iter = PyObject_SelfIter,
+	.tp_iternext = (iternextfunc)ra_iter_next,
+	.tp_methods = ra_iter_methods,
+};
+
+/**
+ * Queue the revision whose delta has just been received.
+ *
+ * text is the svndiff or full text for the revision, or NULL if the
+ * contents did not change.
+ */
+static svn_error_t *file_revs_finish_rev(struct file_revs_queue *fr,
+										 svn_stringbuf_t *text)
+{
+	PyGILState_STATE state;
+	PyObject *py_text, *tuple;
+	svn_error_t *err;
+
+	state = PyGILState_Ensure();
+
+	if (text != NULL) {
+		py_text = PyBytes_FromStringAndSize(text->data, text->len);
+		if (py_text == NULL) {
+			PyGILState_Release(state);
+			return py_svn_error();
+		}
+	} else if (fr->fulltext) {
+		/* Unchanged, share the previous text. */
+		py_text = fr->py_text;
+		Py_INCREF(py_text);
+	} else {
+		py_text = Py_None;
+		Py_INCREF(py_text);
+	}
+
+	if (fr->fulltext) {
+		Py_INCREF(py_text);
+		Py_XDECREF(fr->py_text);
+		fr->py_text = py_text;
+	}
+
+	tuple = Py_BuildValue("(lNNNN)", fr->pending_rev, fr->pending_path,
+						  fr->pending_props, py_text, fr->pending_prop_diffs);
+	fr->pending_path = NULL;
+	fr->pending_props = NULL;
+	fr->pending_prop_diffs = NULL;
+	err = ra_iter_queue_push(&fr->queue, tuple);
+
+	PyGILState_Release(state);
+	return err;
+}
+
+static svn_error_t *file_revs_window_handler(svn_txdelta_window_t *window,
+											 void *baton)
+{
+	struct file_revs_queue *fr = (struct file_revs_queue *)baton;
+
+	SVN_ERR(fr->delta_handler(window, fr->delta_baton));
+	if (window != NULL)
+		return NULL;
+
+	/* All windows have been received */
+	if (fr->fulltext) {
+		fr->cur = !fr->cur;
+		fr->text = fr->next_text;
+	}
+	return file_revs_finish_rev(fr, fr->next_text);
+}
+
+static svn_error_t *py_iter_file_rev_handler(void *baton, const char *path,
+	svn_revnum_t rev, apr_hash_t *rev_props, svn_boolean_t result_of_merge,
+	svn_txdelta_window_handler_t *delta_handler, void **delta_baton,
+	apr_array_header_t *prop_diffs, apr_pool_t *pool)
+{
+	struct file_revs_queue *fr = (struct file_revs_queue *)baton;
+	PyGILState_STATE state;
+	apr_pool_t *next_pool;
+	svn_stream_t *target;
+
+	if (ra_iter_queue_cancelled(&fr->queue))
+		return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+
+	state = PyGILState_Ensure();
+	fr->pending_rev = rev;
+	fr->pending_path = py_path_string(path, strlen(path));
+	if (fr->pending_path == NULL) {
+		PyGILState_Release(state);
+		return py_svn_error();
+	}
+	fr->pending_props = prop_hash_to_dict(rev_props);
+	if (fr->pending_props == NULL) {
+		Py_CLEAR(fr->pending_path);
+		PyGILState_Release(state);
+		return py_svn_error();
+	}
+	if (prop_diffs != NULL)
+		fr->pending_prop_diffs = propchanges_to_list(prop_diffs);
+	else
+		fr->pending_prop_diffs = PyList_New(0);
+	if (fr->pending_prop_diffs == NULL) {
+		Py_CLEAR(fr->pending_path);
+		Py_CLEAR(fr->pending_props);
+		PyGILState_Release(state);
+		return py_svn_error();
+	}
+	PyGILState_Release(state);
+
+	if (delta_handler == NULL || delta_baton == NULL) {
+		return file_revs_finish_rev(fr, NULL);
+	}
+
+	next_pool = fr->text_pool[!fr->cur];
+	apr_pool_clear(next_pool);
+	fr->next_text = svn_stringbuf_create("", next_pool);
+	target = svn_stream_from_stringbuf(fr->next_text, next_pool);
+
+	if (fr->fulltext) {
+		svn_txdelta_apply(svn_stream_from_stringbuf(fr->text, next_pool),
+						  target, NULL, NULL, next_pool,
+						  &fr->delta_handler, &fr->delta_baton);
+	} else {
+#if ONLY_SINCE_SVN(1, 7)
+		svn_txdelta_to_svndiff3(&fr->delta_handler, &fr->delta_baton,
+								target, 0, 0, next_pool);
+#else
+		svn_txdelta_to_svndiff2(&fr->delta_handler, &fr->delta_baton,
+								target, 0, next_pool);
+#endif
+	}
+
+	*delta_handler = file_revs_window_handler;
+	*delta_baton = fr;
+	return NULL;
+}
+
+#if ONLY_BEFORE_SVN(1, 5)
+static svn_error_t *py_iter_ra_file_rev_handler(void *baton, const char *path,
+	svn_revnum_t rev, apr_hash_t *rev_props,
+	svn_txdelta_window_handler_t *delta_handler, void **delta_baton,
+	apr_array_header_t *prop_diffs, apr_pool_t *pool)
+{
+	return py_iter_file_rev_handler(baton, path, rev, rev_props, FALSE,
+									delta_handler, delta_baton, prop_diffs,
+									pool);
+}
+#endif
+
+static svn_error_t *file_revs_run(ra_iter_queue_t *queue)
+{
+	struct file_revs_queue *fr = (struct file_revs_queue *)queue;
+
+#if ONLY_SINCE_SVN(1, 5)
+	return svn_ra_get_file_revs2(queue->ra->ra, fr->path, fr->start,
+			fr->end, fr->include_merged_revisions,
+			py_iter_file_rev_handler, fr, queue->pool);
+#else
+	return svn_ra_get_file_revs(queue->ra->ra, fr->path, fr->start,
+			fr->end, py_iter_ra_file_rev_handler, fr, queue->pool);
+#endif
+}
+
+static void file_revs_finish(ra_iter_queue_t *queue)
+{
+	struct file_revs_queue *fr = (struct file_revs_queue *)queue;
+
+	Py_CLEAR(fr->pending_path);
+	Py_CLEAR(fr->pending_props);
+	Py_CLEAR(fr->pending_prop_diffs);
+	Py_CLEAR(fr->py_text);
+	apr_pool_destroy(fr->text_pool[0]);
+	apr_pool_destroy(fr->text_pool[1]);
+}
+
+PyObject *ra_iter_file_revs(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+	char *kwnames[] = { "path", "start", "end", "include_merged_revisions",
+		"fulltext", "max_queue", NULL };
+	char *path;
+	svn_revnum_t start, end;
+	bool include_merged_revisions = false, fulltext = true;
+	int max_queue = 16;
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	RaIterObject *ret;
+	struct file_revs_queue *fr;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sll|bbi:iter_file_revs",
+									 kwnames, &path, &start, &end,
+									 &include_merged_revisions, &fulltext,
+									 &max_queue))
+		return NULL;
+
+	if (max_queue < 1) {
+		PyErr_SetString(PyExc_ValueError, "max_queue should be at least 1");
+		return NULL;
+	}
+
+#if ONLY_BEFORE_SVN(1, 5)
+	if (include_merged_revisions) {
+		PyErr_SetString(PyExc_NotImplementedError,
+						"include_merged_revisions only supported with svn >= 1.5");
+		return NULL;
+	}
+#endif
+
+	if (ra_check_svn_path(path))
+		return NULL;
+
+	if (ra_check_busy(ra))
+		return NULL;
+
+	ret = PyObject_New(RaIterObject, SUBVERTPY_TYPE(FileRevsIterator_Type));
+	if (ret == NULL) {
+		subvertpy_flag_clear(&ra->busy);
+		return NULL;
+	}
+	ret->queue = NULL;
+
+	fr = (struct file_revs_queue *)ra_iter_queue_new(
+		sizeof(struct file_revs_queue), ra, max_queue);
+	if (fr == NULL) {
+		Py_DECREF(ret);
+		return NULL;
+	}
+	ret->queue = &fr->queue;
+	fr->queue.run = file_revs_run;
+	fr->queue.finish = file_revs_finish;
+	fr->path = apr_pstrdup(fr->queue.pool, path);
+	fr->start = start;
+	fr->end = end;
+	fr->include_merged_revisions = include_merged_revisions;
+	fr->fulltext = fulltext;
+	/* Cleared by the worker without holding the GIL, so not created with
+	 * Pool(). */
+	fr->text_pool[0] = svn_pool_create(fr->queue.pool);
+	fr->text_pool[1] = svn_pool_create(fr->queue.pool);
+	fr->cur = 0;
+	fr->text = svn_stringbuf_create("", fr->text_pool[0]);
+	fr->py_text = PyBytes_FromStringAndSize(NULL, 0);
+	if (fr->py_text == NULL) {
+		ra_iter_queue_abandon(ret->queue);
+		Py_DECREF(ret);
+		return NULL;
+	}
+
+	if (!ra_iter_queue_start(ret->queue)) {
+		Py_DECREF(ret);
+		return NULL;
+	}
+
+	return (PyObject *)ret;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+/*
+ * Iterator over the location segments of a node.
+ *
+ * svn_ra_get_location_segments() runs on a worker thread feeding a queue
+ * (see _ra_iter_queue.c), which blocks once max_queue segments are
+ * waiting to be consumed.
+ */
+
+struct segments_queue {
+	ra_iter_queue_t queue;
+	const char *path;
+	svn_revnum_t peg_revision, start, end;
+};
+
+PyTypeObject SegmentsIterator_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "_ra.SegmentsIterator",
+	.tp_basicsize = sizeof(RaIterObject),
+	.tp_dealloc = (destructor)ra_iter_dealloc,
+#if PY_MAJOR_VERSION < 3
+	.tp_flags = Py_TPFLAGS_HAVE_ITER,
+#endif
+	.tp_iter = PyObject_SelfIter,
+	.tp_iternext = (iternextfunc)ra_iter_next,
+	.tp_methods = ra_iter_methods,
+};
+
+#if ONLY_SINCE_SVN(1, 5)
+static svn_error_t *py_iter_location_segment_receiver(
+	svn_location_segment_t *segment, void *baton, apr_pool_t *pool)
+{
+	struct segments_queue *sq = (struct segments_queue *)baton;
+	PyGILState_STATE state;
+	svn_error_t *err;
+
+	state = PyGILState_Ensure();
+	err = ra_iter_queue_push(&sq->queue,
+							 Py_BuildValue("(llz)", segment->range_start,
+										   segment->range_end, segment->path));
+	PyGILState_Release(state);
+	return err;
+}
+
+static svn_error_t *segments_run(ra_iter_queue_t *queue)
+{
+	struct segments_queue *sq = (struct segments_queue *)queue;
+
+	return svn_ra_get_location_segments(queue->ra->ra, sq->path,
+			sq->peg_revision, sq->start, sq->end,
+			py_iter_location_segment_receiver, sq, queue->pool);
+}
+#endif
+
+PyObject *ra_iter_location_segments(PyObject *self, PyObject *args,
+									PyObject *kwargs)
+{
+#if ONLY_SINCE_SVN(1, 5)
+	char *kwnames[] = { "path", "peg_revision", "start_revision",
+		"end_revision", "max_queue", NULL };
+	char *path;
+	svn_revnum_t peg_revision, start, end;
+	int max_queue = 16;
+	RemoteAccessObject *ra = (RemoteAccessObject *)self;
+	RaIterObject *ret;
+	struct segments_queue *sq;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+									 "slll|i:iter_location_segments",
+									 kwnames, &path, &peg_revision, &start,
+									 &end, &max_queue))
+		return NULL;
+
+	if (max_queue < 1) {
+		PyErr_SetString(PyExc_ValueError, "max_queue should be at least 1");
+		return NULL;
+	}
+
+	if (ra_check_svn_path(path))
+		return NULL;
+
+	if (ra_check_busy(ra))
+		return NULL;
+
+	ret = PyObject_New(RaIterObject, SUBVERTPY_TYPE(SegmentsIterator_Type));
+	if (ret == NULL) {
+		subvertpy_flag_clear(&ra->busy);
+		return NULL;
+	}
+	ret->queue = NULL;
+
+	sq = (struct segments_queue *)ra_iter_queue_new(
+		sizeof(struct segments_queue), ra, max_queue);
+	if (sq == NULL) {
+		Py_DECREF(ret);
+		return NULL;
+	}
+	ret->queue = &sq->queue;
+	sq->queue.run = segments_run;
+	while (*path == '/') path++;
+	sq->path = apr_pstrdup(sq->queue.pool, path);
+	sq->peg_revision = peg_revision;
+	sq->start = start;
+	sq->end = end;
+
+	if (!ra_iter_queue_start(ret->queue)) {
+		Py_DECREF(ret);
+		return NULL;
+	}
+
+	return (PyObject *)ret;
+#else
+	PyErr_SetString(PyExc_NotImplementedError,
+					"location segments are only supported in Subversion >= 1.5");
+	return NULL;
+#endif
+}
@@ -29,6 +29,7 @@ typedef struct {
 	svn_boolean_t discover_changed_paths;
 	svn_boolean_t strict_node_history;
 	svn_boolean_t include_merged_revisions;
+	svn_boolean_t lazy_revprops;
 	int limit;
 	apr_pool_t *pool;
 	apr_array_header_t *apr_paths;
@@ -40,6 +41,9 @@ typedef struct {
 	int queue_size;
 	struct log_entry *head;
 	struct log_entry *tail;
+	/* Event loop and pending __anext__ future, for aiter_log */
+	PyObject *loop;
+	PyObject *waiter;
 } LogIteratorObject;
 
 static void log_iter_dealloc(PyObject *self)
@@ -54,40 +58,130 @@ static void log_iter_dealloc(PyObject *self)
 	}
 	Py_XDECREF(iter->exc_type);
 	Py_XDECREF(iter->exc_val);
+	Py_XDECREF(iter->loop);
+	Py_XDECREF(iter->waiter);
 	apr_pool_destroy(iter->pool);
 	Py_DECREF(iter->ra);
-	PyObject_Del(iter);
+	py_object_del(iter);
 }
 
 static PyObject *log_iter_next(LogIteratorObject *iter)
 {
 	struct log_entry *first;
-	PyObject *ret;
+	PyObject *ret = NULL;
+	bool finished = false;
 	Py_INCREF(iter);
 
-	while (iter->head == NULL) {
-		/* Done, raise exception */
-		if (iter->exc_type != NULL) {
+	while (ret == NULL && !finished) {
+		/* The queue is filled by the worker thread; on free-threaded
+		 * builds it is only touched in a critical section on iter. */
+		Py_BEGIN_CRITICAL_SECTION(iter);
+		first = iter->head;
+		if (first != NULL) {
+			ret = first->tuple;
+			iter->head = first->next;
+			if (first == iter->tail)
+				iter->tail = NULL;
+			free(first);
+			iter->queue_size--;
+		} else if (iter->exc_type != NULL) {
+			/* Done, raise exception */
 			PyErr_SetObject(iter->exc_type, iter->exc_val);
-			Py_DECREF(iter);
-			return NULL;
-		} else {
+			finished = true;
+		}
+		Py_END_CRITICAL_SECTION();
+
+		if (ret == NULL && !finished) {
 			Py_BEGIN_ALLOW_THREADS
 			/* FIXME: Don't waste cycles */
 			Py_END_ALLOW_THREADS
 		}
 	}
-	first = iter->head;
-	ret = iter->head->tuple;
-	iter->head = first->next;
-	if (first == iter->tail)
-		iter->tail = NULL;
-	free(first);
-	iter->queue_size--;
 	Py_DECREF(iter);
 	return ret;
 }
 
+#if PY_VERSION_HEX >= 0x03050000
+/**
+ * Resolve the future returned by __anext__, if there is one and an entry
+ * (or the end of the log) is available.
+ *
+ * Must be called in a critical section on iter.
+ */
+static void log_iter_wake(LogIteratorObject *iter)
+{
+	struct log_entry *first;
+	PyObject *waiter = iter->waiter;
+
+	if (waiter == NULL)
+		return;
+
+	if (iter->head != NULL) {
+		iter->waiter = NULL;
+		first = iter->head;
+		iter->head = first->next;
+		if (first == iter->tail)
+			iter->tail = NULL;
+		iter->queue_size--;
+		async_schedule(iter->loop, waiter, NULL, first->tuple);
+		Py_DECREF(first->tuple);
+		free(first);
+	} else if (iter->exc_type != NULL) {
+		PyObject *exc;
+		iter->waiter = NULL;
+		if (iter->exc_type == PyExc_StopIteration) {
+			exc = PyObject_CallObject(PyExc_StopAsyncIteration, NULL);
+		} else if (PyTuple_Check(iter->exc_val)) {
+			exc = PyObject_CallObject(iter->exc_type, iter->exc_val);
+		} else {
+			exc = PyObject_CallFunctionObjArgs(iter->exc_type,
+											   iter->exc_val, NULL);
+		}
+		if (exc == NULL)
+			exc = async_fetch_exception();
+		async_schedule(iter->loop, waiter, exc, NULL);
+		Py_DECREF(exc);
+	} else {
+		return;
+	}
+
+	Py_DECREF(waiter);
+}
+
+static PyObject *log_iter_anext(LogIteratorObject *iter)
+{
+	PyObject *future;
+
+	if (iter->loop == NULL) {
+		PyErr_SetString(PyExc_TypeError,
+						"use aiter_log() for asynchronous iteration");
+		return NULL;
+	}
+
+	if (iter->waiter != NULL) {
+		PyErr_SetString(PyExc_RuntimeError,
+						"previous __anext__() has not completed yet");
+		return NULL;
+	}
+
+	future = PyObject_CallMethod(iter->loop, "create_future", NULL);
+	if (future == NULL)
+		return NULL;
+
+	Py_INCREF(future);
+	Py_BEGIN_CRITICAL_SECTION(iter);
+	iter->waiter = future;
+	log_iter_wake(iter);
+	Py_END_CRITICAL_SECTION();
+	return future;
+}
+
+static PyAsyncMethods log_iter_as_async = {
+	.am_aiter = PyObject_SelfIter,
+	.am_anext = (unaryfunc)log_iter_anext,
+};
+#endif
+
 static PyObject *py_iter_append(LogIteratorObject *iter, PyObject *tuple)
 {
 	struct log_entry *entry;
@@ -99,6 +193,7 @@ static PyObject *py_iter_append(LogIteratorObject *iter, PyObject *tuple)
 	}
 
 	entry->tuple = tuple;
+	Py_BEGIN_CRITICAL_SECTION(iter);
 	if (iter->tail == NULL) {
 		iter->tail = entry;
 	} else {
@@ -110,6 +205,11 @@ static PyObject *py_iter_append(LogIteratorObject *iter, PyObject *tuple)
 
 	iter->queue_size++;
 
+#if PY_VERSION_HEX >= 0x03050000
+	log_iter_wake(iter);
+#endif
+	Py_END_CRITICAL_SECTION();
+
 	Py_RETURN_NONE;
 }
 
@@ -128,6 +228,10 @@ PyTypeObject LogIterator_Type = {
 	.tp_flags = Py_TPFLAGS_HAVE_ITER, /*	long tp_flags;	*/
 #endif
 
+#if PY_VERSION_HEX >= 0x03050000
+	.tp_as_async = &log_iter_as_async,
+#endif
+
 	/* Iterators */
 	.tp_iter = PyObject_SelfIter,
 	.tp_iternext = (iternextfunc)log_iter_next,
@@ -153,7 +257,10 @@ static svn_error_t *py_iter_log_entry_cb(void *baton, svn_log_entry_t *log_entry
 		return py_svn_error();
 	}
 
-	revprops = prop_hash_to_dict(log_entry->revprops);
+	if (iter->lazy_revprops)
+		revprops = prop_hash_to_propdict(log_entry->revprops);
+	else
+		revprops = prop_hash_to_dict(log_entry->revprops);
 	if (revprops == NULL) {
 		Py_DECREF(py_changed_paths);
 		PyGILState_Release(state);
@@ -228,8 +335,11 @@ static void py_iter_log(void *baton)
 {
 	LogIteratorObject *iter = (LogIteratorObject *)baton;
 	svn_error_t *error;
-	PyGILState_STATE state;
+	PyThreadState *tstate;
+	PyObject *exc_type, *exc_val;
 
+	tstate = subvertpy_thread_attach(iter->ra->interp);
+	Py_BEGIN_ALLOW_THREADS
 #if ONLY_SINCE_SVN(1, 5)
 	error = svn_ra_get_log2(iter->ra->ra, 
 			iter->apr_paths, iter->start, iter->end, iter->limit,
@@ -242,32 +352,41 @@ static void py_iter_log(void *baton)
 			iter->discover_changed_paths, iter->strict_node_history, py_iter_log_cb, 
 			iter, iter->pool);
 #endif
-	state = PyGILState_Ensure();
+	Py_END_ALLOW_THREADS
 	if (error != NULL) {
-		iter->exc_type = (PyObject *)PyErr_GetSubversionExceptionTypeObject();
-		iter->exc_val  = PyErr_NewSubversionException(error);
+		exc_type = (PyObject *)PyErr_GetSubversionExceptionTypeObject();
+		exc_val = PyErr_NewSubversionException(error);
 		svn_error_clear(error);
 	} else {
-		iter->exc_type = PyExc_StopIteration;
-		Py_INCREF(iter->exc_type);
-		iter->exc_val = Py_None;
-		Py_INCREF(iter->exc_val);
+		exc_type = PyExc_StopIteration;
+		Py_INCREF(exc_type);
+		exc_val = Py_None;
+		Py_INCREF(exc_val);
 	}
+	subvertpy_flag_clear(&iter->ra->busy);
+	Py_BEGIN_CRITICAL_SECTION(iter);
+	iter->exc_type = exc_type;
+	iter->exc_val = exc_val;
 	iter->done = TRUE;
-	iter->ra->busy = false;
+#if PY_VERSION_HEX >= 0x03050000
+	log_iter_wake(iter);
+#endif
+	Py_END_CRITICAL_SECTION();
 
 	Py_DECREF(iter);
-	PyGILState_Release(state);
+	subvertpy_thread_detach(tstate);
 }
 
 PyObject *ra_iter_log(PyObject *self, PyObject *args, PyObject *kwargs)
 {
 	char *kwnames[] = { "paths", "start", "end", "limit",
-		"discover_changed_paths", "strict_node_history", "include_merged_revisions", "revprops", NULL };
+		"discover_changed_paths", "strict_node_history", "include_merged_revisions", "revprops",
+		"lazy_revprops", NULL };
 	PyObject *paths;
 	svn_revnum_t start = 0, end = 0;
 	int limit=0; 
 	bool discover_changed_paths=false, strict_node_history=true, include_merged_revisions=false;
+	bool lazy_revprops = false;
 	RemoteAccessObject *ra = (RemoteAccessObject *)self;
 	PyObject *revprops = Py_None;
 	LogIteratorObject *ret;
@@ -275,10 +394,11 @@ PyObject *ra_iter_log(PyObject *self, PyObject *args, PyObject *kwargs)
 	apr_array_header_t *apr_paths;
 	apr_array_header_t *apr_revprops;
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Oll|ibbbO:iter_log", kwnames, 
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Oll|ibbbOb:iter_log", kwnames, 
 						 &paths, &start, &end, &limit,
 						 &discover_changed_paths, &strict_node_history,
-						 &include_merged_revisions, &revprops))
+						 &include_merged_revisions, &revprops,
+						 &lazy_revprops))
 		return NULL;
 
 	if (!ra_get_log_prepare(ra, paths, include_merged_revisions,
@@ -286,7 +406,7 @@ PyObject *ra_iter_log(PyObject *self, PyObject *args, PyObject *kwargs)
 		return NULL;
 	}
 
-	ret = PyObject_New(LogIteratorObject, &LogIterator_Type);
+	ret = PyObject_New(LogIteratorObject, SUBVERTPY_TYPE(LogIterator_Type));
 	ret->ra = ra;
 	Py_INCREF(ret->ra);
 	ret->start = start;
@@ -299,11 +419,14 @@ PyObject *ra_iter_log(PyObject *self, PyObject *args, PyObject *kwargs)
 	ret->pool = pool;
 	ret->include_merged_revisions = include_merged_revisions;
 	ret->strict_node_history = strict_node_history;
+	ret->lazy_revprops = lazy_revprops;
 	ret->apr_revprops = apr_revprops;
 	ret->done = FALSE;
 	ret->queue_size = 0;
 	ret->head = NULL;
 	ret->tail = NULL;
+	ret->loop = NULL;
+	ret->waiter = NULL;
 
 	Py_INCREF(ret);
 	PyThread_start_new_thread(py_iter_log, ret);
@@ -311,4 +434,23 @@ PyObject *ra_iter_log(PyObject *self, PyObject *args, PyObject *kwargs)
 	return (PyObject *)ret;
 }
 
+#if PY_VERSION_HEX >= 0x03050000
+PyObject *ra_aiter_log(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+	PyObject *loop;
+	LogIteratorObject *ret;
+
+	loop = async_get_loop();
+	if (loop == NULL)
+		return NULL;
+
+	ret = (LogIteratorObject *)ra_iter_log(self, args, kwargs);
+	if (ret == NULL) {
+		Py_DECREF(loop);
+		return NULL;
+	}
+	ret->loop = loop;
 
+	return (PyObject *)ret;
+}
+#endif
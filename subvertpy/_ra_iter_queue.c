@@ -0,0 +1,461 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#include <pythread.h>
+
+/*
+ * Bounded queue between an iterator and a worker thread that runs a
+ * Subversion call on its behalf.
+ *
+ * The worker blocks once max_queue items are waiting to be consumed. The
+ * queue is shared by the iterator and the worker and freed by whichever
+ * lets go of it last, so the worker never keeps the iterator alive. When
+ * the iterator is closed or released before it is exhausted, the queue is
+ * cancelled: the worker is woken up, the next item it queues fails with
+ * SVN_ERR_CANCELLED, and the iterator waits for the call to return so
+ * that the session can be used again.
+ */
+
+struct ra_iter_item {
+	PyObject *obj;
+	struct ra_iter_item *next;
+};
+
+typedef struct ra_iter_queue ra_iter_queue_t;
+
+struct ra_iter_queue {
+	RemoteAccessObject *ra;
+	apr_pool_t *pool;
+	int max_queue;
+	/* Runs the call on the worker thread, without the GIL. */
+	svn_error_t *(*run)(ra_iter_queue_t *queue);
+	/* Releases what run used, with the GIL held; may be NULL. Called by
+	 * the worker, or when the queue is freed if it never started. */
+	void (*finish)(ra_iter_queue_t *queue);
+	bool started;
+
+	/* Everything below is protected by lock. */
+	PyThread_type_lock lock;
+	int refs;
+	bool done;
+	bool cancelled;
+	PyObject *exc_type;
+	PyObject *exc_val;
+	int size;
+	struct ra_iter_item *head;
+	struct ra_iter_item *tail;
+	/* ready and space start out held, and are released to wake up the
+	 * consumer and the worker respectively. */
+	PyThread_type_lock ready;
+	PyThread_type_lock space;
+	bool consumer_waiting;
+	bool producer_waiting;
+	/* Held by the consumer, so that only one thread waits for ready. */
+	PyThread_type_lock consumer;
+};
+
+/* Iterator backed by a queue. */
+typedef struct {
+	PyObject_HEAD
+	ra_iter_queue_t *queue;
+} RaIterObject;
+
+static void ra_iter_queue_free_locks(ra_iter_queue_t *queue)
+{
+	if (queue->lock != NULL)
+		PyThread_free_lock(queue->lock);
+	if (queue->ready != NULL)
+		PyThread_free_lock(queue->ready);
+	if (queue->space != NULL)
+		PyThread_free_lock(queue->space);
+	if (queue->consumer != NULL)
+		PyThread_free_lock(queue->consumer);
+}
+
+/**
+ * Allocate a queue for a call on ra, which must have been marked busy.
+ *
+ * size is the size of the structure the queue is embedded at the start
+ * of. Clears the busy flag and sets an exception on failure.
+ */
+static ra_iter_queue_t *ra_iter_queue_new(size_t size,
+										  RemoteAccessObject *ra,
+										  int max_queue)
+{
+	ra_iter_queue_t *queue;
+
+	queue = calloc(1, size);
+	if (queue == NULL) {
+		subvertpy_flag_clear(&ra->busy);
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	queue->pool = Pool(NULL);
+	if (queue->pool == NULL) {
+		free(queue);
+		subvertpy_flag_clear(&ra->busy);
+		return NULL;
+	}
+
+	queue->lock = PyThread_allocate_lock();
+	queue->ready = PyThread_allocate_lock();
+	queue->space = PyThread_allocate_lock();
+	queue->consumer = PyThread_allocate_lock();
+	if (queue->lock == NULL || queue->ready == NULL ||
+		queue->space == NULL || queue->consumer == NULL) {
+		ra_iter_queue_free_locks(queue);
+		apr_pool_destroy(queue->pool);
+		free(queue);
+		subvertpy_flag_clear(&ra->busy);
+		PyErr_NoMemory();
+		return NULL;
+	}
+	PyThread_acquire_lock(queue->ready, WAIT_LOCK);
+	PyThread_acquire_lock(queue->space, WAIT_LOCK);
+
+	queue->ra = ra;
+	Py_INCREF(ra);
+	queue->max_queue = max_queue;
+	queue->refs = 1;
+	return queue;
+}
+
+/* Detach the items that were not consumed. Must be called with lock
+ * held; the items are released by ra_iter_queue_free_items(). */
+static struct ra_iter_item *ra_iter_queue_take_items(ra_iter_queue_t *queue)
+{
+	struct ra_iter_item *items = queue->head;
+
+	queue->head = queue->tail = NULL;
+	queue->size = 0;
+	return items;
+}
+
+static void ra_iter_queue_free_items(struct ra_iter_item *items)
+{
+	while (items != NULL) {
+		struct ra_iter_item *next = items->next;
+		Py_DECREF(items->obj);
+		free(items);
+		items = next;
+	}
+}
+
+/**
+ * Drop a reference to the queue, freeing it if it was the last one.
+ *
+ * Must be called with the GIL held.
+ */
+static void ra_iter_queue_release(ra_iter_queue_t *queue)
+{
+	int refs;
+
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	refs = --queue->refs;
+	PyThread_release_lock(queue->lock);
+	if (refs > 0)
+		return;
+
+	if (!queue->started && queue->finish != NULL)
+		queue->finish(queue);
+	ra_iter_queue_free_items(ra_iter_queue_take_items(queue));
+	Py_XDECREF(queue->exc_type);
+	Py_XDECREF(queue->exc_val);
+	ra_iter_queue_free_locks(queue);
+	apr_pool_destroy(queue->pool);
+	Py_DECREF(queue->ra);
+	free(queue);
+}
+
+/* Must be called with lock held. */
+static void ra_iter_queue_wake_consumer(ra_iter_queue_t *queue)
+{
+	if (queue->consumer_waiting) {
+		queue->consumer_waiting = false;
+		PyThread_release_lock(queue->ready);
+	}
+}
+
+/* Must be called with lock held. */
+static void ra_iter_queue_wake_producer(ra_iter_queue_t *queue)
+{
+	if (queue->producer_waiting) {
+		queue->producer_waiting = false;
+		PyThread_release_lock(queue->space);
+	}
+}
+
+/**
+ * Block until the worker has queued an item or finished.
+ *
+ * Must be called with the GIL, the consumer lock and lock held; lock is
+ * held again on return.
+ */
+static void ra_iter_queue_wait_ready(ra_iter_queue_t *queue)
+{
+	queue->consumer_waiting = true;
+	PyThread_release_lock(queue->lock);
+	Py_BEGIN_ALLOW_THREADS
+	PyThread_acquire_lock(queue->ready, WAIT_LOCK);
+	Py_END_ALLOW_THREADS
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+}
+
+/* Become the consumer. Must be called with the GIL held. */
+static void ra_iter_queue_enter(ra_iter_queue_t *queue)
+{
+	if (!PyThread_acquire_lock(queue->consumer, NOWAIT_LOCK)) {
+		Py_BEGIN_ALLOW_THREADS
+		PyThread_acquire_lock(queue->consumer, WAIT_LOCK);
+		Py_END_ALLOW_THREADS
+	}
+}
+
+static void ra_iter_queue_leave(ra_iter_queue_t *queue)
+{
+	PyThread_release_lock(queue->consumer);
+}
+
+/**
+ * Mark a queue whose worker could not be started as finished, and clear
+ * the busy flag of the session.
+ */
+static void ra_iter_queue_abandon(ra_iter_queue_t *queue)
+{
+	queue->done = true;
+	subvertpy_flag_clear(&queue->ra->busy);
+}
+
+static void ra_iter_queue_worker(void *baton)
+{
+	ra_iter_queue_t *queue = (ra_iter_queue_t *)baton;
+	PyObject *exc_type, *exc_val;
+	PyThreadState *tstate;
+	svn_error_t *error;
+	bool cancelled;
+
+	tstate = subvertpy_thread_attach(queue->ra->interp);
+	Py_BEGIN_ALLOW_THREADS
+	error = queue->run(queue);
+	Py_END_ALLOW_THREADS
+
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	cancelled = queue->cancelled;
+	PyThread_release_lock(queue->lock);
+
+	if (error != NULL && !cancelled) {
+		exc_type = (PyObject *)PyErr_GetSubversionExceptionTypeObject();
+		exc_val = PyErr_NewSubversionException(error);
+	} else {
+		exc_type = PyExc_StopIteration;
+		Py_INCREF(exc_type);
+		exc_val = Py_None;
+		Py_INCREF(exc_val);
+	}
+	svn_error_clear(error);
+	if (queue->finish != NULL)
+		queue->finish(queue);
+
+	/* The session has to be usable by the time the consumer sees that
+	 * the call has finished. */
+	subvertpy_flag_clear(&queue->ra->busy);
+
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	queue->exc_type = exc_type;
+	queue->exc_val = exc_val;
+	queue->done = true;
+	ra_iter_queue_wake_consumer(queue);
+	PyThread_release_lock(queue->lock);
+
+	ra_iter_queue_release(queue);
+	subvertpy_thread_detach(tstate);
+}
+
+/**
+ * Start the worker thread.
+ *
+ * On failure the queue is abandoned and an exception is set.
+ */
+static bool ra_iter_queue_start(ra_iter_queue_t *queue)
+{
+	queue->refs++;
+	queue->started = true;
+	if (PyThread_start_new_thread(ra_iter_queue_worker, queue) == -1) {
+		queue->refs--;
+		queue->started = false;
+		ra_iter_queue_abandon(queue);
+		PyErr_SetString(PyExc_RuntimeError, "Unable to start worker thread");
+		return false;
+	}
+	return true;
+}
+
+/* Whether the consumer has gone away. */
+static bool ra_iter_queue_cancelled(ra_iter_queue_t *queue)
+{
+	bool ret;
+
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	ret = queue->cancelled;
+	PyThread_release_lock(queue->lock);
+	return ret;
+}
+
+/**
+ * Queue an item for the consumer, blocking while the queue is full.
+ *
+ * Must be called on the worker thread with the GIL held. Steals a
+ * reference to obj, which may be NULL if creating it failed.
+ */
+static svn_error_t *ra_iter_queue_push(ra_iter_queue_t *queue, PyObject *obj)
+{
+	struct ra_iter_item *item;
+
+	if (obj == NULL)
+		return py_svn_error();
+
+	item = calloc(1, sizeof(struct ra_iter_item));
+	if (item == NULL) {
+		Py_DECREF(obj);
+		PyErr_NoMemory();
+		return py_svn_error();
+	}
+	item->obj = obj;
+
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	if (queue->cancelled) {
+		PyThread_release_lock(queue->lock);
+		ra_iter_queue_free_items(item);
+		return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+	}
+
+	if (queue->tail == NULL) {
+		queue->head = item;
+	} else {
+		queue->tail->next = item;
+	}
+	queue->tail = item;
+	queue->size++;
+	ra_iter_queue_wake_consumer(queue);
+
+	while (queue->size >= queue->max_queue && !queue->cancelled) {
+		queue->producer_waiting = true;
+		PyThread_release_lock(queue->lock);
+		Py_BEGIN_ALLOW_THREADS
+		PyThread_acquire_lock(queue->space, WAIT_LOCK);
+		Py_END_ALLOW_THREADS
+		PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	}
+	PyThread_release_lock(queue->lock);
+	return NULL;
+}
+
+/**
+ * Take the next item, blocking until there is one. Once the call has
+ * finished and all items have been consumed, raises StopIteration or the
+ * error the call failed with.
+ *
+ * Must be called with the GIL held.
+ */
+static PyObject *ra_iter_queue_next(ra_iter_queue_t *queue)
+{
+	struct ra_iter_item *first;
+	PyObject *ret = NULL;
+
+	ra_iter_queue_enter(queue);
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	while (queue->head == NULL && !queue->done)
+		ra_iter_queue_wait_ready(queue);
+
+	first = queue->head;
+	if (first != NULL) {
+		queue->head = first->next;
+		if (first == queue->tail)
+			queue->tail = NULL;
+		queue->size--;
+		ra_iter_queue_wake_producer(queue);
+	}
+	PyThread_release_lock(queue->lock);
+
+	if (first != NULL) {
+		ret = first->obj;
+		free(first);
+	} else {
+		/* Not changed after done is set. */
+		PyErr_SetObject(queue->exc_type, queue->exc_val);
+	}
+	ra_iter_queue_leave(queue);
+	return ret;
+}
+
+/**
+ * Stop the call early, and wait for it to return.
+ *
+ * Items that were not consumed are dropped. Must be called with the GIL
+ * held.
+ */
+static void ra_iter_queue_cancel(ra_iter_queue_t *queue)
+{
+	struct ra_iter_item *items;
+
+	ra_iter_queue_enter(queue);
+	PyThread_acquire_lock(queue->lock, WAIT_LOCK);
+	queue->cancelled = true;
+	ra_iter_queue_wake_producer(queue);
+	while (!queue->done)
+		ra_iter_queue_wait_ready(queue);
+	items = ra_iter_queue_take_items(queue);
+	PyThread_release_lock(queue->lock);
+	ra_iter_queue_leave(queue);
+
+	ra_iter_queue_free_items(items);
+}
+
+static void ra_iter_dealloc(PyObject *self)
+{
+	RaIterObject *iter = (RaIterObject *)self;
+
+	if (iter->queue != NULL) {
+		/* Abandoned before it was exhausted; don't leave the worker
+		 * waiting for room in the queue. */
+		ra_iter_queue_cancel(iter->queue);
+		ra_iter_queue_release(iter->queue);
+	}
+	py_object_del(self);
+}
+
+static PyObject *ra_iter_next(RaIterObject *iter)
+{
+	return ra_iter_queue_next(iter->queue);
+}
+
+static PyObject *ra_iter_close(RaIterObject *iter)
+{
+	ra_iter_queue_cancel(iter->queue);
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef ra_iter_methods[] = {
+	{ "close", (PyCFunction)ra_iter_close, METH_NOARGS,
+		"S.close()\n"
+		"Stop the request and wait for it to finish, after which the "
+		"session can be used again. Releasing the iterator has the same "
+		"effect." },
+	{ NULL }
+};
@@ -0,0 +1,299 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#include <Python.h>
+#include <apr_general.h>
+#include <svn_types.h>
+#include <svn_diff.h>
+#include <svn_pools.h>
+#include <stdbool.h>
+
+#include "util.h"
+#include "blame.h"
+
+blame_t *blame_create(apr_pool_t *pool)
+{
+	blame_t *blame;
+
+	blame = apr_pcalloc(pool, sizeof(blame_t));
+	blame->pool = pool;
+	/* These are cleared without holding the GIL, so are not created
+	 * with Pool(). */
+	blame->run_pool[0] = svn_pool_create(pool);
+	blame->run_pool[1] = svn_pool_create(pool);
+	blame->cur = 0;
+	blame->runs = apr_array_make(blame->run_pool[0], 16, sizeof(blame_run_t));
+	blame->author_index = apr_hash_make(pool);
+	blame->authors = apr_array_make(pool, 8, sizeof(const char *));
+	return blame;
+}
+
+/**
+ * Return the index of author in the author table, adding it if necessary.
+ * Returns -1 if author is NULL.
+ */
+int blame_author(blame_t *blame, const char *author)
+{
+	int *idx;
+
+	if (author == NULL)
+		return -1;
+
+	idx = apr_hash_get(blame->author_index, author, APR_HASH_KEY_STRING);
+	if (idx != NULL)
+		return *idx;
+
+	idx = apr_palloc(blame->pool, sizeof(int));
+	*idx = blame->authors->nelts;
+	author = apr_pstrdup(blame->pool, author);
+	APR_ARRAY_PUSH(blame->authors, const char *) = author;
+	apr_hash_set(blame->author_index, author, APR_HASH_KEY_STRING, idx);
+	return *idx;
+}
+
+static void blame_append_run(apr_array_header_t *runs, apr_off_t lines,
+							 svn_revnum_t revision, int author)
+{
+	blame_run_t *run;
+
+	if (lines <= 0)
+		return;
+
+	if (runs->nelts > 0) {
+		run = &APR_ARRAY_IDX(runs, runs->nelts - 1, blame_run_t);
+		if (run->revision == revision && run->author == author) {
+			run->lines += lines;
+			return;
+		}
+	}
+
+	run = apr_array_push(runs);
+	run->lines = lines;
+	run->revision = revision;
+	run->author = author;
+}
+
+/**
+ * Add lines to the end of the file.
+ */
+void blame_append(blame_t *blame, apr_off_t lines, svn_revnum_t revision,
+				  int author)
+{
+	blame_append_run(blame->runs, lines, revision, author);
+}
+
+#if ONLY_SINCE_SVN(1, 5)
+typedef struct {
+	const apr_array_header_t *old_runs;
+	apr_array_header_t *new_runs;
+	int run;
+	apr_off_t offset;
+	apr_off_t line;
+	svn_revnum_t revision;
+	int author;
+} blame_diff_baton_t;
+
+/**
+ * Move count lines forward in the original text, copying their
+ * attribution if copy is set.
+ */
+static void blame_diff_advance(blame_diff_baton_t *baton, apr_off_t count,
+							   bool copy)
+{
+	while (count > 0 && baton->run < baton->old_runs->nelts) {
+		const blame_run_t *run = &APR_ARRAY_IDX(baton->old_runs, baton->run,
+												blame_run_t);
+		apr_off_t n = run->lines - baton->offset;
+		if (n > count)
+			n = count;
+		if (copy)
+			blame_append_run(baton->new_runs, n, run->revision, run->author);
+		baton->offset += n;
+		baton->line += n;
+		count -= n;
+		if (baton->offset == run->lines) {
+			baton->run++;
+			baton->offset = 0;
+		}
+	}
+}
+
+static svn_error_t *blame_output_common(void *output_baton,
+	apr_off_t original_start, apr_off_t original_length,
+	apr_off_t modified_start, apr_off_t modified_length,
+	apr_off_t latest_start, apr_off_t latest_length)
+{
+	blame_diff_baton_t *baton = output_baton;
+
+	blame_diff_advance(baton, original_start - baton->line, false);
+	blame_diff_advance(baton, original_length, true);
+	return NULL;
+}
+
+static svn_error_t *blame_output_diff_modified(void *output_baton,
+	apr_off_t original_start, apr_off_t original_length,
+	apr_off_t modified_start, apr_off_t modified_length,
+	apr_off_t latest_start, apr_off_t latest_length)
+{
+	blame_diff_baton_t *baton = output_baton;
+
+	blame_diff_advance(baton, original_start - baton->line, false);
+	blame_diff_advance(baton, original_length, false);
+	blame_append_run(baton->new_runs, modified_length, baton->revision,
+					 baton->author);
+	return NULL;
+}
+
+static const svn_diff_output_fns_t blame_output_fns = {
+	.output_common = blame_output_common,
+	.output_diff_modified = blame_output_diff_modified,
+};
+
+/**
+ * Update the line map for a new revision of the file, attributing all
+ * lines that were added or changed to revision.
+ */
+svn_error_t *blame_apply_diff(blame_t *blame, const svn_string_t *original,
+							  const svn_string_t *modified,
+							  svn_revnum_t revision, int author,
+							  apr_pool_t *scratch_pool)
+{
+	svn_diff_t *diff;
+	blame_diff_baton_t baton;
+	apr_pool_t *next_pool = blame->run_pool[!blame->cur];
+
+	SVN_ERR(svn_diff_mem_string_diff(&diff, original, modified,
+									 svn_diff_file_options_create(scratch_pool),
+									 scratch_pool));
+
+	apr_pool_clear(next_pool);
+	baton.old_runs = blame->runs;
+	baton.new_runs = apr_array_make(next_pool, blame->runs->nelts + 2,
+									sizeof(blame_run_t));
+	baton.run = 0;
+	baton.offset = 0;
+	baton.line = 0;
+	baton.revision = revision;
+	baton.author = author;
+
+	SVN_ERR(svn_diff_output(diff, &baton, &blame_output_fns));
+
+	blame->runs = baton.new_runs;
+	blame->cur = !blame->cur;
+	return NULL;
+}
+#endif
+
+static PyObject *blame_array(const char *typecode, const void *data,
+							 Py_ssize_t size)
+{
+	PyObject *mod, *array, *bytes, *ret;
+
+	mod = PyImport_ImportModule("array");
+	if (mod == NULL)
+		return NULL;
+
+	array = PyObject_CallMethod(mod, "array", "s", typecode);
+	Py_DECREF(mod);
+	if (array == NULL)
+		return NULL;
+
+	bytes = PyBytes_FromStringAndSize(data, size);
+	if (bytes == NULL) {
+		Py_DECREF(array);
+		return NULL;
+	}
+
+#if PY_MAJOR_VERSION >= 3
+	ret = PyObject_CallMethod(array, "frombytes", "O", bytes);
+#else
+	ret = PyObject_CallMethod(array, "fromstring", "O", bytes);
+#endif
+	Py_DECREF(bytes);
+	if (ret == NULL) {
+		Py_DECREF(array);
+		return NULL;
+	}
+	Py_DECREF(ret);
+	return array;
+}
+
+/**
+ * Convert the line map to a (revisions, author_indices, authors) tuple.
+ *
+ * revisions and author_indices are arrays with one entry per line;
+ * author_indices index into the authors list, or are -1 for revisions
+ * without an author.
+ */
+PyObject *blame_to_python(blame_t *blame)
+{
+	Py_ssize_t nlines = 0, i, line = 0;
+	int j;
+	long *revisions;
+	int *authors;
+	PyObject *py_revisions, *py_authors, *py_author_list;
+
+	for (j = 0; j < blame->runs->nelts; j++)
+		nlines += APR_ARRAY_IDX(blame->runs, j, blame_run_t).lines;
+
+	revisions = PyMem_Malloc(sizeof(long) * (nlines + 1));
+	authors = PyMem_Malloc(sizeof(int) * (nlines + 1));
+	if (revisions == NULL || authors == NULL) {
+		PyMem_Free(revisions);
+		PyMem_Free(authors);
+		return PyErr_NoMemory();
+	}
+
+	for (j = 0; j < blame->runs->nelts; j++) {
+		const blame_run_t *run = &APR_ARRAY_IDX(blame->runs, j, blame_run_t);
+		for (i = 0; i < run->lines; i++, line++) {
+			revisions[line] = run->revision;
+			authors[line] = run->author;
+		}
+	}
+
+	py_revisions = blame_array("l", revisions, sizeof(long) * nlines);
+	py_authors = blame_array("i", authors, sizeof(int) * nlines);
+	PyMem_Free(revisions);
+	PyMem_Free(authors);
+	if (py_revisions == NULL || py_authors == NULL) {
+		Py_XDECREF(py_revisions);
+		Py_XDECREF(py_authors);
+		return NULL;
+	}
+
+	py_author_list = PyList_New(blame->authors->nelts);
+	if (py_author_list == NULL) {
+		Py_DECREF(py_revisions);
+		Py_DECREF(py_authors);
+		return NULL;
+	}
+	for (j = 0; j < blame->authors->nelts; j++) {
+		PyObject *author = PyUnicode_FromString(
+			APR_ARRAY_IDX(blame->authors, j, const char *));
+		if (author == NULL) {
+			Py_DECREF(py_author_list);
+			Py_DECREF(py_revisions);
+			Py_DECREF(py_authors);
+			return NULL;
+		}
+		PyList_SET_ITEM(py_author_list, j, author);
+	}
+
+	return Py_BuildValue("(NNN)", py_revisions, py_authors, py_author_list);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef _SUBVERTPY_BLAME_H_
+#define _SUBVERTPY_BLAME_H_
+
+#include <stdbool.h>
+
+#ifdef __GNUC__
+#pragma GCC visibility push(hidden)
+#endif
+
+/* A run of consecutive lines last changed in the same revision. */
+typedef struct {
+	apr_off_t lines;
+	svn_revnum_t revision;
+	int author;
+} blame_run_t;
+
+/* Line to revision map of a file, kept as an array of runs rather than
+ * per line. None of the functions below need the GIL, except for
+ * blame_to_python(). */
+typedef struct {
+	apr_pool_t *run_pool[2];
+	int cur;
+	apr_array_header_t *runs;
+	apr_hash_t *author_index;
+	apr_array_header_t *authors;
+	apr_pool_t *pool;
+} blame_t;
+
+blame_t *blame_create(apr_pool_t *pool);
+int blame_author(blame_t *blame, const char *author);
+void blame_append(blame_t *blame, apr_off_t lines, svn_revnum_t revision,
+				  int author);
+#if ONLY_SINCE_SVN(1, 5)
+svn_error_t *blame_apply_diff(blame_t *blame, const svn_string_t *original,
+							  const svn_string_t *modified,
+							  svn_revnum_t revision, int author,
+							  apr_pool_t *scratch_pool);
+#endif
+PyObject *blame_to_python(blame_t *blame);
+
+#ifdef __GNUC__
+#pragma GCC visibility pop
+#endif
+
+#endif /* _SUBVERTPY_BLAME_H_ */
@@ -0,0 +1,551 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Content-addressed local cache of file texts.
+
+File texts are stored by their MD5 checksum, which is the checksum
+Subversion editors report in ``apply_textdelta`` and ``close``. SHA-1
+checksums are accepted as well, and map onto the MD5 checksum of the same
+text.
+
+The cache directory contains:
+
+ * ``objects/xx/<md5>``: the file texts
+ * ``sha1``: append-only list of ``<sha1> <md5>`` lines
+ * ``refs``: append-only list of ``<md5> <revnum> <url>`` lines, recording
+   the text of a file at a specific revision, so that ``get_file`` for an
+   explicit revision can be answered without knowing the checksum
+ * ``props``: append-only list of ``<md5> <revnum> <url>`` lines, recording
+   the properties of a file at a specific revision; they are stored as
+   texts, in the format of svn hash dumps
+
+The total size of the stored texts is bounded; the least recently used
+texts are removed first. A cache should only be written to by one process
+at a time.
+"""
+
+__docformat__ = "restructuredText"
+
+from collections import OrderedDict
+import hashlib
+import os
+import tempfile
+
+from subvertpy.delta import (
+    TXDELTA_NEW,
+    apply_txdelta_window,
+    send_stream,
+    )
+
+DEFAULT_MAX_SIZE = 256 * 1024 * 1024
+
+
+def default_cache_dir():
+    """Return the default directory for the blob cache."""
+    base = os.environ.get("XDG_CACHE_HOME")
+    if not base:
+        base = os.path.join(os.path.expanduser("~"), ".cache")
+    return os.path.join(base, "subvertpy", "blobs")
+
+
+def _hexdigest(checksum):
+    if isinstance(checksum, bytes) and len(checksum) in (16, 20):
+        # Raw digest, as returned by delta.send_stream.
+        checksum = "".join("%02x" % c for c in bytearray(checksum))
+    if isinstance(checksum, bytes):
+        checksum = checksum.decode("ascii")
+    return checksum.lower()
+
+
+def send_text(text, file_editor, base_checksum=None):
+    """Send a file text to a file editor as a single delta window.
+
+    The window only inserts new data, so it does not depend on the base
+    text.
+
+    :param text: Contents of the file, as bytes or as a file-like object;
+        the contents of the latter are sent in windows of at most
+        ``delta.DELTA_WINDOW_SIZE`` bytes each
+    :param file_editor: File editor to apply the text to
+    :param base_checksum: Checksum of the base text, if any
+    :return: MD5 hex digest of text
+    """
+    if base_checksum is None:
+        handler = file_editor.apply_textdelta()
+    else:
+        handler = file_editor.apply_textdelta(base_checksum)
+    if getattr(text, "read", None) is not None:
+        return _hexdigest(send_stream(text, handler))
+    if text:
+        handler((0, 0, len(text), 0, [(TXDELTA_NEW, 0, len(text))], text))
+    handler(None)
+    return hashlib.md5(text).hexdigest()
+
+
+if str is bytes:
+    def _text(value):
+        return value
+else:
+    def _text(value):
+        return value.decode("utf-8")
+
+
+def _dump_props(props):
+    """Serialize properties in the format of svn hash dumps."""
+    out = []
+    for name, value in sorted(props.items()):
+        if not isinstance(name, bytes):
+            name = name.encode("utf-8")
+        if not isinstance(value, bytes):
+            value = value.encode("utf-8")
+        out.append(("K %d\n" % len(name)).encode("ascii"))
+        out.append(name + b"\n")
+        out.append(("V %d\n" % len(value)).encode("ascii"))
+        out.append(value + b"\n")
+    out.append(b"END\n")
+    return b"".join(out)
+
+
+def _load_props(data):
+    """Parse properties serialized by ``_dump_props``."""
+    props = {}
+    offset = 0
+    while True:
+        end = data.index(b"\n", offset)
+        if data[offset:end] == b"END":
+            return props
+        fields = []
+        for kind in (b"K", b"V"):
+            end = data.index(b"\n", offset)
+            (header, length) = data[offset:end].split(b" ")
+            if header != kind:
+                raise ValueError("invalid property dump")
+            offset = end + 1 + int(length)
+            fields.append(data[end + 1:offset])
+            offset += 1
+        props[_text(fields[0])] = fields[1]
+
+
+class _BlobWriter(object):
+    """Write a text to a temporary file while it is received.
+
+    The checksums are computed as the text is written, so it never has to
+    be held in memory.
+    """
+
+    def __init__(self, cache):
+        self._cache = cache
+        (fd, self.path) = tempfile.mkstemp(prefix=".",
+                                           dir=cache._objects_path)
+        self._file = os.fdopen(fd, "wb")
+        self._md5 = hashlib.md5()
+        self._sha1 = hashlib.sha1()
+        self.size = 0
+
+    def write(self, data):
+        self._file.write(data)
+        self._md5.update(data)
+        self._sha1.update(data)
+        self.size += len(data)
+
+    def finish(self):
+        """Add the text to the cache, if it fits.
+
+        :return: Tuple with the MD5 hex digest of the text and the path of
+            a file with its contents; call ``cleanup`` once that has been
+            read
+        """
+        self._file.close()
+        md5 = self._md5.hexdigest()
+        if self._cache._store(self.path, md5, self._sha1.hexdigest(),
+                              self.size):
+            self.path = None
+            return (md5, self._cache._object_path(md5))
+        return (md5, self.path)
+
+    def cleanup(self):
+        """Remove the temporary file, unless it was added to the cache."""
+        if not self._file.closed:
+            self._file.close()
+        if self.path is not None:
+            try:
+                os.unlink(self.path)
+            except OSError:
+                pass
+            self.path = None
+
+
+class _TeeStream(object):
+
+    def __init__(self, stream, writer):
+        self._stream = stream
+        self._writer = writer
+
+    def write(self, data):
+        self._writer.write(data)
+        return self._stream.write(data)
+
+
+class BlobCache(object):
+    """Size-bounded, content-addressed cache of file texts.
+
+    :param cache_dir: Directory to store the cache in; defaults to
+        ``default_cache_dir()``.
+    :param max_size: Maximum total size of the cached texts, in bytes.
+    """
+
+    def __init__(self, cache_dir=None, max_size=DEFAULT_MAX_SIZE):
+        if cache_dir is None:
+            cache_dir = default_cache_dir()
+        self.path = cache_dir
+        self.max_size = max_size
+        self._objects_path = os.path.join(cache_dir, "objects")
+        if not os.path.isdir(self._objects_path):
+            os.makedirs(self._objects_path)
+        self._sha1_path = os.path.join(cache_dir, "sha1")
+        self._refs_path = os.path.join(cache_dir, "refs")
+        self._props_path = os.path.join(cache_dir, "props")
+        self._load_objects()
+        self._sha1 = self._load_table(self._sha1_path, 2)
+        self._refs = self._load_table(self._refs_path, 3)
+        self._props = self._load_table(self._props_path, 3)
+
+    def _object_path(self, md5):
+        return os.path.join(self._objects_path, md5[:2], md5)
+
+    def _load_objects(self):
+        found = []
+        for subdir in os.listdir(self._objects_path):
+            dirpath = os.path.join(self._objects_path, subdir)
+            if subdir.startswith("."):
+                # Left over from an interrupted _BlobWriter.
+                os.unlink(dirpath)
+                continue
+            for name in os.listdir(dirpath):
+                if name.startswith("."):
+                    # Left over from an interrupted write.
+                    os.unlink(os.path.join(dirpath, name))
+                    continue
+                st = os.stat(os.path.join(dirpath, name))
+                found.append((st.st_mtime, name, st.st_size))
+        found.sort()
+        self._objects = OrderedDict(
+            (name, size) for (mtime, name, size) in found)
+        self.size = sum(self._objects.values())
+
+    def _load_table(self, path, fields):
+        """Load an append-only table, dropping rows for evicted texts.
+
+        The first field of each row is the MD5 checksum it refers to; the
+        result maps the remaining fields to it.
+        """
+        table = {}
+        stale = False
+        if os.path.exists(path):
+            with open(path, "r") as f:
+                for line in f:
+                    row = line.rstrip("\n").split(" ", fields - 1)
+                    if len(row) != fields or row[0] not in self._objects:
+                        stale = True
+                        continue
+                    table[tuple(row[1:])] = row[0]
+        if stale:
+            with open(path + ".tmp", "w") as f:
+                for key, md5 in table.items():
+                    f.write(" ".join((md5, ) + key) + "\n")
+            os.rename(path + ".tmp", path)
+        return table
+
+    def _append_row(self, path, row):
+        with open(path, "a") as f:
+            f.write(" ".join(row) + "\n")
+
+    def _lookup(self, checksum):
+        checksum = _hexdigest(checksum)
+        if len(checksum) == 40:
+            return self._sha1.get((checksum, ))
+        return checksum
+
+    def __contains__(self, checksum):
+        return self._lookup(checksum) in self._objects
+
+    def get(self, checksum):
+        """Return the text with the given MD5 or SHA-1 checksum.
+
+        :return: Text as bytes, or None if it is not in the cache
+        """
+        md5 = self._lookup(checksum)
+        if md5 not in self._objects:
+            return None
+        path = self._object_path(md5)
+        try:
+            with open(path, "rb") as f:
+                text = f.read()
+            os.utime(path, None)
+        except (IOError, OSError):
+            self.size -= self._objects.pop(md5)
+            return None
+        self._objects[md5] = self._objects.pop(md5)
+        return text
+
+    def add(self, text):
+        """Add a text to the cache.
+
+        :return: MD5 hex digest of the text
+        """
+        md5 = hashlib.md5(text).hexdigest()
+        if md5 in self._objects or len(text) > self.max_size:
+            return md5
+        sha1 = hashlib.sha1(text).hexdigest()
+        dirpath = os.path.dirname(self._object_path(md5))
+        if not os.path.isdir(dirpath):
+            os.mkdir(dirpath)
+        (fd, tmppath) = tempfile.mkstemp(prefix=".", dir=dirpath)
+        with os.fdopen(fd, "wb") as f:
+            f.write(text)
+        self._store(tmppath, md5, sha1, len(text))
+        return md5
+
+    def _store(self, tmppath, md5, sha1, size):
+        """Move a file with a text into the cache.
+
+        :return: Whether the text was stored; if not, tmppath is left
+        """
+        if md5 in self._objects or size > self.max_size:
+            return False
+        dirpath = os.path.dirname(self._object_path(md5))
+        if not os.path.isdir(dirpath):
+            os.mkdir(dirpath)
+        os.rename(tmppath, self._object_path(md5))
+        self._objects[md5] = size
+        self.size += size
+        if (sha1, ) not in self._sha1:
+            self._sha1[(sha1, )] = md5
+            self._append_row(self._sha1_path, (md5, sha1))
+        self.evict()
+        return True
+
+    def evict(self, max_size=None):
+        """Remove the least recently used texts until the cache fits.
+
+        :param max_size: Size to shrink to; defaults to ``max_size``
+        """
+        if max_size is None:
+            max_size = self.max_size
+        while self.size > max_size and self._objects:
+            (md5, size) = self._objects.popitem(last=False)
+            self.size -= size
+            try:
+                os.unlink(self._object_path(md5))
+            except OSError:
+                pass
+
+    def _get_props(self, key):
+        md5 = self._props.get(key)
+        if md5 is None:
+            return None
+        data = self.get(md5)
+        if data is None:
+            return None
+        return _load_props(data)
+
+    def _add_ref(self, table, path, md5, key):
+        if table.get(key) != md5 and md5 in self._objects:
+            table[key] = md5
+            self._append_row(path, (md5, ) + key)
+
+    def get_file(self, ra, path, stream, revision=-1, checksum=None):
+        """Fetch a file, as ``RemoteAccess.get_file``.
+
+        The contents are taken from the cache if checksum is known, or if
+        the file was fetched at the same explicit revision before. The
+        properties are then taken from the cache as well if the file was
+        fetched at that explicit revision before, and fetched from the
+        server otherwise. If the contents are not in the cache, they are
+        fetched and added to it.
+
+        :param ra: RemoteAccess object
+        :param checksum: MD5 or SHA-1 checksum of the file at revision, if
+            known (for example from an earlier update)
+        :return: Tuple with fetched revision and properties
+        """
+        url = ra.get_session_url().rstrip("/")
+        if path:
+            url += "/" + path.lstrip("/")
+        explicit = revision is not None and revision >= 0
+        if checksum is None and explicit:
+            checksum = self._refs.get((str(revision), url))
+        if checksum is not None:
+            md5 = self._lookup(checksum)
+            if md5 in self._objects:
+                props = None
+                if explicit:
+                    props = self._get_props((str(revision), url))
+                if props is not None:
+                    ret = (revision, props)
+                else:
+                    ret = ra.get_file(path, None, revision)
+                    self._add_props(ret, url)
+                if self._copy_to(md5, stream):
+                    return ret
+        writer = _BlobWriter(self)
+        try:
+            ret = ra.get_file(path, _TeeStream(stream, writer), revision)
+            (md5, text_path) = writer.finish()
+        finally:
+            writer.cleanup()
+        self._add_ref(self._refs, self._refs_path, md5, (str(ret[0]), url))
+        self._add_props(ret, url)
+        return ret
+
+    def _add_props(self, ret, url):
+        (fetched_rev, props) = ret
+        md5 = self.add(_dump_props(props))
+        self._add_ref(self._props, self._props_path, md5,
+                      (str(fetched_rev), url))
+
+    def _copy_to(self, md5, stream, block_size=1024 * 1024):
+        """Copy a cached text to a stream, without reading it all at once.
+
+        :return: False if the text was not in the cache after all
+        """
+        path = self._object_path(md5)
+        try:
+            f = open(path, "rb")
+        except (IOError, OSError):
+            self.size -= self._objects.pop(md5)
+            return False
+        with f:
+            data = f.read(block_size)
+            while data:
+                stream.write(data)
+                data = f.read(block_size)
+        os.utime(path, None)
+        self._objects[md5] = self._objects.pop(md5)
+        return True
+
+    def wrap_editor(self, editor):
+        """Wrap an update editor so that the texts it receives are cached.
+
+        Texts are only cached if they are complete, i.e. for newly added
+        files or when the base text is in the cache as well.
+
+        The wrapper is a Python editor, so a native editor passed in is
+        no longer driven directly: each delta window costs a Python call.
+        When the base text is cached, the windows are also applied in
+        Python and the resulting text is sent again to ``editor``.
+        """
+        return _CachingEditor(self, editor)
+
+
+class _CachingFileEditor(object):
+    """File editor that reconstructs and caches the text it receives.
+
+    If the base text is known, the windows are applied here rather than
+    by the wrapped editor, which is sent the resulting text with
+    ``send_text`` once the file is closed. Other files are passed through.
+    """
+
+    def __init__(self, cache, editor, base_known):
+        self._cache = cache
+        self._editor = editor
+        self._base_known = base_known
+        self._writer = None
+
+    def __getattr__(self, name):
+        return getattr(self._editor, name)
+
+    def apply_textdelta(self, base_checksum=None):
+        if base_checksum is None:
+            base = b"" if self._base_known else None
+        else:
+            base = self._cache.get(base_checksum)
+        if base is None:
+            if base_checksum is None:
+                return self._editor.apply_textdelta()
+            return self._editor.apply_textdelta(base_checksum)
+        self._base_checksum = base_checksum
+        writer = self._writer = _BlobWriter(self._cache)
+
+        def apply_window(window):
+            if window is not None:
+                writer.write(bytes(apply_txdelta_window(base, window)))
+        return apply_window
+
+    def close(self, checksum=None):
+        if self._writer is not None:
+            error = None
+            try:
+                (md5, path) = self._writer.finish()
+                if checksum is not None and md5 != _hexdigest(checksum):
+                    error = ValueError(
+                        "checksum mismatch: expected %s, got %s" % (
+                            _hexdigest(checksum), md5))
+                else:
+                    with open(path, "rb") as f:
+                        send_text(f, self._editor, self._base_checksum)
+            finally:
+                self._writer.cleanup()
+                self._writer = None
+            if error is not None:
+                # The wrapped file editor has not been sent a text, so
+                # close it without a checksum before failing the edit.
+                self._editor.close()
+                raise error
+        if checksum is None:
+            self._editor.close()
+        else:
+            self._editor.close(checksum)
+
+
+class _CachingDirEditor(object):
+
+    def __init__(self, cache, editor):
+        self._cache = cache
+        self._editor = editor
+
+    def __getattr__(self, name):
+        return getattr(self._editor, name)
+
+    def add_directory(self, *args):
+        return _CachingDirEditor(self._cache,
+                                 self._editor.add_directory(*args))
+
+    def open_directory(self, *args):
+        return _CachingDirEditor(self._cache,
+                                 self._editor.open_directory(*args))
+
+    def add_file(self, path, copyfrom_path=None, copyfrom_rev=-1):
+        return _CachingFileEditor(
+            self._cache,
+            self._editor.add_file(path, copyfrom_path, copyfrom_rev),
+            copyfrom_path is None)
+
+    def open_file(self, *args):
+        return _CachingFileEditor(self._cache, self._editor.open_file(*args),
+                                  False)
+
+
+class _CachingEditor(object):
+
+    def __init__(self, cache, editor):
+        self._cache = cache
+        self._editor = editor
+
+    def __getattr__(self, name):
+        return getattr(self._editor, name)
+
+    def open_root(self, *args):
+        return _CachingDirEditor(self._cache, self._editor.open_root(*args))
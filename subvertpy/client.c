@@ -24,10 +24,15 @@
 #include <svn_client.h>
 #include <svn_config.h>
 #include <svn_path.h>
+#include <svn_props.h>
 
 #include "util.h"
+#include "editor.h"
+#include "mergeinfo.h"
 #include "ra.h"
 #include "wc.h"
+#include "blame.h"
+#include "stats.h"
 
 #if ONLY_SINCE_SVN(1, 6)
 #define INFO_SIZE size64
@@ -70,12 +75,12 @@ typedef struct {
     apr_pool_t *pool;
 } InfoObject;
 
-#define INVOKE_COMMIT_CALLBACK(pool, commit_info, callback) \
+#define INVOKE_COMMIT_CALLBACK(scratch, pool, commit_info, callback) \
     { \
         PyObject *ret; \
         PyObject *py_commit_info = py_commit_info_tuple(commit_info); \
         if (py_commit_info == NULL) { \
-            apr_pool_destroy(pool); \
+            scratch_pool_release(scratch, pool); \
             return NULL; \
         } \
         if (callback != Py_None) { \
@@ -86,7 +91,7 @@ typedef struct {
         } \
         Py_DECREF(py_commit_info); \
         if (ret == NULL) { \
-            apr_pool_destroy(pool); \
+            scratch_pool_release(scratch, pool); \
             return NULL; \
         } \
     } \
@@ -367,11 +372,11 @@ static PyObject *py_info(const svn_info_t *info)
 {
     InfoObject *ret;
 
-    ret = PyObject_New(InfoObject, &Info_Type);
+    ret = PyObject_New(InfoObject, SUBVERTPY_TYPE(Info_Type));
     if (ret == NULL)
         return NULL;
 
-    ret->wc_info = PyObject_New(WCInfoObject, &WCInfo_Type);
+    ret->wc_info = PyObject_New(WCInfoObject, SUBVERTPY_TYPE(WCInfo_Type));
     if (ret->wc_info == NULL)
         return NULL;
 
@@ -468,9 +473,11 @@ typedef struct {
     PyObject_VAR_HEAD
     svn_client_ctx_t *client;
     apr_pool_t *pool;
+    scratch_pool_t scratch;
     PyObject *callbacks;
     PyObject *py_auth;
     PyObject *py_config;
+    progress_state_t progress;
 } ClientObject;
 
 static PyObject *client_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
@@ -483,10 +490,11 @@ static PyObject *client_new(PyTypeObject *type, PyObject *args, PyObject *kwargs
         &config, &auth, &log_msg_func))
         return NULL;
 
-    ret = PyObject_New(ClientObject, &Client_Type);
+    ret = PyObject_New(ClientObject, SUBVERTPY_TYPE(Client_Type));
     if (ret == NULL)
         return NULL;
 
+    scratch_pool_init(&ret->scratch);
     ret->pool = Pool(NULL);
     if (ret->pool == NULL) {
         Py_DECREF(ret);
@@ -502,12 +510,15 @@ static PyObject *client_new(PyTypeObject *type, PyObject *args, PyObject *kwargs
         handle_svn_error(err);
         svn_error_clear(err);
         apr_pool_destroy(ret->pool);
-        PyObject_Del(ret);
+        py_object_del(ret);
         return NULL;
     }
 
     ret->py_auth = NULL;
     ret->py_config = NULL;
+    progress_init(&ret->progress, Py_None);
+    ret->client->progress_func = py_progress_func;
+    ret->client->progress_baton = &ret->progress;
     ret->client->notify_func2 = NULL;
     ret->client->notify_baton2 = NULL;
     ret->client->cancel_func = py_cancel_check;
@@ -531,9 +542,10 @@ static void client_dealloc(PyObject *self)
     Py_XDECREF((PyObject *)client->client->log_msg_baton2);
     Py_XDECREF(client->py_auth);
     Py_XDECREF(client->py_config);
+    Py_XDECREF(client->progress.func);
     if (client->pool != NULL)
         apr_pool_destroy(client->pool);
-    PyObject_Del(self);
+    py_object_del(self);
 }
 
 static PyObject *client_get_log_msg_func(PyObject *self, void *closure)
@@ -589,6 +601,46 @@ static int client_set_notify_func(PyObject *self, PyObject *func, void *closure)
     return 0;
 }
 
+static PyObject *client_get_progress_func(PyObject *self, void *closure)
+{
+    ClientObject *client = (ClientObject *)self;
+    Py_INCREF(client->progress.func);
+    return client->progress.func;
+}
+
+static int client_set_progress_func(PyObject *self, PyObject *func, void *closure)
+{
+    ClientObject *client = (ClientObject *)self;
+    if (func == NULL)
+        func = Py_None;
+    progress_set_func(&client->progress, func);
+    return 0;
+}
+
+static PyObject *client_get_progress_interval(PyObject *self, void *closure)
+{
+    ClientObject *client = (ClientObject *)self;
+    return progress_get_interval(&client->progress);
+}
+
+static int client_set_progress_interval(PyObject *self, PyObject *value, void *closure)
+{
+    ClientObject *client = (ClientObject *)self;
+    return progress_set_interval(&client->progress, value);
+}
+
+static PyObject *client_get_progress_min_bytes(PyObject *self, void *closure)
+{
+    ClientObject *client = (ClientObject *)self;
+    return progress_get_min_bytes(&client->progress);
+}
+
+static int client_set_progress_min_bytes(PyObject *self, PyObject *value, void *closure)
+{
+    ClientObject *client = (ClientObject *)self;
+    return progress_set_min_bytes(&client->progress, value);
+}
+
 static int client_set_auth(PyObject *self, PyObject *auth, void *closure)
 {
     ClientObject *client = (ClientObject *)self;
@@ -666,29 +718,29 @@ static PyObject *client_add(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 #endif
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
 #if ONLY_SINCE_SVN(1, 8)
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
         svn_client_add5(path, recursive?svn_depth_infinity:svn_depth_empty,
                         force, no_ignore, no_autoprops, add_parents,
                         client->client, temp_pool)
         );
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
         svn_client_add4(path, recursive?svn_depth_infinity:svn_depth_empty,
                         force, no_ignore, add_parents,
                         client->client, temp_pool)
         );
 #else
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
         svn_client_add3(path, recursive, force, no_ignore, client->client,
                         temp_pool)
         );
 #endif
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     Py_RETURN_NONE;
 }
 
@@ -720,25 +772,25 @@ static PyObject *client_checkout(PyObject *self, PyObject *args, PyObject *kwarg
         return NULL;
     }
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL) {
         return NULL;
     }
 
     url = py_object_to_svn_uri(py_url, temp_pool);
     if (url == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     path = py_object_to_svn_dirent(py_path, temp_pool);
     if (path == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
 #if ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_checkout3(&result_rev, url,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_checkout3(&result_rev, url,
         path,
         &c_peg_rev, &c_rev, recurse?svn_depth_infinity:svn_depth_files,
         ignore_externals, allow_unver_obstructions, client->client, temp_pool));
@@ -746,16 +798,16 @@ static PyObject *client_checkout(PyObject *self, PyObject *args, PyObject *kwarg
     if (allow_unver_obstructions) {
         PyErr_SetString(PyExc_NotImplementedError,
             "allow_unver_obstructions not supported when built against svn<1.5");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_checkout2(&result_rev, url,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_checkout2(&result_rev, url,
         path,
         &c_peg_rev, &c_rev, recurse,
         ignore_externals, client->client, temp_pool));
 #endif
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     return PyLong_FromLong(result_rev);
 }
 
@@ -827,17 +879,17 @@ static PyObject *client_commit(PyObject *self, PyObject *args, PyObject *kwargs)
                                      &callback)) {
         return NULL;
     }
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL) {
         return NULL;
     }
     if (!client_list_to_apr_array(temp_pool, targets, py_object_to_svn_path_or_url, &apr_targets)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     if (revprops != Py_None && !PyDict_Check(revprops)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         PyErr_SetString(PyExc_TypeError, "Expected dictionary with revision properties");
         return NULL;
     }
@@ -847,14 +899,14 @@ static PyObject *client_commit(PyObject *self, PyObject *args, PyObject *kwargs)
         if (PyDict_Size(revprops) > 0) {
             PyErr_SetString(PyExc_NotImplementedError,
                     "Setting revision properties only supported on svn >= 1.5");
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             return NULL;
         }
 #endif
 
         hash_revprops = prop_dict_to_hash(temp_pool, revprops);
         if (hash_revprops == NULL) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             return NULL;
         }
     } else {
@@ -862,33 +914,33 @@ static PyObject *client_commit(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
 #if ONLY_SINCE_SVN(1, 8)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_commit6(
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_commit6(
         apr_targets, recurse?svn_depth_infinity:svn_depth_files,
         keep_locks, keep_changelist, commit_as_operations,
         include_file_externals, include_dir_externals, changelists,
         hash_revprops, py_commit_callback2, callback, client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_commit4(
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_commit4(
         &commit_info, apr_targets, recurse?svn_depth_infinity:svn_depth_files,
         keep_locks, keep_changelist, changelists, hash_revprops,
         client->client, temp_pool));
 #else
     if (commit_as_operations) {
         PyErr_SetString(PyExc_NotImplementedError, "commit_as_operations only support on svn >= 1.8");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_commit3(&commit_info,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_commit3(&commit_info,
                 apr_targets,
                recurse, keep_locks, client->client, temp_pool));
 #endif
 
 #if ONLY_BEFORE_SVN(1, 8)
-    INVOKE_COMMIT_CALLBACK(temp_pool, commit_info, callback);
+    INVOKE_COMMIT_CALLBACK(&client->scratch, temp_pool, commit_info, callback);
 #endif
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     Py_RETURN_NONE;
 }
@@ -914,38 +966,38 @@ static PyObject *client_export(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!to_opt_revision(rev, &c_rev))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
     from = py_object_to_svn_string(py_from, temp_pool);
     if (from == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     to = py_object_to_svn_dirent(py_to, temp_pool);
     if (to == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
 #if ONLY_SINCE_SVN(1, 7)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_export5(&result_rev, from, to,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_export5(&result_rev, from, to,
         &c_peg_rev, &c_rev, overwrite, ignore_externals, ignore_keywords,
         recurse?svn_depth_infinity:svn_depth_files,
         native_eol, client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_export4(&result_rev, from, to,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_export4(&result_rev, from, to,
         &c_peg_rev, &c_rev, overwrite, ignore_externals,
         recurse?svn_depth_infinity:svn_depth_files,
         native_eol, client->client, temp_pool));
 #else
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_export3(&result_rev, from, to,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_export3(&result_rev, from, to,
         &c_peg_rev, &c_rev, overwrite, ignore_externals, recurse,
         native_eol, client->client, temp_pool));
 #endif
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     return PyLong_FromLong(result_rev);
 }
 
@@ -969,33 +1021,33 @@ static PyObject *client_cat(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!to_opt_revision(peg_rev, &c_peg_rev))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL) {
         return NULL;
     }
 
     path = py_object_to_svn_string(py_path, temp_pool);
     if (path == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     stream = new_py_stream(temp_pool, py_stream);
     if (stream == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
 #if ONLY_SINCE_SVN(1, 9)
     {
     apr_hash_t *props = NULL;
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_cat3(
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_cat3(
         &props, stream, path, &c_peg_rev, &c_rev, expand_keywords,
         client->client, temp_pool, temp_pool));
 
     ret = prop_hash_to_dict(props);
     if (ret == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     }
@@ -1003,16 +1055,16 @@ static PyObject *client_cat(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!expand_keywords) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "expand_keywords=false only supported with svn >= 1.9");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_cat2(stream, path,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_cat2(stream, path,
         &c_peg_rev, &c_rev, client->client, temp_pool));
     ret = Py_None;
     Py_INCREF(ret);
 #endif
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     return ret;
 }
 
@@ -1033,18 +1085,18 @@ static PyObject *client_delete(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O|bbOO", &paths, &force, &keep_local, &py_revprops, &callback))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
     if (!client_list_to_apr_array(temp_pool, paths, py_object_to_svn_path_or_url, &apr_paths)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     if (py_revprops != Py_None) {
         hash_revprops = prop_dict_to_hash(temp_pool, py_revprops);
         if (hash_revprops == NULL) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             return NULL;
         }
     } else {
@@ -1052,34 +1104,34 @@ static PyObject *client_delete(PyObject *self, PyObject *args)
     }
 
 #if ONLY_SINCE_SVN(1, 7)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_delete4(
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_delete4(
         apr_paths, force, keep_local, hash_revprops, py_commit_callback2, callback, client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_delete3(
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_delete3(
         &commit_info, apr_paths, force, keep_local, hash_revprops, client->client, temp_pool));
 #else
     if (hash_revprops != NULL) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "revprops not supported against svn 1.4");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     if (keep_local) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "keep_local not supported against svn 1.4");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_delete2(
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_delete2(
         &commit_info, apr_paths, force, client->client, temp_pool));
 #endif
 
 #if ONLY_BEFORE_SVN(1, 7)
-    INVOKE_COMMIT_CALLBACK(temp_pool, commit_info, callback);
+    INVOKE_COMMIT_CALLBACK(&client->scratch, temp_pool, commit_info, callback);
 #endif
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     Py_RETURN_NONE;
 }
@@ -1101,16 +1153,16 @@ static PyObject *client_mkdir(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|bOO", kwnames, &paths, &make_parents, &revprops, &callback))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
     if (!client_list_to_apr_array(temp_pool, paths, py_object_to_svn_path_or_url, &apr_paths)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     if (revprops != NULL && !PyDict_Check(revprops)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         PyErr_SetString(PyExc_TypeError, "Expected dictionary with revision properties");
         return NULL;
     }
@@ -1119,7 +1171,7 @@ static PyObject *client_mkdir(PyObject *self, PyObject *args, PyObject *kwargs)
     if (revprops != NULL && revprops != Py_None) {
         hash_revprops = prop_dict_to_hash(temp_pool, revprops);
         if (hash_revprops == NULL) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             return NULL;
         }
     } else {
@@ -1127,11 +1179,11 @@ static PyObject *client_mkdir(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
 #if ONLY_SINCE_SVN(1, 7)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_mkdir4(apr_paths,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_mkdir4(apr_paths,
                 make_parents?TRUE:FALSE, hash_revprops, py_commit_callback2, callback,
                 client->client, temp_pool));
 #else
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_mkdir3(&commit_info,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_mkdir3(&commit_info,
                                                     apr_paths,
                 make_parents?TRUE:FALSE, hash_revprops, client->client, temp_pool));
 #endif
@@ -1139,26 +1191,26 @@ static PyObject *client_mkdir(PyObject *self, PyObject *args, PyObject *kwargs)
     if (make_parents) {
         PyErr_SetString(PyExc_ValueError,
                         "make_parents not supported against svn 1.4");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     if (revprops != Py_None) {
         PyErr_SetString(PyExc_ValueError,
                         "revprops not supported against svn 1.4");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_mkdir2(&commit_info,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_mkdir2(&commit_info,
                                                     apr_paths,
                 client->client, temp_pool));
 #endif
 
 #if ONLY_BEFORE_SVN(1, 7)
-    INVOKE_COMMIT_CALLBACK(temp_pool, commit_info, callback);
+    INVOKE_COMMIT_CALLBACK(&client->scratch, temp_pool, commit_info, callback);
 #endif
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     Py_RETURN_NONE;
 }
@@ -1201,14 +1253,14 @@ static PyObject *client_copy(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     if (!to_opt_revision(src_rev, &c_src_rev))
         return NULL;
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
     if (py_revprops != Py_None) {
         revprops = prop_dict_to_hash(temp_pool, py_revprops);
         if (revprops == NULL) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             return NULL;
         }
     } else {
@@ -1219,19 +1271,19 @@ static PyObject *client_copy(PyObject *self, PyObject *args, PyObject *kwargs)
     if (copy_as_child) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "copy_as_child not supported in svn < 1.4");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     if (make_parents) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "make_parents not supported in svn < 1.4");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     if (revprops) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "revprops not supported in svn < 1.4");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 #endif
@@ -1239,7 +1291,7 @@ static PyObject *client_copy(PyObject *self, PyObject *args, PyObject *kwargs)
     if (ignore_externals) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "ignore_externals not supported in svn < 1.5");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 #endif
@@ -1247,13 +1299,13 @@ static PyObject *client_copy(PyObject *self, PyObject *args, PyObject *kwargs)
     if (metadata_only) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "metadata_only not supported in svn < 1.9");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     if (pin_externals) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "pin_externals not supported in svn < 1.9");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     // TODO(jelmer): Set pinned_externals
@@ -1264,38 +1316,38 @@ static PyObject *client_copy(PyObject *self, PyObject *args, PyObject *kwargs)
     src_paths = apr_array_make(temp_pool, 1, sizeof(svn_client_copy_source_t *));
     if (src_paths == NULL) {
         PyErr_NoMemory();
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     APR_ARRAY_PUSH(src_paths, svn_client_copy_source_t *) = &src;
 #endif
 #if ONLY_SINCE_SVN(1, 9)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_copy7(src_paths,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_copy7(src_paths,
                 dst_path, copy_as_child, make_parents,
                 ignore_externals, metadata_only, pin_externals,
                 pinned_externals, revprops, py_commit_callback2,
                 callback, client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 7)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_copy6(src_paths,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_copy6(src_paths,
                 dst_path, copy_as_child, make_parents,
                 ignore_externals, revprops, py_commit_callback2, callback,
                 client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 6)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_copy5(&commit_info, src_paths,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_copy5(&commit_info, src_paths,
                 dst_path, copy_as_child, make_parents,
                 ignore_externals, revprops, client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_copy4(&commit_info, src_paths,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_copy4(&commit_info, src_paths,
                 dst_path, copy_as_child, make_parents,
                 revprops, client->client, temp_pool));
 #else
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_copy2(&commit_info, src_path,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_copy2(&commit_info, src_path,
                 &c_src_rev, dst_path, client->client, temp_pool));
 #endif
 #if ONLY_BEFORE_SVN(1, 7)
-    INVOKE_COMMIT_CALLBACK(temp_pool, commit_info, callback);
+    INVOKE_COMMIT_CALLBACK(&client->scratch, temp_pool, commit_info, callback);
 #endif
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     Py_RETURN_NONE;
 }
@@ -1324,14 +1376,14 @@ static PyObject *client_propset(PyObject *self, PyObject *args)
 
     c_propval.len = vallen;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
     if (py_revprops != Py_None) {
         revprops = prop_dict_to_hash(temp_pool, py_revprops);
         if (revprops == NULL) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             return NULL;
         }
     } else {
@@ -1341,7 +1393,7 @@ static PyObject *client_propset(PyObject *self, PyObject *args)
 #if ONLY_SINCE_SVN(1, 5)
     /* FIXME: Support changelists */
     /* FIXME: Support depth */
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_propset3(&commit_info, propname,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_propset3(&commit_info, propname,
                 &c_propval, target, recurse?svn_depth_infinity:svn_depth_files,
                 skip_checks, base_revision_for_url,
                 NULL, revprops, client->client, temp_pool));
@@ -1350,15 +1402,15 @@ static PyObject *client_propset(PyObject *self, PyObject *args)
     if (revprops) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "revprops not supported with svn < 1.5");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_propset2(propname, &c_propval,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_propset2(propname, &c_propval,
                 target, recurse, skip_checks, client->client, temp_pool));
     ret = Py_None;
     Py_INCREF(ret);
 #endif
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     return ret;
 }
 
@@ -1383,12 +1435,12 @@ static PyObject *client_propget(PyObject *self, PyObject *args)
         return NULL;
     if (!to_opt_revision(revision, &c_rev))
         return NULL;
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
     target = py_object_to_svn_abspath(py_target, temp_pool);
     if (target == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 #if ONLY_SINCE_SVN(1, 8)
@@ -1396,7 +1448,7 @@ static PyObject *client_propget(PyObject *self, PyObject *args)
     /* FIXME: Support actual_revnum */
     /* FIXME: Support depth properly */
     /* FIXME: Support inherited_props */
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_propget5(&hash_props, NULL,
                                           propname, target,
                 &c_peg_rev, &c_rev, NULL, recurse?svn_depth_infinity:svn_depth_files,
@@ -1405,17 +1457,17 @@ static PyObject *client_propget(PyObject *self, PyObject *args)
     /* FIXME: Support changelists */
     /* FIXME: Support actual_revnum */
     /* FIXME: Support depth properly */
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_propget3(&hash_props, propname, target,
                 &c_peg_rev, &c_rev, NULL, recurse?svn_depth_infinity:svn_depth_files,
                 NULL, client->client, temp_pool));
 #else
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_propget2(&hash_props, propname, target,
                 &c_peg_rev, &c_rev, recurse, client->client, temp_pool));
 #endif
     ret = prop_hash_to_dict(hash_props);
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     return ret;
 }
 
@@ -1439,33 +1491,33 @@ static PyObject *client_proplist(PyObject *self, PyObject *args,
         return NULL;
     if (!to_opt_revision(revision, &c_rev))
         return NULL;
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
     prop_list = PyList_New(0);
     if (prop_list == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
 #if ONLY_SINCE_SVN(1, 8)
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_proplist4(target, &c_peg_rev, &c_rev,
                                            depth, NULL,
                                            false, /* TODO(jelmer): Support get_target_inherited_props */
                                            proplist_receiver2, prop_list,
                                            client->client, temp_pool));
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_proplist3(target, &c_peg_rev, &c_rev,
                                            depth, NULL,
                                            proplist_receiver, prop_list,
                                            client->client, temp_pool));
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 #else
     {
         apr_array_header_t *props;
@@ -1475,12 +1527,12 @@ static PyObject *client_proplist(PyObject *self, PyObject *args,
     if (depth != svn_depth_infinity && depth != svn_depth_empty) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "depth can only be infinity or empty when built against svn < 1.5");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
 
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_proplist2(&props, target, &c_peg_rev, &c_rev,
                                            (depth == svn_depth_infinity),
                                            client->client, temp_pool));
@@ -1493,20 +1545,20 @@ static PyObject *client_proplist(PyObject *self, PyObject *args,
 
         prop_dict = prop_hash_to_dict(item->prop_hash);
         if (prop_dict == NULL) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             Py_DECREF(prop_list);
             return NULL;
         }
 
         value = Py_BuildValue("(sO)", item->node_name, prop_dict);
         if (value == NULL) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             Py_DECREF(prop_list);
             Py_DECREF(prop_dict);
             return NULL;
         }
         if (PyList_Append(prop_list, value) != 0) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             Py_DECREF(prop_list);
             Py_DECREF(prop_dict);
             Py_DECREF(value);
@@ -1515,7 +1567,7 @@ static PyObject *client_proplist(PyObject *self, PyObject *args,
         Py_DECREF(value);
     }
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     }
 #endif
@@ -1535,13 +1587,13 @@ static PyObject *client_resolve(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "sii", &path, &depth, &choice))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_resolve(path, depth, choice,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_resolve(path, depth, choice,
             client->client, temp_pool));
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     Py_RETURN_NONE;
 #else
@@ -1580,11 +1632,11 @@ static PyObject *client_update(PyObject *self, PyObject *args, PyObject *kwargs)
 
     if (!to_opt_revision(rev, &c_rev))
         return NULL;
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
     if (!client_list_to_apr_array(temp_pool, paths, py_object_to_svn_path_or_url, &apr_paths)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
@@ -1592,37 +1644,37 @@ static PyObject *client_update(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!adds_as_modification) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "!adds_as_modification not supported before svn 1.7");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     if (make_parents) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "make_parents not supported before svn 1.7");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 #endif
 
 #if ONLY_SINCE_SVN(1, 7)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_update4(&result_revs,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_update4(&result_revs,
         apr_paths, &c_rev, recurse?svn_depth_infinity:svn_depth_files,
         depth_is_sticky?TRUE:FALSE, ignore_externals, allow_unver_obstructions?TRUE:FALSE,
         adds_as_modification?TRUE:FALSE, make_parents?TRUE:FALSE,
         client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_update3(&result_revs,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_update3(&result_revs,
         apr_paths, &c_rev, recurse?svn_depth_infinity:svn_depth_files,
         depth_is_sticky?TRUE:FALSE, ignore_externals, allow_unver_obstructions?TRUE:FALSE,
         client->client, temp_pool));
 #else
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_update2(&result_revs,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_update2(&result_revs,
                                                     apr_paths, &c_rev,
                                                     recurse, ignore_externals, client->client, temp_pool));
 #endif
     ret = PyList_New(result_revs->nelts);
     if (ret == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     for (i = 0; i < result_revs->nelts; i++) {
@@ -1632,7 +1684,7 @@ static PyObject *client_update(PyObject *self, PyObject *args, PyObject *kwargs)
             return NULL;
         }
     }
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     return ret;
 }
 
@@ -1660,12 +1712,12 @@ static PyObject *client_list(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     if (!to_opt_revision(revision, &c_rev))
         return NULL;
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
     entry_dict = PyDict_New();
     if (entry_dict == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
@@ -1673,20 +1725,20 @@ static PyObject *client_list(PyObject *self, PyObject *args, PyObject *kwargs)
     if (include_externals) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "include_externals requires svn >= 1.8");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 #endif
 
 #if ONLY_SINCE_SVN(1, 8)
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_list3(path, &c_peg_rev, &c_rev,
                                        depth, dirents, false,
                                        include_externals,
                                        list_receiver2, entry_dict,
                                        client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_list2(path, &c_peg_rev, &c_rev,
                                        depth, dirents, false,
                                        list_receiver, entry_dict,
@@ -1695,18 +1747,18 @@ static PyObject *client_list(PyObject *self, PyObject *args, PyObject *kwargs)
     if (depth != svn_depth_infinity && depth != svn_depth_empty) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "depth can only be infinity or empty when built against svn < 1.5");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_list(path, &c_peg_rev, &c_rev,
                                        (depth == svn_depth_infinity)?TRUE:FALSE,
                                        dirents, false,
                                        list_receiver, entry_dict,
                                        client->client, temp_pool));
 #endif
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     return entry_dict;
 }
@@ -1746,7 +1798,7 @@ static PyObject *client_diff(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!to_opt_revision(rev1, &c_rev1) || !to_opt_revision(rev2, &c_rev2))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
@@ -1756,12 +1808,12 @@ static PyObject *client_diff(PyObject *self, PyObject *args, PyObject *kwargs)
         Py_INCREF(diffopts);
 
     if (diffopts == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     if (!string_list_to_apr_array(temp_pool, diffopts, &c_diffopts)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         Py_DECREF(diffopts);
         return NULL;
     }
@@ -1769,19 +1821,19 @@ static PyObject *client_diff(PyObject *self, PyObject *args, PyObject *kwargs)
 
     outfile = PyOS_tmpfile();
     if (outfile == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     errfile = PyOS_tmpfile();
     if (errfile == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         Py_DECREF(outfile);
         return NULL;
     }
 
     c_outfile = apr_file_from_object(outfile, temp_pool);
     if (c_outfile == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         Py_DECREF(outfile);
         Py_DECREF(errfile);
         return NULL;
@@ -1789,13 +1841,13 @@ static PyObject *client_diff(PyObject *self, PyObject *args, PyObject *kwargs)
 
     c_errfile = apr_file_from_object(errfile, temp_pool);
     if (c_errfile == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         Py_DECREF(outfile);
         Py_DECREF(errfile);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(temp_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool,
                       svn_client_diff4(c_diffopts,
                                        path1, &c_rev1, path2, &c_rev2,
                                        relative_to_dir, depth,
@@ -1809,7 +1861,7 @@ static PyObject *client_diff(PyObject *self, PyObject *args, PyObject *kwargs)
     offset = 0;
     apr_file_seek(c_errfile, APR_SET, &offset);
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     return Py_BuildValue("(NN)", outfile, errfile);
 #else
@@ -1856,7 +1908,7 @@ static PyObject *client_log(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!to_opt_revision(peg_revision, &c_peg_rev))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
@@ -1864,25 +1916,25 @@ static PyObject *client_log(PyObject *self, PyObject *args, PyObject *kwargs)
     if (include_merged_revisions) {
         PyErr_SetString(PyExc_NotImplementedError, 
                         "include_merged_revisions not supported in svn < 1.5");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     if (revprops) {
         PyErr_SetString(PyExc_NotImplementedError, 
                         "revprops not supported in svn < 1.5");
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 #endif
 
     if (!client_list_to_apr_array(temp_pool, paths, py_object_to_svn_path_or_url, &apr_paths)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
     if (revprops) {
         if (!string_list_to_apr_array(temp_pool, revprops, &apr_revprops)) {
-            apr_pool_destroy(temp_pool);
+            scratch_pool_release(&client->scratch, temp_pool);
             return NULL;
         }
     }
@@ -1893,38 +1945,147 @@ static PyObject *client_log(PyObject *self, PyObject *args, PyObject *kwargs)
 
     revision_ranges = apr_array_make(temp_pool, 1, sizeof(svn_opt_revision_range_t *));
     if (revision_ranges == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
     APR_ARRAY_PUSH(revision_ranges, svn_opt_revision_range_t *) = &revision_range;
 
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_log5(apr_paths, &c_peg_rev,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_log5(apr_paths, &c_peg_rev,
         revision_ranges, limit, discover_changed_paths?TRUE:FALSE,
         strict_node_history?TRUE:FALSE, include_merged_revisions?TRUE:FALSE, apr_revprops,
         py_svn_log_entry_receiver, (void*)callback,
         client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_log4(apr_paths, &c_peg_rev,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_log4(apr_paths, &c_peg_rev,
         &c_start_rev, &c_end_rev, limit, discover_changed_paths?TRUE:FALSE,
         strict_node_history?TRUE:FALSE, include_merged_revisions?TRUE:FALSE, apr_revprops,
         py_svn_log_entry_receiver, (void*)callback,
         client->client, temp_pool));
 #elif ONLY_SINCE_SVN(1, 4)
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_log3(apr_paths, &c_peg_rev,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_log3(apr_paths, &c_peg_rev,
         &c_start_rev, &c_end_rev, limit, discover_changed_paths?TRUE:FALSE,
         strict_node_history?TRUE:FALSE, py_svn_log_wrapper,
         (void*)callback, client->client, temp_pool));
 #else
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_log2(apr_paths, &c_start_rev,
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_log2(apr_paths, &c_start_rev,
         &c_end_rev, limit, discover_changed_paths?TRUE:FALSE, strict_node_history?TRUE:FALSE,
         py_svn_log_wrapper, (void*)callback,
         client->client, temp_pool));
 #endif
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
     Py_RETURN_NONE;
 }
 
+#if ONLY_SINCE_SVN(1, 7)
+static svn_error_t *py_blame_receiver(void *baton, svn_revnum_t start_revnum,
+                                      svn_revnum_t end_revnum,
+                                      apr_int64_t line_no,
+                                      svn_revnum_t revision,
+                                      apr_hash_t *rev_props,
+                                      svn_revnum_t merged_revision,
+                                      apr_hash_t *merged_rev_props,
+                                      const char *merged_path,
+                                      const char *line,
+                                      svn_boolean_t local_change,
+                                      apr_pool_t *pool)
+{
+    blame_t *blame = baton;
+    const svn_string_t *author = NULL;
+
+    if (rev_props != NULL)
+        author = apr_hash_get(rev_props, SVN_PROP_REVISION_AUTHOR,
+                              APR_HASH_KEY_STRING);
+    blame_append(blame, 1, revision,
+                 blame_author(blame, author == NULL?NULL:author->data));
+    return NULL;
+}
+#elif ONLY_SINCE_SVN(1, 5)
+static svn_error_t *py_blame_receiver(void *baton, apr_int64_t line_no,
+                                      svn_revnum_t revision,
+                                      const char *author, const char *date,
+                                      svn_revnum_t merged_revision,
+                                      const char *merged_author,
+                                      const char *merged_date,
+                                      const char *merged_path,
+                                      const char *line, apr_pool_t *pool)
+{
+    blame_t *blame = baton;
+
+    blame_append(blame, 1, revision, blame_author(blame, author));
+    return NULL;
+}
+#endif
+
+static PyObject *client_blame(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if ONLY_SINCE_SVN(1, 5)
+    ClientObject *client = (ClientObject *)self;
+    char *kwnames[] = { "path_or_url", "peg_revision", "start_rev", "end_rev",
+                        "ignore_mime_type", NULL };
+    PyObject *py_path, *peg_rev = Py_None, *start_rev = Py_None,
+             *end_rev = Py_None, *ret;
+    svn_opt_revision_t c_peg_rev, c_start_rev, c_end_rev;
+    bool ignore_mime_type = false;
+    const char *path;
+    apr_pool_t *temp_pool;
+    blame_t *blame;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OOOb", kwnames,
+                                     &py_path, &peg_rev, &start_rev, &end_rev,
+                                     &ignore_mime_type))
+        return NULL;
+
+    if (!to_opt_revision(peg_rev, &c_peg_rev))
+        return NULL;
+    if (start_rev == Py_None) {
+        c_start_rev.kind = svn_opt_revision_number;
+        c_start_rev.value.number = 0;
+    } else if (!to_opt_revision(start_rev, &c_start_rev)) {
+        return NULL;
+    }
+    if (end_rev == Py_None) {
+        c_end_rev = c_peg_rev;
+        if (c_end_rev.kind == svn_opt_revision_unspecified)
+            c_end_rev.kind = svn_opt_revision_head;
+    } else if (!to_opt_revision(end_rev, &c_end_rev)) {
+        return NULL;
+    }
+
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
+    if (temp_pool == NULL)
+        return NULL;
+
+    path = py_object_to_svn_path_or_url(py_path, temp_pool);
+    if (path == NULL) {
+        scratch_pool_release(&client->scratch, temp_pool);
+        return NULL;
+    }
+
+    blame = blame_create(temp_pool);
+
+#if ONLY_SINCE_SVN(1, 7)
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_blame5(
+        path, &c_peg_rev, &c_start_rev, &c_end_rev,
+        svn_diff_file_options_create(temp_pool), ignore_mime_type, FALSE,
+        py_blame_receiver, blame, client->client, temp_pool));
+#else
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_blame4(
+        path, &c_peg_rev, &c_start_rev, &c_end_rev,
+        svn_diff_file_options_create(temp_pool), ignore_mime_type, FALSE,
+        py_blame_receiver, blame, client->client, temp_pool));
+#endif
+
+    ret = blame_to_python(blame);
+    scratch_pool_release(&client->scratch, temp_pool);
+    return ret;
+#else
+    PyErr_SetString(PyExc_NotImplementedError,
+                    "blame is only supported in Subversion >= 1.5");
+    return NULL;
+#endif
+}
+
 static PyObject *client_info(PyObject *self, PyObject *args, PyObject *kwargs)
 {
     char *kwnames[] = {
@@ -1965,13 +2126,13 @@ static PyObject *client_info(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 #endif
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
     entry_dict = PyDict_New();
     if (entry_dict == NULL) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
@@ -1999,12 +2160,12 @@ static PyObject *client_info(PyObject *self, PyObject *args, PyObject *kwargs)
     if (err != NULL) {
         handle_svn_error(err);
         svn_error_clear(err);
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         Py_DECREF(entry_dict);
         return NULL;
     }
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     return entry_dict;
 }
@@ -2026,18 +2187,18 @@ static PyObject *client_lock(PyObject *self, PyObject *args, PyObject *kwargs)
                                      &py_targets, &comment, &steal_lock))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
     if (!client_list_to_apr_array(temp_pool, py_targets, py_object_to_svn_path_or_url, &targets)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_lock(targets, comment, steal_lock, client->client, temp_pool));
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_lock(targets, comment, steal_lock, client->client, temp_pool));
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     Py_RETURN_NONE;
 }
@@ -2058,18 +2219,18 @@ static PyObject *client_unlock(PyObject *self, PyObject *args, PyObject *kwargs)
                                      &py_targets, &break_lock))
         return NULL;
 
-    temp_pool = Pool(NULL);
+    temp_pool = scratch_pool_acquire(&client->scratch, client->pool);
     if (temp_pool == NULL)
         return NULL;
 
     if (!client_list_to_apr_array(temp_pool, py_targets, py_object_to_svn_path_or_url, &targets)) {
-        apr_pool_destroy(temp_pool);
+        scratch_pool_release(&client->scratch, temp_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(temp_pool, svn_client_unlock(targets, break_lock, client->client, temp_pool));
+    RUN_SVN_WITH_SCRATCH_POOL(&client->scratch, temp_pool, svn_client_unlock(targets, break_lock, client->client, temp_pool));
 
-    apr_pool_destroy(temp_pool);
+    scratch_pool_release(&client->scratch, temp_pool);
 
     Py_RETURN_NONE;
 }
@@ -2096,6 +2257,12 @@ static PyMethodDef client_methods[] = {
     { "mkdir", (PyCFunction)client_mkdir, METH_VARARGS|METH_KEYWORDS, "S.mkdir(paths, make_parents=False, revprops=None, callback=None)" },
     { "log", (PyCFunction)client_log, METH_VARARGS|METH_KEYWORDS,
         "S.log(callback, paths, start_rev=None, end_rev=None, limit=0, peg_revision=None, discover_changed_paths=False, strict_node_history=False, include_merged_revisions=False, revprops=None)" },
+    { "blame", (PyCFunction)client_blame, METH_VARARGS|METH_KEYWORDS,
+        "S.blame(path_or_url, peg_revision=None, start_rev=None, end_rev=None, ignore_mime_type=False) -> (revisions, author_indices, authors)\n"
+        "Annotate each line with the revision it was last changed in.\n"
+        "revisions and author_indices are arrays with an entry per line;\n"
+        "author_indices are indexes into the authors list, or -1 for\n"
+        "revisions without an author." },
     { "info", (PyCFunction)client_info, METH_VARARGS|METH_KEYWORDS,
         "S.info(path, revision=None, peg_revision=None, depth=DEPTH_EMPTY) -> dict of info entries" },
     { "lock", (PyCFunction)client_lock, METH_VARARGS,
@@ -2108,6 +2275,14 @@ static PyMethodDef client_methods[] = {
 static PyGetSetDef client_getset[] = {
     { "log_msg_func", client_get_log_msg_func, client_set_log_msg_func, NULL },
     { "notify_func", client_get_notify_func, client_set_notify_func, NULL },
+    { "progress_func", client_get_progress_func, client_set_progress_func,
+        "Called with (progress, total) as data is transferred." },
+    { "progress_interval", client_get_progress_interval,
+        client_set_progress_interval,
+        "Minimum number of seconds between calls to progress_func." },
+    { "progress_min_bytes", client_get_progress_min_bytes,
+        client_set_progress_min_bytes,
+        "Minimum number of bytes transferred between calls to progress_func." },
     { "auth", NULL, client_set_auth, NULL },
     { "config", NULL, client_set_config, NULL },
     { NULL, }
@@ -2156,7 +2331,7 @@ static void config_dealloc(PyObject *obj)
     apr_pool_t *pool = ((ConfigObject *)obj)->pool;
     if (pool != NULL)
         apr_pool_destroy(pool);
-    PyObject_Del(obj);
+    py_object_del(obj);
 }
 
 PyTypeObject Config_Type = {
@@ -2224,7 +2399,7 @@ static void configitem_dealloc(PyObject *self)
     ConfigItemObject *item = (ConfigItemObject *)self;
 
     Py_XDECREF(item->parent);
-    PyObject_Del(item);
+    py_object_del(item);
 }
 
 PyTypeObject ConfigItem_Type = {
@@ -2243,7 +2418,7 @@ static void info_dealloc(PyObject *self)
     apr_pool_t *pool = ((InfoObject *)self)->pool;
     if (pool != NULL)
         apr_pool_destroy(pool);
-    PyObject_Del(self);
+    py_object_del(self);
 }
 
 static PyMemberDef info_members[] = {
@@ -2378,7 +2553,7 @@ static PyMemberDef wc_info_members[] = {
 
 static void wcinfo_dealloc(PyObject *self)
 {
-    PyObject_Del(self);
+    py_object_del(self);
 }
 
 PyTypeObject WCInfo_Type = {
@@ -2523,13 +2698,13 @@ static PyObject *get_config(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "|z", &config_dir))
         return NULL;
 
-    data = PyObject_New(ConfigObject, &Config_Type);
+    data = PyObject_New(ConfigObject, SUBVERTPY_TYPE(Config_Type));
     if (data == NULL)
         return NULL;
 
     data->pool = Pool(NULL);
     if (data->pool == NULL) {
-        PyObject_Del(data);
+        py_object_del(data);
         return NULL;
     }
 
@@ -2573,6 +2748,11 @@ static PyMethodDef client_mod_methods[] = {
         "api_version() -> (major, minor, patch, tag)\n\n"
         "Version of libsvn_client Subvertpy was compiled against."
     },
+    { "pool_stats", (PyCFunction)py_pool_stats, METH_NOARGS,
+        "pool_stats() -> dict\n\n"
+        "Counts of APR pools created, currently live, live at the same time\n"
+        "at most and reused as scratch pools by this module." },
+    STATS_METHODS,
     { "version", (PyCFunction)version, METH_NOARGS,
         "version() -> (major, minor, patch, tag)\n\n"
         "Version of libsvn_wc currently used."
@@ -2580,50 +2760,48 @@ static PyMethodDef client_mod_methods[] = {
     { NULL }
 };
 
-static PyObject *
-moduleinit(void)
+static const subvertpy_type_def_t client_types[] = {
+    { Config_Type_ID, &Config_Type },
+    { ConfigItem_Type_ID, &ConfigItem_Type },
+    { Info_Type_ID, &Info_Type },
+    { WCInfo_Type_ID, &WCInfo_Type },
+    { Client_Type_ID, &Client_Type },
+    { 0, NULL }
+};
+
+static int client_exec(PyObject *mod)
 {
-    PyObject *mod;
+    if (subvertpy_state_init(mod) < 0)
+        return -1;
 
-    if (PyType_Ready(&Client_Type) < 0)
-        return NULL;
+    /* The remote access and working copy code is linked in as well. */
+    if (subvertpy_add_types(mod, util_types) < 0)
+        return -1;
 
-    if (PyType_Ready(&Config_Type) < 0)
-        return NULL;
+    if (subvertpy_add_types(mod, editor_types) < 0)
+        return -1;
 
-    if (PyType_Ready(&ConfigItem_Type) < 0)
-        return NULL;
+    if (mergeinfo_api_import() < 0)
+        return -1;
 
-    if (PyType_Ready(&Info_Type) < 0)
-        return NULL;
+    if (subvertpy_add_types(mod, ra_types) < 0)
+        return -1;
 
-    if (PyType_Ready(&WCInfo_Type) < 0)
-        return NULL;
+    if (subvertpy_add_types(mod, wc_types) < 0)
+        return -1;
 
-    /* Make sure APR is initialized */
-    apr_initialize();
+    if (subvertpy_add_types(mod, wc_adm_types) < 0)
+        return -1;
 
-#if PY_MAJOR_VERSION >= 3
-    static struct PyModuleDef moduledef = {
-      PyModuleDef_HEAD_INIT,
-      "client",         /* m_name */
-      "Client methods",            /* m_doc */
-      -1,              /* m_size */
-      client_mod_methods, /* m_methods */
-      NULL,            /* m_reload */
-      NULL,            /* m_traverse */
-      NULL,            /* m_clear*/
-      NULL,            /* m_free */
-    };
-    mod = PyModule_Create(&moduledef);
-#else
-    mod = Py_InitModule3("client", client_mod_methods, "Client methods");
-#endif
-    if (mod == NULL)
-        return NULL;
+    if (subvertpy_add_types(mod, client_types) < 0)
+        return -1;
 
-    Py_INCREF(&Client_Type);
-    PyModule_AddObject(mod, "Client", (PyObject *)&Client_Type);
+    /* Make sure APR is initialized */
+    if (!subvertpy_global_init(NULL))
+        return -1;
+
+    Py_INCREF(SUBVERTPY_TYPE(Client_Type));
+    PyModule_AddObject(mod, "Client", (PyObject *)SUBVERTPY_TYPE(Client_Type));
 
     PyModule_AddObject(mod, "depth_empty",
                        (PyObject *)PyLong_FromLong(svn_depth_empty));
@@ -2634,22 +2812,60 @@ moduleinit(void)
     PyModule_AddObject(mod, "depth_infinity",
                        (PyObject *)PyLong_FromLong(svn_depth_infinity));
 
-    Py_INCREF(&Config_Type);
-    PyModule_AddObject(mod, "Config", (PyObject *)&Config_Type);
+    Py_INCREF(SUBVERTPY_TYPE(Config_Type));
+    PyModule_AddObject(mod, "Config", (PyObject *)SUBVERTPY_TYPE(Config_Type));
 
-    return mod;
+    return 0;
 }
 
+#if PY_VERSION_HEX >= 0x03050000
+static PyModuleDef_Slot client_module_slots[] = {
+    { Py_mod_exec, client_exec },
+    SUBVERTPY_MODULE_SLOTS
+    { 0, NULL }
+};
+#endif
+
 #if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef moduledef = {
+    PyModuleDef_HEAD_INIT,
+    "client",         /* m_name */
+    "Client methods",            /* m_doc */
+    SUBVERTPY_STATE_SIZE,              /* m_size */
+    client_mod_methods, /* m_methods */
+#if PY_VERSION_HEX >= 0x03050000
+    client_module_slots, /* m_slots */
+#else
+    NULL,            /* m_reload */
+#endif
+    subvertpy_state_traverse, /* m_traverse */
+    subvertpy_state_clear, /* m_clear*/
+    subvertpy_state_free, /* m_free */
+};
+#endif
+
+#if PY_VERSION_HEX >= 0x03050000
+PyMODINIT_FUNC
+PyInit_client(void)
+{
+    return PyModuleDef_Init(&moduledef);
+}
+#elif PY_MAJOR_VERSION >= 3
 PyMODINIT_FUNC
 PyInit_client(void)
 {
-    return moduleinit();
+    PyObject *mod = PyModule_Create(&moduledef);
+    if (mod != NULL && client_exec(mod) < 0)
+        Py_CLEAR(mod);
+    return mod;
 }
 #else
 PyMODINIT_FUNC
 initclient(void)
 {
-    moduleinit();
+    PyObject *mod = Py_InitModule3("client", client_mod_methods,
+                                   "Client methods");
+    if (mod != NULL)
+        client_exec(mod);
 }
 #endif
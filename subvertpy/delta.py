@@ -214,11 +214,14 @@ def unpack_svndiff_instruction(text):
 SVNDIFF0_HEADER = b"SVN\0"
 
 
-def pack_svndiff0_window(window):
-    """Pack an individual window using svndiff0.
+def pack_svndiff0_window_header(window):
+    """Pack all of an individual window but its new data using svndiff0.
+
+    The packed window is the returned header followed by the new data,
+    which can thus be written out without copying it.
 
     :param window: Window to pack
-    :return: Packed diff (as bytestring)
+    :return: Packed header (as bytearray)
     """
     (sview_offset, sview_len, tview_len, src_ops, ops, new_data) = window
     ret = (encode_length(sview_offset) +
@@ -232,7 +235,17 @@ def pack_svndiff0_window(window):
     ret.extend(encode_length(len(instrdata)))
     ret.extend(encode_length(len(new_data)))
     ret.extend(instrdata)
-    ret.extend(new_data)
+    return ret
+
+
+def pack_svndiff0_window(window):
+    """Pack an individual window using svndiff0.
+
+    :param window: Window to pack
+    :return: Packed diff (as bytestring)
+    """
+    ret = pack_svndiff0_window_header(window)
+    ret.extend(window[5])
     return ret
 
 
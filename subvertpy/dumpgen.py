@@ -0,0 +1,393 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Generator for synthetic repositories.
+
+Writes a dumpfile stream (format version 2) for a repository with a
+configurable shape and loads it with ``Repository.load_fs``, which is
+much faster than creating the revisions through a commit editor.
+
+The repository has the usual trunk/branches/tags layout. Revision 1
+creates a tree below trunk with ``fanout`` subdirectories per directory,
+``depth`` levels deep, and ``files_per_dir`` files in every directory at
+the bottom. Every later revision then does one of:
+
+ * copy trunk to a new branch (``copy_rate``)
+ * rename a file in trunk (``rename_rate``)
+ * cherry-pick trunk revisions into a branch, recorded only as
+   ``svn:mergeinfo`` (``mergeinfo_rate``)
+ * change ``changes_per_revision`` files in trunk, adding a new file with
+   probability ``add_rate``
+
+File sizes follow a log-normal distribution around ``file_size``; a
+fraction ``binary_rate`` of the files is binary. All choices come from
+a seeded random number generator, so the same parameters always produce
+the same repository.
+
+The contents of the files in trunk are kept in memory while generating.
+"""
+
+__docformat__ = "restructuredText"
+
+import base64
+import binascii
+import hashlib
+import math
+import posixpath
+import random
+import time
+import uuid
+
+from subvertpy import repos
+
+EPOCH = 946684800  # 2000-01-01T00:00:00Z
+SECONDS_PER_REVISION = 600
+
+
+def _random_bytes(rnd, n):
+    if n <= 0:
+        return b""
+    value = rnd.getrandbits(8 * n)
+    try:
+        return value.to_bytes(n, "little")
+    except AttributeError:
+        return binascii.unhexlify("%0*x" % (2 * n, value))
+
+
+def _props(props):
+    """Serialize a property block."""
+    ret = []
+    for name in sorted(props):
+        value = props[name]
+        ret.append(b"K " + str(len(name)).encode("ascii") + b"\n" + name +
+                   b"\n")
+        ret.append(b"V " + str(len(value)).encode("ascii") + b"\n" + value +
+                   b"\n")
+    ret.append(b"PROPS-END\n")
+    return b"".join(ret)
+
+
+def _headers(headers):
+    return b"".join(
+        name + b": " + value + b"\n" for (name, value) in headers)
+
+
+def _node(path, kind=None, action=b"add", props=None, text=None,
+          copyfrom=None):
+    """Serialize a node record."""
+    headers = [(b"Node-path", path)]
+    if kind is not None:
+        headers.append((b"Node-kind", kind))
+    headers.append((b"Node-action", action))
+    if copyfrom is not None:
+        headers.append((b"Node-copyfrom-rev",
+                        str(copyfrom[1]).encode("ascii")))
+        headers.append((b"Node-copyfrom-path", copyfrom[0]))
+    content = b""
+    if props is not None:
+        prop_block = _props(props)
+        headers.append((b"Prop-content-length",
+                        str(len(prop_block)).encode("ascii")))
+        content += prop_block
+    if text is not None:
+        headers.append((b"Text-content-length",
+                        str(len(text)).encode("ascii")))
+        headers.append((b"Text-content-md5",
+                        hashlib.md5(text).hexdigest().encode("ascii")))
+        content += text
+    if props is not None or text is not None:
+        headers.append((b"Content-length",
+                        str(len(content)).encode("ascii")))
+    return _headers(headers) + b"\n" + content + b"\n\n"
+
+
+def _revision(revnum, props):
+    prop_block = _props(props)
+    length = str(len(prop_block)).encode("ascii")
+    return _headers([
+        (b"Revision-number", str(revnum).encode("ascii")),
+        (b"Prop-content-length", length),
+        (b"Content-length", length)]) + b"\n" + prop_block + b"\n"
+
+
+def _format_ranges(revnums):
+    """Format a set of revision numbers as a mergeinfo range list."""
+    ranges = []
+    for revnum in sorted(revnums):
+        if ranges and ranges[-1][1] == revnum - 1:
+            ranges[-1][1] = revnum
+        else:
+            ranges.append([revnum, revnum])
+    return ",".join(
+        "%d" % start if start == end else "%d-%d" % (start, end)
+        for (start, end) in ranges)
+
+
+class DumpGenerator(object):
+    """Generator of a synthetic dumpfile.
+
+    :param revisions: Number of revisions, not counting revision 0
+    :param fanout: Number of subdirectories per directory in trunk
+    :param depth: Number of directory levels in trunk
+    :param files_per_dir: Number of files per directory at the bottom
+    :param file_size: Median file size, in bytes
+    :param file_size_sigma: Spread of the log-normal file size distribution
+    :param max_file_size: Maximum file size, in bytes
+    :param binary_rate: Fraction of the files that is binary
+    :param changes_per_revision: Number of files changed per revision
+    :param add_rate: Probability that a revision adds a file
+    :param copy_rate: Probability that a revision creates a branch
+    :param rename_rate: Probability that a revision renames a file
+    :param mergeinfo_rate: Probability that a revision merges into a branch
+    :param mergeinfo_density: Number of trunk revisions picked per merge;
+        they are chosen at random, so mergeinfo grows fragmented
+    :param authors: Number of distinct authors
+    :param seed: Seed for the random number generator
+    """
+
+    def __init__(self, revisions=1000, fanout=4, depth=3, files_per_dir=4,
+                 file_size=4096, file_size_sigma=1.0,
+                 max_file_size=16 * 1024 * 1024, binary_rate=0.05,
+                 changes_per_revision=3, add_rate=0.1, copy_rate=0.01,
+                 rename_rate=0.02, mergeinfo_rate=0.05, mergeinfo_density=5,
+                 authors=10, seed=0):
+        if fanout < 1 or depth < 0 or files_per_dir < 1:
+            raise ValueError("tree should contain at least one file")
+        self.revisions = revisions
+        self.fanout = fanout
+        self.depth = depth
+        self.files_per_dir = files_per_dir
+        self.file_size = file_size
+        self.file_size_sigma = file_size_sigma
+        self.max_file_size = max_file_size
+        self.binary_rate = binary_rate
+        self.changes_per_revision = changes_per_revision
+        self.add_rate = add_rate
+        self.copy_rate = copy_rate
+        self.rename_rate = rename_rate
+        self.mergeinfo_rate = mergeinfo_rate
+        self.mergeinfo_density = mergeinfo_density
+        self.authors = authors
+        self.seed = seed
+
+    def _size(self, rnd):
+        size = int(rnd.lognormvariate(math.log(max(self.file_size, 1)),
+                                      self.file_size_sigma))
+        return min(size, self.max_file_size)
+
+    def _text(self, rnd, size):
+        """Create a text file of roughly size bytes."""
+        return base64.b64encode(_random_bytes(rnd, size * 3 // 4))
+
+    def _new_file(self, rnd, path):
+        """Create the contents and properties of a new file."""
+        if rnd.random() < self.binary_rate:
+            self._binary.add(path)
+            return (_random_bytes(rnd, self._size(rnd)),
+                    {b"svn:mime-type": b"application/octet-stream"})
+        return (self._wrap(self._text(rnd, self._size(rnd))), {})
+
+    def _wrap(self, text):
+        return b"\n".join(text[i:i+76] for i in range(0, len(text), 76))
+
+    def _change_file(self, rnd, path):
+        """Change part of a file."""
+        text = self._files[path]
+        if path in self._binary:
+            new = _random_bytes(rnd, max(1, len(text) // 10))
+        else:
+            new = self._text(rnd, max(76, len(text) // 10))
+        offset = rnd.randrange(len(text) + 1)
+        text = text[:offset] + new + text[offset + len(new):]
+        if path not in self._binary:
+            text = self._wrap(text.replace(b"\n", b""))
+        self._files[path] = text
+        return text
+
+    def _revprops(self, rnd, revnum, message):
+        date = time.strftime(
+            "%Y-%m-%dT%H:%M:%S.000000Z",
+            time.gmtime(EPOCH + revnum * SECONDS_PER_REVISION))
+        return {b"svn:author": ("user%d" % rnd.randrange(self.authors)
+                                ).encode("ascii"),
+                b"svn:date": date.encode("ascii"),
+                b"svn:log": message.encode("utf-8")}
+
+    def _initial_tree(self, rnd):
+        yield _node(b"trunk", b"dir", props={})
+        yield _node(b"branches", b"dir", props={})
+        yield _node(b"tags", b"dir", props={})
+        level = [b"trunk"]
+        for i in range(self.depth):
+            next_level = []
+            for parent in level:
+                for j in range(self.fanout):
+                    path = parent + ("/d%d" % j).encode("ascii")
+                    yield _node(path, b"dir", props={})
+                    next_level.append(path)
+            level = next_level
+        for parent in level:
+            self._dirs.append(parent)
+            for j in range(self.files_per_dir):
+                path = parent + ("/f%d" % j).encode("ascii")
+                (text, props) = self._new_file(rnd, path)
+                self._files[path] = text
+                self._paths.append(path)
+                yield _node(path, b"file", props=props, text=text)
+
+    def _branch(self, rnd, revnum):
+        name = ("branches/b%d" % revnum).encode("ascii")
+        self._branches[name] = set()
+        self._branch_names.append(name)
+        return ("Create branch %s" % name.decode("ascii"),
+                [_node(name, b"dir", copyfrom=(b"trunk", revnum - 1))])
+
+    def _rename(self, rnd, revnum):
+        idx = rnd.randrange(len(self._paths))
+        old = self._paths[idx]
+        new = (posixpath.dirname(old) +
+               ("/f%d" % revnum).encode("ascii"))
+        self._paths[idx] = new
+        self._files[new] = self._files.pop(old)
+        if old in self._binary:
+            self._binary.remove(old)
+            self._binary.add(new)
+        return ("Rename %s" % old.decode("ascii"),
+                [_node(new, b"file", copyfrom=(old, revnum - 1)),
+                 _node(old, action=b"delete")])
+
+    def _merge(self, rnd, revnum):
+        name = rnd.choice(self._branch_names)
+        merged = self._branches[name]
+        for i in range(self.mergeinfo_density):
+            if not self._trunk_revs:
+                break
+            merged.add(rnd.choice(self._trunk_revs))
+        mergeinfo = ("/trunk:%s" % _format_ranges(merged)).encode("ascii")
+        return ("Merge into %s" % name.decode("ascii"),
+                [_node(name, b"dir", action=b"change",
+                       props={b"svn:mergeinfo": mergeinfo})])
+
+    def _edit(self, rnd, revnum):
+        nodes = []
+        for path in sorted(rnd.sample(
+                self._paths, min(self.changes_per_revision,
+                                 len(self._paths)))):
+            nodes.append(_node(path, b"file", action=b"change",
+                               text=self._change_file(rnd, path)))
+        if rnd.random() < self.add_rate:
+            path = (rnd.choice(self._dirs) +
+                    ("/f%d" % revnum).encode("ascii"))
+            (text, props) = self._new_file(rnd, path)
+            self._files[path] = text
+            self._paths.append(path)
+            nodes.append(_node(path, b"file", props=props, text=text))
+        self._trunk_revs.append(revnum)
+        return ("Change %d files" % len(nodes), nodes)
+
+    def generate(self):
+        """Generate the dumpfile.
+
+        :return: Iterator over chunks of the dumpfile
+        """
+        rnd = random.Random(self.seed)
+        self._files = {}
+        self._paths = []
+        self._binary = set()
+        self._dirs = []
+        self._branches = {}
+        self._branch_names = []
+        self._trunk_revs = []
+
+        yield b"SVN-fs-dump-format-version: 2\n\n"
+        yield ("UUID: %s\n\n" % uuid.UUID(
+            int=rnd.getrandbits(128), version=4)).encode("ascii")
+        date = time.strftime("%Y-%m-%dT%H:%M:%S.000000Z",
+                             time.gmtime(EPOCH))
+        yield _revision(0, {b"svn:date": date.encode("ascii")})
+        if self.revisions < 1:
+            return
+
+        yield _revision(1, self._revprops(rnd, 1, "Initial import"))
+        for chunk in self._initial_tree(rnd):
+            yield chunk
+
+        for revnum in range(2, self.revisions + 1):
+            choice = rnd.random()
+            if choice < self.copy_rate:
+                (message, nodes) = self._branch(rnd, revnum)
+            elif choice < self.copy_rate + self.rename_rate:
+                (message, nodes) = self._rename(rnd, revnum)
+            elif (choice < self.copy_rate + self.rename_rate +
+                    self.mergeinfo_rate and self._branches):
+                (message, nodes) = self._merge(rnd, revnum)
+            else:
+                (message, nodes) = self._edit(rnd, revnum)
+            yield _revision(revnum, self._revprops(rnd, revnum, message))
+            for node in nodes:
+                yield node
+
+
+class DumpStream(object):
+    """Read-only file-like object over an iterator of byte strings."""
+
+    def __init__(self, chunks):
+        self._chunks = iter(chunks)
+        self._current = b""
+        self._offset = 0
+
+    def read(self, size=-1):
+        # Subversion takes a short read to mean the end of the stream, so
+        # always return size bytes unless the chunks have run out.
+        ret = []
+        while size != 0:
+            if self._offset >= len(self._current):
+                try:
+                    self._current = next(self._chunks)
+                except StopIteration:
+                    break
+                self._offset = 0
+                continue
+            if size < 0:
+                piece = self._current[self._offset:]
+            else:
+                piece = self._current[self._offset:self._offset + size]
+                size -= len(piece)
+            self._offset += len(piece)
+            ret.append(piece)
+        return b"".join(ret)
+
+
+class _NullStream(object):
+
+    def write(self, data):
+        pass
+
+
+def create_repository(path, feedback_stream=None, **kwargs):
+    """Create a synthetic repository.
+
+    :param path: Path to create the repository at
+    :param feedback_stream: Optional stream to write load progress to
+    :param kwargs: Parameters for ``DumpGenerator``
+    :return: The new ``repos.Repository``
+    """
+    generator = DumpGenerator(**kwargs)
+    r = repos.create(path)
+    if feedback_stream is None:
+        feedback_stream = _NullStream()
+    r.load_fs(DumpStream(generator.generate()), feedback_stream,
+              repos.LOAD_UUID_FORCE)
+    return r
@@ -24,6 +24,7 @@
 
 #include "editor.h"
 #include "util.h"
+#include "stats.h"
 
 typedef struct EditorObject {
 	PyObject_VAR_HEAD
@@ -76,7 +77,7 @@ static void py_editor_dealloc(PyObject *self)
 		apr_pool_destroy(editor->pool);
 		editor->pool = NULL;
 	}
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 /* paranoia check */
@@ -164,7 +165,7 @@ static PyObject *txdelta_call(PyObject *self, PyObject *args, PyObject *kwargs)
 
 static void py_txdelta_window_handler_dealloc(PyObject *self)
 {
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 PyTypeObject TxDeltaWindowHandler_Type = {
@@ -214,7 +215,7 @@ static PyObject *py_file_editor_apply_textdelta(PyObject *self, PyObject *args)
 	RUN_SVN(editor->editor->apply_textdelta(editor->baton,
 				c_base_checksum, editor->pool, 
 				&txdelta_handler, &txdelta_baton));
-	py_txdelta = PyObject_New(TxDeltaWindowHandlerObject, &TxDeltaWindowHandler_Type);
+	py_txdelta = PyObject_New(TxDeltaWindowHandlerObject, SUBVERTPY_TYPE(TxDeltaWindowHandler_Type));
 	py_txdelta->txdelta_handler = txdelta_handler;
 	py_txdelta->txdelta_baton = txdelta_baton;
 	return (PyObject *)py_txdelta;
@@ -440,7 +441,7 @@ static PyObject *py_dir_editor_add_directory(PyObject *self, PyObject *args)
 		return NULL;
 
 	return new_editor_object(editor, editor->editor, child_baton, subpool, 
-							 &DirectoryEditor_Type, NULL, NULL, NULL);
+							 SUBVERTPY_TYPE(DirectoryEditor_Type), NULL, NULL, NULL);
 }
 
 static PyObject *py_dir_editor_open_directory(PyObject *self, PyObject *args)
@@ -478,7 +479,7 @@ static PyObject *py_dir_editor_open_directory(PyObject *self, PyObject *args)
 		return NULL;
 
 	return new_editor_object(editor, editor->editor, child_baton, subpool,
-							 &DirectoryEditor_Type, NULL, NULL, NULL);
+							 SUBVERTPY_TYPE(DirectoryEditor_Type), NULL, NULL, NULL);
 }
 
 static PyObject *py_dir_editor_change_prop(PyObject *self, PyObject *args)
@@ -610,7 +611,7 @@ static PyObject *py_dir_editor_add_file(PyObject *self, PyObject *args)
 		return NULL;
 
 	return new_editor_object(editor, editor->editor, file_baton, subpool,
-							 &FileEditor_Type, NULL, NULL, NULL);
+							 SUBVERTPY_TYPE(FileEditor_Type), NULL, NULL, NULL);
 }
 
 static PyObject *py_dir_editor_open_file(PyObject *self, PyObject *args)
@@ -648,7 +649,7 @@ static PyObject *py_dir_editor_open_file(PyObject *self, PyObject *args)
 		return NULL;
 
 	return new_editor_object(editor, editor->editor, file_baton, subpool,
-							 &FileEditor_Type, NULL, NULL, NULL);
+							 SUBVERTPY_TYPE(FileEditor_Type), NULL, NULL, NULL);
 }
 
 static PyObject *py_dir_editor_absent_file(PyObject *self, PyObject *args)
@@ -834,7 +835,7 @@ static PyObject *py_editor_open_root(PyObject *self, PyObject *args)
 		return NULL;
 
 	return new_editor_object(editor, editor->editor, root_baton, subpool,
-							 &DirectoryEditor_Type, NULL, NULL, NULL);
+							 SUBVERTPY_TYPE(DirectoryEditor_Type), NULL, NULL, NULL);
 }
 
 static PyObject *py_editor_close(PyObject *self)
@@ -999,10 +1000,12 @@ static svn_error_t *py_cb_editor_set_target_revision(void *edit_baton, svn_revnu
 {
 	PyObject *self = (PyObject *)edit_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 
 	ret = PyObject_CallMethod(self, "set_target_revision", "l", target_revision);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1011,10 +1014,12 @@ static svn_error_t *py_cb_editor_open_root(void *edit_baton, svn_revnum_t base_r
 {
 	PyObject *self = (PyObject *)edit_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	*root_baton = NULL;
 	ret = PyObject_CallMethod(self, "open_root", "l", base_revision);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	*root_baton = (void *)ret;
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1023,9 +1028,11 @@ static svn_error_t *py_cb_editor_delete_entry(const char *path, svn_revnum_t rev
 {
 	PyObject *self = (PyObject *)parent_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "delete_entry", "sl", path, revision);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1034,6 +1041,7 @@ static svn_error_t *py_cb_editor_add_directory(const char *path, void *parent_ba
 {
 	PyObject *self = (PyObject *)parent_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	*child_baton = NULL;
 
 	if (copyfrom_path == NULL) {
@@ -1041,8 +1049,9 @@ static svn_error_t *py_cb_editor_add_directory(const char *path, void *parent_ba
 	} else {
 		ret = PyObject_CallMethod(self, "add_directory", "ssl", path, copyfrom_path, copyfrom_revision);
 	}
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	*child_baton = (void *)ret;
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1051,10 +1060,12 @@ static svn_error_t *py_cb_editor_open_directory(const char *path, void *parent_b
 {
 	PyObject *self = (PyObject *)parent_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	*child_baton = NULL;
 	ret = PyObject_CallMethod(self, "open_directory", "sl", path, base_revision);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	*child_baton = (void *)ret;
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1063,14 +1074,16 @@ static svn_error_t *py_cb_editor_change_prop(void *dir_baton, const char *name,
 {
 	PyObject *self = (PyObject *)dir_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 
 	if (value != NULL) {
 		ret = PyObject_CallMethod(self, "change_prop", "sz#", name, value->data, value->len);
 	} else {
 		ret = PyObject_CallMethod(self, "change_prop", "sO", name, Py_None);
 	}
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1079,10 +1092,12 @@ static svn_error_t *py_cb_editor_close_directory(void *dir_baton, apr_pool_t *po
 {
 	PyObject *self = (PyObject *)dir_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "close", "");
 	Py_DECREF(self);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1091,9 +1106,11 @@ static svn_error_t *py_cb_editor_absent_directory(const char *path, void *parent
 {
 	PyObject *self = (PyObject *)parent_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "absent_directory", "s", path);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1102,14 +1119,16 @@ static svn_error_t *py_cb_editor_add_file(const char *path, void *parent_baton,
 {
 	PyObject *self = (PyObject *)parent_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	if (copy_path == NULL) {
 		ret = PyObject_CallMethod(self, "add_file", "s", path);
 	} else {
 		ret = PyObject_CallMethod(self, "add_file", "ssl", path, copy_path, 
 								  copy_revision);
 	}
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	*file_baton = (void *)ret;
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1118,9 +1137,11 @@ static svn_error_t *py_cb_editor_open_file(const char *path, void *parent_baton,
 {
 	PyObject *self = (PyObject *)parent_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "open_file", "sl", path, base_revision);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	*file_baton = (void *)ret;
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1196,12 +1217,14 @@ static svn_error_t *py_cb_editor_apply_textdelta(void *file_baton, const char *b
 {
 	PyObject *self = (PyObject *)file_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	*handler_baton = NULL;
 
 	ret = PyObject_CallMethod(self, "apply_textdelta", "z", base_checksum);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	*handler_baton = (void *)ret;
 	*handler = py_txdelta_window_handler;
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1211,6 +1234,7 @@ static svn_error_t *py_cb_editor_close_file(void *file_baton,
 {
 	PyObject *self = (PyObject *)file_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 
 	if (text_checksum != NULL) {
 		ret = PyObject_CallMethod(self, "close", "");
@@ -1218,8 +1242,9 @@ static svn_error_t *py_cb_editor_close_file(void *file_baton,
 		ret = PyObject_CallMethod(self, "close", "s", text_checksum);
 	}
 	Py_DECREF(self);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1228,9 +1253,11 @@ static svn_error_t *py_cb_editor_absent_file(const char *path, void *parent_bato
 {
 	PyObject *self = (PyObject *)parent_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "absent_file", "s", path);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1239,10 +1266,12 @@ static svn_error_t *py_cb_editor_close_edit(void *edit_baton, apr_pool_t *pool)
 {
 	PyObject *self = (PyObject *)edit_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "close", "");
 	Py_DECREF(self);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1251,10 +1280,12 @@ static svn_error_t *py_cb_editor_abort_edit(void *edit_baton, apr_pool_t *pool)
 {
 	PyObject *self = (PyObject *)edit_baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "abort", "");
 	Py_DECREF(self);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -1278,4 +1309,136 @@ const svn_delta_editor_t py_editor = {
 	py_cb_editor_abort_edit
 };
 
+/*
+ * Editors that wrap a native editor are driven directly by libsvn rather
+ * than through py_editor. The edit baton is the EditorObject itself, so
+ * that it can be marked as closed (and its reference released, as
+ * py_editor does) once the edit is complete; everything below the root
+ * directory goes straight to the wrapped editor.
+ */
+
+static void native_editor_done(EditorObject *obj)
+{
+	obj->done = true;
+	apr_pool_destroy(obj->pool);
+	obj->pool = NULL;
+
+	if (obj->done_cb != NULL)
+		obj->done_cb(obj->done_baton);
+}
+
+static svn_error_t *native_editor_set_target_revision(void *edit_baton, svn_revnum_t target_revision, apr_pool_t *pool)
+{
+	EditorObject *obj = (EditorObject *)edit_baton;
+
+	return obj->editor->set_target_revision(obj->baton, target_revision,
+											pool);
+}
+
+static svn_error_t *native_editor_open_root(void *edit_baton, svn_revnum_t base_revision, apr_pool_t *pool, void **root_baton)
+{
+	EditorObject *obj = (EditorObject *)edit_baton;
+
+	return obj->editor->open_root(obj->baton, base_revision, pool,
+								  root_baton);
+}
+
+static svn_error_t *native_editor_close_edit(void *edit_baton, apr_pool_t *pool)
+{
+	EditorObject *obj = (EditorObject *)edit_baton;
+	PyGILState_STATE state;
+	svn_error_t *err;
+
+	err = obj->editor->close_edit(obj->baton, pool);
 
+	state = PyGILState_Ensure();
+	if (err == NULL)
+		native_editor_done(obj);
+	Py_DECREF(obj);
+	PyGILState_Release(state);
+	return err;
+}
+
+static svn_error_t *native_editor_abort_edit(void *edit_baton, apr_pool_t *pool)
+{
+	EditorObject *obj = (EditorObject *)edit_baton;
+	PyGILState_STATE state;
+	svn_error_t *err;
+
+	err = obj->editor->abort_edit(obj->baton, pool);
+
+	state = PyGILState_Ensure();
+	if (err == NULL)
+		native_editor_done(obj);
+	Py_DECREF(obj);
+	PyGILState_Release(state);
+	return err;
+}
+
+/**
+ * Check whether obj is an Editor created by any of the extension modules.
+ *
+ * Each extension module has its own copy of Editor_Type, so the types of
+ * the other modules are looked up through their "_types" capsules.
+ */
+static bool native_editor_check(PyObject *obj)
+{
+	static const char *modules[] = {
+		"subvertpy._ra", "subvertpy.wc", "subvertpy.client", NULL
+	};
+	PyTypeObject *type = Py_TYPE(obj);
+	int i;
+
+	if (type == SUBVERTPY_TYPE(Editor_Type))
+		return true;
+
+	for (i = 0; modules[i] != NULL; i++) {
+		if (type == subvertpy_module_type(modules[i], Editor_Type_ID))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Obtain the delta editor and edit baton to hand to libsvn for obj.
+ *
+ * If obj wraps a native editor that has not been used yet, such as the
+ * editors returned by wc.Context.get_update_editor(), that editor is
+ * driven directly and the interpreter is only entered once the edit is
+ * closed. Anything else is driven through py_editor with obj as baton.
+ *
+ * Either way, the caller should hold a reference to obj on behalf of the
+ * editor.
+ */
+void py_object_to_editor(PyObject *obj, apr_pool_t *pool,
+						 const svn_delta_editor_t **editor,
+						 void **edit_baton)
+{
+	EditorObject *native = (EditorObject *)obj;
+	svn_delta_editor_t *wrapper;
+
+	if (!native_editor_check(obj) || native->done || native->active_child ||
+		native->parent != NULL) {
+		*editor = &py_editor;
+		*edit_baton = obj;
+		return;
+	}
+
+	wrapper = apr_palloc(pool, sizeof(svn_delta_editor_t));
+	*wrapper = *native->editor;
+	wrapper->set_target_revision = native_editor_set_target_revision;
+	wrapper->open_root = native_editor_open_root;
+	wrapper->close_edit = native_editor_close_edit;
+	wrapper->abort_edit = native_editor_abort_edit;
+
+	*editor = wrapper;
+	*edit_baton = obj;
+}
+
+const subvertpy_type_def_t editor_types[] = {
+	{ TxDeltaWindowHandler_Type_ID, &TxDeltaWindowHandler_Type },
+	{ FileEditor_Type_ID, &FileEditor_Type },
+	{ DirectoryEditor_Type_ID, &DirectoryEditor_Type },
+	{ Editor_Type_ID, &Editor_Type },
+	{ 0, NULL }
+};
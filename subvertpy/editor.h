@@ -20,6 +20,8 @@
 #ifndef _BZR_SVN_EDITOR_H_
 #define _BZR_SVN_EDITOR_H_
 
+#include "util.h"
+
 #ifdef __GNUC__
 #pragma GCC visibility push(hidden)
 #endif
@@ -28,6 +30,7 @@ extern PyTypeObject DirectoryEditor_Type;
 extern PyTypeObject FileEditor_Type;
 extern PyTypeObject Editor_Type;
 extern PyTypeObject TxDeltaWindowHandler_Type;
+extern const subvertpy_type_def_t editor_types[];
 struct EditorObject;
 PyObject *new_editor_object(
      struct EditorObject *parent, const
@@ -35,10 +38,10 @@ PyObject *new_editor_object(
      *pool, PyTypeObject *type, void (*done_cb) (void *baton),
      void *done_baton, PyObject *commit_callback);
 
-#define DirectoryEditor_Check(op) PyObject_TypeCheck(op, &DirectoryEditor_Type)
-#define FileEditor_Check(op) PyObject_TypeCheck(op, &FileEditor_Type)
-#define Editor_Check(op) PyObject_TypeCheck(op, &Editor_Type)
-#define TxDeltaWindowHandler_Check(op) PyObject_TypeCheck(op, &TxDeltaWindowHandler_Type)
+#define DirectoryEditor_Check(op) PyObject_TypeCheck(op, SUBVERTPY_TYPE(DirectoryEditor_Type))
+#define FileEditor_Check(op) PyObject_TypeCheck(op, SUBVERTPY_TYPE(FileEditor_Type))
+#define Editor_Check(op) PyObject_TypeCheck(op, SUBVERTPY_TYPE(Editor_Type))
+#define TxDeltaWindowHandler_Check(op) PyObject_TypeCheck(op, SUBVERTPY_TYPE(TxDeltaWindowHandler_Type))
 
 typedef struct {
     PyObject_HEAD
@@ -47,6 +50,9 @@ typedef struct {
 } TxDeltaWindowHandlerObject;
 
 svn_error_t *py_txdelta_window_handler(svn_txdelta_window_t *window, void *baton);
+void py_object_to_editor(PyObject *obj, apr_pool_t *pool,
+                         const svn_delta_editor_t **editor,
+                         void **edit_baton);
 
 #ifdef __GNUC__
 #pragma GCC visibility pop
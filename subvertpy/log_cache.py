@@ -0,0 +1,598 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Persistent local cache of repository revision logs.
+
+The log of committed revisions never changes, apart from revision property
+edits, so it can be fetched once and answered locally from then on.
+
+The cache for a repository lives in a directory named after its UUID and
+consists of three files:
+
+ * ``log.dat``: append-only log records, one per revision (and one more
+   for each revision whose properties were refreshed)
+ * ``log.idx``: the offset of the current record of each revision in
+   ``log.dat``, as fixed-width big-endian integers indexed by revision
+ * ``paths.idx``: append-only list of the paths touched by each revision,
+   including all of their parent directories, and of the paths it added
+   or replaced, from which the path to revisions index is built
+
+Records are only visible once their offset has been written to
+``log.idx``, so an interrupted sync leaves the cache consistent.
+Writers take a lock on the ``lock`` file, where ``fcntl`` is available,
+so several processes can share a cache.
+"""
+
+__docformat__ = "restructuredText"
+
+from array import array
+import bisect
+import contextlib
+import mmap
+import os
+import struct
+
+try:
+    import fcntl
+except ImportError:  # Windows
+    fcntl = None
+
+try:
+    from urllib import unquote
+except ImportError:
+    from urllib.parse import unquote
+
+from subvertpy import (
+    ERR_FS_NO_SUCH_REVISION,
+    NODE_UNKNOWN,
+    SubversionException,
+    )
+
+_U32 = struct.Struct(">I")
+_OFFSET = struct.Struct(">Q")
+_RECORD_HEADER = struct.Struct(">IIII")
+_PATHS_HEADER = struct.Struct(">III")
+_COPYFROM = struct.Struct(">ib")
+_NONE = 0xffffffff
+
+
+def default_cache_dir():
+    """Return the default directory for log caches."""
+    base = os.environ.get("XDG_CACHE_HOME")
+    if not base:
+        base = os.path.join(os.path.expanduser("~"), ".cache")
+    return os.path.join(base, "subvertpy", "log")
+
+
+if str is bytes:
+    def _text(value):
+        return value
+else:
+    def _text(value):
+        return value.decode("utf-8")
+
+
+def _pack_bytes(out, value):
+    if value is None:
+        out.append(_U32.pack(_NONE))
+        return
+    if not isinstance(value, bytes):
+        value = value.encode("utf-8")
+    out.append(_U32.pack(len(value)))
+    out.append(value)
+
+
+def _unpack_bytes(buf, offset):
+    (length, ) = _U32.unpack_from(buf, offset)
+    offset += _U32.size
+    if length == _NONE:
+        return None, offset
+    return buf[offset:offset+length], offset + length
+
+
+def _parents(path):
+    """Return path and all its parent directories."""
+    ret = [path]
+    while path != "/":
+        path = path.rsplit("/", 1)[0] or "/"
+        ret.append(path)
+    return ret
+
+
+def _iter_paths(data, tip):
+    """Iterate over the records in the contents of paths.idx.
+
+    Stops at the first partial record or record for a revision beyond
+    tip, which are left behind by an interrupted sync.
+
+    :return: Iterator over (revnum, touched, added, end) tuples
+    """
+    offset = 0
+    while offset + _PATHS_HEADER.size <= len(data):
+        (revnum, ntouched, nadded) = _PATHS_HEADER.unpack_from(data, offset)
+        end = offset + _PATHS_HEADER.size
+        found = []
+        try:
+            for i in range(ntouched + nadded):
+                path, end = _unpack_bytes(data, end)
+                found.append(path)
+        except struct.error:
+            return
+        if end > len(data) or revnum > tip:
+            return
+        yield (revnum, found[:ntouched], found[ntouched:], end)
+        offset = end
+
+
+def _pack_record(revnum, changed_paths, revprops):
+    out = []
+    changed_paths = changed_paths or {}
+    for name, value in sorted(revprops.items()):
+        _pack_bytes(out, name)
+        _pack_bytes(out, value)
+    for path, change in sorted(changed_paths.items()):
+        _pack_bytes(out, path)
+        _pack_bytes(out, change[0])
+        _pack_bytes(out, change[1])
+        if len(change) > 3:
+            node_kind = change[3]
+        else:
+            node_kind = NODE_UNKNOWN
+        out.append(_COPYFROM.pack(change[2], node_kind))
+    body = b"".join(out)
+    return _RECORD_HEADER.pack(
+        _RECORD_HEADER.size + len(body), revnum, len(revprops),
+        len(changed_paths)) + body
+
+
+def _unpack_record(buf, offset):
+    (length, revnum, nprops, npaths) = _RECORD_HEADER.unpack_from(buf, offset)
+    offset += _RECORD_HEADER.size
+    revprops = {}
+    for i in range(nprops):
+        name, offset = _unpack_bytes(buf, offset)
+        value, offset = _unpack_bytes(buf, offset)
+        revprops[_text(name)] = value
+    changed_paths = {}
+    for i in range(npaths):
+        path, offset = _unpack_bytes(buf, offset)
+        action, offset = _unpack_bytes(buf, offset)
+        copyfrom_path, offset = _unpack_bytes(buf, offset)
+        (copyfrom_rev, node_kind) = _COPYFROM.unpack_from(buf, offset)
+        offset += _COPYFROM.size
+        if copyfrom_path is not None:
+            copyfrom_path = _text(copyfrom_path)
+        changed_paths[_text(path)] = (
+            _text(action), copyfrom_path, copyfrom_rev, node_kind)
+    return revnum, changed_paths, revprops
+
+
+class LogCache(object):
+    """Persistent cache of the revision log of a repository.
+
+    :param ra: RemoteAccess object (or ra_svn client) for the repository;
+        log queries take paths relative to its URL, as for ``ra.get_log``.
+    :param cache_dir: Directory to store caches in; defaults to
+        ``default_cache_dir()``.
+    """
+
+    def __init__(self, ra, cache_dir=None):
+        self._ra = ra
+        if cache_dir is None:
+            cache_dir = default_cache_dir()
+        self.path = os.path.join(cache_dir, ra.get_uuid())
+        if not os.path.isdir(self.path):
+            os.makedirs(self.path)
+        self._root = ra.get_repos_root()
+        self._data_path = os.path.join(self.path, "log.dat")
+        self._index_path = os.path.join(self.path, "log.idx")
+        self._paths_path = os.path.join(self.path, "paths.idx")
+        self._lock_path = os.path.join(self.path, "lock")
+        for p in (self._data_path, self._index_path, self._paths_path):
+            if not os.path.exists(p):
+                open(p, "wb").close()
+        self._map = None
+        self._offsets = []
+        self._paths = None
+        with self._lock():
+            self._load_index()
+
+    @contextlib.contextmanager
+    def _lock(self):
+        """Hold the lock that serializes writers to the cache."""
+        with open(self._lock_path, "ab") as f:
+            if fcntl is not None:
+                fcntl.lockf(f, fcntl.LOCK_EX)
+            try:
+                yield
+            finally:
+                if fcntl is not None:
+                    fcntl.lockf(f, fcntl.LOCK_UN)
+
+    def _load_index(self):
+        """Load log.idx and drop what an interrupted sync left behind.
+
+        Must be called with the lock held.
+        """
+        with open(self._index_path, "rb") as f:
+            data = f.read()
+        count = len(data) // _OFFSET.size
+        # Other processes may have appended to the data file since it was
+        # mapped, and to the path index if they synced.
+        self.close()
+        if count != len(self._offsets):
+            self._paths = None
+        self._offsets = [_OFFSET.unpack_from(data, i * _OFFSET.size)[0]
+                         for i in range(count)]
+        if len(data) != count * _OFFSET.size:
+            # Interrupted write; drop the partial entry.
+            with open(self._index_path, "r+b") as f:
+                f.truncate(count * _OFFSET.size)
+        # Records for revisions beyond the tip would otherwise be followed
+        # by a second copy once those revisions are fetched again.
+        with open(self._paths_path, "rb") as f:
+            data = f.read()
+        end = 0
+        for (revnum, touched, added, end) in _iter_paths(data, self.tip):
+            pass
+        if end != len(data):
+            with open(self._paths_path, "r+b") as f:
+                f.truncate(end)
+
+    def _load_paths(self):
+        paths = {}
+        adds = {}
+        with open(self._paths_path, "rb") as f:
+            data = f.read()
+        for (revnum, touched, added, end) in _iter_paths(data, self.tip):
+            for path in touched:
+                paths.setdefault(_text(path), array("l")).append(revnum)
+            for path in added:
+                adds.setdefault(_text(path), array("l")).append(revnum)
+        self._paths = paths
+        self._adds = adds
+
+    @property
+    def tip(self):
+        """The last revision in the cache, or -1 if it is empty."""
+        return len(self._offsets) - 1
+
+    def close(self):
+        if self._map is not None:
+            self._map.close()
+            self._map = None
+
+    def _data(self):
+        if self._map is None:
+            with open(self._data_path, "rb") as f:
+                self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        return self._map
+
+    def _read(self, revnum):
+        return _unpack_record(self._data(), self._offsets[revnum])
+
+    def _append(self, entries):
+        """Append log entries to the cache.
+
+        :param entries: List of (revnum, changed_paths, revprops) tuples
+        """
+        self.close()
+        records = []
+        touched = []
+        with open(self._data_path, "ab") as f:
+            f.seek(0, os.SEEK_END)
+            offset = f.tell()
+            for (revnum, changed_paths, revprops) in entries:
+                record = _pack_record(revnum, changed_paths, revprops)
+                records.append((revnum, offset))
+                f.write(record)
+                offset += len(record)
+                changed_paths = changed_paths or {}
+                touched.append((revnum, sorted(set(
+                    parent for path in changed_paths
+                    for parent in _parents(path))), sorted(
+                    path for (path, change) in changed_paths.items()
+                    if change[0] in ("A", "R"))))
+        with open(self._paths_path, "ab") as f:
+            for (revnum, paths, added) in touched:
+                out = [_PATHS_HEADER.pack(revnum, len(paths), len(added))]
+                for path in paths + added:
+                    _pack_bytes(out, path)
+                f.write(b"".join(out))
+                if self._paths is not None:
+                    for path in paths:
+                        self._paths.setdefault(
+                            path, array("l")).append(revnum)
+                    for path in added:
+                        self._adds.setdefault(
+                            path, array("l")).append(revnum)
+        return records
+
+    def sync(self, batch_size=1000):
+        """Fetch any revisions newer than the cached tip.
+
+        :param batch_size: Number of revisions to fetch per request
+        :return: Latest revision in the repository
+        """
+        latest = self._ra.get_latest_revnum()
+        if latest <= self.tip:
+            return latest
+        with self._lock():
+            self._load_index()
+            if latest <= self.tip:
+                return latest
+            url = self._ra.url
+            self._ra.reparent(self._root)
+            try:
+                while self.tip < latest:
+                    start = self.tip + 1
+                    end = min(latest, start + batch_size - 1)
+                    self._fetch(start, end)
+            finally:
+                self._ra.reparent(url)
+        return latest
+
+    def _fetch(self, start, end):
+        if getattr(self._ra, "iter_log", None) is not None:
+            log = self._ra.iter_log(
+                [""], start, end, discover_changed_paths=True,
+                strict_node_history=True, revprops=None)
+        else:
+            log = self._ra.log(
+                [""], start, end, discover_changed_paths=True,
+                strict_node_history=True, include_merged_revisions=False,
+                revprops=None)
+        entries = [(entry[1], entry[0], entry[2]) for entry in log]
+        entries.sort(key=lambda entry: entry[0])
+        records = self._append(entries)
+        with open(self._index_path, "ab") as f:
+            for (revnum, offset) in records:
+                if revnum != len(self._offsets):
+                    raise AssertionError(
+                        "unexpected revision %d in log" % revnum)
+                f.write(_OFFSET.pack(offset))
+                self._offsets.append(offset)
+
+    def refresh_revprops(self, revnum):
+        """Refetch the revision properties of a cached revision.
+
+        Use this after changing a revision property.
+        """
+        if revnum > self.tip:
+            return
+        revprops = self._ra.rev_proplist(revnum)
+        with self._lock():
+            self._load_index()
+            (revnum, changed_paths, old_revprops) = self._read(revnum)
+            self.close()
+            with open(self._data_path, "ab") as f:
+                f.seek(0, os.SEEK_END)
+                offset = f.tell()
+                f.write(_pack_record(revnum, changed_paths, dict(revprops)))
+            with open(self._index_path, "r+b") as f:
+                f.seek(revnum * _OFFSET.size)
+                f.write(_OFFSET.pack(offset))
+            self._offsets[revnum] = offset
+
+    def _abspath(self, path):
+        url = self._ra.url
+        prefix = unquote(url[len(self._root):]).strip("/")
+        path = "/".join(p for p in (prefix, path.strip("/")) if p)
+        return "/" + path
+
+    def _copy_source(self, revnum, path):
+        """Find where path was added or replaced in revnum, if it was.
+
+        :return: None if path was not added in revnum, otherwise tuple
+            with copy source path and revision (or None and -1)
+        """
+        (revnum, changed_paths, revprops) = self._read(revnum)
+        best = None
+        for changed_path, change in changed_paths.items():
+            if change[0] not in ("A", "R"):
+                continue
+            if (changed_path == path or
+                    path.startswith(changed_path.rstrip("/") + "/")):
+                if best is None or len(changed_path) > len(best[0]):
+                    best = (changed_path, change)
+        if best is None:
+            return None
+        (changed_path, change) = best
+        if change[1] is None:
+            return (None, -1)
+        return (change[1] + path[len(changed_path):], change[2])
+
+    def _candidates(self, path, hi, lo):
+        """Find the revisions in [lo, hi] that may have touched path.
+
+        These are the revisions that changed path or its children, and the
+        ones that added or replaced one of its parents, which implicitly
+        add path if it was copied along.
+        """
+        ret = set()
+        indexes = [self._paths.get(path, ())]
+        indexes.extend(self._adds.get(parent, ())
+                       for parent in _parents(path)[1:])
+        for revnums in indexes:
+            ret.update(revnums[bisect.bisect_left(revnums, lo):
+                               bisect.bisect_right(revnums, hi)])
+        return sorted(ret, reverse=True)
+
+    def _history(self, path, hi, lo, strict_node_history):
+        """Find the revisions in [lo, hi] that touched path or its children.
+
+        Follows copies unless strict_node_history is set.
+        """
+        if self._paths is None:
+            self._load_paths()
+        while path is not None:
+            next_path = None
+            for revnum in self._candidates(path, hi, lo):
+                yield revnum
+                copy = self._copy_source(revnum, path)
+                if copy is not None:
+                    (copyfrom_path, hi) = copy
+                    if not strict_node_history:
+                        next_path = copyfrom_path
+                    break
+            path = next_path
+
+    def _entries(self, paths, start, end, limit, strict_node_history):
+        if start is None or start == -1 or end is None or end == -1:
+            latest = self.sync()
+            if start is None or start == -1:
+                start = latest
+            if end is None or end == -1:
+                end = latest
+        hi = max(start, end)
+        lo = min(start, end)
+        if hi > self.tip:
+            self.sync()
+            if hi > self.tip:
+                raise SubversionException(
+                    "No such revision %d" % hi, ERR_FS_NO_SUCH_REVISION)
+        if paths is None:
+            paths = [""]
+        abspaths = [self._abspath(p) for p in paths]
+        if "/" in abspaths:
+            revnums = range(lo, hi + 1)
+        else:
+            revnums = set()
+            for path in abspaths:
+                revnums.update(
+                    self._history(path, hi, lo, strict_node_history))
+            revnums = sorted(revnums)
+        if start > end:
+            revnums = reversed(revnums)
+        for (i, revnum) in enumerate(revnums):
+            if limit and i >= limit:
+                break
+            yield self._read(revnum)
+
+    def iter_log(self, paths, start, end, limit=0,
+                 discover_changed_paths=False, strict_node_history=True,
+                 include_merged_revisions=False, revprops=None):
+        """Iterate over log entries, as ``RemoteAccess.iter_log``.
+
+        Revisions missing from the cache are fetched first. Unlike the
+        server, no error is raised for paths that do not exist.
+
+        :return: Iterator over (changed_paths, revnum, revprops) tuples
+        """
+        if include_merged_revisions:
+            raise NotImplementedError(
+                "merged revisions are not stored in the log cache")
+        for (revnum, changed_paths, all_revprops) in self._entries(
+                paths, start, end, limit, strict_node_history):
+            if not discover_changed_paths or not changed_paths:
+                changed_paths = None
+            if revprops is None:
+                selected = all_revprops
+            else:
+                selected = dict(
+                    (name, all_revprops[name]) for name in revprops
+                    if name in all_revprops)
+            yield (changed_paths, revnum, selected)
+
+    def get_log(self, callback, *args, **kwargs):
+        """Report log entries to a callback, as ``RemoteAccess.get_log``."""
+        for (changed_paths, revnum, revprops) in self.iter_log(
+                *args, **kwargs):
+            if changed_paths is not None:
+                changed_paths = dict(
+                    (path, change[:3])
+                    for (path, change) in changed_paths.items())
+            callback(changed_paths, revnum, revprops)
+
+
+class CachedRemoteAccess(object):
+    """RemoteAccess wrapper that answers log queries from a LogCache.
+
+    All other attributes are looked up on the wrapped object.
+
+    :param ra: RemoteAccess object or ra_svn client
+    :param cache_dir: Directory to store caches in
+    :param blob_cache: Optional ``blob_cache.BlobCache`` to answer
+        ``get_file`` from and to store the texts received by
+        ``do_update`` and ``do_switch`` in
+    """
+
+    def __init__(self, ra, cache_dir=None, blob_cache=None):
+        self._ra = ra
+        self.log_cache = LogCache(ra, cache_dir)
+        self.blob_cache = blob_cache
+
+    def __getattr__(self, name):
+        return getattr(self._ra, name)
+
+    def get_file(self, path, stream, revision=-1, checksum=None):
+        if self.blob_cache is None or stream is None:
+            return self._ra.get_file(path, stream, revision)
+        return self.blob_cache.get_file(self._ra, path, stream, revision,
+                                        checksum)
+
+    def do_update(self, revnum, path, recurse, editor, *args, **kwargs):
+        if self.blob_cache is not None:
+            editor = self.blob_cache.wrap_editor(editor)
+        return self._ra.do_update(revnum, path, recurse, editor, *args,
+                                  **kwargs)
+
+    def do_switch(self, revnum, path, recurse, url, editor, *args, **kwargs):
+        if self.blob_cache is not None:
+            editor = self.blob_cache.wrap_editor(editor)
+        return self._ra.do_switch(revnum, path, recurse, url, editor, *args,
+                                  **kwargs)
+
+    def iter_log(self, paths, start, end, limit=0,
+                 discover_changed_paths=False, strict_node_history=True,
+                 include_merged_revisions=False, revprops=None, **kwargs):
+        if include_merged_revisions or kwargs:
+            return self._ra.iter_log(
+                paths, start, end, limit, discover_changed_paths,
+                strict_node_history, include_merged_revisions, revprops,
+                **kwargs)
+        return self.log_cache.iter_log(
+            paths, start, end, limit, discover_changed_paths,
+            strict_node_history, False, revprops)
+
+    def get_log(self, callback, paths, start, end, limit=0,
+                discover_changed_paths=False, strict_node_history=True,
+                include_merged_revisions=False, revprops=None):
+        if include_merged_revisions:
+            return self._ra.get_log(
+                callback, paths, start, end, limit, discover_changed_paths,
+                strict_node_history, include_merged_revisions, revprops)
+        return self.log_cache.get_log(
+            callback, paths, start, end, limit, discover_changed_paths,
+            strict_node_history, False, revprops)
+
+    def log(self, paths, start, end, limit=0, discover_changed_paths=True,
+            strict_node_history=True, include_merged_revisions=True,
+            revprops=None):
+        """Iterate over log entries, as ``ra_svn.SVNClient.log``."""
+        if include_merged_revisions:
+            for entry in self._ra.log(
+                    paths, start, end, limit, discover_changed_paths,
+                    strict_node_history, include_merged_revisions, revprops):
+                yield entry
+            return
+        for (changed_paths, revnum, props) in self.log_cache.iter_log(
+                paths, start, end, limit, discover_changed_paths,
+                strict_node_history, False, revprops):
+            if changed_paths is not None:
+                changed_paths = dict(
+                    (path, change[:3])
+                    for (path, change) in changed_paths.items())
+            yield (changed_paths or {}, revnum, props, None)
@@ -0,0 +1,1672 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#include <Python.h>
+#include <apr_general.h>
+#include <svn_types.h>
+#include <svn_mergeinfo.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "util.h"
+#include "mergeinfo.h"
+
+/* Per-revision state used when combining two range lists. Combining
+ * two states with max() gives the union, with min() the intersection. */
+enum {
+	RANGE_ABSENT = 0,
+	RANGE_NON_INHERITABLE = 1,
+	RANGE_INHERITABLE = 2,
+};
+
+typedef int (*range_op_t)(int a, int b);
+
+static int op_union(int a, int b)
+{
+	return a > b?a:b;
+}
+
+static int op_intersect(int a, int b)
+{
+	return a < b?a:b;
+}
+
+static int op_intersect_strict(int a, int b)
+{
+	return (a == b)?a:RANGE_ABSENT;
+}
+
+static int op_remove(int a, int b)
+{
+	return (b == RANGE_ABSENT)?a:RANGE_ABSENT;
+}
+
+static int op_remove_strict(int a, int b)
+{
+	return (a == b)?RANGE_ABSENT:a;
+}
+
+static void range_append(mergeinfo_range_t *out, Py_ssize_t *n,
+						 svn_revnum_t start, svn_revnum_t end,
+						 bool inheritable)
+{
+	if (*n > 0 && out[*n-1].end + 1 == start &&
+		out[*n-1].inheritable == inheritable) {
+		out[*n-1].end = end;
+		return;
+	}
+	out[*n].start = start;
+	out[*n].end = end;
+	out[*n].inheritable = inheritable;
+	(*n)++;
+}
+
+/**
+ * Combine two canonical range lists in a single sweep.
+ *
+ * out must have room for 2 * (na + nb) entries.
+ *
+ * :return: number of ranges written to out
+ */
+static Py_ssize_t ranges_combine(const mergeinfo_range_t *a, Py_ssize_t na,
+								 const mergeinfo_range_t *b, Py_ssize_t nb,
+								 range_op_t op, mergeinfo_range_t *out)
+{
+	Py_ssize_t i = 0, j = 0, n = 0;
+	svn_revnum_t pos;
+
+	if (na == 0 && nb == 0)
+		return 0;
+	if (na == 0)
+		pos = b[0].start;
+	else if (nb == 0)
+		pos = a[0].start;
+	else
+		pos = (a[0].start < b[0].start)?a[0].start:b[0].start;
+
+	while (i < na || j < nb) {
+		int sa = RANGE_ABSENT, sb = RANGE_ABSENT, state;
+		svn_revnum_t next = LONG_MAX;
+
+		if (i < na) {
+			if (a[i].start <= pos) {
+				sa = a[i].inheritable?RANGE_INHERITABLE:RANGE_NON_INHERITABLE;
+				next = a[i].end + 1;
+			} else {
+				next = a[i].start;
+			}
+		}
+		if (j < nb) {
+			svn_revnum_t bnext;
+			if (b[j].start <= pos) {
+				sb = b[j].inheritable?RANGE_INHERITABLE:RANGE_NON_INHERITABLE;
+				bnext = b[j].end + 1;
+			} else {
+				bnext = b[j].start;
+			}
+			if (bnext < next)
+				next = bnext;
+		}
+
+		state = op(sa, sb);
+		if (state != RANGE_ABSENT)
+			range_append(out, &n, pos, next - 1, state == RANGE_INHERITABLE);
+
+		pos = next;
+		if (i < na && a[i].end < pos)
+			i++;
+		if (j < nb && b[j].end < pos)
+			j++;
+	}
+
+	return n;
+}
+
+static RangeListObject *rangelist_new(Py_ssize_t count)
+{
+	RangeListObject *ret;
+
+	ret = PyObject_New(RangeListObject, SUBVERTPY_TYPE(RangeList_Type));
+	if (ret == NULL)
+		return NULL;
+
+	ret->count = 0;
+	ret->ranges = NULL;
+	if (count > 0) {
+		ret->ranges = PyMem_New(mergeinfo_range_t, count);
+		if (ret->ranges == NULL) {
+			Py_DECREF(ret);
+			PyErr_NoMemory();
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+static RangeListObject *rangelist_combine(RangeListObject *a,
+										  RangeListObject *b, range_op_t op)
+{
+	RangeListObject *ret;
+
+	ret = rangelist_new(2 * (a->count + b->count));
+	if (ret == NULL)
+		return NULL;
+
+	ret->count = ranges_combine(a->ranges, a->count, b->ranges, b->count,
+								op, ret->ranges);
+
+	return ret;
+}
+
+static int range_cmp(const void *a, const void *b)
+{
+	const mergeinfo_range_t *ra = a, *rb = b;
+
+	if (ra->start < rb->start)
+		return -1;
+	if (ra->start > rb->start)
+		return 1;
+	return 0;
+}
+
+/* Coalesce overlapping and adjacent ranges in a list sorted by start.
+ * Returns the new number of ranges. */
+static Py_ssize_t ranges_coalesce(mergeinfo_range_t *ranges, Py_ssize_t count)
+{
+	Py_ssize_t i, n = 0;
+
+	for (i = 0; i < count; i++) {
+		if (n > 0 && ranges[i].start <= ranges[n-1].end + 1) {
+			if (ranges[i].end > ranges[n-1].end)
+				ranges[n-1].end = ranges[i].end;
+		} else {
+			ranges[n++] = ranges[i];
+		}
+	}
+
+	return n;
+}
+
+/**
+ * Turn an arbitrary array of ranges into a canonical range list.
+ *
+ * Where inheritable and non-inheritable ranges overlap, the inheritable
+ * range wins, like svn_rangelist_merge2() does.
+ *
+ * Takes ownership of ranges.
+ */
+static RangeListObject *rangelist_normalize(mergeinfo_range_t *ranges,
+											Py_ssize_t count)
+{
+	RangeListObject *ret;
+	mergeinfo_range_t *inh, *noninh;
+	Py_ssize_t i, ninh = 0, nnoninh = 0;
+	bool sorted = true;
+
+	for (i = 1; i < count; i++) {
+		if (ranges[i].start < ranges[i-1].start) {
+			sorted = false;
+			break;
+		}
+	}
+	if (!sorted)
+		qsort(ranges, count, sizeof(mergeinfo_range_t), range_cmp);
+
+	inh = PyMem_New(mergeinfo_range_t, count+1);
+	noninh = PyMem_New(mergeinfo_range_t, count+1);
+	if (inh == NULL || noninh == NULL) {
+		PyMem_Free(inh);
+		PyMem_Free(noninh);
+		PyMem_Free(ranges);
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (ranges[i].inheritable)
+			inh[ninh++] = ranges[i];
+		else
+			noninh[nnoninh++] = ranges[i];
+	}
+	PyMem_Free(ranges);
+
+	ninh = ranges_coalesce(inh, ninh);
+	nnoninh = ranges_coalesce(noninh, nnoninh);
+
+	ret = rangelist_new(2 * (ninh + nnoninh));
+	if (ret != NULL) {
+		ret->count = ranges_combine(inh, ninh, noninh, nnoninh, op_union,
+									ret->ranges);
+	}
+
+	PyMem_Free(inh);
+	PyMem_Free(noninh);
+
+	return ret;
+}
+
+static bool range_check(svn_revnum_t start, svn_revnum_t end)
+{
+	if (start < 0 || end < start || end >= LONG_MAX - 1) {
+		PyErr_Format(PyExc_ValueError, "Invalid revision range: %ld-%ld",
+					 start, end);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Convert a Python object to a range list.
+ *
+ * Accepts a RangeList or any iterable of (start, end) or
+ * (start, end, inheritable) tuples.
+ */
+RangeListObject *rangelist_from_object(PyObject *obj)
+{
+	PyObject *iter, *item;
+	mergeinfo_range_t *ranges;
+	Py_ssize_t count = 0, size;
+
+	if (RangeList_Check(obj)) {
+		Py_INCREF(obj);
+		return (RangeListObject *)obj;
+	}
+
+#if PY_MAJOR_VERSION >= 3
+	size = PyObject_LengthHint(obj, 8);
+	if (size < 0)
+		return NULL;
+	if (size < 8)
+		size = 8;
+#else
+	size = 8;
+#endif
+
+	ranges = PyMem_New(mergeinfo_range_t, size);
+	if (ranges == NULL) {
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	iter = PyObject_GetIter(obj);
+	if (iter == NULL) {
+		PyMem_Free(ranges);
+		return NULL;
+	}
+
+	while ((item = PyIter_Next(iter)) != NULL) {
+		long start, end;
+		PyObject *py_inheritable = Py_True;
+		int inheritable;
+
+		if (!PyTuple_Check(item) ||
+			!PyArg_ParseTuple(item, "ll|O", &start, &end, &py_inheritable)) {
+			if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_TypeError)) {
+				PyErr_Clear();
+				PyErr_Format(PyExc_TypeError,
+							 "Expected (start, end, inheritable) tuple, got %s",
+							 Py_TYPE(item)->tp_name);
+			}
+			goto fail_item;
+		}
+
+		inheritable = PyObject_IsTrue(py_inheritable);
+		if (inheritable == -1)
+			goto fail_item;
+
+		if (!range_check(start, end))
+			goto fail_item;
+
+		if (count == size) {
+			mergeinfo_range_t *resized;
+			size *= 2;
+			resized = PyMem_Realloc(ranges, size * sizeof(mergeinfo_range_t));
+			if (resized == NULL) {
+				PyErr_NoMemory();
+				goto fail_item;
+			}
+			ranges = resized;
+		}
+		ranges[count].start = start;
+		ranges[count].end = end;
+		ranges[count].inheritable = inheritable?true:false;
+		count++;
+		Py_DECREF(item);
+	}
+
+	Py_DECREF(iter);
+
+	if (PyErr_Occurred()) {
+		PyMem_Free(ranges);
+		return NULL;
+	}
+
+	return rangelist_normalize(ranges, count);
+
+fail_item:
+	Py_DECREF(item);
+	Py_DECREF(iter);
+	PyMem_Free(ranges);
+	return NULL;
+}
+
+static void set_parse_error(const char *msg, const char *text, Py_ssize_t len)
+{
+	char buf[256];
+
+	snprintf(buf, sizeof(buf), "%.*s", (int)len, text);
+	PyErr_Format(PyExc_ValueError, "%s: %s", msg, buf);
+}
+
+static bool parse_revnum(const char **p, const char *end, svn_revnum_t *rev)
+{
+	const char *s = *p;
+	svn_revnum_t ret = 0;
+
+	if (s == end || *s < '0' || *s > '9')
+		return false;
+
+	while (s < end && *s >= '0' && *s <= '9') {
+		if (ret > (LONG_MAX - 10) / 10)
+			return false;
+		ret = ret * 10 + (*s - '0');
+		s++;
+	}
+
+	*p = s;
+	*rev = ret;
+	return true;
+}
+
+/**
+ * Parse the textual representation of a range list, e.g. "1-3,5*,7".
+ */
+static RangeListObject *rangelist_parse(const char *text, Py_ssize_t len)
+{
+	const char *p = text, *end = text + len;
+	mergeinfo_range_t *ranges;
+	Py_ssize_t count = 0;
+
+	/* Each range takes at least two characters, including separator. */
+	ranges = PyMem_New(mergeinfo_range_t, len / 2 + 1);
+	if (ranges == NULL) {
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	while (p < end) {
+		svn_revnum_t start, stop;
+		bool inheritable = true;
+
+		if (!parse_revnum(&p, end, &start))
+			goto fail;
+		stop = start;
+		if (p < end && *p == '-') {
+			p++;
+			if (!parse_revnum(&p, end, &stop))
+				goto fail;
+		}
+		if (p < end && *p == '*') {
+			inheritable = false;
+			p++;
+		}
+		if (p < end) {
+			if (*p != ',')
+				goto fail;
+			p++;
+			if (p == end)
+				goto fail;
+		}
+		if (start > stop)
+			goto fail;
+		ranges[count].start = start;
+		ranges[count].end = stop;
+		ranges[count].inheritable = inheritable;
+		count++;
+	}
+
+	if (count == 0)
+		goto fail;
+
+	return rangelist_normalize(ranges, count);
+
+fail:
+	PyMem_Free(ranges);
+	set_parse_error("Invalid mergeinfo range list", text, len);
+	return NULL;
+}
+
+static PyObject *rangelist_to_string(RangeListObject *self)
+{
+	PyObject *ret;
+	char *buf, *p;
+	Py_ssize_t i;
+
+	/* Two revision numbers, a dash, an asterisk and a comma. */
+	buf = PyMem_Malloc(self->count * 48 + 1);
+	if (buf == NULL)
+		return PyErr_NoMemory();
+
+	p = buf;
+	for (i = 0; i < self->count; i++) {
+		mergeinfo_range_t *range = &self->ranges[i];
+		if (i > 0)
+			*p++ = ',';
+		if (range->start == range->end)
+			p += sprintf(p, "%ld", range->start);
+		else
+			p += sprintf(p, "%ld-%ld", range->start, range->end);
+		if (!range->inheritable)
+			*p++ = '*';
+	}
+
+	ret = PyUnicode_FromStringAndSize(buf, p - buf);
+	PyMem_Free(buf);
+	return ret;
+}
+
+/* Obtain a pointer to the UTF-8 contents of a str or bytes object.
+ * *tmp receives a reference that must be released by the caller. */
+static const char *text_from_object(PyObject *obj, Py_ssize_t *len,
+									PyObject **tmp)
+{
+	char *text;
+
+	if (PyUnicode_Check(obj)) {
+		*tmp = PyUnicode_AsUTF8String(obj);
+		if (*tmp == NULL)
+			return NULL;
+	} else if (PyBytes_Check(obj)) {
+		*tmp = obj;
+		Py_INCREF(obj);
+	} else {
+		PyErr_Format(PyExc_TypeError, "Expected str or bytes, got %s",
+					 Py_TYPE(obj)->tp_name);
+		return NULL;
+	}
+
+	if (PyBytes_AsStringAndSize(*tmp, &text, len) < 0) {
+		Py_DECREF(*tmp);
+		return NULL;
+	}
+
+	return text;
+}
+
+static PyObject *rangelist_tp_new(PyTypeObject *type, PyObject *args,
+								  PyObject *kwargs)
+{
+	PyObject *ranges = NULL;
+	char *kwnames[] = { "ranges", NULL };
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O:RangeList", kwnames,
+									 &ranges))
+		return NULL;
+
+	if (ranges == NULL)
+		return (PyObject *)rangelist_new(0);
+
+	return (PyObject *)rangelist_from_object(ranges);
+}
+
+static void rangelist_dealloc(PyObject *self)
+{
+	RangeListObject *rangelist = (RangeListObject *)self;
+	PyMem_Free(rangelist->ranges);
+	py_object_del(self);
+}
+
+static Py_ssize_t rangelist_len(PyObject *self)
+{
+	return ((RangeListObject *)self)->count;
+}
+
+static PyObject *rangelist_item(PyObject *self, Py_ssize_t i)
+{
+	RangeListObject *rangelist = (RangeListObject *)self;
+	mergeinfo_range_t *range;
+
+	if (i < 0 || i >= rangelist->count) {
+		PyErr_SetString(PyExc_IndexError, "range index out of range");
+		return NULL;
+	}
+
+	range = &rangelist->ranges[i];
+	return Py_BuildValue("(llN)", range->start, range->end,
+						 PyBool_FromLong(range->inheritable));
+}
+
+/* Find the range containing revnum, or NULL. O(log n). */
+static mergeinfo_range_t *rangelist_find(RangeListObject *self,
+										 svn_revnum_t revnum)
+{
+	Py_ssize_t lo = 0, hi = self->count;
+
+	while (lo < hi) {
+		Py_ssize_t mid = lo + (hi - lo) / 2;
+		if (self->ranges[mid].end < revnum)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo < self->count && self->ranges[lo].start <= revnum)
+		return &self->ranges[lo];
+
+	return NULL;
+}
+
+static int rangelist_contains(PyObject *self, PyObject *py_revnum)
+{
+	long revnum;
+
+	revnum = PyLong_AsLong(py_revnum);
+	if (revnum == -1 && PyErr_Occurred())
+		return -1;
+
+	return rangelist_find((RangeListObject *)self, revnum) != NULL;
+}
+
+static PyObject *rangelist_richcompare(PyObject *self, PyObject *other, int op)
+{
+	RangeListObject *a = (RangeListObject *)self, *b;
+	bool equal;
+	Py_ssize_t i;
+
+	if (op != Py_EQ && op != Py_NE) {
+		Py_INCREF(Py_NotImplemented);
+		return Py_NotImplemented;
+	}
+
+	b = rangelist_from_object(other);
+	if (b == NULL) {
+		PyErr_Clear();
+		Py_INCREF(Py_NotImplemented);
+		return Py_NotImplemented;
+	}
+
+	equal = (a->count == b->count);
+	for (i = 0; equal && i < a->count; i++) {
+		equal = (a->ranges[i].start == b->ranges[i].start &&
+				 a->ranges[i].end == b->ranges[i].end &&
+				 a->ranges[i].inheritable == b->ranges[i].inheritable);
+	}
+	Py_DECREF(b);
+
+	if (equal == (op == Py_EQ))
+		Py_RETURN_TRUE;
+	Py_RETURN_FALSE;
+}
+
+static PyObject *rangelist_repr(PyObject *self)
+{
+	PyObject *list, *ret;
+
+	list = PySequence_List(self);
+	if (list == NULL)
+		return NULL;
+
+	ret = PyUnicode_FromFormat("RangeList(%R)", list);
+	Py_DECREF(list);
+	return ret;
+}
+
+static PyObject *rangelist_str(PyObject *self)
+{
+	return rangelist_to_string((RangeListObject *)self);
+}
+
+static PyObject *rangelist_parse_method(PyObject *cls, PyObject *args)
+{
+	PyObject *py_text, *tmp;
+	const char *text;
+	Py_ssize_t len;
+	RangeListObject *ret;
+
+	if (!PyArg_ParseTuple(args, "O:parse", &py_text))
+		return NULL;
+
+	text = text_from_object(py_text, &len, &tmp);
+	if (text == NULL)
+		return NULL;
+
+	ret = rangelist_parse(text, len);
+	Py_DECREF(tmp);
+	return (PyObject *)ret;
+}
+
+static PyObject *rangelist_binop(PyObject *self, PyObject *py_other,
+								 range_op_t op)
+{
+	RangeListObject *other, *ret;
+
+	other = rangelist_from_object(py_other);
+	if (other == NULL)
+		return NULL;
+
+	ret = rangelist_combine((RangeListObject *)self, other, op);
+	Py_DECREF(other);
+	return (PyObject *)ret;
+}
+
+static PyObject *rangelist_merge(PyObject *self, PyObject *args)
+{
+	PyObject *other;
+
+	if (!PyArg_ParseTuple(args, "O:merge", &other))
+		return NULL;
+
+	return rangelist_binop(self, other, op_union);
+}
+
+static PyObject *rangelist_remove(PyObject *self, PyObject *args,
+								  PyObject *kwargs)
+{
+	PyObject *other;
+	char consider_inheritance = false;
+	char *kwnames[] = { "other", "consider_inheritance", NULL };
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|b:remove", kwnames,
+									 &other, &consider_inheritance))
+		return NULL;
+
+	return rangelist_binop(self, other,
+						   consider_inheritance?op_remove_strict:op_remove);
+}
+
+static PyObject *rangelist_intersect(PyObject *self, PyObject *args,
+									 PyObject *kwargs)
+{
+	PyObject *other;
+	char consider_inheritance = false;
+	char *kwnames[] = { "other", "consider_inheritance", NULL };
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|b:intersect", kwnames,
+									 &other, &consider_inheritance))
+		return NULL;
+
+	return rangelist_binop(self, other,
+						   consider_inheritance?op_intersect_strict:op_intersect);
+}
+
+static RangeListObject *rangelist_inheritable_only(RangeListObject *self)
+{
+	RangeListObject *ret;
+	Py_ssize_t i;
+
+	ret = rangelist_new(self->count);
+	if (ret == NULL)
+		return NULL;
+
+	for (i = 0; i < self->count; i++) {
+		if (self->ranges[i].inheritable)
+			ret->ranges[ret->count++] = self->ranges[i];
+	}
+
+	return ret;
+}
+
+static PyObject *rangelist_inheritable(PyObject *self)
+{
+	return (PyObject *)rangelist_inheritable_only((RangeListObject *)self);
+}
+
+static PyMethodDef rangelist_methods[] = {
+	{ "parse", rangelist_parse_method, METH_VARARGS|METH_CLASS,
+		"RangeList.parse(text) -> RangeList\n"
+		"Parse a range list in svn:mergeinfo syntax, e.g. '1-3,5*,7'." },
+	{ "merge", rangelist_merge, METH_VARARGS,
+		"S.merge(other) -> RangeList\n"
+		"Return the union of two range lists. Where ranges overlap, "
+		"inheritable ranges take precedence." },
+	{ "remove", (PyCFunction)rangelist_remove, METH_VARARGS|METH_KEYWORDS,
+		"S.remove(other, consider_inheritance=False) -> RangeList\n"
+		"Return the revisions in this range list that are not in other." },
+	{ "intersect", (PyCFunction)rangelist_intersect, METH_VARARGS|METH_KEYWORDS,
+		"S.intersect(other, consider_inheritance=False) -> RangeList\n"
+		"Return the revisions present in both range lists." },
+	{ "inheritable", (PyCFunction)rangelist_inheritable, METH_NOARGS,
+		"S.inheritable() -> RangeList\n"
+		"Return only the inheritable ranges." },
+	{ NULL }
+};
+
+static PySequenceMethods rangelist_as_sequence = {
+	.sq_length = rangelist_len,
+	.sq_item = rangelist_item,
+	.sq_contains = rangelist_contains,
+};
+
+PyTypeObject RangeList_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	"subvertpy.subr.RangeList", /*	const char *tp_name;  For printing, in format "<module>.<name>" */
+	sizeof(RangeListObject),
+	0,/*	Py_ssize_t tp_basicsize, tp_itemsize;  For allocation */
+
+	/* Methods to implement standard operations */
+
+	.tp_dealloc = rangelist_dealloc,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_repr = rangelist_repr,
+	.tp_as_sequence = &rangelist_as_sequence,
+	.tp_str = rangelist_str,
+	.tp_doc = "Sorted list of revision ranges, as (start, end, inheritable) "
+		"tuples with inclusive start and end.",
+	.tp_richcompare = rangelist_richcompare,
+	.tp_methods = rangelist_methods,
+	.tp_new = rangelist_tp_new,
+};
+
+/* Make sure all values of a MergeInfo dictionary are RangeList objects. */
+static int mergeinfo_coerce_values(PyObject *self)
+{
+	PyObject *key, *value;
+	Py_ssize_t pos = 0;
+
+	while (PyDict_Next(self, &pos, &key, &value)) {
+		RangeListObject *rangelist;
+		int ret;
+
+		if (RangeList_Check(value))
+			continue;
+
+		rangelist = rangelist_from_object(value);
+		if (rangelist == NULL)
+			return -1;
+		/* Replacing values of existing keys is safe while iterating. */
+		ret = PyDict_SetItem(self, key, (PyObject *)rangelist);
+		Py_DECREF(rangelist);
+		if (ret != 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int mergeinfo_init(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+	if (PyDict_Type.tp_init(self, args, kwargs) < 0)
+		return -1;
+
+	return mergeinfo_coerce_values(self);
+}
+
+static int mergeinfo_ass_subscript(PyObject *self, PyObject *key,
+								   PyObject *value)
+{
+	RangeListObject *rangelist;
+	int ret;
+
+	if (value == NULL)
+		return PyDict_DelItem(self, key);
+
+	rangelist = rangelist_from_object(value);
+	if (rangelist == NULL)
+		return -1;
+
+	ret = PyDict_SetItem(self, key, (PyObject *)rangelist);
+	Py_DECREF(rangelist);
+	return ret;
+}
+
+static PyObject *mergeinfo_update(PyObject *self, PyObject *args,
+								  PyObject *kwargs)
+{
+	PyObject *items;
+	int ret;
+
+	/* dict.__init__ accepts the same arguments as dict.update; convert
+	 * everything before touching self so that a bad value leaves it as
+	 * it was. */
+	items = PyDict_New();
+	if (items == NULL)
+		return NULL;
+	if (PyDict_Type.tp_init(items, args, kwargs) < 0 ||
+		mergeinfo_coerce_values(items) < 0) {
+		Py_DECREF(items);
+		return NULL;
+	}
+
+	ret = PyDict_Update(self, items);
+	Py_DECREF(items);
+	if (ret != 0)
+		return NULL;
+	Py_RETURN_NONE;
+}
+
+static PyObject *mergeinfo_setdefault(PyObject *self, PyObject *args)
+{
+	PyObject *key, *py_default = NULL, *value;
+	RangeListObject *rangelist;
+
+	if (!PyArg_ParseTuple(args, "O|O:setdefault", &key, &py_default))
+		return NULL;
+
+	value = PyDict_GetItem(self, key);
+	if (value != NULL) {
+		Py_INCREF(value);
+		return value;
+	}
+
+	if (py_default == NULL)
+		rangelist = rangelist_new(0);
+	else
+		rangelist = rangelist_from_object(py_default);
+	if (rangelist == NULL)
+		return NULL;
+
+	if (PyDict_SetItem(self, key, (PyObject *)rangelist) != 0) {
+		Py_DECREF(rangelist);
+		return NULL;
+	}
+	return (PyObject *)rangelist;
+}
+
+static PyObject *mergeinfo_new_empty(void)
+{
+	return PyObject_CallObject((PyObject *)SUBVERTPY_TYPE(MergeInfo_Type), NULL);
+}
+
+/* Look up the range list for key in an arbitrary mapping of mergeinfo.
+ * Returns a new reference, Py_None if the key is not present or NULL on
+ * error. */
+static PyObject *mergeinfo_lookup(PyObject *mapping, PyObject *key)
+{
+	PyObject *value, *ret;
+
+	if (PyDict_Check(mapping)) {
+		value = PyDict_GetItem(mapping, key);
+		if (value == NULL)
+			Py_RETURN_NONE;
+		return (PyObject *)rangelist_from_object(value);
+	}
+
+	value = PyObject_GetItem(mapping, key);
+	if (value == NULL) {
+		if (!PyErr_ExceptionMatches(PyExc_KeyError))
+			return NULL;
+		PyErr_Clear();
+		Py_RETURN_NONE;
+	}
+
+	ret = (PyObject *)rangelist_from_object(value);
+	Py_DECREF(value);
+	return ret;
+}
+
+/* Convert an arbitrary mapping to a dictionary that can be walked
+ * with PyDict_Next. */
+static PyObject *mergeinfo_as_dict(PyObject *obj)
+{
+	PyObject *ret;
+
+	if (PyDict_Check(obj)) {
+		Py_INCREF(obj);
+		return obj;
+	}
+
+	ret = PyDict_New();
+	if (ret == NULL)
+		return NULL;
+
+	if (PyDict_Merge(ret, obj, 1) < 0) {
+		Py_DECREF(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+/**
+ * Apply op to the range lists of each path in self and other.
+ *
+ * If only_common is true, only paths present in both are visited;
+ * otherwise paths missing from other are combined with an empty list and
+ * paths only in other are added as-is.
+ */
+static PyObject *mergeinfo_combine(PyObject *self, PyObject *py_other,
+								   range_op_t op, bool only_common)
+{
+	PyObject *ret, *other, *key, *value;
+	Py_ssize_t pos = 0;
+
+	other = mergeinfo_as_dict(py_other);
+	if (other == NULL)
+		return NULL;
+
+	ret = mergeinfo_new_empty();
+	if (ret == NULL) {
+		Py_DECREF(other);
+		return NULL;
+	}
+
+	while (PyDict_Next(self, &pos, &key, &value)) {
+		RangeListObject *a, *result;
+		PyObject *b;
+
+		b = mergeinfo_lookup(other, key);
+		if (b == NULL)
+			goto fail;
+
+		if (b == Py_None && only_common) {
+			Py_DECREF(b);
+			continue;
+		}
+
+		a = rangelist_from_object(value);
+		if (a == NULL) {
+			Py_DECREF(b);
+			goto fail;
+		}
+
+		if (b == Py_None) {
+			result = a;
+		} else {
+			result = rangelist_combine(a, (RangeListObject *)b, op);
+			Py_DECREF(a);
+		}
+		Py_DECREF(b);
+		if (result == NULL)
+			goto fail;
+
+		if (result->count > 0 &&
+			PyDict_SetItem(ret, key, (PyObject *)result) != 0) {
+			Py_DECREF(result);
+			goto fail;
+		}
+		Py_DECREF(result);
+	}
+
+	if (op == op_union) {
+		pos = 0;
+		while (PyDict_Next(other, &pos, &key, &value)) {
+			RangeListObject *b;
+
+			if (PyDict_GetItem(ret, key) != NULL)
+				continue;
+
+			b = rangelist_from_object(value);
+			if (b == NULL)
+				goto fail;
+			if (b->count > 0 &&
+				PyDict_SetItem(ret, key, (PyObject *)b) != 0) {
+				Py_DECREF(b);
+				goto fail;
+			}
+			Py_DECREF(b);
+		}
+	}
+
+	Py_DECREF(other);
+	return ret;
+
+fail:
+	Py_DECREF(other);
+	Py_DECREF(ret);
+	return NULL;
+}
+
+static PyObject *mergeinfo_merge(PyObject *self, PyObject *args)
+{
+	PyObject *other;
+
+	if (!PyArg_ParseTuple(args, "O:merge", &other))
+		return NULL;
+
+	return mergeinfo_combine(self, other, op_union, false);
+}
+
+static PyObject *mergeinfo_remove(PyObject *self, PyObject *args,
+								  PyObject *kwargs)
+{
+	PyObject *other;
+	char consider_inheritance = false;
+	char *kwnames[] = { "other", "consider_inheritance", NULL };
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|b:remove", kwnames,
+									 &other, &consider_inheritance))
+		return NULL;
+
+	return mergeinfo_combine(self, other,
+							 consider_inheritance?op_remove_strict:op_remove,
+							 false);
+}
+
+static PyObject *mergeinfo_intersect(PyObject *self, PyObject *args,
+									 PyObject *kwargs)
+{
+	PyObject *other;
+	char consider_inheritance = false;
+	char *kwnames[] = { "other", "consider_inheritance", NULL };
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|b:intersect", kwnames,
+									 &other, &consider_inheritance))
+		return NULL;
+
+	return mergeinfo_combine(self, other,
+							 consider_inheritance?op_intersect_strict:op_intersect,
+							 true);
+}
+
+static PyObject *mergeinfo_inheritable(PyObject *self)
+{
+	PyObject *ret, *key, *value;
+	Py_ssize_t pos = 0;
+
+	ret = mergeinfo_new_empty();
+	if (ret == NULL)
+		return NULL;
+
+	while (PyDict_Next(self, &pos, &key, &value)) {
+		RangeListObject *rangelist, *inheritable;
+
+		rangelist = rangelist_from_object(value);
+		if (rangelist == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+		inheritable = rangelist_inheritable_only(rangelist);
+		Py_DECREF(rangelist);
+		if (inheritable == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+		if (inheritable->count > 0 &&
+			PyDict_SetItem(ret, key, (PyObject *)inheritable) != 0) {
+			Py_DECREF(inheritable);
+			Py_DECREF(ret);
+			return NULL;
+		}
+		Py_DECREF(inheritable);
+	}
+
+	return ret;
+}
+
+static PyObject *mergeinfo_includes(PyObject *self, PyObject *args)
+{
+	PyObject *path, *value;
+	long revnum;
+	RangeListObject *rangelist;
+	bool found;
+
+	if (!PyArg_ParseTuple(args, "Ol:includes", &path, &revnum))
+		return NULL;
+
+	value = PyDict_GetItem(self, path);
+	if (value == NULL)
+		Py_RETURN_FALSE;
+
+	rangelist = rangelist_from_object(value);
+	if (rangelist == NULL)
+		return NULL;
+
+	found = (rangelist_find(rangelist, revnum) != NULL);
+	Py_DECREF(rangelist);
+
+	return PyBool_FromLong(found);
+}
+
+PyObject *mergeinfo_from_property(PyTypeObject *type, const char *text,
+								  Py_ssize_t len)
+{
+	PyObject *ret;
+	const char *line = text, *end = text + len;
+
+	ret = PyObject_CallObject((PyObject *)type, NULL);
+	if (ret == NULL)
+		return NULL;
+
+	while (line < end) {
+		const char *eol, *next, *colon;
+		PyObject *path;
+		RangeListObject *rangelist;
+		int err;
+
+		eol = memchr(line, '\n', end - line);
+		if (eol == NULL) {
+			eol = end;
+			next = end;
+		} else {
+			next = eol + 1;
+		}
+		if (eol > line && eol[-1] == '\r')
+			eol--;
+
+		if (eol == line) {
+			line = next;
+			continue;
+		}
+
+		for (colon = eol - 1; colon > line && *colon != ':'; colon--);
+
+		if (*colon != ':' || *line != '/') {
+			set_parse_error("Invalid mergeinfo line", line, eol - line);
+			Py_DECREF(ret);
+			return NULL;
+		}
+
+		path = PyUnicode_FromStringAndSize(line, colon - line);
+		if (path == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+
+		rangelist = rangelist_parse(colon + 1, eol - colon - 1);
+		if (rangelist == NULL) {
+			Py_DECREF(path);
+			Py_DECREF(ret);
+			return NULL;
+		}
+
+		err = PyDict_SetItem(ret, path, (PyObject *)rangelist);
+		Py_DECREF(path);
+		Py_DECREF(rangelist);
+		if (err != 0) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+
+		line = next;
+	}
+
+	return ret;
+}
+
+static PyObject *mergeinfo_from_property_method(PyObject *cls, PyObject *args)
+{
+	PyObject *py_text, *tmp, *ret;
+	const char *text;
+	Py_ssize_t len;
+
+	if (!PyArg_ParseTuple(args, "O:from_property", &py_text))
+		return NULL;
+
+	text = text_from_object(py_text, &len, &tmp);
+	if (text == NULL)
+		return NULL;
+
+	ret = mergeinfo_from_property((PyTypeObject *)cls, text, len);
+	Py_DECREF(tmp);
+	return ret;
+}
+
+static PyObject *mergeinfo_to_property(PyObject *self)
+{
+	PyObject *lines, *key, *value, *sep, *ret;
+	Py_ssize_t pos = 0;
+
+	lines = PyList_New(0);
+	if (lines == NULL)
+		return NULL;
+
+	while (PyDict_Next(self, &pos, &key, &value)) {
+		RangeListObject *rangelist;
+		PyObject *ranges, *line;
+		int err;
+
+		rangelist = rangelist_from_object(value);
+		if (rangelist == NULL) {
+			Py_DECREF(lines);
+			return NULL;
+		}
+		ranges = rangelist_to_string(rangelist);
+		Py_DECREF(rangelist);
+		if (ranges == NULL) {
+			Py_DECREF(lines);
+			return NULL;
+		}
+		line = PyUnicode_FromFormat("%S:%U\n", key, ranges);
+		Py_DECREF(ranges);
+		if (line == NULL) {
+			Py_DECREF(lines);
+			return NULL;
+		}
+		err = PyList_Append(lines, line);
+		Py_DECREF(line);
+		if (err != 0) {
+			Py_DECREF(lines);
+			return NULL;
+		}
+	}
+
+	sep = PyUnicode_FromString("");
+	if (sep == NULL) {
+		Py_DECREF(lines);
+		return NULL;
+	}
+	ret = PyUnicode_Join(sep, lines);
+	Py_DECREF(sep);
+	Py_DECREF(lines);
+	return ret;
+}
+
+static PyMethodDef mergeinfo_methods[] = {
+	{ "from_property", mergeinfo_from_property_method, METH_VARARGS|METH_CLASS,
+		"MergeInfo.from_property(text) -> MergeInfo\n"
+		"Parse the contents of a svn:mergeinfo property." },
+	{ "to_property", (PyCFunction)mergeinfo_to_property, METH_NOARGS,
+		"S.to_property() -> str\n"
+		"Generate the contents of a svn:mergeinfo property." },
+	{ "merge", mergeinfo_merge, METH_VARARGS,
+		"S.merge(other) -> MergeInfo\n"
+		"Return the union of two sets of mergeinfo." },
+	{ "remove", (PyCFunction)mergeinfo_remove, METH_VARARGS|METH_KEYWORDS,
+		"S.remove(other, consider_inheritance=False) -> MergeInfo\n"
+		"Return the mergeinfo in this object that is not in other." },
+	{ "intersect", (PyCFunction)mergeinfo_intersect, METH_VARARGS|METH_KEYWORDS,
+		"S.intersect(other, consider_inheritance=False) -> MergeInfo\n"
+		"Return the mergeinfo present in both objects." },
+	{ "inheritable", (PyCFunction)mergeinfo_inheritable, METH_NOARGS,
+		"S.inheritable() -> MergeInfo\n"
+		"Return only the inheritable ranges." },
+	{ "includes", mergeinfo_includes, METH_VARARGS,
+		"S.includes(path, revnum) -> bool\n"
+		"Check whether revnum of path has been merged." },
+	{ "update", (PyCFunction)mergeinfo_update, METH_VARARGS|METH_KEYWORDS,
+		"S.update([other, ]**kwargs) -> None\n"
+		"Update from a mapping or iterable of pairs, converting the values "
+		"to RangeList objects." },
+	{ "setdefault", mergeinfo_setdefault, METH_VARARGS,
+		"S.setdefault(path, ranges=RangeList()) -> RangeList\n"
+		"Return the ranges for path, storing ranges first if path is not "
+		"present." },
+	{ NULL }
+};
+
+static PyMappingMethods mergeinfo_as_mapping = {
+	.mp_ass_subscript = mergeinfo_ass_subscript,
+};
+
+/* Derived from dict when the type is created; see mergeinfo_types. */
+PyTypeObject MergeInfo_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	"subvertpy.subr.MergeInfo", /*	const char *tp_name;  For printing, in format "<module>.<name>" */
+	0,
+	0,/*	Py_ssize_t tp_basicsize, tp_itemsize;  For allocation */
+
+	.tp_as_mapping = &mergeinfo_as_mapping,
+	.tp_flags = Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+	.tp_doc = "Dictionary mapping paths to RangeList objects.",
+	.tp_methods = mergeinfo_methods,
+	.tp_init = mergeinfo_init,
+};
+
+PyObject *mergeinfo_subtract(PyObject *whiteboard, PyObject *eraser,
+							 bool consider_inheritance)
+{
+	return mergeinfo_combine(whiteboard, eraser,
+							 consider_inheritance?op_remove_strict:op_remove,
+							 false);
+}
+
+#if ONLY_SINCE_SVN(1, 5)
+PyObject *rangelist_from_svn(const apr_array_header_t *rangelist)
+{
+	mergeinfo_range_t *ranges;
+	int i;
+
+	ranges = PyMem_New(mergeinfo_range_t, rangelist->nelts + 1);
+	if (ranges == NULL)
+		return PyErr_NoMemory();
+
+	for (i = 0; i < rangelist->nelts; i++) {
+		svn_merge_range_t *range = APR_ARRAY_IDX(rangelist, i,
+												 svn_merge_range_t *);
+		/* svn_merge_range_t has an exclusive start revision */
+		ranges[i].start = range->start + 1;
+		ranges[i].end = range->end;
+		ranges[i].inheritable = range->inheritable?true:false;
+	}
+
+	/* Range lists from libsvn are already canonical, in which case this
+	 * is a linear scan. */
+	return (PyObject *)rangelist_normalize(ranges, rangelist->nelts);
+}
+
+PyObject *mergeinfo_from_svn(svn_mergeinfo_t mergeinfo, apr_pool_t *pool)
+{
+	PyObject *ret;
+	const char *key;
+	apr_ssize_t klen;
+	apr_hash_index_t *idx;
+	apr_array_header_t *rangelist;
+
+	ret = mergeinfo_new_empty();
+	if (ret == NULL)
+		return NULL;
+
+	for (idx = apr_hash_first(pool, mergeinfo); idx != NULL;
+		 idx = apr_hash_next(idx)) {
+		PyObject *pyval;
+		apr_hash_this(idx, (const void **)&key, &klen, (void **)&rangelist);
+		pyval = rangelist_from_svn(rangelist);
+		if (pyval == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+		if (PyDict_SetItemString(ret, key, pyval) != 0) {
+			Py_DECREF(pyval);
+			Py_DECREF(ret);
+			return NULL;
+		}
+		Py_DECREF(pyval);
+	}
+
+	return ret;
+}
+
+typedef struct {
+	PyObject_HEAD
+	apr_pool_t *pool;
+	svn_mergeinfo_catalog_t catalog;
+	PyObject *keys;
+	PyObject *cache;
+} MergeInfoCatalogObject;
+
+PyObject *mergeinfo_catalog_new(svn_mergeinfo_catalog_t catalog,
+								apr_pool_t *pool)
+{
+	MergeInfoCatalogObject *ret;
+
+	ret = PyObject_New(MergeInfoCatalogObject, SUBVERTPY_TYPE(MergeInfoCatalog_Type));
+	if (ret == NULL) {
+		apr_pool_destroy(pool);
+		return NULL;
+	}
+
+	ret->pool = pool;
+	ret->catalog = catalog;
+	ret->keys = NULL;
+	ret->cache = PyDict_New();
+	if (ret->cache == NULL) {
+		Py_DECREF(ret);
+		return NULL;
+	}
+
+	return (PyObject *)ret;
+}
+
+static void catalog_dealloc(PyObject *self)
+{
+	MergeInfoCatalogObject *catalog = (MergeInfoCatalogObject *)self;
+
+	Py_XDECREF(catalog->keys);
+	Py_XDECREF(catalog->cache);
+	if (catalog->pool != NULL)
+		apr_pool_destroy(catalog->pool);
+	py_object_del(self);
+}
+
+static Py_ssize_t catalog_len(PyObject *self)
+{
+	MergeInfoCatalogObject *catalog = (MergeInfoCatalogObject *)self;
+
+	if (catalog->catalog == NULL)
+		return 0;
+
+	return apr_hash_count(catalog->catalog);
+}
+
+/* Find the entry for a str or bytes key in the underlying catalog.
+ * Returns NULL without an exception set if there is no such entry. */
+static svn_mergeinfo_t catalog_get_svn(MergeInfoCatalogObject *self,
+									   PyObject *key)
+{
+	PyObject *bytes;
+	svn_mergeinfo_t ret;
+
+	if (self->catalog == NULL)
+		return NULL;
+
+	if (PyUnicode_Check(key)) {
+		bytes = PyUnicode_AsUTF8String(key);
+		if (bytes == NULL)
+			return NULL;
+	} else if (PyBytes_Check(key)) {
+		bytes = key;
+		Py_INCREF(bytes);
+	} else {
+		return NULL;
+	}
+
+	ret = apr_hash_get(self->catalog, PyBytes_AsString(bytes),
+					   PyBytes_Size(bytes));
+	Py_DECREF(bytes);
+	return ret;
+}
+
+/* Look up path in the catalog. Returns a borrowed reference, or NULL
+ * without an exception set if path is not in the catalog. */
+static PyObject *catalog_lookup(MergeInfoCatalogObject *self, PyObject *key)
+{
+	PyObject *ret;
+	svn_mergeinfo_t mergeinfo;
+
+	ret = PyDict_GetItem(self->cache, key);
+	if (ret != NULL)
+		return ret;
+
+	mergeinfo = catalog_get_svn(self, key);
+	if (mergeinfo == NULL)
+		return NULL;
+
+	ret = mergeinfo_from_svn(mergeinfo, NULL);
+	if (ret == NULL)
+		return NULL;
+
+	if (PyDict_SetItem(self->cache, key, ret) != 0) {
+		Py_DECREF(ret);
+		return NULL;
+	}
+	Py_DECREF(ret);
+
+	return ret;
+}
+
+static PyObject *catalog_subscript(PyObject *self, PyObject *key)
+{
+	PyObject *ret;
+
+	ret = catalog_lookup((MergeInfoCatalogObject *)self, key);
+	if (ret == NULL) {
+		if (!PyErr_Occurred())
+			PyErr_SetObject(PyExc_KeyError, key);
+		return NULL;
+	}
+
+	Py_INCREF(ret);
+	return ret;
+}
+
+static int catalog_contains(PyObject *self, PyObject *key)
+{
+	if (catalog_get_svn((MergeInfoCatalogObject *)self, key) != NULL)
+		return 1;
+
+	return PyErr_Occurred()?-1:0;
+}
+
+static PyObject *catalog_keys(PyObject *self)
+{
+	MergeInfoCatalogObject *catalog = (MergeInfoCatalogObject *)self;
+	apr_hash_index_t *idx;
+
+	if (catalog->keys != NULL) {
+		Py_INCREF(catalog->keys);
+		return catalog->keys;
+	}
+
+	catalog->keys = PyList_New(0);
+	if (catalog->keys == NULL)
+		return NULL;
+
+	if (catalog->catalog == NULL) {
+		Py_INCREF(catalog->keys);
+		return catalog->keys;
+	}
+
+	/* Iterating with a NULL pool uses the hash's internal iterator, so
+	 * repeated iteration does not grow the catalog pool. */
+	for (idx = apr_hash_first(NULL, catalog->catalog); idx != NULL;
+		 idx = apr_hash_next(idx)) {
+		const char *key;
+		apr_ssize_t klen;
+		PyObject *py_key;
+		int err;
+
+		apr_hash_this(idx, (const void **)&key, &klen, NULL);
+		py_key = PyUnicode_FromStringAndSize(key, klen);
+		if (py_key == NULL) {
+			Py_CLEAR(catalog->keys);
+			return NULL;
+		}
+		err = PyList_Append(catalog->keys, py_key);
+		Py_DECREF(py_key);
+		if (err != 0) {
+			Py_CLEAR(catalog->keys);
+			return NULL;
+		}
+	}
+
+	Py_INCREF(catalog->keys);
+	return catalog->keys;
+}
+
+static PyObject *catalog_iter(PyObject *self)
+{
+	PyObject *keys, *ret;
+
+	keys = catalog_keys(self);
+	if (keys == NULL)
+		return NULL;
+
+	ret = PyObject_GetIter(keys);
+	Py_DECREF(keys);
+	return ret;
+}
+
+static PyObject *catalog_items(PyObject *self)
+{
+	PyObject *keys, *ret;
+	Py_ssize_t i;
+
+	keys = catalog_keys(self);
+	if (keys == NULL)
+		return NULL;
+
+	ret = PyList_New(PyList_Size(keys));
+	if (ret == NULL) {
+		Py_DECREF(keys);
+		return NULL;
+	}
+
+	for (i = 0; i < PyList_Size(keys); i++) {
+		PyObject *key = PyList_GetItem(keys, i), *value, *item;
+		value = catalog_subscript(self, key);
+		if (value == NULL) {
+			Py_DECREF(keys);
+			Py_DECREF(ret);
+			return NULL;
+		}
+		item = Py_BuildValue("(ON)", key, value);
+		if (item == NULL) {
+			Py_DECREF(keys);
+			Py_DECREF(ret);
+			return NULL;
+		}
+		PyList_SetItem(ret, i, item);
+	}
+
+	Py_DECREF(keys);
+	return ret;
+}
+
+static PyObject *catalog_get(PyObject *self, PyObject *args)
+{
+	PyObject *key, *defval = Py_None, *ret;
+
+	if (!PyArg_ParseTuple(args, "O|O:get", &key, &defval))
+		return NULL;
+
+	ret = catalog_lookup((MergeInfoCatalogObject *)self, key);
+	if (ret == NULL) {
+		if (PyErr_Occurred())
+			return NULL;
+		ret = defval;
+	}
+
+	Py_INCREF(ret);
+	return ret;
+}
+
+static PyMethodDef catalog_methods[] = {
+	{ "keys", (PyCFunction)catalog_keys, METH_NOARGS,
+		"S.keys() -> list of paths" },
+	{ "items", (PyCFunction)catalog_items, METH_NOARGS,
+		"S.items() -> list of (path, MergeInfo) tuples" },
+	{ "get", catalog_get, METH_VARARGS,
+		"S.get(path, default=None) -> MergeInfo" },
+	{ NULL }
+};
+
+static PyMappingMethods catalog_as_mapping = {
+	.mp_length = catalog_len,
+	.mp_subscript = catalog_subscript,
+};
+
+static PySequenceMethods catalog_as_sequence = {
+	.sq_contains = catalog_contains,
+};
+
+PyTypeObject MergeInfoCatalog_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	"_ra.MergeInfoCatalog", /*	const char *tp_name;  For printing, in format "<module>.<name>" */
+	sizeof(MergeInfoCatalogObject),
+	0,/*	Py_ssize_t tp_basicsize, tp_itemsize;  For allocation */
+
+	.tp_dealloc = catalog_dealloc,
+	.tp_as_sequence = &catalog_as_sequence,
+	.tp_as_mapping = &catalog_as_mapping,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_doc = "Mergeinfo catalog, mapping paths to MergeInfo objects. "
+		"Entries are converted when they are first accessed.",
+	.tp_iter = catalog_iter,
+	.tp_methods = catalog_methods,
+};
+#endif
+
+const mergeinfo_api_t mergeinfo_api_table = {
+	mergeinfo_subtract,
+#if ONLY_SINCE_SVN(1, 5)
+	mergeinfo_from_svn,
+	mergeinfo_catalog_new,
+#endif
+};
+
+const subvertpy_type_def_t mergeinfo_types[] = {
+	{ RangeList_Type_ID, &RangeList_Type },
+	{ MergeInfo_Type_ID, &MergeInfo_Type, true },
+#if ONLY_SINCE_SVN(1, 5)
+	{ MergeInfoCatalog_Type_ID, &MergeInfoCatalog_Type },
+#endif
+	{ 0, NULL }
+};
@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef _SUBVERTPY_MERGEINFO_H_
+#define _SUBVERTPY_MERGEINFO_H_
+
+#include <stdbool.h>
+
+#ifdef __GNUC__
+#pragma GCC visibility push(hidden)
+#endif
+
+/* A single range of revisions; both start and end are inclusive, as in
+ * the textual form of svn:mergeinfo (unlike svn_merge_range_t, whose
+ * start is exclusive). */
+typedef struct {
+	svn_revnum_t start;
+	svn_revnum_t end;
+	bool inheritable;
+} mergeinfo_range_t;
+
+/* Immutable, sorted list of non-overlapping, non-adjacent ranges. */
+typedef struct {
+	PyObject_HEAD
+	Py_ssize_t count;
+	mergeinfo_range_t *ranges;
+} RangeListObject;
+
+extern PyTypeObject RangeList_Type;
+extern PyTypeObject MergeInfo_Type;
+extern PyTypeObject MergeInfoCatalog_Type;
+extern const subvertpy_type_def_t mergeinfo_types[];
+
+#define RangeList_Check(op) PyObject_TypeCheck(op, SUBVERTPY_TYPE(RangeList_Type))
+#define MergeInfo_Check(op) PyObject_TypeCheck(op, SUBVERTPY_TYPE(MergeInfo_Type))
+
+RangeListObject *rangelist_from_object(PyObject *obj);
+PyObject *mergeinfo_from_property(PyTypeObject *type, const char *text,
+								  Py_ssize_t len);
+PyObject *mergeinfo_subtract(PyObject *whiteboard, PyObject *eraser,
+							 bool consider_inheritance);
+#if ONLY_SINCE_SVN(1, 5)
+PyObject *rangelist_from_svn(const apr_array_header_t *rangelist);
+PyObject *mergeinfo_from_svn(svn_mergeinfo_t mergeinfo, apr_pool_t *pool);
+/* Takes ownership of pool. */
+PyObject *mergeinfo_catalog_new(svn_mergeinfo_catalog_t catalog,
+								apr_pool_t *pool);
+#endif
+
+/* The MergeInfo and RangeList types live in subvertpy.subr; other modules
+ * reach the functions below through this table, which subr exports as
+ * the "_mergeinfo_api" capsule, so that they hand out the same types. */
+#define MERGEINFO_API_CAPSULE "subvertpy.subr._mergeinfo_api"
+
+typedef struct {
+	PyObject *(*subtract)(PyObject *whiteboard, PyObject *eraser,
+						  bool consider_inheritance);
+#if ONLY_SINCE_SVN(1, 5)
+	PyObject *(*from_svn)(svn_mergeinfo_t mergeinfo, apr_pool_t *pool);
+	PyObject *(*catalog_new)(svn_mergeinfo_catalog_t catalog,
+							 apr_pool_t *pool);
+#endif
+} mergeinfo_api_t;
+
+extern const mergeinfo_api_t mergeinfo_api_table;
+
+/* Set by mergeinfo_api_import() in the modules that link _ra.c. */
+extern const mergeinfo_api_t *mergeinfo_api;
+int mergeinfo_api_import(void);
+
+#ifdef __GNUC__
+#pragma GCC visibility pop
+#endif
+
+#endif /* _SUBVERTPY_MERGEINFO_H_ */
@@ -0,0 +1,249 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""In-memory cache of revision metadata.
+
+The results of ``stat``, ``check_path``, ``get_dir`` and ``get_locations``
+for a concrete revision never change, so they can be remembered rather
+than asked for again. Requests for HEAD (-1) are always passed on.
+Revision properties can be changed, so ``rev_proplist`` results are
+dropped when they are changed through the same cache.
+
+Entries are keyed on the path relative to the repository root, so that
+sessions for different URLs in the same repository share a cache; use
+``MetadataCache.shared()`` to get the cache for a repository UUID.
+
+Results are copied when they are stored and when they are returned, so
+callers are free to modify them.
+"""
+
+__docformat__ = "restructuredText"
+
+from collections import OrderedDict
+import sys
+import threading
+
+try:
+    from urllib import unquote
+except ImportError:
+    from urllib.parse import unquote
+
+from subvertpy.subr import uri_canonicalize
+
+DEFAULT_MAX_SIZE = 16 * 1024 * 1024
+
+_MISSING = object()
+_shared = {}
+_shared_lock = threading.Lock()
+
+
+def _is_concrete(revnum):
+    return revnum is not None and revnum >= 0
+
+
+def _copy(value):
+    if isinstance(value, dict):
+        return dict((k, _copy(v)) for (k, v) in value.items())
+    if isinstance(value, list):
+        return [_copy(v) for v in value]
+    if isinstance(value, tuple):
+        return tuple(_copy(v) for v in value)
+    return value
+
+
+def _estimate_size(value):
+    """Estimate the memory used by a result, including its contents."""
+    size = sys.getsizeof(value)
+    if isinstance(value, dict):
+        for (k, v) in value.items():
+            size += _estimate_size(k) + _estimate_size(v)
+    elif isinstance(value, (list, tuple)):
+        for v in value:
+            size += _estimate_size(v)
+    return size
+
+
+class MetadataCache(object):
+    """Bounded least-recently-used cache of revision metadata.
+
+    :param max_size: Maximum estimated size of the cached results, in bytes
+    """
+
+    def __init__(self, max_size=DEFAULT_MAX_SIZE):
+        self.max_size = max_size
+        self.size = 0
+        self._entries = OrderedDict()
+        self._lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+
+    @classmethod
+    def shared(cls, uuid):
+        """Return the cache shared by all sessions to a repository."""
+        with _shared_lock:
+            try:
+                return _shared[uuid]
+            except KeyError:
+                cache = _shared[uuid] = cls()
+                return cache
+
+    def __len__(self):
+        return len(self._entries)
+
+    @property
+    def hit_rate(self):
+        """Fraction of lookups answered from the cache."""
+        total = self.hits + self.misses
+        if total == 0:
+            return 0.0
+        return float(self.hits) / total
+
+    def stats(self):
+        """Return a dictionary with the hits, misses and size of the cache."""
+        return {"hits": self.hits, "misses": self.misses,
+                "entries": len(self._entries), "size": self.size,
+                "hit_rate": self.hit_rate}
+
+    def clear(self):
+        with self._lock:
+            self._entries.clear()
+            self.size = 0
+            self.hits = 0
+            self.misses = 0
+
+    def get(self, key, default=None):
+        """Return the cached value for key, or default on a miss."""
+        with self._lock:
+            try:
+                entry = self._entries.pop(key)
+            except KeyError:
+                self.misses += 1
+                return default
+            self._entries[key] = entry
+            self.hits += 1
+        return _copy(entry[0])
+
+    def lookup(self, key, fetch):
+        """Return the cached value for key, calling fetch() on a miss."""
+        value = self.get(key, _MISSING)
+        if value is _MISSING:
+            value = fetch()
+            self.store(key, value)
+        return value
+
+    def store(self, key, value):
+        value = _copy(value)
+        size = _estimate_size(key) + _estimate_size(value)
+        with self._lock:
+            self._remove(key)
+            if size > self.max_size:
+                return
+            self._entries[key] = (value, size)
+            self.size += size
+            while self.size > self.max_size:
+                (_, (_, old_size)) = self._entries.popitem(last=False)
+                self.size -= old_size
+
+    def _remove(self, key):
+        entry = self._entries.pop(key, None)
+        if entry is not None:
+            self.size -= entry[1]
+
+    def invalidate(self, key):
+        with self._lock:
+            self._remove(key)
+
+
+class MetadataCachingRemoteAccess(object):
+    """RemoteAccess wrapper that caches metadata for concrete revisions.
+
+    All other attributes are looked up on the wrapped object.
+
+    :param ra: RemoteAccess object
+    :param cache: MetadataCache to use; defaults to the cache shared by all
+        sessions to the same repository
+    """
+
+    def __init__(self, ra, cache=None):
+        self._ra = ra
+        if cache is None:
+            cache = MetadataCache.shared(ra.get_uuid())
+        self.metadata_cache = cache
+        self._root = uri_canonicalize(ra.get_repos_root())
+
+    def __getattr__(self, name):
+        return getattr(self._ra, name)
+
+    def _key(self, path):
+        url = uri_canonicalize(self._ra.get_session_url())
+        relpath = unquote(url[len(self._root):])
+        return "/".join(
+            p for p in (relpath + "/" + path).split("/") if p not in ("", "."))
+
+    def stat(self, path, revnum):
+        if not _is_concrete(revnum):
+            return self._ra.stat(path, revnum)
+        return self.metadata_cache.lookup(
+            ("stat", self._key(path), revnum),
+            lambda: self._ra.stat(path, revnum))
+
+    def check_path(self, path, revnum):
+        if not _is_concrete(revnum):
+            return self._ra.check_path(path, revnum)
+        return self.metadata_cache.lookup(
+            ("check_path", self._key(path), revnum),
+            lambda: self._ra.check_path(path, revnum))
+
+    def get_dir(self, path, revision=-1, dirent_fields=-1):
+        if not _is_concrete(revision):
+            return self._ra.get_dir(path, revision, dirent_fields)
+        return self.metadata_cache.lookup(
+            ("get_dir", self._key(path), revision, dirent_fields),
+            lambda: self._ra.get_dir(path, revision, dirent_fields))
+
+    def get_locations(self, path, peg_revision, location_revisions):
+        if not _is_concrete(peg_revision):
+            return self._ra.get_locations(path, peg_revision,
+                                          location_revisions)
+        key = self._key(path)
+        ret = {}
+        missing = []
+        for revnum in location_revisions:
+            location = self.metadata_cache.get(
+                ("location", key, peg_revision, revnum), _MISSING)
+            if location is _MISSING:
+                missing.append(revnum)
+            elif location is not None:
+                ret[revnum] = location
+        if missing:
+            fetched = self._ra.get_locations(path, peg_revision, missing)
+            for revnum in missing:
+                location = fetched.get(revnum)
+                self.metadata_cache.store(
+                    ("location", key, peg_revision, revnum), location)
+                if location is not None:
+                    ret[revnum] = location
+        return ret
+
+    def rev_proplist(self, revnum, lazy=False):
+        if lazy or not _is_concrete(revnum):
+            return self._ra.rev_proplist(revnum, lazy)
+        return self.metadata_cache.lookup(
+            ("rev_proplist", revnum),
+            lambda: self._ra.rev_proplist(revnum))
+
+    def change_rev_prop(self, revnum, name, value, *args):
+        self.metadata_cache.invalidate(("rev_proplist", revnum))
+        return self._ra.change_rev_prop(revnum, name, value, *args)
@@ -20,6 +20,8 @@
 #ifndef _BZR_SVN_RA_H_
 #define _BZR_SVN_RA_H_
 
+#include <svn_ra.h>
+
 typedef struct {
     PyObject_HEAD
     svn_auth_baton_t *auth_baton;
@@ -27,4 +29,53 @@ typedef struct {
     PyObject *providers;
 } AuthObject;
 
+#if ONLY_SINCE_SVN(1, 5)
+#define REPORTER_T svn_ra_reporter3_t
+#else
+#define REPORTER_T svn_ra_reporter2_t
+#endif
+
+struct ra_async_call;
+struct ra_scratch_file;
+
+extern const subvertpy_type_def_t ra_types[];
+
+/** Connection to a remote Subversion repository. */
+typedef struct {
+    PyObject_VAR_HEAD
+    svn_ra_session_t *ra;
+    apr_pool_t *pool;
+    const char *url;
+    progress_state_t progress;
+    AuthObject *auth;
+    subvertpy_flag_t busy;
+    scratch_pool_t scratch;
+    /* Pending calls made through the awaitable methods. */
+    struct ra_async_call *async_head, *async_tail;
+    bool async_running;
+    /* Interpreter the session was opened in, and that its worker
+     * threads run Python code in. */
+    PyInterpreterState *interp;
+    PyObject *client_string_func;
+    PyObject *open_tmp_file_func;
+    /* Scratch files currently kept in memory, and where to spill to once
+     * they hold scratch_memory_limit bytes, checked as files are opened;
+     * see set_tmp_file_options(). */
+    struct ra_scratch_file *scratch_files;
+    apr_off_t scratch_memory_limit;
+    const char *scratch_dir;
+    const char *root;
+    const char *corrected_url;
+} RemoteAccessObject;
+
+/* Reporter returned by RemoteAccess.do_update() and friends. Also used
+ * by the wc module, which drives it directly. */
+typedef struct {
+    PyObject_VAR_HEAD
+    const REPORTER_T *reporter;
+    void *report_baton;
+    apr_pool_t *pool;
+    RemoteAccessObject *ra;
+} ReporterObject;
+
 #endif /* _BZR_SVN_RA_H_ */
@@ -17,6 +17,8 @@
 
 __author__ = "Jelmer Vernooij <jelmer@jelmer.uk>"
 
+import threading
+
 from subvertpy import SubversionException, ERR_BAD_URL
 
 from subvertpy import _ra
@@ -51,3 +53,40 @@ def RemoteAccess(url, *args, **kwargs):
     if type not in url_handlers:
         raise SubversionException("Unknown URL type '%s'" % type, ERR_BAD_URL)
     return url_handlers[type](url, *args, **kwargs)
+
+
+def get_locations_many(sessions, requests):
+    """Look up the locations of many paths over several sessions.
+
+    The requests are split between the sessions, each of which handles its
+    share with ``RemoteAccess.get_locations_many`` on a separate thread.
+
+    :param sessions: RemoteAccess objects, all opened at the same URL
+    :param requests: List of (path, peg_revision, location_revisions) tuples
+    :return: List with a revision number to path dictionary per request
+    """
+    requests = list(requests)
+    sessions = list(sessions)[:max(len(requests), 1)]
+    if not sessions:
+        raise ValueError("at least one session is required")
+    chunk = -(-len(requests) // len(sessions))
+    results = [None] * len(sessions)
+    errors = []
+
+    def run(i):
+        try:
+            results[i] = sessions[i].get_locations_many(
+                requests[i*chunk:(i+1)*chunk])
+        except BaseException as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=run, args=(i, ))
+               for i in range(1, len(sessions))]
+    for t in threads:
+        t.start()
+    run(0)
+    for t in threads:
+        t.join()
+    if errors:
+        raise errors[0]
+    return [locations for ret in results for locations in ret]
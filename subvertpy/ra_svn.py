@@ -26,6 +26,7 @@ import os
 import socket
 import subprocess
 from errno import EPIPE
+from hashlib import md5
 try:
     import urlparse
 except ImportError:
@@ -42,9 +43,12 @@ from subvertpy import (
     properties,
     )
 from subvertpy.delta import (
-    pack_svndiff0_window,
+    apply_txdelta_handler_chunks,
+    pack_svndiff0_window_header,
     unpack_svndiff0,
+    DELTA_WINDOW_SIZE,
     SVNDIFF0_HEADER,
+    TXDELTA_NEW,
     )
 from subvertpy.marshall import (
     NeedMoreData,
@@ -130,6 +134,19 @@ class SVNConnection(object):
         # self.mutter("OUT: %r" % marshalled_data)
         self.send_fn(marshalled_data)
 
+    def send_string_msg(self, command, id, parts):
+        """Send a command with an id and a string made up of several parts.
+
+        The parts are written out one by one rather than joined first.
+        """
+        length = sum(len(part) for part in parts)
+        self.send_fn(b"( " + marshall(literal(command)) + b"( " +
+                     marshall(id) + ("%d:" % length).encode("ascii"))
+        for part in parts:
+            if len(part):
+                self.send_fn(part)
+        self.send_fn(b" ) ) ")
+
     def send_success(self, *contents):
         self.send_msg([literal("success"), list(contents)])
 
@@ -393,10 +410,38 @@ class FileEditor(object):
             if delta is None:
                 self.conn.send_msg([literal("textdelta-end"), [self.id]])
             else:
-                self.conn.send_msg([literal("textdelta-chunk"),
-                                   [self.id, pack_svndiff0_window(delta)]])
+                self.conn.send_string_msg(
+                    "textdelta-chunk", self.id,
+                    [pack_svndiff0_window_header(delta), delta[5]])
         return send_textdelta
 
+    def send_stream(self, stream, base_checksum=None,
+                    chunk_size=DELTA_WINDOW_SIZE):
+        """Send the contents of a file-like object as the new file text.
+
+        At most chunk_size bytes are read at a time, and sent as a single
+        window, so memory use does not depend on the size of the file.
+
+        :param stream: File-like object to read the text from
+        :param base_checksum: Checksum of the base text
+        :param chunk_size: Size of the windows to send
+        :return: MD5 hex digest of the text, to pass to close()
+        """
+        handler = self.apply_textdelta(base_checksum)
+        hash = md5()
+        while True:
+            data = stream.read(chunk_size)
+            if not data:
+                break
+            hash.update(data)
+            window = (0, 0, len(data), 0, [(TXDELTA_NEW, 0, len(data))],
+                      data)
+            self.conn.send_string_msg(
+                "textdelta-chunk", self.id,
+                [pack_svndiff0_window_header(window), data])
+        handler(None)
+        return hash.hexdigest()
+
     def change_prop(self, name, value):
         self._is_last_open()
         if value is None:
@@ -422,6 +467,22 @@ def mark_busy(unbound):
     return convert
 
 
+def mark_busy_iter(unbound):
+    """Like mark_busy, for generators: busy until exhausted or closed."""
+
+    def convert(self, *args, **kwargs):
+        self.busy = True
+        try:
+            for item in unbound(self, *args, **kwargs):
+                yield item
+        finally:
+            self.busy = False
+
+    convert.__doc__ = unbound.__doc__
+    convert.__name__ = unbound.__name__
+    return convert
+
+
 def unmarshall_dirent(d):
     ret = {
         "name": d[0],
@@ -529,8 +590,64 @@ class SVNClient(SVNConnection):
             user, password, host, port, ["svnserve", "-t"])
         return (self._tunnel.recv, self._tunnel.send)
 
-    def get_file_revs(self, path, start, end, file_rev_handler):
-        raise NotImplementedError(self.get_file_revs)
+    def _file_revs(self, path, start, end, include_merged_revisions):
+        args = [path]
+        for rev in (start, end):
+            if rev is None or rev == -1:
+                args.append([])
+            else:
+                args.append([rev])
+        args.append(include_merged_revisions)
+        self.send_msg([literal("get-file-revs"), args])
+        self._recv_ack()
+        while True:
+            msg = self.recv_msg()
+            if msg == "done":
+                break
+            chunks = []
+            while True:
+                chunk = self.recv_msg()
+                if not chunk:
+                    break
+                chunks.append(chunk)
+            result_of_merge = len(msg) > 4 and bool(msg[4])
+            prop_diffs = [(name, value[0] if value else None)
+                          for (name, value) in msg[3]]
+            yield (msg[0], msg[1], dict(msg[2]), prop_diffs,
+                   result_of_merge, b"".join(chunks))
+        self._unpack()
+
+    @mark_busy
+    def get_file_revs(self, path, start, end, file_rev_handler,
+                      include_merged_revisions=False):
+        for (path, rev, revprops, prop_diffs, result_of_merge,
+             diff) in self._file_revs(path, start, end,
+                                      include_merged_revisions):
+            handler = file_rev_handler(path, rev, revprops, result_of_merge)
+            if diff and handler is not None:
+                for window in unpack_svndiff0(diff):
+                    handler(window)
+                handler(None)
+
+    @mark_busy_iter
+    def iter_file_revs(self, path, start, end, include_merged_revisions=False,
+                       fulltext=True, max_queue=16):
+        # max_queue is accepted for compatibility with _ra; entries are
+        # read off the connection as they are consumed.
+        text = b""
+        for (path, rev, revprops, prop_diffs, result_of_merge,
+             diff) in self._file_revs(path, start, end,
+                                      include_merged_revisions):
+            if not fulltext:
+                yield (rev, path, revprops, diff or None, prop_diffs)
+                continue
+            if diff:
+                target = []
+                handler = apply_txdelta_handler_chunks([text], target)
+                for window in unpack_svndiff0(diff):
+                    handler(window)
+                text = b"".join(target)
+            yield (rev, path, revprops, text, prop_diffs)
 
     @mark_busy
     def get_locations(self, path, peg_revision, location_revisions):
@@ -690,7 +807,9 @@ class SVNClient(SVNConnection):
         self._recv_ack()
         raise NotImplementedError(self.get_commit_editor)
 
-    def rev_proplist(self, revision):
+    def rev_proplist(self, revision, lazy=False):
+        # lazy is accepted for compatibility with _ra; the properties
+        # have already been decoded off the wire.
         self.send_msg([literal("rev-proplist"), [revision]])
         self._recv_ack()
         return dict(self._unpack()[0])
@@ -25,6 +25,7 @@
 #include <apr_md5.h>
 
 #include "util.h"
+#include "stats.h"
 
 extern PyTypeObject FileSystemRoot_Type;
 extern PyTypeObject Repository_Type;
@@ -74,7 +75,7 @@ static PyObject *repos_create(PyObject *self, PyObject *args)
 											 path, NULL, NULL,
 											 hash_config, hash_fs_config, pool));
 
-	ret = PyObject_New(RepositoryObject, &Repository_Type);
+	ret = PyObject_New(RepositoryObject, SUBVERTPY_TYPE(Repository_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -89,7 +90,7 @@ static void repos_dealloc(PyObject *self)
 	RepositoryObject *repos = (RepositoryObject *)self;
 
 	apr_pool_destroy(repos->pool);
-	PyObject_Del(repos);
+	py_object_del(repos);
 }
 
 static PyObject *repos_init(PyTypeObject *type, PyObject *args, PyObject *kwargs)
@@ -103,13 +104,13 @@ static PyObject *repos_init(PyTypeObject *type, PyObject *args, PyObject *kwargs
 	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwnames, &py_path))
 		return NULL;
 
-	ret = PyObject_New(RepositoryObject, &Repository_Type);
+	ret = PyObject_New(RepositoryObject, SUBVERTPY_TYPE(Repository_Type));
 	if (ret == NULL)
 		return NULL;
 
 	ret->pool = Pool(NULL);
 	if (ret->pool == NULL) {
-		PyObject_DEL(ret);
+		py_object_del(ret);
 		return NULL;
 	}
 
@@ -136,6 +137,7 @@ static PyObject *repos_init(PyTypeObject *type, PyObject *args, PyObject *kwargs
 typedef struct {
 	PyObject_VAR_HEAD
 	apr_pool_t *pool;
+	scratch_pool_t scratch;
 	svn_fs_root_t *root;
 } FileSystemRootObject;
 
@@ -158,7 +160,7 @@ static PyObject *repos_fs(PyObject *self)
 		return NULL;
 	}
 
-	ret = PyObject_New(FileSystemObject, &FileSystem_Type);
+	ret = PyObject_New(FileSystemObject, SUBVERTPY_TYPE(FileSystem_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -218,12 +220,13 @@ static PyObject *fs_get_revision_root(FileSystemObject *self, PyObject *args)
 
 	RUN_SVN_WITH_POOL(pool, svn_fs_revision_root(&root, self->fs, rev, pool));
 
-	ret = PyObject_New(FileSystemRootObject, &FileSystemRoot_Type);
+	ret = PyObject_New(FileSystemRootObject, SUBVERTPY_TYPE(FileSystemRoot_Type));
 	if (ret == NULL)
 		return NULL;
 
 	ret->root = root;
 	ret->pool = pool;
+	scratch_pool_init(&ret->scratch);
 
 	return (PyObject *)ret;
 }
@@ -263,7 +266,7 @@ static void fs_dealloc(PyObject *self)
 {
 	FileSystemObject *fsobj = (FileSystemObject *)self;
 	Py_DECREF(fsobj->repos);
-	PyObject_DEL(fsobj);
+	py_object_del(fsobj);
 }
 
 PyTypeObject FileSystem_Type = {
@@ -444,6 +447,11 @@ static PyMethodDef repos_module_methods[] = {
 		"api_version() -> (major, minor, patch, tag)\n\n"
 		"Version of libsvn_client Subvertpy was compiled against."
 	},
+	{ "pool_stats", (PyCFunction)py_pool_stats, METH_NOARGS,
+		"pool_stats() -> dict\n\n"
+		"Counts of APR pools created, currently live, live at the same time\n"
+		"at most and reused as scratch pools by this module." },
+	STATS_METHODS,
 	{ "version", (PyCFunction)version, METH_NOARGS,
 		"version() -> (major, minor, patch, tag)\n\n"
 		"Version of libsvn_wc currently used."
@@ -621,7 +629,7 @@ static void fs_root_dealloc(PyObject *self)
 	FileSystemRootObject *fsobj = (FileSystemRootObject *)self;
 
 	apr_pool_destroy(fsobj->pool);
-	PyObject_DEL(fsobj);
+	py_object_del(fsobj);
 }
 
 static PyObject *py_string_from_svn_node_id(const svn_fs_id_t *id)
@@ -689,19 +697,19 @@ static PyObject *fs_root_paths_changed(FileSystemRootObject *self)
 	apr_ssize_t klen;
 	apr_hash_index_t *idx;
 	PyObject *ret;
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&self->scratch, self->pool);
 	if (temp_pool == NULL)
 		return NULL;
 #if ONLY_SINCE_SVN(1, 6)
-	RUN_SVN_WITH_POOL(temp_pool,
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool,
 					  svn_fs_paths_changed2(&changed_paths, self->root, temp_pool));
 #else
-	RUN_SVN_WITH_POOL(temp_pool,
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool,
 					  svn_fs_paths_changed(&changed_paths, self->root, temp_pool));
 #endif
 	ret = PyDict_New();
 	if (ret == NULL) {
-		apr_pool_destroy(temp_pool);
+		scratch_pool_release(&self->scratch, temp_pool);
 		return NULL;
 	}
 
@@ -720,20 +728,20 @@ static PyObject *fs_root_paths_changed(FileSystemRootObject *self)
 		py_val = py_fs_path_change(val);
 #endif
 		if (py_val == NULL) {
-			apr_pool_destroy(temp_pool);
-			PyObject_Del(ret);
+			scratch_pool_release(&self->scratch, temp_pool);
+			Py_DECREF(ret);
 			return NULL;
 		}
 		if (PyDict_SetItemString(ret, key, py_val) != 0) {
-			apr_pool_destroy(temp_pool);
-			PyObject_Del(ret);
+			scratch_pool_release(&self->scratch, temp_pool);
+			Py_DECREF(ret);
 			Py_DECREF(py_val);
 			return NULL;
 		}
 
 		Py_DECREF(py_val);
 	}
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&self->scratch, temp_pool);
 	return ret;
 }
 
@@ -746,12 +754,12 @@ static PyObject *fs_root_is_dir(FileSystemRootObject *self, PyObject *args)
 	if (!PyArg_ParseTuple(args, "s", &path))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&self->scratch, self->pool);
 	if (temp_pool == NULL)
 		return NULL;
-	RUN_SVN_WITH_POOL(temp_pool, svn_fs_is_dir(&is_dir, self->root,
-											   path, temp_pool));
-	apr_pool_destroy(temp_pool);
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool,
+		svn_fs_is_dir(&is_dir, self->root, path, temp_pool));
+	scratch_pool_release(&self->scratch, temp_pool);
 	return PyBool_FromLong(is_dir);
 }
 
@@ -764,12 +772,12 @@ static PyObject *fs_root_is_file(FileSystemRootObject *self, PyObject *args)
 	if (!PyArg_ParseTuple(args, "s", &path))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&self->scratch, self->pool);
 	if (temp_pool == NULL)
 		return NULL;
-	RUN_SVN_WITH_POOL(temp_pool, svn_fs_is_file(&is_file, self->root,
-											   path, temp_pool));
-	apr_pool_destroy(temp_pool);
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool,
+		svn_fs_is_file(&is_file, self->root, path, temp_pool));
+	scratch_pool_release(&self->scratch, temp_pool);
 	return PyBool_FromLong(is_file);
 }
 
@@ -782,12 +790,12 @@ static PyObject *fs_root_file_length(FileSystemRootObject *self, PyObject *args)
 	if (!PyArg_ParseTuple(args, "s", &path))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&self->scratch, self->pool);
 	if (temp_pool == NULL)
 		return NULL;
-	RUN_SVN_WITH_POOL(temp_pool, svn_fs_file_length(&filesize, self->root,
-											   path, temp_pool));
-	apr_pool_destroy(temp_pool);
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool,
+		svn_fs_file_length(&filesize, self->root, path, temp_pool));
+	scratch_pool_release(&self->scratch, temp_pool);
 	return PyLong_FromLong(filesize);
 }
 
@@ -801,13 +809,13 @@ static PyObject *fs_node_file_proplist(FileSystemRootObject *self, PyObject *arg
 	if (!PyArg_ParseTuple(args, "s", &path))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&self->scratch, self->pool);
 	if (temp_pool == NULL)
 		return NULL;
-	RUN_SVN_WITH_POOL(temp_pool, svn_fs_node_proplist(&proplist, self->root,
-											   path, temp_pool));
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool,
+		svn_fs_node_proplist(&proplist, self->root, path, temp_pool));
 	ret = prop_hash_to_dict(proplist);
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&self->scratch, temp_pool);
 	return ret;
 }
 
@@ -829,11 +837,11 @@ static PyObject *fs_root_file_checksum(FileSystemRootObject *self, PyObject *arg
 	if (!PyArg_ParseTuple(args, "s|ib", &path, &kind, &force))
 		return NULL;
 
-	temp_pool = Pool(NULL);
+	temp_pool = scratch_pool_acquire(&self->scratch, self->pool);
 	if (temp_pool == NULL)
 		return NULL;
 #if ONLY_SINCE_SVN(1, 6)
-	RUN_SVN_WITH_POOL(temp_pool, svn_fs_file_checksum(
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool, svn_fs_file_checksum(
 		&checksum, kind, self->root, path, force?TRUE:FALSE, temp_pool));
 	cstr = svn_checksum_to_cstring(checksum, temp_pool);
 	if (cstr == NULL) {
@@ -845,15 +853,15 @@ static PyObject *fs_root_file_checksum(FileSystemRootObject *self, PyObject *arg
 #else
 	if (kind > 0)  {
 		PyErr_SetString(PyExc_ValueError, "Only MD5 checksums allowed with subversion < 1.6");
+		scratch_pool_release(&self->scratch, temp_pool);
 		return NULL;
 	}
 
-	RUN_SVN_WITH_POOL(temp_pool, svn_fs_file_md5_checksum(checksum,
-													  self->root,
-											   path, temp_pool));
+	RUN_SVN_WITH_SCRATCH_POOL(&self->scratch, temp_pool,
+		svn_fs_file_md5_checksum(checksum, self->root, path, temp_pool));
 	ret = PyBytes_FromStringAndSize((char *)checksum, APR_MD5_DIGESTSIZE);
 #endif
-	apr_pool_destroy(temp_pool);
+	scratch_pool_release(&self->scratch, temp_pool);
 	return ret;
 }
 
@@ -873,7 +881,7 @@ static PyObject *fs_root_file_contents(FileSystemRootObject *self, PyObject *arg
 	RUN_SVN_WITH_POOL(pool, svn_fs_file_contents(&stream, self->root,
 											   path, pool));
 
-	ret = PyObject_New(StreamObject, &Stream_Type);
+	ret = PyObject_New(StreamObject, SUBVERTPY_TYPE(Stream_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -956,48 +964,26 @@ PyTypeObject FileSystemRoot_Type = {
 };
 
 
-static PyObject *moduleinit(void)
-{
-	static apr_pool_t *pool;
-	PyObject *mod;
-
-	if (PyType_Ready(&Repository_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&FileSystem_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&FileSystemRoot_Type) < 0)
-		return NULL;
+static const subvertpy_type_def_t repos_types[] = {
+	{ FileSystem_Type_ID, &FileSystem_Type },
+	{ Repository_Type_ID, &Repository_Type },
+	{ FileSystemRoot_Type_ID, &FileSystemRoot_Type },
+	{ 0, NULL }
+};
 
-	if (PyType_Ready(&Stream_Type) < 0)
-		return NULL;
+static int repos_exec(PyObject *mod)
+{
+	if (subvertpy_state_init(mod) < 0)
+		return -1;
 
-	apr_initialize();
-	pool = Pool(NULL);
-	if (pool == NULL)
-		return NULL;
+	if (subvertpy_add_types(mod, util_types) < 0)
+		return -1;
 
-	svn_fs_initialize(pool);
+	if (subvertpy_add_types(mod, repos_types) < 0)
+		return -1;
 
-#if PY_MAJOR_VERSION >= 3
-	static struct PyModuleDef moduledef = {
-	  PyModuleDef_HEAD_INIT,
-	  "repos",         /* m_name */
-	  "Local repository management.", /* m_doc */
-	  -1,              /* m_size */
-	  repos_module_methods, /* m_methods */
-	  NULL,            /* m_reload */
-	  NULL,            /* m_traverse */
-	  NULL,            /* m_clear*/
-	  NULL,            /* m_free */
-	};
-	mod = PyModule_Create(&moduledef);
-#else
-	mod = Py_InitModule3("repos", repos_module_methods, "Local repository management");
-#endif
-	if (mod == NULL)
-		return NULL;
+	if (!subvertpy_global_init(svn_fs_initialize))
+		return -1;
 
 	PyModule_AddIntConstant(mod, "LOAD_UUID_DEFAULT", svn_repos_load_uuid_default);
 	PyModule_AddIntConstant(mod, "LOAD_UUID_IGNORE", svn_repos_load_uuid_ignore);
@@ -1015,25 +1001,63 @@ static PyObject *moduleinit(void)
 	PyModule_AddIntConstant(mod, "CHECKSUM_MD5", 0);
 #endif
 
-	PyModule_AddObject(mod, "Repository", (PyObject *)&Repository_Type);
-	Py_INCREF(&Repository_Type);
+	PyModule_AddObject(mod, "Repository", (PyObject *)SUBVERTPY_TYPE(Repository_Type));
+	Py_INCREF(SUBVERTPY_TYPE(Repository_Type));
 
-	PyModule_AddObject(mod, "Stream", (PyObject *)&Stream_Type);
-	Py_INCREF(&Stream_Type);
+	PyModule_AddObject(mod, "Stream", (PyObject *)SUBVERTPY_TYPE(Stream_Type));
+	Py_INCREF(SUBVERTPY_TYPE(Stream_Type));
 
-	return mod;
+	return 0;
 }
 
+#if PY_VERSION_HEX >= 0x03050000
+static PyModuleDef_Slot repos_module_slots[] = {
+	{ Py_mod_exec, repos_exec },
+	SUBVERTPY_MODULE_SLOTS
+	{ 0, NULL }
+};
+#endif
+
 #if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef moduledef = {
+	PyModuleDef_HEAD_INIT,
+	"repos",         /* m_name */
+	"Local repository management.", /* m_doc */
+	SUBVERTPY_STATE_SIZE,              /* m_size */
+	repos_module_methods, /* m_methods */
+#if PY_VERSION_HEX >= 0x03050000
+	repos_module_slots, /* m_slots */
+#else
+	NULL,            /* m_reload */
+#endif
+	subvertpy_state_traverse, /* m_traverse */
+	subvertpy_state_clear, /* m_clear*/
+	subvertpy_state_free, /* m_free */
+};
+#endif
+
+#if PY_VERSION_HEX >= 0x03050000
 PyMODINIT_FUNC
 PyInit_repos(void)
 {
-	return moduleinit();
+	return PyModuleDef_Init(&moduledef);
+}
+#elif PY_MAJOR_VERSION >= 3
+PyMODINIT_FUNC
+PyInit_repos(void)
+{
+	PyObject *mod = PyModule_Create(&moduledef);
+	if (mod != NULL && repos_exec(mod) < 0)
+		Py_CLEAR(mod);
+	return mod;
 }
 #else
 PyMODINIT_FUNC
 initrepos(void)
 {
-	moduleinit();
+	PyObject *mod = Py_InitModule3("repos", repos_module_methods,
+								   "Local repository management");
+	if (mod != NULL)
+		repos_exec(mod);
 }
 #endif
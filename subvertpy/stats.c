@@ -0,0 +1,282 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#include <Python.h>
+#include <apr_general.h>
+#include <svn_types.h>
+#include <stdbool.h>
+
+#include "util.h"
+#include "stats.h"
+
+bool stats_enabled = false;
+/* Protects the counters and the span callback on free-threaded builds.
+ * No Python code is run while it is held. */
+static subvertpy_mutex_t stats_lock;
+static stats_op_t *stats_ops = NULL;
+/* The counters are shared by all interpreters, but the span callback
+ * can only be called from the interpreter it belongs to. */
+static PyObject *stats_span_callback = NULL;
+static PyInterpreterState *stats_span_interp = NULL;
+
+static stats_op_t *stats_lookup(const char *name, stats_kind_t kind)
+{
+	stats_op_t *op;
+
+	for (op = stats_ops; op != NULL; op = op->next) {
+		if (op->kind == kind && !strcmp(op->name, name))
+			return op;
+	}
+
+	op = PyMem_Malloc(sizeof(stats_op_t));
+	if (op == NULL)
+		return NULL;
+	memset(op, 0, sizeof(stats_op_t));
+	op->name = name;
+	op->kind = kind;
+	op->next = stats_ops;
+	stats_ops = op;
+	return op;
+}
+
+static const char *stats_kind_name(stats_kind_t kind)
+{
+	return kind == STATS_OPERATION?"operation":"callback";
+}
+
+/**
+ * Hand a finished call to the span callback.
+ *
+ * Exceptions raised by the callback are reported as unraisable; an
+ * exception that was already set (e.g. by a failing Python callback) is
+ * preserved.
+ */
+static void stats_export_span(PyObject *callback, stats_op_t *op,
+							  apr_time_t start, apr_time_t end,
+							  apr_off_t bytes, bool failed)
+{
+	PyObject *type, *value, *tb, *ret;
+
+	PyErr_Fetch(&type, &value, &tb);
+	ret = PyObject_CallFunction(callback, "sLL{s:s,s:L,s:O}",
+								op->name,
+								(long long)start * 1000,
+								(long long)end * 1000,
+								"subvertpy.kind", stats_kind_name(op->kind),
+								"subvertpy.bytes", (long long)bytes,
+								"error", failed?Py_True:Py_False);
+	if (ret == NULL)
+		PyErr_WriteUnraisable(callback);
+	Py_XDECREF(ret);
+	PyErr_Restore(type, value, tb);
+}
+
+/**
+ * Record a call that started at start and has just finished.
+ *
+ * Must be called with the GIL held. slot caches the counters for name,
+ * which should be a string constant.
+ */
+void stats_record(stats_op_t **slot, const char *name, stats_kind_t kind,
+				  apr_time_t start, apr_off_t bytes, bool failed)
+{
+	stats_op_t *op;
+	apr_time_t end = apr_time_now(), duration = end - start;
+	apr_time_t d;
+	int bucket = 0;
+	PyObject *callback;
+
+	for (d = duration; d > 0 && bucket < STATS_BUCKETS - 1; d >>= 1)
+		bucket++;
+
+	subvertpy_mutex_lock(&stats_lock);
+	op = *slot;
+	if (op == NULL) {
+		op = *slot = stats_lookup(name, kind);
+		if (op == NULL) {
+			subvertpy_mutex_unlock(&stats_lock);
+			PyErr_Clear();
+			return;
+		}
+	}
+
+	op->calls++;
+	if (failed)
+		op->errors++;
+	op->total += duration;
+	if (duration > op->max)
+		op->max = duration;
+	op->bytes += bytes;
+	op->histogram[bucket]++;
+
+	callback = NULL;
+	if (stats_span_interp == subvertpy_current_interp()) {
+		callback = stats_span_callback;
+		Py_XINCREF(callback);
+	}
+	subvertpy_mutex_unlock(&stats_lock);
+
+	if (callback != NULL) {
+		stats_export_span(callback, op, start, end, bytes, failed);
+		Py_DECREF(callback);
+	}
+}
+
+static PyObject *stats_op_to_python(stats_op_t *op)
+{
+	PyObject *histogram;
+	int i;
+
+	histogram = PyTuple_New(STATS_BUCKETS);
+	if (histogram == NULL)
+		return NULL;
+	for (i = 0; i < STATS_BUCKETS; i++) {
+		PyObject *count = PyLong_FromUnsignedLong(op->histogram[i]);
+		if (count == NULL) {
+			Py_DECREF(histogram);
+			return NULL;
+		}
+		PyTuple_SET_ITEM(histogram, i, count);
+	}
+
+	return Py_BuildValue("{s:k,s:k,s:d,s:d,s:L,s:N}",
+						 "calls", op->calls,
+						 "errors", op->errors,
+						 "time", (double)op->total / APR_USEC_PER_SEC,
+						 "max", (double)op->max / APR_USEC_PER_SEC,
+						 "bytes", (long long)op->bytes,
+						 "histogram", histogram);
+}
+
+/**
+ * Return a snapshot of the counters of this module.
+ */
+PyObject *py_stats_snapshot(PyObject *self)
+{
+	PyObject *operations, *callbacks, *pools, *ret;
+	stats_op_t *op, copy;
+
+	operations = PyDict_New();
+	callbacks = PyDict_New();
+	if (operations == NULL || callbacks == NULL)
+		goto fail;
+
+	/* Counters are never freed and only ever prepended to the list, so
+	 * it can be walked without the lock; each entry is copied with the
+	 * lock held before it is converted. */
+	subvertpy_mutex_lock(&stats_lock);
+	op = stats_ops;
+	subvertpy_mutex_unlock(&stats_lock);
+	for (; op != NULL; op = copy.next) {
+		PyObject *item;
+		subvertpy_mutex_lock(&stats_lock);
+		copy = *op;
+		subvertpy_mutex_unlock(&stats_lock);
+		if (copy.calls == 0)
+			continue;
+		item = stats_op_to_python(&copy);
+		if (item == NULL)
+			goto fail;
+		if (PyDict_SetItemString(
+				copy.kind == STATS_OPERATION?operations:callbacks,
+				copy.name, item) != 0) {
+			Py_DECREF(item);
+			goto fail;
+		}
+		Py_DECREF(item);
+	}
+
+	pools = py_pool_stats(self);
+	if (pools == NULL)
+		goto fail;
+
+	ret = Py_BuildValue("{s:O,s:N,s:N,s:N}",
+						"enabled", stats_enabled?Py_True:Py_False,
+						"operations", operations,
+						"callbacks", callbacks,
+						"pools", pools);
+	return ret;
+
+fail:
+	Py_XDECREF(operations);
+	Py_XDECREF(callbacks);
+	return NULL;
+}
+
+PyObject *py_stats_reset(PyObject *self)
+{
+	stats_op_t *op;
+
+	subvertpy_mutex_lock(&stats_lock);
+	for (op = stats_ops; op != NULL; op = op->next) {
+		stats_op_t *next = op->next;
+		const char *name = op->name;
+		stats_kind_t kind = op->kind;
+		/* Call sites keep pointers to their counters, so they are
+		 * zeroed rather than freed. */
+		memset(op, 0, sizeof(stats_op_t));
+		op->name = name;
+		op->kind = kind;
+		op->next = next;
+	}
+	subvertpy_mutex_unlock(&stats_lock);
+	pool_stats_reset_peak();
+
+	Py_RETURN_NONE;
+}
+
+PyObject *py_stats_configure(PyObject *self, PyObject *args)
+{
+	PyObject *enabled, *span_callback, *old;
+	int is_enabled;
+
+	if (!PyArg_ParseTuple(args, "OO", &enabled, &span_callback))
+		return NULL;
+
+	is_enabled = PyObject_IsTrue(enabled);
+	if (is_enabled == -1)
+		return NULL;
+
+	if (span_callback != Py_None && !PyCallable_Check(span_callback)) {
+		PyErr_SetString(PyExc_TypeError, "span_callback should be callable");
+		return NULL;
+	}
+
+	if (span_callback == Py_None) {
+		span_callback = NULL;
+	} else {
+		Py_INCREF(span_callback);
+	}
+	subvertpy_mutex_lock(&stats_lock);
+	if (stats_span_callback != NULL &&
+		stats_span_interp != subvertpy_current_interp()) {
+		subvertpy_mutex_unlock(&stats_lock);
+		Py_XDECREF(span_callback);
+		PyErr_SetString(PyExc_RuntimeError,
+						"span callback was set by another interpreter");
+		return NULL;
+	}
+	old = stats_span_callback;
+	stats_span_callback = span_callback;
+	stats_span_interp = subvertpy_current_interp();
+	stats_enabled = is_enabled;
+	subvertpy_mutex_unlock(&stats_lock);
+	Py_XDECREF(old);
+
+	Py_RETURN_NONE;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2026 The Subvertpy contributors
+ * -*- coding: utf-8 -*-
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifndef _SUBVERTPY_STATS_H_
+#define _SUBVERTPY_STATS_H_
+
+#include <stdbool.h>
+#include <apr_time.h>
+
+#ifdef __GNUC__
+#pragma GCC visibility push(hidden)
+#endif
+
+/* Number of latency histogram buckets. Bucket i counts calls that took
+ * less than 2**i microseconds (and at least 2**(i-1)); the last bucket
+ * also counts everything slower. */
+#define STATS_BUCKETS 28
+
+typedef enum {
+	STATS_OPERATION,
+	STATS_CALLBACK,
+} stats_kind_t;
+
+/* Counters for a single operation or callback. */
+typedef struct stats_op {
+	const char *name;
+	stats_kind_t kind;
+	unsigned long calls;
+	unsigned long errors;
+	apr_time_t total;
+	apr_time_t max;
+	apr_off_t bytes;
+	unsigned long histogram[STATS_BUCKETS];
+	struct stats_op *next;
+} stats_op_t;
+
+/* Whether instrumentation is enabled for this module. Nothing but this
+ * flag is looked at when it is not. */
+extern bool stats_enabled;
+
+void stats_record(stats_op_t **slot, const char *name, stats_kind_t kind,
+				  apr_time_t start, apr_off_t bytes, bool failed);
+PyObject *py_stats_snapshot(PyObject *self);
+PyObject *py_stats_reset(PyObject *self);
+PyObject *py_stats_configure(PyObject *self, PyObject *args);
+
+#ifdef __GNUC__
+#pragma GCC visibility pop
+#endif
+
+/* Time the remainder of the enclosing block. The counters are cached in a
+ * static slot, so they are only looked up by name once per call site. */
+#define STATS_TIMER \
+	static stats_op_t *_stats_op = NULL; \
+	apr_time_t _stats_start = stats_enabled?apr_time_now():0
+
+#define STATS_TIMER_STOP(kind, bytes, failed) \
+	if (_stats_start != 0) { \
+		stats_record(&_stats_op, __func__, kind, _stats_start, bytes, \
+					 failed); \
+	}
+
+/* Like CB_CHECK_PYRETVAL, for callbacks timed with STATS_TIMER. */
+#define CB_CHECK_PYRETVAL_TIMED(ret) \
+	if (ret == NULL) { \
+		STATS_TIMER_STOP(STATS_CALLBACK, 0, true); \
+		PyGILState_Release(state); \
+		return py_svn_error(); \
+	}
+
+#define STATS_METHODS \
+	{ "_stats", (PyCFunction)py_stats_snapshot, METH_NOARGS, \
+		"_stats() -> dict\n\n" \
+		"Operation and callback counters of this module; see subvertpy.stats()." }, \
+	{ "_stats_reset", (PyCFunction)py_stats_reset, METH_NOARGS, \
+		"_stats_reset()\n\n" \
+		"Reset the operation and callback counters of this module." }, \
+	{ "_stats_configure", (PyCFunction)py_stats_configure, METH_VARARGS, \
+		"_stats_configure(enabled, span_callback)\n\n" \
+		"Enable or disable instrumentation for this module." }
+
+#endif /* _SUBVERTPY_STATS_H_ */
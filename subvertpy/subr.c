@@ -24,6 +24,7 @@
 #include <apr_sha1.h>
 
 #include "util.h"
+#include "mergeinfo.h"
 
 static PyObject *py_uri_canonicalize(PyObject *self, PyObject *args)
 {
@@ -86,45 +87,82 @@ static PyMethodDef subr_methods[] = {
     { NULL }
 };
 
-static PyObject *
-moduleinit(void)
+static int subr_exec(PyObject *mod)
 {
-    PyObject *mod;
+    if (subvertpy_state_init(mod) < 0)
+        return -1;
 
-    apr_initialize();
+    if (subvertpy_add_types(mod, util_types) < 0)
+        return -1;
+
+    if (subvertpy_add_types(mod, mergeinfo_types) < 0)
+        return -1;
+
+    if (!subvertpy_global_init(NULL))
+        return -1;
+
+    PyModule_AddObject(mod, "RangeList", (PyObject *)SUBVERTPY_TYPE(RangeList_Type));
+    Py_INCREF(SUBVERTPY_TYPE(RangeList_Type));
+
+    PyModule_AddObject(mod, "MergeInfo", (PyObject *)SUBVERTPY_TYPE(MergeInfo_Type));
+    Py_INCREF(SUBVERTPY_TYPE(MergeInfo_Type));
+
+    /* Lets subvertpy.ra and subvertpy.client create objects of the types
+     * above rather than linking in their own copies. */
+    PyModule_AddObject(mod, "_mergeinfo_api",
+                       PyCapsule_New((void *)&mergeinfo_api_table,
+                                     MERGEINFO_API_CAPSULE, NULL));
+
+    return 0;
+}
+
+#if PY_VERSION_HEX >= 0x03050000
+static PyModuleDef_Slot subr_module_slots[] = {
+    { Py_mod_exec, subr_exec },
+    SUBVERTPY_MODULE_SLOTS
+    { 0, NULL }
+};
+#endif
 
 #if PY_MAJOR_VERSION >= 3
-    static struct PyModuleDef moduledef = {
-      PyModuleDef_HEAD_INIT,
-      "subr",         /* m_name */
-      "subr", /* m_doc */
-      -1,              /* m_size */
-      subr_methods, /* m_methods */
-      NULL,            /* m_reload */
-      NULL,            /* m_traverse */
-      NULL,            /* m_clear*/
-      NULL,            /* m_free */
-    };
-    mod = PyModule_Create(&moduledef);
+static struct PyModuleDef moduledef = {
+    PyModuleDef_HEAD_INIT,
+    "subr",         /* m_name */
+    "subr", /* m_doc */
+    SUBVERTPY_STATE_SIZE,              /* m_size */
+    subr_methods, /* m_methods */
+#if PY_VERSION_HEX >= 0x03050000
+    subr_module_slots, /* m_slots */
 #else
-    mod = Py_InitModule3("subr", subr_methods, "Subversion subr");
+    NULL,            /* m_reload */
+#endif
+    subvertpy_state_traverse, /* m_traverse */
+    subvertpy_state_clear, /* m_clear*/
+    subvertpy_state_free, /* m_free */
+};
 #endif
-    if (mod == NULL)
-        return NULL;
 
-    return mod;
+#if PY_VERSION_HEX >= 0x03050000
+PyMODINIT_FUNC
+PyInit_subr(void)
+{
+    return PyModuleDef_Init(&moduledef);
 }
-
-#if PY_MAJOR_VERSION >= 3
+#elif PY_MAJOR_VERSION >= 3
 PyMODINIT_FUNC
 PyInit_subr(void)
 {
-    return moduleinit();
+    PyObject *mod = PyModule_Create(&moduledef);
+    if (mod != NULL && subr_exec(mod) < 0)
+        Py_CLEAR(mod);
+    return mod;
 }
 #else
 PyMODINIT_FUNC
 initsubr(void)
 {
-    moduleinit();
+    PyObject *mod = Py_InitModule3("subr", subr_methods, "Subversion subr");
+    if (mod != NULL)
+        subr_exec(mod);
 }
 #endif
@@ -441,12 +441,17 @@ class SubversionTestCase(TestCaseInTempDir):
 
 def test_suite():
     names = [
+        'blob_cache',
         'client',
         'core',
         'delta',
+        'dumpgen',
+        'log_cache',
         'marshall',
+        'metadata_cache',
         'properties',
         'ra',
+        'ra_svn',
         'repos',
         'server',
         'subr',
@@ -0,0 +1,205 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Blob cache tests."""
+
+import hashlib
+from io import BytesIO
+import os
+
+from subvertpy import ra
+from subvertpy.blob_cache import (
+    BlobCache,
+    send_text,
+    )
+from subvertpy.log_cache import CachedRemoteAccess
+from subvertpy.tests import (
+    SubversionTestCase,
+    TestCaseInTempDir,
+    )
+
+
+class TestBlobCache(TestCaseInTempDir):
+
+    def test_add_get(self):
+        cache = BlobCache(os.path.join(self.test_dir, "cache"))
+        md5 = cache.add(b"contents")
+        self.assertEqual(hashlib.md5(b"contents").hexdigest(), md5)
+        self.assertEqual(b"contents", cache.get(md5))
+        self.assertEqual(
+            b"contents", cache.get(hashlib.sha1(b"contents").hexdigest()))
+        self.assertEqual(
+            b"contents", cache.get(hashlib.md5(b"contents").digest()))
+        self.assertIs(None, cache.get(hashlib.md5(b"other").hexdigest()))
+        cache = BlobCache(os.path.join(self.test_dir, "cache"))
+        self.assertIn(md5, cache)
+        self.assertEqual(8, cache.size)
+
+    def test_evict(self):
+        cache = BlobCache(os.path.join(self.test_dir, "cache"), max_size=10)
+        first = cache.add(b"12345")
+        second = cache.add(b"abcde")
+        cache.get(first)
+        third = cache.add(b"xyz")
+        self.assertIn(first, cache)
+        self.assertNotIn(second, cache)
+        self.assertIn(third, cache)
+        self.assertEqual(8, cache.size)
+        cache.evict(0)
+        self.assertEqual(0, cache.size)
+        self.assertIs(None, cache.get(first))
+
+    def test_checksum_mismatch(self):
+        cache = BlobCache(os.path.join(self.test_dir, "cache"))
+        closed = []
+
+        class FileEditor(object):
+
+            def close(self, checksum=None):
+                closed.append(checksum)
+
+        class DirEditor(object):
+
+            def add_file(self, path, copyfrom_path=None, copyfrom_rev=-1):
+                return FileEditor()
+
+        class Editor(object):
+
+            def open_root(self, base_revnum=-1):
+                return DirEditor()
+
+        root = cache.wrap_editor(Editor()).open_root()
+        file_editor = root.add_file("foo")
+        handler = file_editor.apply_textdelta()
+        handler((0, 0, 3, 0, [(2, 0, 3)], b"foo"))
+        handler(None)
+        self.assertRaises(ValueError, file_editor.close,
+                          hashlib.md5(b"bar").hexdigest())
+        self.assertEqual([None], closed)
+
+    def test_send_text(self):
+        windows = []
+
+        class FileEditor(object):
+
+            def apply_textdelta(self, base_checksum=None):
+                return windows.append
+
+        self.assertEqual(hashlib.md5(b"text").hexdigest(),
+                         send_text(b"text", FileEditor()))
+        self.assertEqual([(0, 0, 4, 0, [(2, 0, 4)], b"text"), None], windows)
+        del windows[:]
+        self.assertEqual(hashlib.md5(b"text").hexdigest(),
+                         send_text(BytesIO(b"text"), FileEditor()))
+        self.assertEqual(b"text", b"".join(w[5] for w in windows[:-1]))
+        self.assertIs(None, windows[-1])
+
+
+class TestBlobCacheRemoteAccess(SubversionTestCase):
+
+    def setUp(self):
+        super(TestBlobCacheRemoteAccess, self).setUp()
+        self.repos_url = self.make_repository("d")
+        self.ra = ra.RemoteAccess(
+            self.repos_url, auth=ra.Auth([ra.get_username_provider()]))
+        self.cache = BlobCache(os.path.join(self.test_dir, "cache"))
+        with self.get_commit_editor(self.repos_url) as dc:
+            dc.add_file("foo").modify(b"foo contents")
+
+    def tearDown(self):
+        del self.ra
+        super(TestBlobCacheRemoteAccess, self).tearDown()
+
+    def test_get_file(self):
+        calls = []
+
+        class CountingRemoteAccess(object):
+
+            def __init__(self, ra):
+                self._ra = ra
+
+            def __getattr__(self, name):
+                return getattr(self._ra, name)
+
+            def get_file(self, path, stream, revision=-1):
+                calls.append(stream is not None)
+                return self._ra.get_file(path, stream, revision)
+
+        conn = CountingRemoteAccess(self.ra)
+        results = []
+        for i in range(2):
+            stream = BytesIO()
+            (fetched_rev, props) = self.cache.get_file(conn, "foo", stream, 1)
+            self.assertEqual(1, fetched_rev)
+            self.assertEqual(b"foo contents", stream.getvalue())
+            results.append(props)
+        self.assertEqual([True], calls)
+        self.assertEqual(results[0], results[1])
+        stream = BytesIO()
+        self.cache.get_file(
+            conn, "foo", stream,
+            checksum=hashlib.sha1(b"foo contents").hexdigest())
+        self.assertEqual(b"foo contents", stream.getvalue())
+        self.assertEqual([True, False], calls)
+
+    def test_update(self):
+        received = []
+        windows = []
+
+        class FileEditor(object):
+
+            def apply_textdelta(self, base_checksum=None):
+                return windows.append
+
+            def change_prop(self, name, value):
+                pass
+
+            def close(self, checksum=None):
+                received.append(checksum)
+
+        class DirEditor(object):
+
+            def add_file(self, path, copyfrom_path=None, copyfrom_rev=-1):
+                return FileEditor()
+
+            def add_directory(self, *args):
+                return self
+
+            def change_prop(self, name, value):
+                pass
+
+            def close(self):
+                pass
+
+        class Editor(object):
+
+            def set_target_revision(self, revnum):
+                pass
+
+            def open_root(self, base_revnum=-1):
+                return DirEditor()
+
+            def close(self):
+                pass
+
+        conn = CachedRemoteAccess(self.ra, os.path.join(self.test_dir, "log"),
+                                  blob_cache=self.cache)
+        reporter = conn.do_update(1, "", True, Editor())
+        reporter.set_path("", 0, True)
+        reporter.finish()
+        self.assertEqual([hashlib.md5(b"foo contents").hexdigest()], received)
+        self.assertEqual(b"foo contents", self.cache.get(received[0]))
+        self.assertEqual([(0, 0, 12, 0, [(2, 0, 12)], b"foo contents"), None],
+                         windows)
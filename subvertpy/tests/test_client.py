@@ -185,6 +185,30 @@ class TestClient(SubversionTestCase):
         self.assertCatEquals(b"bla", revision=1)
         self.assertCatEquals(b"blabla", revision=2)
 
+    def test_blame(self):
+        dc = self.get_commit_editor(self.repos_url)
+        dc.add_file("foo").modify(b"a\nb\n")
+        dc.close()
+
+        dc = self.get_commit_editor(self.repos_url)
+        dc.open_file("foo").modify(b"a\nc\nb\n")
+        dc.close()
+
+        if client.api_version() < (1, 5):
+            self.assertRaises(NotImplementedError, self.client.blame,
+                              self.repos_url + "/foo")
+            return  # Skip test
+
+        (revisions, author_indices, authors) = self.client.blame(
+            self.repos_url + "/foo")
+        self.assertEqual([1, 2, 1], list(revisions))
+        self.assertEqual(3, len(author_indices))
+        self.assertEqual(author_indices[0], author_indices[2])
+
+        (revisions, author_indices, authors) = self.client.blame(
+            self.repos_url + "/foo", end_rev=1)
+        self.assertEqual([1, 1], list(revisions))
+
     def assertLogEntryChangedPathsEquals(self, expected, entry):
         changed_paths = entry["changed_paths"]
         self.assertIsInstance(changed_paths, dict)
@@ -0,0 +1,74 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Synthetic repository generator tests."""
+
+import os
+
+from subvertpy.dumpgen import (
+    DumpGenerator,
+    DumpStream,
+    create_repository,
+    )
+from subvertpy.tests import TestCaseInTempDir, TestCase
+
+
+class DumpGeneratorTests(TestCase):
+
+    def dump(self, **kwargs):
+        return b"".join(DumpGenerator(**kwargs).generate())
+
+    def test_header(self):
+        dump = self.dump(revisions=1)
+        self.assertTrue(dump.startswith(b"SVN-fs-dump-format-version: 2\n"))
+
+    def test_deterministic(self):
+        self.assertEqual(self.dump(revisions=20, seed=3),
+                         self.dump(revisions=20, seed=3))
+
+    def test_seed(self):
+        self.assertNotEqual(self.dump(revisions=20, seed=3),
+                            self.dump(revisions=20, seed=4))
+
+    def test_revision_count(self):
+        dump = self.dump(revisions=20)
+        self.assertEqual(21, dump.count(b"\nRevision-number: "))
+
+    def test_empty_tree(self):
+        self.assertRaises(ValueError, DumpGenerator, files_per_dir=0)
+
+
+class DumpStreamTests(TestCase):
+
+    def test_read_all(self):
+        stream = DumpStream([b"foo", b"", b"bar"])
+        self.assertEqual(b"foobar", stream.read())
+        self.assertEqual(b"", stream.read())
+
+    def test_read_across_chunks(self):
+        stream = DumpStream([b"foo", b"bar", b"bla"])
+        self.assertEqual(b"foob", stream.read(4))
+        self.assertEqual(b"arbl", stream.read(4))
+        self.assertEqual(b"a", stream.read(4))
+        self.assertEqual(b"", stream.read(4))
+
+
+class CreateRepositoryTests(TestCaseInTempDir):
+
+    def test_create(self):
+        r = create_repository(
+            os.path.join(self.test_dir, "foo"), revisions=50,
+            copy_rate=0.2, rename_rate=0.1, mergeinfo_rate=0.2)
+        self.assertEqual(50, r.fs().youngest_revision())
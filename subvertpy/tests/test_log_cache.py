@@ -0,0 +1,136 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Log cache tests."""
+
+import os
+
+from subvertpy import (
+    SubversionException,
+    ra,
+    )
+from subvertpy.log_cache import (
+    CachedRemoteAccess,
+    LogCache,
+    )
+from subvertpy.tests import (
+    SubversionTestCase,
+    )
+
+
+class TestLogCache(SubversionTestCase):
+
+    def setUp(self):
+        super(TestLogCache, self).setUp()
+        self.repos_url = self.make_repository("d")
+        self.ra = ra.RemoteAccess(
+            self.repos_url, auth=ra.Auth([ra.get_username_provider()]))
+        self.cache_dir = os.path.join(self.test_dir, "cache")
+
+    def tearDown(self):
+        del self.ra
+        super(TestLogCache, self).tearDown()
+
+    def build_history(self):
+        with self.get_commit_editor(self.repos_url) as dc:
+            trunk = dc.add_dir("trunk")
+            trunk.add_file("trunk/a").modify(b"a")
+        with self.get_commit_editor(self.repos_url) as dc:
+            dc.add_dir("branches")
+        with self.get_commit_editor(self.repos_url) as dc:
+            dc.open_dir("branches").add_dir("branches/b", "trunk", 1)
+        with self.get_commit_editor(self.repos_url) as dc:
+            dc.open_dir("branches").open_dir("branches/b").open_file(
+                "branches/b/a").modify(b"b")
+
+    def assertSameLog(self, cached, paths, start, end, **kwargs):
+        expected = []
+        self.ra.get_log(
+            lambda *args: expected.append(args[:3]), paths, start, end,
+            **kwargs)
+        actual = []
+        cached.get_log(
+            lambda *args: actual.append(args), paths, start, end, **kwargs)
+        self.assertEqual(expected, actual)
+
+    def test_sync(self):
+        self.build_history()
+        cache = LogCache(self.ra, self.cache_dir)
+        self.assertEqual(-1, cache.tip)
+        self.assertEqual(4, cache.sync(batch_size=3))
+        self.assertEqual(4, cache.tip)
+        # Reopening uses the data on disk.
+        cache = LogCache(self.ra, self.cache_dir)
+        self.assertEqual(4, cache.tip)
+
+    def test_get_log(self):
+        self.build_history()
+        cache = LogCache(self.ra, self.cache_dir)
+        self.assertSameLog(cache, [""], 4, 0, discover_changed_paths=True)
+        self.assertSameLog(cache, None, 0, 4, revprops=["svn:log"])
+        self.assertSameLog(cache, ["branches/b/a"], 4, 0)
+        self.assertSameLog(cache, ["branches/b/a"], 4, 0,
+                           strict_node_history=False)
+        self.assertSameLog(cache, ["trunk"], 0, 4, limit=1)
+
+    def test_incremental(self):
+        cache = LogCache(self.ra, self.cache_dir)
+        self.assertEqual([0], [entry[1] for entry in
+                               cache.iter_log(None, -1, 0)])
+        self.build_history()
+        self.assertEqual([4, 3, 2, 1, 0], [entry[1] for entry in
+                                           cache.iter_log(None, -1, 0)])
+        self.assertRaises(SubversionException, list,
+                          cache.iter_log(None, 0, 10))
+
+    def test_interrupted_sync(self):
+        self.build_history()
+        cache = LogCache(self.ra, self.cache_dir)
+        cache.sync()
+        paths_idx = os.path.join(cache.path, "paths.idx")
+        size = os.path.getsize(paths_idx)
+        # A sync that stopped before updating log.idx.
+        cache._append([(5, {"/trunk/a": ("M", None, -1)}, {})])
+        self.assertNotEqual(size, os.path.getsize(paths_idx))
+        cache = LogCache(self.ra, self.cache_dir)
+        self.assertEqual(size, os.path.getsize(paths_idx))
+        self.assertSameLog(cache, ["trunk"], 4, 0)
+
+    def test_shared(self):
+        cache = LogCache(self.ra, self.cache_dir)
+        other = LogCache(self.ra, self.cache_dir)
+        cache.sync()
+        self.build_history()
+        other.sync()
+        self.assertEqual(4, cache.sync())
+        self.assertSameLog(cache, ["branches/b"], 4, 0)
+
+    def test_refresh_revprops(self):
+        self.build_history()
+        cache = LogCache(self.ra, self.cache_dir)
+        cache.sync()
+        self.ra.change_rev_prop(1, "svn:log", b"edited")
+        cache.refresh_revprops(1)
+        cache = LogCache(self.ra, self.cache_dir)
+        self.assertEqual(
+            [b"edited"], [entry[2]["svn:log"] for entry in
+                          cache.iter_log(None, 1, 1, revprops=["svn:log"])])
+
+    def test_cached_remote_access(self):
+        self.build_history()
+        conn = CachedRemoteAccess(self.ra, self.cache_dir)
+        self.assertEqual(4, conn.get_latest_revnum())
+        self.assertSameLog(conn, ["trunk/a"], 0, 4,
+                           discover_changed_paths=True)
@@ -0,0 +1,134 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Metadata cache tests."""
+
+from subvertpy import (
+    NODE_DIR,
+    NODE_FILE,
+    ra,
+    )
+from subvertpy.metadata_cache import (
+    MetadataCache,
+    MetadataCachingRemoteAccess,
+    )
+from subvertpy.tests import (
+    SubversionTestCase,
+    TestCase,
+    )
+
+
+class TestMetadataCache(TestCase):
+
+    def test_lookup(self):
+        cache = MetadataCache()
+        self.assertEqual(1, cache.lookup("a", lambda: 1))
+        self.assertEqual(1, cache.lookup("a", lambda: 2))
+        self.assertEqual(0.5, cache.hit_rate)
+        cache.max_size = cache.size * 2
+        cache.store("b", 2)
+        cache.get("a")
+        cache.store("c", 3)
+        self.assertEqual(2, len(cache))
+        self.assertIs(None, cache.get("b"))
+        self.assertEqual({"hits": 2, "misses": 2, "entries": 2,
+                          "size": cache.size, "hit_rate": 0.5},
+                         cache.stats())
+
+    def test_max_size(self):
+        cache = MetadataCache(max_size=1000)
+        cache.store("small", 1)
+        cache.store("large", {"x": b"x" * 1000})
+        self.assertIs(None, cache.get("large"))
+        self.assertEqual(1, cache.get("small"))
+        self.assertTrue(0 < cache.size <= 1000)
+        cache.clear()
+        self.assertEqual(0, cache.size)
+
+    def test_copies(self):
+        cache = MetadataCache()
+        value = {"kind": 1}
+        cache.store("a", value)
+        value["kind"] = 2
+        cache.get("a")["kind"] = 3
+        self.assertEqual({"kind": 1}, cache.get("a"))
+
+
+class TestMetadataCachingRemoteAccess(SubversionTestCase):
+
+    def setUp(self):
+        super(TestMetadataCachingRemoteAccess, self).setUp()
+        self.repos_url = self.make_repository("d")
+        with self.get_commit_editor(self.repos_url) as dc:
+            dc.add_dir("trunk").add_file("trunk/foo").modify(b"foo")
+        self.ra = ra.RemoteAccess(
+            self.repos_url, auth=ra.Auth([ra.get_username_provider()]))
+        self.cache = MetadataCache()
+        self.conn = MetadataCachingRemoteAccess(self.ra, self.cache)
+
+    def tearDown(self):
+        del self.conn
+        del self.ra
+        super(TestMetadataCachingRemoteAccess, self).tearDown()
+
+    def test_check_path(self):
+        self.assertEqual(NODE_FILE, self.conn.check_path("trunk/foo", 1))
+        self.assertEqual(NODE_FILE, self.conn.check_path("trunk/foo", 1))
+        self.assertEqual(NODE_DIR, self.conn.check_path("trunk", -1))
+        self.assertEqual(1, self.cache.hits)
+        self.assertEqual(1, self.cache.misses)
+
+    def test_shared_between_sessions(self):
+        self.conn.stat("trunk/foo", 1)
+        other = MetadataCachingRemoteAccess(
+            ra.RemoteAccess(self.repos_url + "/trunk",
+                            auth=ra.Auth([ra.get_username_provider()])),
+            self.cache)
+        self.assertEqual(self.conn.stat("trunk/foo", 1),
+                         other.stat("foo", 1))
+        self.assertEqual(1, self.cache.hits)
+        other = MetadataCachingRemoteAccess(
+            ra.RemoteAccess(self.repos_url + "/trunk/",
+                            auth=ra.Auth([ra.get_username_provider()])),
+            self.cache)
+        other.stat("./foo", 1)
+        self.assertEqual(2, self.cache.hits)
+        self.assertIs(MetadataCache.shared(self.ra.get_uuid()),
+                      MetadataCache.shared(self.ra.get_uuid()))
+
+    def test_get_dir(self):
+        (dirents, fetched_rev, props) = self.conn.get_dir("trunk", 1)
+        self.assertEqual(["foo"], list(dirents.keys()))
+        dirents["foo"]["kind"] = NODE_DIR
+        dirents.clear()
+        (dirents, fetched_rev, props) = self.conn.get_dir("trunk", 1)
+        self.assertEqual(["foo"], list(dirents.keys()))
+        self.assertEqual(NODE_FILE, dirents["foo"]["kind"])
+        self.assertEqual(1, self.cache.hits)
+
+    def test_get_locations(self):
+        self.assertEqual({1: "/trunk/foo"},
+                         self.conn.get_locations("trunk/foo", 1, [1]))
+        self.assertEqual({1: "/trunk/foo"},
+                         self.conn.get_locations("trunk/foo", 1, [0, 1]))
+        self.assertEqual({1: "/trunk/foo"},
+                         self.conn.get_locations("trunk/foo", 1, [0, 1]))
+        self.assertEqual(3, self.cache.hits)
+
+    def test_rev_proplist(self):
+        self.assertEqual(b"Test commit",
+                         self.conn.rev_proplist(1)["svn:log"])
+        self.conn.change_rev_prop(1, "svn:log", b"Changed")
+        self.assertEqual(b"Changed", self.conn.rev_proplist(1)["svn:log"])
@@ -16,17 +16,32 @@
 """Subversion ra library tests."""
 
 from io import BytesIO
+import os
+import sys
+import threading
 
 from subvertpy import (
     NODE_DIR, NODE_NONE, NODE_UNKNOWN,
     SubversionException,
+    enable_stats,
     ra,
+    reset_stats,
+    stats,
+    )
+from subvertpy.subr import (
+    MergeInfo,
+    RangeList,
     )
 from subvertpy.tests import (
     SubversionTestCase,
     TestCase,
     )
 
+try:
+    import asyncio
+except ImportError:
+    asyncio = None
+
 
 class VersionTest(TestCase):
 
@@ -46,6 +61,70 @@ class TestRemoteAccessUnknown(TestCase):
         self.assertRaises(SubversionException, ra.RemoteAccess, "bla://")
 
 
+class TmpFileOptionsTests(TestCase):
+
+    def setUp(self):
+        super(TmpFileOptionsTests, self).setUp()
+        self.addCleanup(ra.set_tmp_file_options, *ra.get_tmp_file_options())
+
+    def test_default(self):
+        (memory_limit, directory) = ra.get_tmp_file_options()
+        self.assertTrue(memory_limit >= 0)
+
+    def test_set(self):
+        ra.set_tmp_file_options(1024, os.getcwd())
+        self.assertEqual((1024, os.getcwd()), ra.get_tmp_file_options())
+
+    def test_relative_directory(self):
+        ra.set_tmp_file_options(0, "spill")
+        self.assertEqual(
+            (0, os.path.join(os.getcwd(), "spill")),
+            ra.get_tmp_file_options())
+
+    def test_default_directory(self):
+        ra.set_tmp_file_options(1024, os.getcwd())
+        ra.set_tmp_file_options(0)
+        self.assertEqual((0, None), ra.get_tmp_file_options())
+
+    def test_negative(self):
+        self.assertRaises(ValueError, ra.set_tmp_file_options, -1)
+
+
+class SubinterpreterTests(SubversionTestCase):
+
+    def run_in_subinterpreter(self, code):
+        try:
+            import _interpreters as interpreters
+        except ImportError:
+            try:
+                import _xxsubinterpreters as interpreters
+            except ImportError:
+                self.skipTest("subinterpreters not available")
+        interp = interpreters.create()
+        try:
+            # Older versions raise, newer ones return the exception.
+            ret = interpreters.run_string(interp, code)
+        finally:
+            interpreters.destroy(interp)
+        self.assertIsNone(ret)
+
+    def test_import(self):
+        self.run_in_subinterpreter(
+            "from subvertpy import client, ra, repos, subr, wc\n")
+
+    def test_open(self):
+        repos_url = self.make_repository("d")
+        self.run_in_subinterpreter(
+            "from subvertpy import ra\n"
+            "conn = ra.RemoteAccess(%r,\n"
+            "    auth=ra.Auth([ra.get_username_provider()]))\n"
+            "assert conn.get_latest_revnum() == 0\n"
+            "assert len(list(conn.iter_log(None, 0, 0))) == 1\n" % repos_url)
+        conn = ra.RemoteAccess(
+            repos_url, auth=ra.Auth([ra.get_username_provider()]))
+        self.assertEqual(0, conn.get_latest_revnum())
+
+
 class TestRemoteAccess(SubversionTestCase):
 
     def setUp(self):
@@ -123,6 +202,18 @@ class TestRemoteAccess(SubversionTestCase):
     def test_rev_proplist(self):
         self.assertIsInstance(self.ra.rev_proplist(0), dict)
 
+    def test_rev_proplist_lazy(self):
+        self.do_commit()
+        props = self.ra.rev_proplist(1, lazy=True)
+        self.assertIsInstance(props, ra.PropDict)
+        self.assertEqual(self.ra.rev_proplist(1), props)
+        self.assertTrue("svn:log" in props)
+        self.assertFalse("svn:nonexistent" in props)
+        self.assertEqual(None, props.get("svn:nonexistent"))
+        self.assertRaises(KeyError, props.__getitem__, "svn:nonexistent")
+        self.assertEqual(set(["svn:date", "svn:author", "svn:log"]),
+                         set(props))
+
     def test_do_diff(self):
         self.do_commit()
 
@@ -197,6 +288,68 @@ class TestRemoteAccess(SubversionTestCase):
             revprops=["svn:date", "svn:author", "svn:log"]))
         check_results(returned)
 
+    def test_iter_log_shares_paths(self):
+        self.do_commit()
+        first = list(self.ra.iter_log(
+            None, 1, 1, discover_changed_paths=True))[0][0]
+        second = list(self.ra.iter_log(
+            None, 1, 1, discover_changed_paths=True))[0][0]
+        self.assertEqual(first, second)
+        self.assertIs(list(first)[0], list(second)[0])
+
+    def test_iter_log_lazy_revprops(self):
+        self.do_commit()
+        returned = list(self.ra.iter_log(
+            None, 0, 1, revprops=["svn:date", "svn:author", "svn:log"],
+            lazy_revprops=True))
+        self.assertEqual(2, len(returned))
+        props = returned[1][2]
+        self.assertIsInstance(props, ra.PropDict)
+        self.assertEqual(self.ra.rev_proplist(1), props)
+
+    def _run_async(self, future):
+        return self.loop.run_until_complete(future)
+
+    def _new_loop(self):
+        if asyncio is None or sys.version_info < (3, 5):
+            self.skipTest("asyncio not available")
+        self.loop = asyncio.new_event_loop()
+        self.addCleanup(self.loop.close)
+        asyncio.set_event_loop(self.loop)
+        self.addCleanup(asyncio.set_event_loop, None)
+
+    def test_aget_latest_revnum(self):
+        self._new_loop()
+        self.do_commit()
+        self.assertEqual(1, self._run_async(self.ra.aget_latest_revnum()))
+
+    def test_async_calls_queue(self):
+        self._new_loop()
+        self.do_commit()
+        futures = [self.ra.aget_uuid(), self.ra.acheck_path("", 1),
+                   self.ra.arev_proplist(1)]
+        results = self._run_async(asyncio.gather(*futures))
+        self.assertEqual(
+            [self.ra.get_uuid(), NODE_DIR, self.ra.rev_proplist(1)],
+            results)
+
+    def test_async_error(self):
+        self._new_loop()
+        self.assertRaises(SubversionException, self._run_async,
+                          self.ra.arev_proplist(10))
+
+    def test_aiter_log(self):
+        self._new_loop()
+        self.do_commit()
+        it = self.ra.aiter_log(None, 0, 1, revprops=["svn:date"])
+        returned = []
+        while True:
+            try:
+                returned.append(self._run_async(it.__anext__()))
+            except StopAsyncIteration:
+                break
+        self.assertEqual([0, 1], [entry[1] for entry in returned])
+
     def test_get_log(self):
         returned = []
 
@@ -262,6 +415,31 @@ class TestRemoteAccess(SubversionTestCase):
             {"svn:log": "foo"}, mycb)
         editor.abort()
 
+    def test_busy(self):
+        self.assertFalse(self.ra.busy)
+        editor = self.ra.get_commit_editor({"svn:log": "foo"})
+        self.assertTrue(self.ra.busy)
+        editor.abort()
+        self.assertFalse(self.ra.busy)
+
+    def test_sessions_in_threads(self):
+        self.do_commit()
+        results = []
+
+        def run():
+            conn = ra.RemoteAccess(
+                self.repos_url, auth=ra.Auth([ra.get_username_provider()]))
+            for i in range(20):
+                results.append((conn.get_latest_revnum(),
+                                conn.check_path("foo", 1)))
+
+        threads = [threading.Thread(target=run) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual([(1, NODE_DIR)] * 80, results)
+
     def test_get_commit_editor_double_open(self):
         def mycb(rev):
             pass
@@ -313,6 +491,55 @@ class TestRemoteAccess(SubversionTestCase):
         dir.close()
         editor.close()
 
+    def test_commit_tree(self):
+        self.build_tree({"tree/a": b"a\n", "tree/sub/b": b"b\n" * 1000,
+                         "tree/sub/c": b"c\n", "tree/.svn/entries": b"x"})
+        tree = os.path.abspath("tree")
+        (revnum, date, author) = self.ra.commit_tree(
+            tree, 0, {"svn:log": "import"}, jobs=2)
+        self.assertEqual(1, revnum)
+        (dirents, fetched_rev, props) = self.ra.get_dir("", 1)
+        self.assertEqual(["a", "sub"], sorted(dirents.keys()))
+        stream = BytesIO()
+        self.ra.get_file("sub/b", stream, 1)
+        self.assertEqual(b"b\n" * 1000, stream.getvalue())
+
+        os.remove("tree/sub/c")
+        self.build_tree({"tree/sub/b": b"b\n" * 999 + b"B\n",
+                         "tree/d/e": b"e\n"})
+        (revnum, date, author) = self.ra.commit_tree(
+            tree, 1, {"svn:log": "update"}, jobs=0)
+        self.assertEqual(2, revnum)
+        changed = {}
+
+        def cb(paths, rev, revprops, has_children=None):
+            changed.update(paths)
+        self.ra.get_log(cb, None, 2, 2, discover_changed_paths=True)
+        self.assertEqual(
+            {"/d": "A", "/d/e": "A", "/sub/b": "M", "/sub/c": "D"},
+            dict((path, change[0]) for (path, change) in changed.items()))
+        stream = BytesIO()
+        self.ra.get_file("sub/b", stream, 2)
+        self.assertEqual(b"b\n" * 999 + b"B\n", stream.getvalue())
+
+    def test_commit_tree_symlink(self):
+        if not getattr(os, "symlink", None):
+            self.skipTest("symlinks not supported")
+        self.build_tree({"tree/a": b"a\n", "tree/b": b"b\n"})
+        tree = os.path.abspath("tree")
+        self.ra.commit_tree(tree, 0, {"svn:log": "import"})
+        os.remove("tree/a")
+        os.symlink("b", "tree/a")
+        self.build_tree({"tree/b": b"B\n"})
+        (revnum, date, author) = self.ra.commit_tree(
+            tree, 1, {"svn:log": "update"})
+        self.assertEqual(2, revnum)
+        (dirents, fetched_rev, props) = self.ra.get_dir("", 2)
+        self.assertEqual(["a", "b"], sorted(dirents.keys()))
+        stream = BytesIO()
+        self.ra.get_file("a", stream, 2)
+        self.assertEqual(b"a\n", stream.getvalue())
+
     def test_commit_file_props(self):
         cb = self.commit_editor()
         f = cb.add_file("bar")
@@ -356,6 +583,81 @@ class TestRemoteAccess(SubversionTestCase):
         self.assertEqual("/bar", rets[0][0])
         self.assertEqual("/bar", rets[1][0])
 
+    def _commit_file_revs(self):
+        cb = self.commit_editor()
+        cb.add_file("bar").modify(b"a\n")
+        cb.close()
+
+        cb = self.commit_editor()
+        cb.open_file("bar").modify(b"a\nb\n")
+        cb.close()
+
+        cb = self.commit_editor()
+        cb.open_file("bar").change_prop("bla", "bloe")
+        cb.close()
+
+    def test_iter_file_revs(self):
+        self._commit_file_revs()
+        rets = list(self.ra.iter_file_revs("bar", 1, 3))
+        self.assertEqual([1, 2, 3], [r[0] for r in rets])
+        self.assertEqual(["/bar"] * 3, [r[1] for r in rets])
+        self.assertEqual([b"a\n", b"a\nb\n", b"a\nb\n"],
+                         [r[3] for r in rets])
+        self.assertEqual(self.ra.rev_proplist(2), rets[1][2])
+        self.assertEqual([], rets[1][4])
+        self.assertEqual([("bla", "bloe")], rets[2][4])
+
+    def test_iter_file_revs_delta(self):
+        self._commit_file_revs()
+        rets = list(self.ra.iter_file_revs("bar", 1, 3, fulltext=False,
+                                           max_queue=1))
+        self.assertEqual(3, len(rets))
+        self.assertTrue(rets[0][3].startswith(b"SVN"))
+        self.assertEqual(None, rets[2][3])
+
+    def test_iter_file_revs_close(self):
+        self._commit_file_revs()
+        it = self.ra.iter_file_revs("bar", 1, 3, max_queue=1)
+        self.assertEqual(1, next(it)[0])
+        it.close()
+        self.assertEqual(3, self.ra.get_latest_revnum())
+
+    def test_iter_file_revs_abandoned(self):
+        self._commit_file_revs()
+        it = self.ra.iter_file_revs("bar", 1, 3, max_queue=1)
+        self.assertEqual(1, next(it)[0])
+        del it
+        self.assertFalse(self.ra.busy)
+        self.assertEqual(3, self.ra.get_latest_revnum())
+
+    def test_blame(self):
+        self._commit_file_revs()
+        cb = self.commit_editor()
+        cb.open_file("bar").modify(b"c\na\nb\n")
+        cb.close()
+
+        (revisions, author_indices, authors) = self.ra.blame("bar", 4)
+        self.assertEqual([4, 1, 2], list(revisions))
+        self.assertEqual(3, len(author_indices))
+        for i in author_indices:
+            self.assertTrue(i == -1 or 0 <= i < len(authors))
+
+        (revisions, author_indices, authors) = self.ra.blame("bar", 2)
+        self.assertEqual([1, 2], list(revisions))
+
+    def test_blame_keywords(self):
+        self._commit_file_revs()
+        cb = self.commit_editor()
+        cb.open_file("bar").modify(b"c\na\nb\n")
+        cb.close()
+
+        (revisions, author_indices, authors) = self.ra.blame(
+            "bar", end=4, start=3)
+        self.assertEqual([4, 3, 3], list(revisions))
+        (revisions, author_indices, authors) = self.ra.blame(
+            path="bar", start=0, end=2)
+        self.assertEqual([1, 2], list(revisions))
+
     def test_get_file(self):
         cb = self.commit_editor()
         cb.add_file("bar").modify(b"a")
@@ -371,6 +673,63 @@ class TestRemoteAccess(SubversionTestCase):
         stream.seek(0)
         self.assertEqual(b"a", stream.read())
 
+    def test_mergeinfo(self):
+        cb = self.commit_editor()
+        cb.add_dir("trunk")
+        cb.add_dir("branch").change_prop("svn:mergeinfo", "/trunk:1-2,4*\n")
+        cb.close()
+
+        catalog = self.ra.mergeinfo(["branch"], 1)
+        self.assertEqual(1, len(catalog))
+        mergeinfo = list(catalog.values())[0]
+        self.assertIsInstance(mergeinfo, MergeInfo)
+        self.assertIsInstance(mergeinfo["/trunk"], RangeList)
+        self.assertEqual({"/trunk": [(1, 2, True), (4, 4, False)]}, mergeinfo)
+        self.assertEqual("/trunk:1-2,4*\n", mergeinfo.to_property())
+        self.assertTrue(mergeinfo.includes("/trunk", 2))
+
+    def test_mergeinfo_lazy(self):
+        cb = self.commit_editor()
+        cb.add_dir("trunk")
+        cb.add_dir("branch").change_prop("svn:mergeinfo", "/trunk:1\n")
+        cb.close()
+
+        catalog = self.ra.mergeinfo(["branch"], 1, lazy=True)
+        self.assertEqual(1, len(catalog))
+        self.assertEqual(
+            {"/trunk": [(1, 1, True)]}, catalog[list(catalog)[0]])
+        self.assertEqual(dict(self.ra.mergeinfo(["branch"], 1)), dict(catalog))
+
+    def test_eligible_revisions(self):
+        cb = self.commit_editor()
+        cb.add_dir("trunk").add_file("trunk/bar").modify(b"a")
+        cb.close()
+
+        cb = self.commit_editor()
+        cb.add_dir("branch", "trunk", 1)
+        cb.close()
+
+        for contents in (b"b", b"c"):
+            cb = self.commit_editor()
+            cb.open_dir("trunk").open_file("trunk/bar").modify(contents)
+            cb.close()
+
+        cb = self.commit_editor()
+        cb.open_dir("branch").change_prop("svn:mergeinfo", "/trunk:3\n")
+        cb.close()
+
+        # Doesn't touch trunk, so there is nothing to merge.
+        cb = self.commit_editor()
+        cb.add_dir("other")
+        cb.close()
+
+        eligible = self.ra.eligible_revisions("trunk", "branch")
+        self.assertEqual(["/trunk"], list(eligible.keys()))
+        self.assertTrue(4 in eligible["/trunk"])
+        self.assertFalse(3 in eligible["/trunk"])
+        self.assertFalse(1 in eligible["/trunk"])
+        self.assertEqual({"/trunk": [(4, 4, True)]}, eligible)
+
     def test_get_locations_root(self):
         self.assertEqual({0: "/"}, self.ra.get_locations("", 0, [0]))
 
@@ -394,6 +753,66 @@ class TestRemoteAccess(SubversionTestCase):
                  'size']),
             set(ret.keys()))
 
+    def test_stat_reuses_pools(self):
+        cb = self.commit_editor()
+        cb.add_dir("bar")
+        cb.close()
+
+        self.ra.stat("bar", 1)
+        before = ra.pool_stats()
+        for i in range(10):
+            self.ra.stat("bar", 1)
+            self.ra.check_path("bar", 1)
+        after = ra.pool_stats()
+        self.assertEqual(before["live"], after["live"])
+        self.assertEqual(before["created"], after["created"])
+        self.assertEqual(before["scratch_reused"] + 20,
+                         after["scratch_reused"])
+
+    def test_counters(self):
+        before = self.ra.counters
+        self.ra.get_latest_revnum()
+        self.ra.get_uuid()
+        after = self.ra.counters
+        self.assertEqual(before["requests"] + 2, after["requests"])
+        self.assertTrue(after["elapsed"] >= before["elapsed"])
+        self.assertTrue(after["bytes"] >= before["bytes"])
+
+    def test_stats(self):
+        spans = []
+        enable_stats(span_callback=lambda *args: spans.append(args))
+        self.addCleanup(enable_stats, False)
+        reset_stats()
+        self.ra.get_latest_revnum()
+        self.ra.get_latest_revnum()
+        op = stats()["operations"]["ra_get_latest_revnum"]
+        self.assertEqual(2, op["calls"])
+        self.assertEqual(0, op["errors"])
+        self.assertEqual(2, sum(op["histogram"]))
+        self.assertTrue(op["max"] <= op["time"])
+        self.assertEqual(2, len(spans))
+        (name, start, end, attributes) = spans[0]
+        self.assertEqual("ra_get_latest_revnum", name)
+        self.assertTrue(start <= end)
+        self.assertEqual("operation", attributes["subvertpy.kind"])
+        self.assertFalse(attributes["error"])
+        self.assertIn("peak", stats()["pools"]["_ra"])
+
+    def test_stats_disabled(self):
+        reset_stats()
+        self.ra.get_latest_revnum()
+        self.assertEqual({}, stats()["operations"])
+
+    def test_progress_throttle(self):
+        self.assertEqual(0, self.ra.progress_interval)
+        self.assertEqual(0, self.ra.progress_min_bytes)
+        self.ra.progress_interval = 0.5
+        self.ra.progress_min_bytes = 4096
+        self.assertEqual(0.5, self.ra.progress_interval)
+        self.assertEqual(4096, self.ra.progress_min_bytes)
+        self.assertRaises(ValueError, setattr, self.ra, "progress_interval",
+                          -1)
+
     def test_get_locations_dir(self):
         cb = self.commit_editor()
         cb.add_dir("bar")
@@ -423,6 +842,51 @@ class TestRemoteAccess(SubversionTestCase):
                 {1: "/bar", 2: "/bla", 3: "/bla"},
                 self.ra.get_locations("bla", 3, [1, 2, 3]))
 
+    def _commit_rename(self):
+        cb = self.commit_editor()
+        cb.add_dir("bar")
+        cb.close()
+
+        cb = self.commit_editor()
+        cb.add_dir("bla", "bar", 1)
+        cb.delete("bar")
+        cb.close()
+
+    def test_iter_location_segments(self):
+        self._commit_rename()
+        self.assertEqual(
+            [(2, 2, "bla"), (1, 1, "bar")],
+            list(self.ra.iter_location_segments("bla", 2, 2, 1)))
+        it = self.ra.iter_location_segments("bla", 2, 2, 1, max_queue=1)
+        self.assertEqual((2, 2, "bla"), next(it))
+        it.close()
+        self.assertEqual(2, self.ra.get_latest_revnum())
+
+    def test_iter_location_segments_abandoned(self):
+        self._commit_rename()
+        it = self.ra.iter_location_segments("bla", 2, 2, 1, max_queue=1)
+        self.assertEqual((2, 2, "bla"), next(it))
+        del it
+        self.assertFalse(self.ra.busy)
+        self.assertEqual(2, self.ra.get_latest_revnum())
+
+    def test_get_locations_many(self):
+        self._commit_rename()
+        requests = [("bla", 2, [1, 2]), ("bar", 1, (1, ))]
+        self.assertEqual(
+            [{1: "/bar", 2: "/bla"}, {1: "/bar"}],
+            self.ra.get_locations_many(requests))
+        self.assertEqual([], self.ra.get_locations_many([]))
+        self.assertRaises(SubversionException, self.ra.get_locations_many,
+                          [("bla", 2, [1]), ("bar", 2, [1])])
+        self.assertEqual(2, self.ra.get_latest_revnum())
+
+        other = ra.RemoteAccess(self.repos_url,
+                                auth=ra.Auth([ra.get_username_provider()]))
+        self.assertEqual(
+            [{1: "/bar", 2: "/bla"}, {1: "/bar"}] * 3,
+            ra.get_locations_many([self.ra, other], requests * 3))
+
 
 class AuthTests(TestCase):
 
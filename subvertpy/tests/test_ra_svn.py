@@ -0,0 +1,76 @@
+# Copyright (C) 2026 The Subvertpy contributors
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Tests for subvertpy.ra_svn."""
+
+from hashlib import md5
+from io import BytesIO
+
+from subvertpy.delta import (
+    apply_txdelta_handler,
+    unpack_svndiff0,
+    )
+from subvertpy.marshall import unmarshall
+from subvertpy.ra_svn import (
+    FileEditor,
+    SVNConnection,
+    )
+from subvertpy.tests import TestCase
+
+
+class FileEditorTests(TestCase):
+
+    def setUp(self):
+        super(FileEditorTests, self).setUp()
+        self.sent = []
+        self.conn = SVNConnection(None, self.sent.append)
+        self.conn._open_ids = []
+
+    def received(self):
+        data = b"".join(bytes(part) for part in self.sent)
+        msgs = []
+        while data:
+            (data, msg) = unmarshall(data)
+            msgs.append(msg)
+        return msgs
+
+    def received_text(self, msgs):
+        diff = b"".join(args[1] for (cmd, args) in msgs
+                        if cmd == "textdelta-chunk")
+        text = BytesIO()
+        handler = apply_txdelta_handler(b"", text)
+        for window in unpack_svndiff0(diff):
+            handler(window)
+        return text.getvalue()
+
+    def test_send_stream(self):
+        editor = FileEditor(self.conn, "f")
+        contents = b"abcdefghij" * 10
+        checksum = editor.send_stream(BytesIO(contents), chunk_size=30)
+        self.assertEqual(md5(contents).hexdigest(), checksum)
+        msgs = self.received()
+        self.assertEqual(
+            ["apply-textdelta"] + ["textdelta-chunk"] * 5 +
+            ["textdelta-end"], [cmd for (cmd, args) in msgs])
+        self.assertEqual(contents, self.received_text(msgs))
+        # The window data is written out as is.
+        self.assertIn(contents[:30], self.sent)
+
+    def test_apply_textdelta(self):
+        editor = FileEditor(self.conn, "f")
+        handler = editor.apply_textdelta()
+        handler((0, 0, 3, 0, [(2, 0, 3)], b"foo"))
+        handler(None)
+        self.assertEqual(b"foo", self.received_text(self.received()))
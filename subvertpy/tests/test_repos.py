@@ -135,6 +135,18 @@ class TestRepository(TestCaseInTempDir):
         # nonexistant path.
         # self.assertEqual(False, root.is_dir("nonexistant"))
 
+    def test_is_dir_reuses_pools(self):
+        repos.create(os.path.join(self.test_dir, "foo"))
+        root = repos.Repository("foo").fs().revision_root(0)
+        root.is_dir("")
+        before = repos.pool_stats()
+        for i in range(10):
+            root.is_dir("")
+        after = repos.pool_stats()
+        self.assertEqual(before["live"], after["live"])
+        self.assertEqual(before["scratch_reused"] + 10,
+                         after["scratch_reused"])
+
     def test_is_file(self):
         repos.create(os.path.join(self.test_dir, "foo"))
         root = repos.Repository("foo").fs().revision_root(0)
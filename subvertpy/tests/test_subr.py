@@ -18,10 +18,13 @@
 import os
 from unittest import TestCase
 
+from subvertpy.properties import generate_mergeinfo_property
 from subvertpy.subr import (
     uri_canonicalize,
     dirent_canonicalize,
     abspath,
+    MergeInfo,
+    RangeList,
     )
 
 
@@ -62,3 +65,126 @@ class AbspathTests(TestCase):
         self.assertEqual(
                 os.path.join(os.getcwd(), 'bar', 'foo'),
                 abspath('bar/foo'))
+
+
+class RangeListTests(TestCase):
+
+    def test_parse(self):
+        self.assertEqual(
+                [(1, 3, True), (5, 5, False), (7, 7, True)],
+                list(RangeList.parse("1-3,5*,7")))
+
+    def test_parse_invalid(self):
+        self.assertRaises(ValueError, RangeList.parse, "1-")
+        self.assertRaises(ValueError, RangeList.parse, "3-1")
+        self.assertRaises(ValueError, RangeList.parse, "1,,2")
+
+    def test_str(self):
+        self.assertEqual("1-3,5*,7", str(RangeList.parse("1-3,5*,7")))
+
+    def test_normalize(self):
+        self.assertEqual(
+                [(1, 3, True)],
+                RangeList([(3, 3, True), (1, 2, True)]))
+        self.assertEqual(
+                [(5, 12, True), (13, 20, False)],
+                RangeList([(10, 20, False), (5, 12, True)]))
+
+    def test_contains(self):
+        ranges = RangeList.parse("1-3,5*,7")
+        self.assertTrue(1 in ranges)
+        self.assertTrue(5 in ranges)
+        self.assertFalse(4 in ranges)
+        self.assertFalse(8 in ranges)
+
+    def test_merge(self):
+        self.assertEqual(
+                "1-7", str(RangeList.parse("1-3,5*,7").merge([(4, 6)])))
+
+    def test_remove(self):
+        ranges = RangeList.parse("1-3,5*,7")
+        self.assertEqual("1,7", str(ranges.remove([(2, 5)])))
+        self.assertEqual(
+                "1-3,5*,7",
+                str(ranges.remove([(5, 5, True)], consider_inheritance=True)))
+
+    def test_intersect(self):
+        self.assertEqual(
+                "3,5*,7",
+                str(RangeList.parse("1-3,5*,7").intersect([(3, 10, True)])))
+
+    def test_inheritable(self):
+        self.assertEqual(
+                "1-3,7", str(RangeList.parse("1-3,5*,7").inheritable()))
+
+
+class MergeInfoTests(TestCase):
+
+    def test_from_property(self):
+        mergeinfo = MergeInfo.from_property("/trunk:1-2\n/branches/a:3-5*\n")
+        self.assertEqual(
+                {"/trunk": [(1, 2, True)], "/branches/a": [(3, 5, False)]},
+                mergeinfo)
+        self.assertIsInstance(mergeinfo["/trunk"], RangeList)
+
+    def test_update(self):
+        mergeinfo = MergeInfo()
+        mergeinfo.update({"/trunk": [(1, 2, True)]}, **{"/a": [(3, 3)]})
+        mergeinfo.update([("/b", [(4, 4)])])
+        self.assertIsInstance(mergeinfo["/trunk"], RangeList)
+        self.assertIsInstance(mergeinfo["/a"], RangeList)
+        self.assertIsInstance(mergeinfo["/b"], RangeList)
+        self.assertRaises(TypeError, mergeinfo.update, {"/c": 1})
+        self.assertNotIn("/c", mergeinfo)
+
+    def test_setdefault(self):
+        mergeinfo = MergeInfo()
+        ranges = mergeinfo.setdefault("/trunk", [(1, 2, True)])
+        self.assertIsInstance(ranges, RangeList)
+        self.assertIs(ranges, mergeinfo["/trunk"])
+        self.assertIs(ranges, mergeinfo.setdefault("/trunk", [(3, 3)]))
+        self.assertEqual([], mergeinfo.setdefault("/a"))
+        self.assertIsInstance(mergeinfo["/a"], RangeList)
+
+    def test_from_property_invalid(self):
+        self.assertRaises(ValueError, MergeInfo.from_property, "trunk:1\n")
+
+    def test_to_property(self):
+        mergeinfo = MergeInfo({"/trunk": [(1, 2, True), (4, 4, False)]})
+        self.assertEqual("/trunk:1-2,4*\n", mergeinfo.to_property())
+        self.assertEqual(
+                generate_mergeinfo_property(mergeinfo),
+                mergeinfo.to_property())
+
+    def test_setitem(self):
+        mergeinfo = MergeInfo()
+        mergeinfo["/trunk"] = [(1, 2, True)]
+        self.assertIsInstance(mergeinfo["/trunk"], RangeList)
+
+    def test_merge(self):
+        mergeinfo = MergeInfo.from_property("/trunk:1-2\n")
+        self.assertEqual(
+                {"/trunk": [(1, 4, True)], "/x": [(1, 1, True)]},
+                mergeinfo.merge({"/trunk": [(3, 4)], "/x": [(1, 1)]}))
+
+    def test_remove(self):
+        mergeinfo = MergeInfo.from_property("/trunk:1-2\n/a:3\n")
+        self.assertEqual(
+                {"/a": [(3, 3, True)]},
+                mergeinfo.remove({"/trunk": [(1, 2)]}))
+
+    def test_intersect(self):
+        mergeinfo = MergeInfo.from_property("/trunk:1-2\n/a:3\n")
+        self.assertEqual(
+                {"/trunk": [(2, 2, True)]},
+                mergeinfo.intersect({"/trunk": [(2, 9)]}))
+
+    def test_inheritable(self):
+        mergeinfo = MergeInfo.from_property("/trunk:1-2\n/a:3*\n")
+        self.assertEqual({"/trunk": [(1, 2, True)]}, mergeinfo.inheritable())
+
+    def test_includes(self):
+        mergeinfo = MergeInfo.from_property("/trunk:1-2\n")
+        self.assertTrue(mergeinfo.includes("/trunk", 2))
+        self.assertFalse(mergeinfo.includes("/trunk", 3))
+        self.assertFalse(mergeinfo.includes("/branches/a", 1))
@@ -23,6 +23,10 @@ import subvertpy
 from subvertpy import (
     NODE_DIR,
     NODE_FILE,
+    enable_stats,
+    ra,
+    reset_stats,
+    stats,
     wc,
     )
 from subvertpy.tests import (
@@ -237,6 +241,67 @@ class AdmObjTests(SubversionTestCase):
         self.assertEqual(NODE_FILE, entry.kind)
         self.assertEqual(1, entry.revision)
 
+    def test_entries_read(self):
+        self.make_client("repos", "checkout")
+        self.build_tree({"checkout/bar": b"la"})
+        self.client_add('checkout/bar')
+        adm = wc.Adm(None, "checkout")
+        entries = adm.entries_read()
+        self.assertEqual("bar", entries["bar"].name)
+        self.assertEqual(NODE_FILE, entries["bar"].kind)
+        self.assertEqual(NODE_DIR, entries[""].kind)
+
+    def test_iter_entries(self):
+        self.make_client("repos", "checkout")
+        self.build_tree({"checkout/bar": b"la", "checkout/sub": None,
+                         "checkout/sub/foo": b"foo"})
+        self.client_add('checkout/bar')
+        self.client_add('checkout/sub')
+        adm = wc.Adm(None, "checkout")
+        found = {}
+        adm.walk_entries("checkout",
+                         lambda path, entry: found.setdefault(path, entry))
+        entries = dict(adm.iter_entries("checkout"))
+        self.assertEqual(sorted(found), sorted(entries))
+        for path, entry in entries.items():
+            self.assertEqual(found[path].url, entry.url)
+            self.assertEqual(found[path].revision, entry.revision)
+
+    def test_iter_entries_fields(self):
+        self.make_client("repos", "checkout")
+        self.build_tree({"checkout/bar": b"la"})
+        self.client_add('checkout/bar')
+        adm = wc.Adm(None, "checkout")
+        entries = adm.iter_entries("checkout", fields=["name", "kind"])
+        names = set()
+        for path, entry in entries:
+            names.add(entry.name)
+            self.assertIn(entry.kind, (NODE_DIR, NODE_FILE))
+            self.assertRaises(AttributeError, getattr, entry, "url")
+        self.assertIn("bar", names)
+        self.assertRaises(ValueError, adm.iter_entries, "checkout",
+                          fields=["nonexistent"])
+
+    def test_iter_entries_all_fields(self):
+        self.make_client("repos", "checkout")
+        self.build_tree({"checkout/bar": b"la"})
+        self.client_add('checkout/bar')
+        adm = wc.Adm(None, "checkout")
+        fields = ["name", "copyfrom_url", "copyfrom_rev", "uuid", "url",
+                  "repos", "schedule", "kind", "revision", "cmt_rev",
+                  "checksum", "cmt_date", "cmt_author"]
+        entries = dict(adm.iter_entries("checkout", fields=fields))
+
+        class Editor(object):
+
+            def change_prop(self, name, value):
+                pass
+
+        # Only complete entries are accepted here.
+        adm.transmit_prop_deltas(
+            "checkout/bar", entries[os.path.join(adm.access_path(), "bar")],
+            Editor())
+
     def test_get_actual_target(self):
         self.make_client("repos", ".")
         self.assertEqual((self.test_dir, "bla"),
@@ -250,6 +315,30 @@ class AdmObjTests(SubversionTestCase):
         self.assertTrue(adm.is_wc_root(self.test_dir))
         self.assertFalse(adm.is_wc_root(os.path.join(self.test_dir, "bar")))
 
+    def test_update_editor_native(self):
+        repos_url = self.make_client("repos", "checkout")
+        self.make_checkout(repos_url, "checkout2")
+        with open('checkout/bla.txt', 'w') as f:
+            f.write("data")
+        self.client_add("checkout/bla.txt")
+        self.client_commit("checkout", "add bla")
+        enable_stats()
+        self.addCleanup(enable_stats, False)
+        reset_stats()
+        conn = ra.RemoteAccess(repos_url)
+        context = wc.Context()
+        path = os.path.abspath("checkout2")
+        editor = context.get_update_editor(path, "")
+        reporter = conn.do_update(1, "", True, editor)
+        context.crawl_revisions(path, reporter)
+        with open('checkout2/bla.txt', 'r') as f:
+            self.assertEqual("data", f.read())
+        # The update editor was driven without calling back into Python.
+        self.assertEqual({}, stats()["callbacks"])
+        # The reporter was finished natively, releasing the session.
+        self.assertRaises(RuntimeError, reporter.finish)
+        self.assertEqual(1, conn.get_latest_revnum())
+
     def test_status(self):
         self.make_client("repos", "checkout")
         self.build_tree({"checkout/bar": b"text"})
@@ -360,6 +449,35 @@ class AdmObjTests(SubversionTestCase):
         self.assertEqual(NODE_FILE, bar.kind)
         self.assertEqual(wc.SCHEDULE_NORMAL, bar.schedule)
 
+    def test_queue_many(self):
+        if wc.api_version() >= (1, 7):
+            self.skipTest("TODO: doesn't yet work with svn >= 1.7")
+        self.make_client("repos", "checkout")
+        self.build_tree({"checkout/bar": b"blala", "checkout/foo": b"la"})
+        self.client_add('checkout/bar')
+        self.client_add('checkout/foo')
+        adm = wc.Adm(None, "checkout", True)
+        cq = wc.CommittedQueue()
+        cq.queue_many([
+            ("checkout/bar", adm),
+            {"path": "checkout/foo", "adm": adm,
+             "md5_digest": hashlib.md5(b'la').digest()}])
+        adm.process_committed_queue(cq, 1, "2010-05-31T08:49:22.430000Z",
+                                    "jelmer")
+        for name in ("bar", "foo"):
+            entry = adm.entry("checkout/" + name)
+            self.assertEqual(wc.SCHEDULE_NORMAL, entry.schedule)
+            self.assertEqual(1, entry.revision)
+
+    def test_queue_many_invalid(self):
+        self.make_client("repos", "checkout")
+        adm = wc.Adm(None, "checkout", True)
+        cq = wc.CommittedQueue()
+        self.assertRaises(TypeError, cq.queue_many, [("checkout", adm), 1])
+        self.assertRaises(ValueError, cq.queue_many,
+                          [{"path": "checkout", "adm": adm,
+                            "md5_digest": b"short"}])
+
     def test_process_committed(self):
         if wc.api_version() >= (1, 7):
             self.skipTest("TODO: doesn't yet work with svn >= 1.7")
@@ -563,3 +681,38 @@ class ContextTests(SubversionTestCase):
         cq.queue("checkout/bar", adm)
         adm.process_committed_queue(cq, 1, "2010-05-31T08:49:22.430000Z",
                                     "jelmer")
+
+    def test_process_committed_queue_background(self):
+        try:
+            import concurrent.futures  # noqa: F401
+        except ImportError:
+            self.skipTest("concurrent.futures not available")
+        self.make_client("repos", "checkout")
+        context = wc.Context()
+        cq = wc.CommittedQueue()
+        steps = []
+        future = context.process_committed_queue(
+            cq, 1, "2010-05-31T08:49:22.430000Z", "jelmer", background=True,
+            notify=steps.append, notify_interval=0)
+        self.assertIsNone(future.result())
+        self.assertTrue(future.done())
+        self.assertEqual(sorted(steps), steps)
+
+    def test_process_committed_queue_busy(self):
+        try:
+            import concurrent.futures  # noqa: F401
+        except ImportError:
+            self.skipTest("concurrent.futures not available")
+        self.make_client("repos", "checkout")
+        context = wc.Context()
+        cq = wc.CommittedQueue()
+
+        def notify(steps):
+            # Raising here fails the future.
+            self.assertRaises(RuntimeError, context.check_wc, "checkout")
+            self.assertRaises(RuntimeError, cq.queue, "checkout", context)
+        future = context.process_committed_queue(
+            cq, 1, "2010-05-31T08:49:22.430000Z", "jelmer", background=True,
+            notify=notify, notify_interval=0)
+        self.assertIsNone(future.result())
+        self.assertIsInstance(context.check_wc("checkout"), int)
@@ -21,6 +21,7 @@
 #include <apr_general.h>
 #include <apr_file_io.h>
 #include <apr_portable.h>
+#include <apr_time.h>
 #include <svn_error.h>
 #include <svn_io.h>
 #include <apr_errno.h>
@@ -30,6 +31,7 @@
 #include <svn_props.h>
 
 #include "util.h"
+#include "stats.h"
 
 #define BZR_SVN_APR_ERROR_OFFSET (APR_OS_START_USERERR + \
 								  (50 * SVN_ERR_CATEGORY_SIZE))
@@ -77,67 +79,107 @@ svn_dirent_canonicalize(const char *dirent,
 
 #endif
 
+/**
+ * Return the UTF-8 contents of a str or bytes object.
+ *
+ * On Python 3 the buffer of a str is owned by the object itself, so no
+ * temporary bytes object is created; *tmp is set to an object the caller
+ * has to release (possibly NULL).
+ */
+static const char *py_object_as_utf8(PyObject *obj, PyObject **tmp,
+									 const char *errmsg)
+{
+	*tmp = NULL;
+
+	if (PyUnicode_Check(obj)) {
+#if PY_MAJOR_VERSION >= 3
+		return PyUnicode_AsUTF8(obj);
+#else
+		*tmp = PyUnicode_AsUTF8String(obj);
+		if (*tmp == NULL) {
+			return NULL;
+		}
+		return PyBytes_AsString(*tmp);
+#endif
+	}
+
+	if (PyBytes_Check(obj)) {
+		return PyBytes_AsString(obj);
+	}
+
+	PyErr_SetString(PyExc_TypeError, errmsg);
+	return NULL;
+}
+
+/* Paths passed in by callers are usually canonical already; checking that
+ * is cheaper than canonicalizing them again. */
+static const char *canonical_dirent(const char *dirent, apr_pool_t *pool)
+{
+#if ONLY_SINCE_SVN(1, 7)
+	if (svn_dirent_is_canonical(dirent, pool))
+		return apr_pstrdup(pool, dirent);
+#endif
+	return svn_dirent_canonicalize(dirent, pool);
+}
+
+static const char *canonical_uri(const char *uri, apr_pool_t *pool)
+{
+#if ONLY_SINCE_SVN(1, 7)
+	if (svn_uri_is_canonical(uri, pool))
+		return apr_pstrdup(pool, uri);
+#endif
+	return svn_uri_canonicalize(uri, pool);
+}
+
+static const char *canonical_relpath(const char *relpath, apr_pool_t *pool)
+{
+#if ONLY_SINCE_SVN(1, 7)
+	if (svn_relpath_is_canonical(relpath))
+		return apr_pstrdup(pool, relpath);
+#endif
+	return svn_relpath_canonicalize(relpath, pool);
+}
+
 const char *py_object_to_svn_path_or_url(PyObject *obj, apr_pool_t *pool)
 {
     const char *ret;
+    PyObject *tmp;
 
-    if (PyUnicode_Check(obj)) {
-        obj = PyUnicode_AsUTF8String(obj);
-        if (obj == NULL) {
-            return NULL;
-        }
-    } else {
-        Py_INCREF(obj);
-    }
-
-    if (!PyBytes_Check(obj)) {
-        PyErr_SetString(PyExc_TypeError,
-                        "URIs need to be UTF-8 bytestrings or unicode strings");
-        Py_DECREF(obj);
+    ret = py_object_as_utf8(obj, &tmp,
+                            "URIs need to be UTF-8 bytestrings or unicode strings");
+    if (ret == NULL) {
         return NULL;
     }
 
-    ret = PyBytes_AsString(obj);
     if (svn_path_is_url(ret)) {
-        ret = svn_uri_canonicalize(ret, pool);
+        ret = canonical_uri(ret, pool);
     } else {
-        ret = svn_dirent_canonicalize(ret, pool);
+        ret = canonical_dirent(ret, pool);
     }
 
-    Py_DECREF(obj);
+    Py_XDECREF(tmp);
     return ret;
 }
 
 const char *py_object_to_svn_abspath(PyObject *obj, apr_pool_t *pool)
 {
     const char *ret;
+    PyObject *tmp;
 
-    if (PyUnicode_Check(obj)) {
-        obj = PyUnicode_AsUTF8String(obj);
-        if (obj == NULL) {
-            return NULL;
-        }
-    } else {
-        Py_INCREF(obj);
-    }
-
-    if (!PyBytes_Check(obj)) {
-        PyErr_SetString(PyExc_TypeError,
-                        "URIs need to be UTF-8 bytestrings or unicode strings");
-        Py_DECREF(obj);
-        return NULL;
-    }
-
-    ret = PyBytes_AsString(obj);
-    ret = apr_pstrdup(pool, ret);
-    Py_DECREF(obj);
+    ret = py_object_as_utf8(obj, &tmp,
+                            "URIs need to be UTF-8 bytestrings or unicode strings");
     if (ret == NULL) {
         return NULL;
     }
+
     if (svn_dirent_is_absolute(ret)) {
-        return svn_dirent_canonicalize(ret, pool);
+        ret = canonical_dirent(ret, pool);
+        Py_XDECREF(tmp);
+        return ret;
     } else {
         const char *absolute;
+        ret = apr_pstrdup(pool, ret);
+        Py_XDECREF(tmp);
         RUN_SVN(svn_dirent_get_absolute(&absolute, ret, pool))
         return svn_dirent_canonicalize(absolute, pool);
     }
@@ -146,101 +188,97 @@ const char *py_object_to_svn_abspath(PyObject *obj, apr_pool_t *pool)
 const char *py_object_to_svn_dirent(PyObject *obj, apr_pool_t *pool)
 {
     const char *ret;
+    PyObject *tmp;
 
-    if (PyUnicode_Check(obj)) {
-        obj = PyUnicode_AsUTF8String(obj);
-        if (obj == NULL) {
-            return NULL;
-        }
-    } else {
-        Py_INCREF(obj);
-    }
-
-    if (PyBytes_Check(obj)) {
-        ret = svn_dirent_canonicalize(PyBytes_AsString(obj), pool);
-        Py_DECREF(obj);
-        return ret;
-    } else {
-        PyErr_SetString(PyExc_TypeError,
-                        "URIs need to be UTF-8 bytestrings or unicode strings");
-        Py_DECREF(obj);
+    ret = py_object_as_utf8(obj, &tmp,
+                            "URIs need to be UTF-8 bytestrings or unicode strings");
+    if (ret == NULL) {
         return NULL;
     }
+
+    ret = canonical_dirent(ret, pool);
+    Py_XDECREF(tmp);
+    return ret;
 }
 
 char *py_object_to_svn_string(PyObject *obj, apr_pool_t *pool)
 {
+    const char *data;
     char *ret;
+    PyObject *tmp;
 
-    if (PyUnicode_Check(obj)) {
-        obj = PyUnicode_AsUTF8String(obj);
-        if (obj == NULL) {
-            return NULL;
-        }
-    } else {
-        Py_INCREF(obj);
-    }
-
-    if (PyBytes_Check(obj)) {
-        ret = apr_pstrdup(pool, PyBytes_AsString(obj));
-        Py_DECREF(obj);
-        return ret;
-    } else {
-        PyErr_SetString(PyExc_TypeError,
-                        "URIs need to be UTF-8 bytestrings or unicode strings");
-        Py_DECREF(obj);
+    data = py_object_as_utf8(obj, &tmp,
+                             "URIs need to be UTF-8 bytestrings or unicode strings");
+    if (data == NULL) {
         return NULL;
     }
+
+    ret = apr_pstrdup(pool, data);
+    Py_XDECREF(tmp);
+    return ret;
 }
 
 const char *py_object_to_svn_uri(PyObject *obj, apr_pool_t *pool)
 {
 	const char *ret;
+	PyObject *tmp;
 
-	if (PyUnicode_Check(obj)) {
-		obj = PyUnicode_AsUTF8String(obj);
-		if (obj == NULL) {
-			return NULL;
-		}
-	} else {
-        Py_INCREF(obj);
-    }
-
-	if (PyBytes_Check(obj)) {
-		ret = svn_uri_canonicalize(PyBytes_AsString(obj), pool);
-		Py_DECREF(obj);
-		return ret;
-	} else {
-		PyErr_SetString(PyExc_TypeError,
-						"URIs need to be UTF-8 bytestrings or unicode strings");
-		Py_DECREF(obj);
+	ret = py_object_as_utf8(obj, &tmp,
+							"URIs need to be UTF-8 bytestrings or unicode strings");
+	if (ret == NULL) {
 		return NULL;
 	}
+
+	ret = canonical_uri(ret, pool);
+	Py_XDECREF(tmp);
+	return ret;
 }
 
 const char *py_object_to_svn_relpath(PyObject *obj, apr_pool_t *pool)
 {
     const char *ret;
+    PyObject *tmp;
 
-    if (PyUnicode_Check(obj)) {
-        obj = PyUnicode_AsUTF8String(obj);
-        if (obj == NULL) {
-            return NULL;
-        }
-    } else {
-        Py_INCREF(obj);
-    }
-
-    if (PyBytes_Check(obj)) {
-        ret = svn_relpath_canonicalize(PyBytes_AsString(obj), pool);
-        Py_DECREF(obj);
-        return ret;
-    } else {
-        PyErr_SetString(PyExc_TypeError,
-                        "relative paths need to be UTF-8 bytestrings or unicode strings");
-        Py_DECREF(obj);
+    ret = py_object_as_utf8(obj, &tmp,
+                            "relative paths need to be UTF-8 bytestrings or unicode strings");
+    if (ret == NULL) {
         return NULL;
     }
+
+    ret = canonical_relpath(ret, pool);
+    Py_XDECREF(tmp);
+    return ret;
+}
+
+static struct {
+    unsigned long created;
+    unsigned long live;
+    unsigned long peak;
+    unsigned long scratch_reused;
+} pool_counters;
+
+/* Pools are also destroyed with the GIL released, so the counters have
+ * their own lock on free-threaded builds. */
+static subvertpy_mutex_t pool_counters_lock;
+
+static apr_status_t pool_untrack(void *data)
+{
+    subvertpy_mutex_lock(&pool_counters_lock);
+    pool_counters.live--;
+    subvertpy_mutex_unlock(&pool_counters_lock);
+    return APR_SUCCESS;
+}
+
+/* Count pool as live until it is cleared or destroyed. */
+static void pool_track(apr_pool_t *pool)
+{
+    subvertpy_mutex_lock(&pool_counters_lock);
+    pool_counters.live++;
+    if (pool_counters.live > pool_counters.peak)
+        pool_counters.peak = pool_counters.live;
+    subvertpy_mutex_unlock(&pool_counters_lock);
+    apr_pool_cleanup_register(pool, NULL, pool_untrack,
+                              apr_pool_cleanup_null);
 }
 
 apr_pool_t *Pool(apr_pool_t *parent)
@@ -253,9 +291,580 @@ apr_pool_t *Pool(apr_pool_t *parent)
         PyErr_SetAprStatus(status);
         return NULL;
     }
+    subvertpy_mutex_lock(&pool_counters_lock);
+    pool_counters.created++;
+    subvertpy_mutex_unlock(&pool_counters_lock);
+    pool_track(ret);
+    return ret;
+}
+
+void scratch_pool_init(scratch_pool_t *scratch)
+{
+    scratch->pool = NULL;
+    scratch->in_use = false;
+}
+
+/**
+ * Obtain a pool for temporary allocations during a single call.
+ *
+ * The scratch pool is created as a subpool of parent the first time it
+ * is needed. If it is already in use (e.g. by another thread, or by a
+ * callback re-entering the object), a new top-level pool is returned
+ * instead. Either way, the pool should be handed back with
+ * scratch_pool_release().
+ */
+apr_pool_t *scratch_pool_acquire(scratch_pool_t *scratch, apr_pool_t *parent)
+{
+    if (subvertpy_flag_test_and_set(&scratch->in_use)) {
+        return Pool(NULL);
+    }
+
+    if (scratch->pool == NULL) {
+        scratch->pool = Pool(parent);
+        if (scratch->pool == NULL) {
+            subvertpy_flag_clear(&scratch->in_use);
+            return NULL;
+        }
+    } else {
+        subvertpy_mutex_lock(&pool_counters_lock);
+        pool_counters.scratch_reused++;
+        subvertpy_mutex_unlock(&pool_counters_lock);
+    }
+
+    return scratch->pool;
+}
+
+void scratch_pool_release(scratch_pool_t *scratch, apr_pool_t *pool)
+{
+    if (pool != scratch->pool) {
+        apr_pool_destroy(pool);
+        return;
+    }
+
+    apr_pool_clear(pool);
+    /* Clearing ran the cleanup that stopped counting the pool. */
+    pool_track(pool);
+    subvertpy_flag_clear(&scratch->in_use);
+}
+
+PyObject *py_pool_stats(PyObject *self)
+{
+    unsigned long created, live, peak, scratch_reused;
+
+    subvertpy_mutex_lock(&pool_counters_lock);
+    created = pool_counters.created;
+    live = pool_counters.live;
+    peak = pool_counters.peak;
+    scratch_reused = pool_counters.scratch_reused;
+    subvertpy_mutex_unlock(&pool_counters_lock);
+
+    return Py_BuildValue("{s:k,s:k,s:k,s:k}",
+                         "created", created,
+                         "live", live,
+                         "peak", peak,
+                         "scratch_reused", scratch_reused);
+}
+
+void pool_stats_reset_peak(void)
+{
+    subvertpy_mutex_lock(&pool_counters_lock);
+    pool_counters.peak = pool_counters.live;
+    subvertpy_mutex_unlock(&pool_counters_lock);
+}
+
+/**
+ * Initialise APR, and run init with a pool that lives as long as the
+ * process.
+ *
+ * Modules are executed once for every interpreter that imports them,
+ * but APR and libsvn keep global state of their own, so this is only
+ * done by the first.
+ */
+bool subvertpy_global_init(svn_error_t *(*init)(apr_pool_t *pool))
+{
+    static subvertpy_mutex_t lock;
+    static apr_pool_t *pool = NULL;
+    apr_status_t status;
+    svn_error_t *err;
+    bool ret = true;
+
+    subvertpy_mutex_lock(&lock);
+    if (pool == NULL) {
+        status = apr_initialize();
+        if (status != APR_SUCCESS) {
+            PyErr_SetAprStatus(status);
+            ret = false;
+        } else if ((pool = Pool(NULL)) == NULL) {
+            ret = false;
+        } else if (init != NULL && (err = init(pool)) != NULL) {
+            handle_svn_error(err);
+            svn_error_clear(err);
+            apr_pool_destroy(pool);
+            pool = NULL;
+            ret = false;
+        }
+    }
+    subvertpy_mutex_unlock(&lock);
+
     return ret;
 }
 
+/**
+ * Create a thread state for the current thread in interp and make it
+ * current.
+ *
+ * Threads started by subvertpy use this rather than PyGILState_Ensure(),
+ * which would run them in the main interpreter. Callbacks that use
+ * PyGILState_Ensure() on the thread afterwards get this thread state.
+ */
+PyThreadState *subvertpy_thread_attach(PyInterpreterState *interp)
+{
+    PyThreadState *tstate = PyThreadState_New(interp);
+
+    if (tstate == NULL)
+        Py_FatalError("subvertpy: unable to create thread state");
+    PyEval_RestoreThread(tstate);
+    return tstate;
+}
+
+void subvertpy_thread_detach(PyThreadState *tstate)
+{
+    PyThreadState_Clear(tstate);
+    PyEval_ReleaseThread(tstate);
+    PyThreadState_Delete(tstate);
+}
+
+/**
+ * Make sure the current thread can call into interp.
+ *
+ * For code such as pool cleanups, which can run both with and without
+ * the GIL held. Unlike PyGILState_Ensure(), this does not fall back to
+ * the main interpreter when the thread has no thread state attached.
+ *
+ * Returns the thread state to pass to subvertpy_thread_release(), which
+ * is NULL if one was already attached.
+ */
+PyThreadState *subvertpy_thread_ensure(PyInterpreterState *interp)
+{
+    if (subvertpy_attached_tstate() != NULL)
+        return NULL;
+    return subvertpy_thread_attach(interp);
+}
+
+void subvertpy_thread_release(PyThreadState *tstate)
+{
+    if (tstate != NULL)
+        subvertpy_thread_detach(tstate);
+}
+
+/**
+ * Return a type of another extension module, if it has been imported.
+ *
+ * The source files are linked into several modules, each with its own
+ * copy of the types, so objects created by another module are recognised
+ * by comparing against the types it exports in its "_types" capsule.
+ *
+ * :param name: Full name of the module, e.g. "subvertpy._ra"
+ * :param id: Identifier of the type
+ * :return: Borrowed reference to the type, or NULL
+ */
+PyTypeObject *subvertpy_module_type(const char *name, int id)
+{
+    PyObject *mod, *capsule;
+    subvertpy_state_t *state;
+
+    /* A module that has not been imported can not have created objects. */
+    mod = PyDict_GetItemString(PyImport_GetModuleDict(), name);
+    if (mod == NULL)
+        return NULL;
+    capsule = PyObject_GetAttrString(mod, "_types");
+    if (capsule == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+    state = PyCapsule_GetPointer(capsule, SUBVERTPY_TYPES_CAPSULE);
+    Py_DECREF(capsule);
+    if (state == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+    return state->types[id];
+}
+
+/**
+ * Release an object created with PyObject_New().
+ *
+ * Instances of heap types hold a reference to their type, which is
+ * dropped here.
+ */
+void py_object_del(void *obj)
+{
+    PyTypeObject *type = Py_TYPE((PyObject *)obj);
+
+    PyObject_Del(obj);
+    if (type->tp_flags & Py_TPFLAGS_HEAPTYPE)
+        Py_DECREF(type);
+}
+
+#ifdef SUBVERTPY_HEAP_TYPES
+/* The source files are linked into several extension modules, so these
+ * are per module rather than per process. The state of the module in the
+ * main interpreter is kept at hand; other interpreters find theirs in
+ * their interpreter dictionary, under state_key. */
+static subvertpy_state_t *main_state = NULL;
+static char state_key[64];
+
+/**
+ * Return the state of this module in the current interpreter.
+ */
+subvertpy_state_t *subvertpy_state(void)
+{
+    PyInterpreterState *interp = PyInterpreterState_Get();
+    PyObject *dict, *mod;
+
+    if (main_state != NULL && interp == PyInterpreterState_Main())
+        return main_state;
+
+    dict = PyInterpreterState_GetDict(interp);
+    mod = (dict == NULL)?NULL:PyDict_GetItemString(dict, state_key);
+    if (mod == NULL)
+        Py_FatalError("subvertpy: module not initialized in this interpreter");
+    return PyModule_GetState(mod);
+}
+
+/**
+ * Register mod as the module of the current interpreter.
+ *
+ * The interpreter dictionary keeps the module, and with it the state,
+ * alive until the interpreter is finalized.
+ */
+int subvertpy_state_init(PyObject *mod)
+{
+    PyInterpreterState *interp = PyInterpreterState_Get();
+    PyObject *dict;
+
+    dict = PyInterpreterState_GetDict(interp);
+    if (dict == NULL) {
+        if (!PyErr_Occurred())
+            PyErr_SetString(PyExc_RuntimeError,
+                            "no interpreter dictionary available");
+        return -1;
+    }
+
+    snprintf(state_key, sizeof(state_key), "subvertpy.%s",
+             PyModule_GetDef(mod)->m_name);
+    if (PyDict_SetItemString(dict, state_key, mod) < 0)
+        return -1;
+
+    if (interp == PyInterpreterState_Main())
+        main_state = PyModule_GetState(mod);
+    return PyModule_AddObject(mod, "_types",
+                              PyCapsule_New(PyModule_GetState(mod),
+                                            SUBVERTPY_TYPES_CAPSULE, NULL));
+}
+
+/**
+ * Create a heap type from the static definition in def.
+ */
+static PyTypeObject *type_from_template(PyObject *mod,
+                                        const subvertpy_type_def_t *def)
+{
+    PyTypeObject *tmpl = def->tmpl;
+    PyType_Slot slots[48];
+    PyType_Spec spec;
+    int n = 0;
+
+#define ADD_SLOT(id, value) \
+    if ((value) != NULL) { \
+        slots[n].slot = (id); \
+        slots[n].pfunc = (void *)(value); \
+        n++; \
+    }
+    ADD_SLOT(Py_tp_dealloc, tmpl->tp_dealloc);
+    ADD_SLOT(Py_tp_getattr, tmpl->tp_getattr);
+    ADD_SLOT(Py_tp_setattr, tmpl->tp_setattr);
+    ADD_SLOT(Py_tp_repr, tmpl->tp_repr);
+    ADD_SLOT(Py_tp_hash, tmpl->tp_hash);
+    ADD_SLOT(Py_tp_call, tmpl->tp_call);
+    ADD_SLOT(Py_tp_str, tmpl->tp_str);
+    ADD_SLOT(Py_tp_getattro, tmpl->tp_getattro);
+    ADD_SLOT(Py_tp_setattro, tmpl->tp_setattro);
+    ADD_SLOT(Py_tp_doc, tmpl->tp_doc);
+    ADD_SLOT(Py_tp_traverse, tmpl->tp_traverse);
+    ADD_SLOT(Py_tp_clear, tmpl->tp_clear);
+    ADD_SLOT(Py_tp_richcompare, tmpl->tp_richcompare);
+    ADD_SLOT(Py_tp_iter, tmpl->tp_iter);
+    ADD_SLOT(Py_tp_iternext, tmpl->tp_iternext);
+    ADD_SLOT(Py_tp_methods, tmpl->tp_methods);
+    ADD_SLOT(Py_tp_members, tmpl->tp_members);
+    ADD_SLOT(Py_tp_getset, tmpl->tp_getset);
+    ADD_SLOT(Py_tp_descr_get, tmpl->tp_descr_get);
+    ADD_SLOT(Py_tp_descr_set, tmpl->tp_descr_set);
+    ADD_SLOT(Py_tp_init, tmpl->tp_init);
+    ADD_SLOT(Py_tp_new, tmpl->tp_new);
+    ADD_SLOT(Py_tp_finalize, tmpl->tp_finalize);
+    if (tmpl->tp_as_sequence != NULL) {
+        ADD_SLOT(Py_sq_length, tmpl->tp_as_sequence->sq_length);
+        ADD_SLOT(Py_sq_concat, tmpl->tp_as_sequence->sq_concat);
+        ADD_SLOT(Py_sq_repeat, tmpl->tp_as_sequence->sq_repeat);
+        ADD_SLOT(Py_sq_item, tmpl->tp_as_sequence->sq_item);
+        ADD_SLOT(Py_sq_ass_item, tmpl->tp_as_sequence->sq_ass_item);
+        ADD_SLOT(Py_sq_contains, tmpl->tp_as_sequence->sq_contains);
+    }
+    if (tmpl->tp_as_mapping != NULL) {
+        ADD_SLOT(Py_mp_length, tmpl->tp_as_mapping->mp_length);
+        ADD_SLOT(Py_mp_subscript, tmpl->tp_as_mapping->mp_subscript);
+        ADD_SLOT(Py_mp_ass_subscript,
+                 tmpl->tp_as_mapping->mp_ass_subscript);
+    }
+    if (tmpl->tp_as_async != NULL) {
+        ADD_SLOT(Py_am_await, tmpl->tp_as_async->am_await);
+        ADD_SLOT(Py_am_aiter, tmpl->tp_as_async->am_aiter);
+        ADD_SLOT(Py_am_anext, tmpl->tp_as_async->am_anext);
+    }
+#undef ADD_SLOT
+    slots[n].slot = 0;
+    slots[n].pfunc = NULL;
+
+    spec.name = tmpl->tp_name;
+    spec.basicsize = tmpl->tp_basicsize;
+    spec.itemsize = tmpl->tp_itemsize;
+    spec.flags = tmpl->tp_flags | Py_TPFLAGS_IMMUTABLETYPE;
+    /* Heap types inherit tp_new from object, static ones don't. */
+    if (tmpl->tp_new == NULL && !def->dict_subclass)
+        spec.flags |= Py_TPFLAGS_DISALLOW_INSTANTIATION;
+    spec.slots = slots;
+
+    return (PyTypeObject *)PyType_FromModuleAndSpec(
+        mod, &spec, def->dict_subclass?(PyObject *)&PyDict_Type:NULL);
+}
+
+/**
+ * Create the types in defs, which is terminated by an entry without
+ * template, for mod.
+ */
+int subvertpy_add_types(PyObject *mod, const subvertpy_type_def_t *defs)
+{
+    subvertpy_state_t *state = PyModule_GetState(mod);
+
+    for (; defs->tmpl != NULL; defs++) {
+        PyTypeObject *type = type_from_template(mod, defs);
+        if (type == NULL)
+            return -1;
+        Py_XSETREF(state->types[defs->id], type);
+    }
+    return 0;
+}
+
+int subvertpy_state_traverse(PyObject *mod, visitproc visit, void *arg)
+{
+    subvertpy_state_t *state = PyModule_GetState(mod);
+    int i;
+
+    if (state == NULL)
+        return 0;
+    for (i = 0; i < SUBVERTPY_NUM_TYPES; i++)
+        Py_VISIT(state->types[i]);
+    Py_VISIT(state->busy_exc);
+    Py_VISIT(state->async_complete_func);
+    return 0;
+}
+
+int subvertpy_state_clear(PyObject *mod)
+{
+    subvertpy_state_t *state = PyModule_GetState(mod);
+    int i;
+
+    if (state == NULL)
+        return 0;
+    for (i = 0; i < SUBVERTPY_NUM_TYPES; i++)
+        Py_CLEAR(state->types[i]);
+    Py_CLEAR(state->busy_exc);
+    Py_CLEAR(state->async_complete_func);
+    return 0;
+}
+
+void subvertpy_state_free(void *mod)
+{
+    if (main_state == PyModule_GetState(mod))
+        main_state = NULL;
+    subvertpy_state_clear(mod);
+}
+#else
+/* Without heap types there is a single set of (static) types, shared
+ * by all interpreters. */
+static subvertpy_state_t static_state;
+
+subvertpy_state_t *subvertpy_state(void)
+{
+    return &static_state;
+}
+
+int subvertpy_state_init(PyObject *mod)
+{
+    return PyModule_AddObject(mod, "_types",
+                              PyCapsule_New(&static_state,
+                                            SUBVERTPY_TYPES_CAPSULE, NULL));
+}
+
+int subvertpy_add_types(PyObject *mod, const subvertpy_type_def_t *defs)
+{
+    for (; defs->tmpl != NULL; defs++) {
+        if (defs->dict_subclass)
+            defs->tmpl->tp_base = &PyDict_Type;
+        if (PyType_Ready(defs->tmpl) < 0)
+            return -1;
+        static_state.types[defs->id] = defs->tmpl;
+    }
+    return 0;
+}
+
+int subvertpy_state_traverse(PyObject *mod, visitproc visit, void *arg)
+{
+    return 0;
+}
+
+int subvertpy_state_clear(PyObject *mod)
+{
+    return 0;
+}
+
+void subvertpy_state_free(void *mod)
+{
+}
+#endif
+
+void progress_init(progress_state_t *progress, PyObject *func)
+{
+    memset(progress, 0, sizeof(progress_state_t));
+    Py_INCREF(func);
+    progress->func = func;
+}
+
+void progress_set_func(progress_state_t *progress, PyObject *func)
+{
+    Py_INCREF(func);
+    Py_XDECREF(progress->func);
+    progress->func = func;
+}
+
+/**
+ * Progress callback for libsvn.
+ *
+ * Called without the GIL held, often many times per second. The counters
+ * are updated natively and Python is only called once both min_interval
+ * and min_bytes have passed since the last call, or when the transfer
+ * is complete.
+ */
+void py_progress_func(apr_off_t progress, apr_off_t total, void *baton,
+                      apr_pool_t *pool)
+{
+    progress_state_t *state = (progress_state_t *)baton;
+    PyGILState_STATE gstate;
+    PyObject *ret;
+    apr_off_t last;
+    apr_time_t now;
+
+    /* Some RA layers report progress per request rather than per
+     * session. */
+    last = subvertpy_counter_exchange(&state->last_progress, progress);
+    if (progress >= last)
+        subvertpy_counter_add(&state->bytes, progress - last);
+    else
+        subvertpy_counter_add(&state->bytes, progress);
+    subvertpy_counter_add(&state->ticks, 1);
+
+    if (state->func == Py_None)
+        return;
+
+    last = subvertpy_counter_get(&state->last_reported);
+    if (progress < last)
+        last = 0;
+
+    if (total < 0 || progress < total) {
+        if (state->min_bytes > 0 && progress - last < state->min_bytes)
+            return;
+        if (state->min_interval > 0) {
+            now = apr_time_now();
+            if (now - subvertpy_counter_get(&state->last_time) <
+                    state->min_interval)
+                return;
+            subvertpy_counter_set(&state->last_time, now);
+        }
+    }
+    subvertpy_counter_set(&state->last_reported, progress);
+    subvertpy_counter_add(&state->calls, 1);
+
+    gstate = PyGILState_Ensure();
+    ret = PyObject_CallFunction(state->func, "LL", progress, total);
+    Py_XDECREF(ret);
+    PyGILState_Release(gstate);
+}
+
+PyObject *progress_get_interval(progress_state_t *progress)
+{
+    return PyFloat_FromDouble((double)progress->min_interval / APR_USEC_PER_SEC);
+}
+
+int progress_set_interval(progress_state_t *progress, PyObject *value)
+{
+    double interval;
+
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "can not delete progress_interval");
+        return -1;
+    }
+    interval = PyFloat_AsDouble(value);
+    if (interval == -1 && PyErr_Occurred())
+        return -1;
+    if (interval < 0) {
+        PyErr_SetString(PyExc_ValueError, "interval can not be negative");
+        return -1;
+    }
+    progress->min_interval = (apr_time_t)(interval * APR_USEC_PER_SEC);
+    return 0;
+}
+
+PyObject *progress_get_min_bytes(progress_state_t *progress)
+{
+    return PyLong_FromLongLong(progress->min_bytes);
+}
+
+int progress_set_min_bytes(progress_state_t *progress, PyObject *value)
+{
+    PY_LONG_LONG min_bytes;
+
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "can not delete progress_min_bytes");
+        return -1;
+    }
+    min_bytes = PyLong_AsLongLong(value);
+    if (min_bytes == -1 && PyErr_Occurred())
+        return -1;
+    if (min_bytes < 0) {
+        PyErr_SetString(PyExc_ValueError, "byte count can not be negative");
+        return -1;
+    }
+    progress->min_bytes = min_bytes;
+    return 0;
+}
+
+PyObject *progress_counters(progress_state_t *progress)
+{
+    return Py_BuildValue("{s:L,s:L,s:d,s:L,s:L}",
+                         "bytes",
+                         (PY_LONG_LONG)subvertpy_counter_get(&progress->bytes),
+                         "requests",
+                         (PY_LONG_LONG)subvertpy_counter_get(&progress->requests),
+                         "elapsed",
+                         (double)subvertpy_counter_get(&progress->elapsed) /
+                             APR_USEC_PER_SEC,
+                         "progress_ticks",
+                         (PY_LONG_LONG)subvertpy_counter_get(&progress->ticks),
+                         "progress_calls",
+                         (PY_LONG_LONG)subvertpy_counter_get(&progress->calls));
+}
+
 PyTypeObject *PyErr_GetSubversionExceptionTypeObject(void)
 {
     PyObject *coremod, *excobj;
@@ -482,34 +1091,174 @@ bool relpath_list_to_apr_array(apr_pool_t *pool, PyObject *l, apr_array_header_t
 	return true;
 }
 
+/* Direct-mapped cache of str objects, keyed by their UTF-8 contents.
+ * Only accessed with the GIL held, or with the lock of the cache on
+ * free-threaded builds. */
+typedef struct {
+	size_t hash;
+	Py_ssize_t len;
+	char *data;
+	PyObject *obj;
+} string_cache_slot_t;
+
+typedef struct {
+	subvertpy_mutex_t lock;
+	string_cache_slot_t *slots;
+	size_t size;
+	Py_ssize_t max_len;
+	bool intern;
+} string_cache_t;
+
+static size_t string_cache_hash(const char *data, Py_ssize_t len)
+{
+	/* FNV-1a */
+	size_t hash = 2166136261U;
+	Py_ssize_t i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/**
+ * Return a str for data, reusing a cached object where possible.
+ *
+ * The number of slots in cache must be a power of two. The lock is not
+ * held while the str is created, so that it is only contended for the
+ * lookup and the store. Objects can not be shared between interpreters,
+ * so only the main interpreter uses the cache.
+ */
+static PyObject *string_cache_get(string_cache_t *cache, const char *data,
+								  Py_ssize_t len)
+{
+	size_t hash;
+	string_cache_slot_t *slot;
+	PyObject *ret, *old;
+	char *copy;
+
+	if (len > cache->max_len || !subvertpy_in_main_interpreter())
+		return PyUnicode_FromStringAndSize(data, len);
+
+	hash = string_cache_hash(data, len);
+	slot = &cache->slots[hash & (cache->size - 1)];
+	subvertpy_mutex_lock(&cache->lock);
+	if (slot->obj != NULL && slot->hash == hash && slot->len == len &&
+		memcmp(slot->data, data, len) == 0) {
+		ret = slot->obj;
+		Py_INCREF(ret);
+		subvertpy_mutex_unlock(&cache->lock);
+		return ret;
+	}
+	subvertpy_mutex_unlock(&cache->lock);
+
+	ret = PyUnicode_FromStringAndSize(data, len);
+	if (ret == NULL)
+		return NULL;
+
+#if PY_MAJOR_VERSION >= 3
+	if (cache->intern)
+		PyUnicode_InternInPlace(&ret);
+#endif
+
+	subvertpy_mutex_lock(&cache->lock);
+	copy = PyMem_Realloc(slot->data, len + 1);
+	if (copy == NULL) {
+		/* Not fatal; just don't cache. */
+		subvertpy_mutex_unlock(&cache->lock);
+		return ret;
+	}
+	memcpy(copy, data, len);
+	slot->data = copy;
+	slot->hash = hash;
+	slot->len = len;
+	old = slot->obj;
+	slot->obj = ret;
+	Py_INCREF(ret);
+	subvertpy_mutex_unlock(&cache->lock);
+	Py_XDECREF(old);
+
+	return ret;
+}
+
+#define PROP_NAME_CACHE_SIZE 256
+#define PROP_NAME_MAX_LEN 128
+
+static string_cache_slot_t prop_name_slots[PROP_NAME_CACHE_SIZE];
+static string_cache_t prop_name_cache = {
+	.slots = prop_name_slots,
+	.size = PROP_NAME_CACHE_SIZE,
+	.max_len = PROP_NAME_MAX_LEN,
+	.intern = true,
+};
+
+/**
+ * Convert a property name to a str.
+ *
+ * Property names are drawn from a small set (svn:log, svn:author,
+ * svn:date, svn:mergeinfo, ...), so the str objects are cached and
+ * interned rather than allocated for every property of every revision.
+ */
+PyObject *py_prop_name(const char *name, apr_ssize_t len)
+{
+	if (len < 0)
+		len = strlen(name);
+	return string_cache_get(&prop_name_cache, name, len);
+}
+
+#define PATH_CACHE_SIZE 4096
+#define PATH_MAX_LEN 512
+
+static string_cache_slot_t path_slots[PATH_CACHE_SIZE];
+static string_cache_t path_cache = {
+	.slots = path_slots,
+	.size = PATH_CACHE_SIZE,
+	.max_len = PATH_MAX_LEN,
+	.intern = false,
+};
+
+/**
+ * Convert a path produced by Subversion to a str.
+ *
+ * Log entries, directory listings and status walks keep returning the
+ * same paths, so recently converted ones are shared from a bounded
+ * cache rather than allocated again.
+ */
+PyObject *py_path_string(const char *path, apr_ssize_t len)
+{
+	if (len < 0)
+		len = strlen(path);
+	return string_cache_get(&path_cache, path, len);
+}
+
+static PyObject *py_prop_value(const svn_string_t *val)
+{
+	if (val == NULL || val->data == NULL)
+		Py_RETURN_NONE;
+	return PyBytes_FromStringAndSize(val->data, val->len);
+}
+
 PyObject *prop_hash_to_dict(apr_hash_t *props)
 {
 	const char *key;
 	apr_hash_index_t *idx;
 	apr_ssize_t klen;
 	svn_string_t *val;
-	apr_pool_t *pool;
 	PyObject *py_props;
-	if (props == NULL) {
-		return PyDict_New();
-	}
-	pool = Pool(NULL);
-	if (pool == NULL)
-		goto fail_pool;
+
 	py_props = PyDict_New();
-	if (py_props == NULL) {
-		goto fail_props;
+	if (py_props == NULL || props == NULL) {
+		return py_props;
 	}
-	for (idx = apr_hash_first(pool, props); idx != NULL;
+	/* A NULL pool makes APR use the iterator embedded in the hash, which
+	 * saves creating a pool for every call. */
+	for (idx = apr_hash_first(NULL, props); idx != NULL;
 		 idx = apr_hash_next(idx)) {
 		PyObject *py_key, *py_val;
 		apr_hash_this(idx, (const void **)&key, &klen, (void **)&val);
-		if (val == NULL || val->data == NULL) {
-			py_val = Py_None;
-			Py_INCREF(py_val);
-		} else {
-			py_val = PyBytes_FromStringAndSize(val->data, val->len);
-		}
+		py_val = py_prop_value(val);
 		if (py_val == NULL) {
 			goto fail_item;
 		}
@@ -517,7 +1266,11 @@ PyObject *prop_hash_to_dict(apr_hash_t *props)
 			py_key = Py_None;
 			Py_INCREF(py_key);
 		} else {
-			py_key = PyUnicode_FromStringAndSize(key, klen);
+			py_key = py_prop_name(key, klen);
+		}
+		if (py_key == NULL) {
+			Py_DECREF(py_val);
+			goto fail_item;
 		}
 		if (PyDict_SetItem(py_props, py_key, py_val) != 0) {
 			Py_DECREF(py_key);
@@ -527,17 +1280,412 @@ PyObject *prop_hash_to_dict(apr_hash_t *props)
 		Py_DECREF(py_key);
 		Py_DECREF(py_val);
 	}
-	apr_pool_destroy(pool);
 	return py_props;
 
 fail_item:
 	Py_DECREF(py_props);
-fail_props:
-	apr_pool_destroy(pool);
-fail_pool:
 	return NULL;
 }
 
+typedef struct {
+	const char *key;
+	Py_ssize_t klen;
+	const char *val;
+	Py_ssize_t vlen;
+	PyObject *py_val;
+} propdict_entry_t;
+
+typedef struct {
+	PyObject_HEAD
+	Py_ssize_t count;
+	/* Entries followed by the key and value data, in a single block. */
+	propdict_entry_t *entries;
+} PropDictObject;
+
+/**
+ * Convert a property hash to a PropDict.
+ *
+ * Keys and values are copied into a single block of memory; str and
+ * bytes objects are only created when they are accessed.
+ */
+PyObject *prop_hash_to_propdict(apr_hash_t *props)
+{
+	PropDictObject *ret;
+	apr_hash_index_t *idx;
+	const char *key;
+	apr_ssize_t klen;
+	svn_string_t *val;
+	size_t size;
+	Py_ssize_t count, i;
+	char *data;
+
+	ret = PyObject_New(PropDictObject, SUBVERTPY_TYPE(PropDict_Type));
+	if (ret == NULL)
+		return NULL;
+	ret->count = 0;
+	ret->entries = NULL;
+
+	if (props == NULL)
+		return (PyObject *)ret;
+
+	count = apr_hash_count(props);
+	size = count * sizeof(propdict_entry_t);
+	for (idx = apr_hash_first(NULL, props); idx != NULL;
+		 idx = apr_hash_next(idx)) {
+		apr_hash_this(idx, (const void **)&key, &klen, (void **)&val);
+		size += klen;
+		if (val != NULL && val->data != NULL)
+			size += val->len;
+	}
+
+	ret->entries = PyMem_Malloc(size + 1);
+	if (ret->entries == NULL) {
+		Py_DECREF(ret);
+		return PyErr_NoMemory();
+	}
+
+	data = (char *)(ret->entries + count);
+	i = 0;
+	for (idx = apr_hash_first(NULL, props); idx != NULL && i < count;
+		 idx = apr_hash_next(idx), i++) {
+		propdict_entry_t *entry = &ret->entries[i];
+		apr_hash_this(idx, (const void **)&key, &klen, (void **)&val);
+		memcpy(data, key, klen);
+		entry->key = data;
+		entry->klen = klen;
+		data += klen;
+		entry->py_val = NULL;
+		if (val == NULL || val->data == NULL) {
+			entry->val = NULL;
+			entry->vlen = 0;
+		} else {
+			memcpy(data, val->data, val->len);
+			entry->val = data;
+			entry->vlen = val->len;
+			data += val->len;
+		}
+	}
+	ret->count = i;
+
+	return (PyObject *)ret;
+}
+
+static void propdict_dealloc(PyObject *self)
+{
+	PropDictObject *propdict = (PropDictObject *)self;
+	Py_ssize_t i;
+
+	for (i = 0; i < propdict->count; i++)
+		Py_XDECREF(propdict->entries[i].py_val);
+	PyMem_Free(propdict->entries);
+	py_object_del(self);
+}
+
+static Py_ssize_t propdict_len(PyObject *self)
+{
+	return ((PropDictObject *)self)->count;
+}
+
+/* Find the entry for a property name. Returns NULL without an exception
+ * set if it is not present. */
+static propdict_entry_t *propdict_find(PropDictObject *self, PyObject *key)
+{
+	const char *name;
+	Py_ssize_t len, i;
+	propdict_entry_t *ret = NULL;
+#if PY_MAJOR_VERSION < 3
+	PyObject *bytes;
+#endif
+
+	if (!PyUnicode_Check(key))
+		return NULL;
+
+#if PY_MAJOR_VERSION >= 3
+	name = PyUnicode_AsUTF8AndSize(key, &len);
+	if (name == NULL)
+		return NULL;
+#else
+	bytes = PyUnicode_AsUTF8String(key);
+	if (bytes == NULL)
+		return NULL;
+	name = PyBytes_AsString(bytes);
+	len = PyBytes_Size(bytes);
+#endif
+
+	/* Nodes and revisions have few properties; a linear scan beats
+	 * building an index. */
+	for (i = 0; i < self->count; i++) {
+		if (self->entries[i].klen == len &&
+			memcmp(self->entries[i].key, name, len) == 0) {
+			ret = &self->entries[i];
+			break;
+		}
+	}
+
+#if PY_MAJOR_VERSION < 3
+	Py_DECREF(bytes);
+#endif
+	return ret;
+}
+
+static PyObject *propdict_entry_value(PropDictObject *propdict,
+										propdict_entry_t *entry)
+{
+	PyObject *ret;
+
+	/* Values are created on first access, possibly by several threads
+	 * at once. */
+	Py_BEGIN_CRITICAL_SECTION(propdict);
+	if (entry->py_val == NULL) {
+		if (entry->val == NULL) {
+			entry->py_val = Py_None;
+			Py_INCREF(Py_None);
+		} else {
+			entry->py_val = PyBytes_FromStringAndSize(entry->val,
+													  entry->vlen);
+		}
+	}
+	ret = entry->py_val;
+	Py_XINCREF(ret);
+	Py_END_CRITICAL_SECTION();
+
+	return ret;
+}
+
+static PyObject *propdict_subscript(PyObject *self, PyObject *key)
+{
+	propdict_entry_t *entry;
+
+	entry = propdict_find((PropDictObject *)self, key);
+	if (entry == NULL) {
+		if (!PyErr_Occurred())
+			PyErr_SetObject(PyExc_KeyError, key);
+		return NULL;
+	}
+
+	return propdict_entry_value((PropDictObject *)self, entry);
+}
+
+static int propdict_contains(PyObject *self, PyObject *key)
+{
+	if (propdict_find((PropDictObject *)self, key) != NULL)
+		return 1;
+	return PyErr_Occurred()?-1:0;
+}
+
+static PyObject *propdict_get(PyObject *self, PyObject *args)
+{
+	PyObject *key, *defval = Py_None;
+	propdict_entry_t *entry;
+
+	if (!PyArg_ParseTuple(args, "O|O:get", &key, &defval))
+		return NULL;
+
+	entry = propdict_find((PropDictObject *)self, key);
+	if (entry == NULL) {
+		if (PyErr_Occurred())
+			return NULL;
+		Py_INCREF(defval);
+		return defval;
+	}
+
+	return propdict_entry_value((PropDictObject *)self, entry);
+}
+
+static PyObject *propdict_keys(PyObject *self)
+{
+	PropDictObject *propdict = (PropDictObject *)self;
+	PyObject *ret;
+	Py_ssize_t i;
+
+	ret = PyList_New(propdict->count);
+	if (ret == NULL)
+		return NULL;
+
+	for (i = 0; i < propdict->count; i++) {
+		PyObject *key = py_prop_name(propdict->entries[i].key,
+									 propdict->entries[i].klen);
+		if (key == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+		PyList_SET_ITEM(ret, i, key);
+	}
+
+	return ret;
+}
+
+static PyObject *propdict_values(PyObject *self)
+{
+	PropDictObject *propdict = (PropDictObject *)self;
+	PyObject *ret;
+	Py_ssize_t i;
+
+	ret = PyList_New(propdict->count);
+	if (ret == NULL)
+		return NULL;
+
+	for (i = 0; i < propdict->count; i++) {
+		PyObject *value = propdict_entry_value(propdict,
+											   &propdict->entries[i]);
+		if (value == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+		PyList_SET_ITEM(ret, i, value);
+	}
+
+	return ret;
+}
+
+static PyObject *propdict_copy(PyObject *self)
+{
+	PropDictObject *propdict = (PropDictObject *)self;
+	PyObject *ret;
+	Py_ssize_t i;
+
+	ret = PyDict_New();
+	if (ret == NULL)
+		return NULL;
+
+	for (i = 0; i < propdict->count; i++) {
+		PyObject *key, *value;
+		int err;
+
+		key = py_prop_name(propdict->entries[i].key,
+						   propdict->entries[i].klen);
+		if (key == NULL) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+		value = propdict_entry_value(propdict, &propdict->entries[i]);
+		if (value == NULL) {
+			Py_DECREF(key);
+			Py_DECREF(ret);
+			return NULL;
+		}
+		err = PyDict_SetItem(ret, key, value);
+		Py_DECREF(key);
+		Py_DECREF(value);
+		if (err != 0) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+static PyObject *propdict_items(PyObject *self)
+{
+	PyObject *dict, *ret;
+
+	dict = propdict_copy(self);
+	if (dict == NULL)
+		return NULL;
+
+	ret = PyDict_Items(dict);
+	Py_DECREF(dict);
+	return ret;
+}
+
+static PyObject *propdict_iter(PyObject *self)
+{
+	PyObject *keys, *ret;
+
+	keys = propdict_keys(self);
+	if (keys == NULL)
+		return NULL;
+
+	ret = PyObject_GetIter(keys);
+	Py_DECREF(keys);
+	return ret;
+}
+
+static PyObject *propdict_richcompare(PyObject *self, PyObject *other, int op)
+{
+	PyObject *dict, *ret;
+
+	if ((op != Py_EQ && op != Py_NE) ||
+		(!PyDict_Check(other) && Py_TYPE(other) != SUBVERTPY_TYPE(PropDict_Type))) {
+		Py_INCREF(Py_NotImplemented);
+		return Py_NotImplemented;
+	}
+
+	dict = propdict_copy(self);
+	if (dict == NULL)
+		return NULL;
+
+	if (Py_TYPE(other) == SUBVERTPY_TYPE(PropDict_Type)) {
+		other = propdict_copy(other);
+		if (other == NULL) {
+			Py_DECREF(dict);
+			return NULL;
+		}
+	} else {
+		Py_INCREF(other);
+	}
+
+	ret = PyObject_RichCompare(dict, other, op);
+	Py_DECREF(other);
+	Py_DECREF(dict);
+	return ret;
+}
+
+static PyObject *propdict_repr(PyObject *self)
+{
+	PyObject *dict, *ret;
+
+	dict = propdict_copy(self);
+	if (dict == NULL)
+		return NULL;
+
+	ret = PyObject_Repr(dict);
+	Py_DECREF(dict);
+	return ret;
+}
+
+static PyMethodDef propdict_methods[] = {
+	{ "get", propdict_get, METH_VARARGS,
+		"S.get(name, default=None) -> value" },
+	{ "keys", (PyCFunction)propdict_keys, METH_NOARGS,
+		"S.keys() -> list of property names" },
+	{ "values", (PyCFunction)propdict_values, METH_NOARGS,
+		"S.values() -> list of property values" },
+	{ "items", (PyCFunction)propdict_items, METH_NOARGS,
+		"S.items() -> list of (name, value) tuples" },
+	{ "copy", (PyCFunction)propdict_copy, METH_NOARGS,
+		"S.copy() -> dict" },
+	{ NULL }
+};
+
+static PyMappingMethods propdict_as_mapping = {
+	.mp_length = propdict_len,
+	.mp_subscript = propdict_subscript,
+};
+
+static PySequenceMethods propdict_as_sequence = {
+	.sq_contains = propdict_contains,
+};
+
+PyTypeObject PropDict_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	"_ra.PropDict", /*	const char *tp_name;  For printing, in format "<module>.<name>" */
+	sizeof(PropDictObject),
+	0,/*	Py_ssize_t tp_basicsize, tp_itemsize;  For allocation */
+
+	.tp_dealloc = propdict_dealloc,
+	.tp_repr = propdict_repr,
+	.tp_as_sequence = &propdict_as_sequence,
+	.tp_as_mapping = &propdict_as_mapping,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_doc = "Read-only mapping of property names to values. Values are "
+		"decoded when they are first accessed.",
+	.tp_richcompare = propdict_richcompare,
+	.tp_iter = propdict_iter,
+	.tp_methods = propdict_methods,
+};
+
 apr_hash_t *prop_dict_to_hash(apr_pool_t *pool, PyObject *py_props)
 {
 	Py_ssize_t idx = 0;
@@ -618,7 +1766,7 @@ PyObject *pyify_changed_paths(apr_hash_t *changed_paths, bool node_kind, apr_poo
 				py_copyfrom_path = Py_None;
 				Py_INCREF(Py_None);
 			} else {
-				py_copyfrom_path = PyUnicode_FromString(val->copyfrom_path);
+				py_copyfrom_path = py_path_string(val->copyfrom_path, -1);
 			}
 			if (node_kind) {
 				pyval = Py_BuildValue(SOURCEPATH_FORMAT4, val->action, py_copyfrom_path,
@@ -639,7 +1787,7 @@ PyObject *pyify_changed_paths(apr_hash_t *changed_paths, bool node_kind, apr_poo
 				return NULL;
 			}
 
-			py_key = PyUnicode_FromString(key);
+			py_key = py_path_string(key, klen);
 			if (py_key == NULL) {
 				Py_DECREF(pyval);
 				Py_DECREF(py_changed_paths);
@@ -685,7 +1833,7 @@ PyObject *pyify_changed_paths2(apr_hash_t *changed_paths, apr_pool_t *pool)
 				py_copyfrom_path = Py_None;
 				Py_INCREF(Py_None);
 			} else {
-				py_copyfrom_path = PyUnicode_FromString(val->copyfrom_path);
+				py_copyfrom_path = py_path_string(val->copyfrom_path, -1);
 			}
 			pyval = Py_BuildValue(SOURCEPATH_FORMAT4, val->action, py_copyfrom_path,
 										 val->copyfrom_rev, val->node_kind);
@@ -699,7 +1847,7 @@ PyObject *pyify_changed_paths2(apr_hash_t *changed_paths, apr_pool_t *pool)
 				Py_DECREF(pyval);
 				return NULL;
 			}
-			py_key = PyUnicode_FromString(key);
+			py_key = py_path_string(key, klen);
 			if (py_key == NULL) {
 				Py_DECREF(py_changed_paths);
 				Py_DECREF(pyval);
@@ -851,18 +1999,21 @@ static svn_error_t *py_stream_read(void *baton, char *buffer, apr_size_t *length
 {
 	PyObject *self = (PyObject *)baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 
 	ret = PyObject_CallMethod(self, "read", "i", *length);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 
 	if (!PyBytes_Check(ret)) {
 		PyErr_SetString(PyExc_TypeError, "Expected stream read function to return bytes");
+		STATS_TIMER_STOP(STATS_CALLBACK, 0, true);
 		PyGILState_Release(state);
 		return py_svn_error();
 	}
 	*length = PyBytes_Size(ret);
 	memcpy(buffer, PyBytes_AsString(ret), *length);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, *length, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -871,13 +2022,16 @@ static svn_error_t *py_stream_write(void *baton, const char *data, apr_size_t *l
 {
 	PyObject *self = (PyObject *)baton, *ret, *py_data;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 
 	py_data = PyBytes_FromStringAndSize(data, *len);
-	CB_CHECK_PYRETVAL(py_data);
+	CB_CHECK_PYRETVAL_TIMED(py_data);
 
 	ret = PyObject_CallMethod(self, "write", "O", py_data);
-	CB_CHECK_PYRETVAL(ret);
+	Py_DECREF(py_data);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, *len, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -886,10 +2040,12 @@ static svn_error_t *py_stream_close(void *baton)
 {
 	PyObject *self = (PyObject *)baton, *ret;
 	PyGILState_STATE state = PyGILState_Ensure();
+	STATS_TIMER;
 	ret = PyObject_CallMethod(self, "close", "");
 	Py_DECREF(self);
-	CB_CHECK_PYRETVAL(ret);
+	CB_CHECK_PYRETVAL_TIMED(ret);
 	Py_DECREF(ret);
+	STATS_TIMER_STOP(STATS_CALLBACK, 0, false);
 	PyGILState_Release(state);
 	return NULL;
 }
@@ -926,19 +2082,35 @@ svn_error_t *py_cancel_check(void *cancel_baton)
 
 static apr_hash_t *get_default_config(void)
 {
-	static bool initialised = false;
+	static subvertpy_mutex_t lock;
 	static apr_pool_t *pool = NULL;
 	static apr_hash_t *default_config = NULL;
+	apr_hash_t *ret;
 
-	if (!initialised) {
-		pool = Pool(NULL);
-		RUN_SVN_WITH_POOL(pool,
-					  svn_config_get_config(&default_config, NULL, pool));
+	/* The configuration is read with the GIL (or the lock) held, so that
+	 * concurrent first callers can not both load it. */
+	subvertpy_mutex_lock(&lock);
+	if (default_config == NULL) {
+		svn_error_t *err;
 		/* TODO(jelmer): Deal with pool */
-		initialised = true;
+		pool = Pool(NULL);
+		if (pool == NULL) {
+			subvertpy_mutex_unlock(&lock);
+			return NULL;
+		}
+		err = svn_config_get_config(&default_config, NULL, pool);
+		if (err != NULL) {
+			handle_svn_error(err);
+			svn_error_clear(err);
+			apr_pool_destroy(pool);
+			pool = NULL;
+			default_config = NULL;
+		}
 	}
+	ret = default_config;
+	subvertpy_mutex_unlock(&lock);
 
-	return default_config;
+	return ret;
 }
 
 apr_hash_t *config_hash_from_object(PyObject *config, apr_pool_t *pool)
@@ -1034,7 +2206,7 @@ static void stream_dealloc(PyObject *self)
 
 	apr_pool_destroy(streamself->pool);
 
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyObject *stream_init(PyTypeObject *type, PyObject *args, PyObject *kwargs)
@@ -1045,7 +2217,7 @@ static PyObject *stream_init(PyTypeObject *type, PyObject *args, PyObject *kwarg
 	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwnames))
 		return NULL;
 
-	ret = PyObject_New(StreamObject, &Stream_Type);
+	ret = PyObject_New(StreamObject, SUBVERTPY_TYPE(Stream_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -1164,6 +2336,12 @@ PyTypeObject Stream_Type = {
 	.tp_new = stream_init, /* tp_new tp_new */
 };
 
+const subvertpy_type_def_t util_types[] = {
+	{ PropDict_Type_ID, &PropDict_Type },
+	{ Stream_Type_ID, &Stream_Type },
+	{ 0, NULL }
+};
+
 PyObject *dirent_hash_to_dict(apr_hash_t *dirents, unsigned int dirent_fields, apr_pool_t *temp_pool)
 {
 	svn_dirent_t *dirent;
@@ -1188,7 +2366,12 @@ PyObject *dirent_hash_to_dict(apr_hash_t *dirents, unsigned int dirent_fields, a
 			pykey = Py_None;
 			Py_INCREF(pykey);
 		} else {
-			pykey = PyUnicode_FromStringAndSize(key, klen);
+			pykey = py_path_string(key, klen);
+			if (pykey == NULL) {
+				Py_DECREF(item);
+				Py_DECREF(py_dirents);
+				return NULL;
+			}
 		}
 		if (PyDict_SetItem(py_dirents, pykey, item) != 0) {
 			Py_DECREF(item);
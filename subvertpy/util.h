@@ -35,16 +35,262 @@
 
 #define ONLY_BEFORE_SVN(maj, min) (!(ONLY_SINCE_SVN(maj, min)))
 
+/* Free-threaded (PEP 703) builds of Python have no GIL to serialise
+ * access to shared state, so it is protected explicitly there. Since
+ * Python 3.13 the locks are also real for builds with a GIL, as
+ * subinterpreters can each have their own; before that they compile to
+ * nothing. Flags are plain bools with the GIL. */
+#ifndef Py_BEGIN_CRITICAL_SECTION
+#define Py_BEGIN_CRITICAL_SECTION(op) {
+#define Py_END_CRITICAL_SECTION() }
+#endif
+
+#if defined(Py_GIL_DISABLED) || PY_VERSION_HEX >= 0x030D0000
+typedef PyMutex subvertpy_mutex_t;
+#define subvertpy_mutex_lock(m) PyMutex_Lock(m)
+#define subvertpy_mutex_unlock(m) PyMutex_Unlock(m)
+#else
+typedef char subvertpy_mutex_t;
+#define subvertpy_mutex_lock(m) ((void)(m))
+#define subvertpy_mutex_unlock(m) ((void)(m))
+#endif
+
+/* Flag claimed by one thread at a time, e.g. while an object is in use
+ * with the GIL released. subvertpy_flag_test_and_set() returns whether
+ * the flag was already set. */
+#if defined(Py_GIL_DISABLED) && defined(_MSC_VER)
+#include <intrin.h>
+typedef volatile long subvertpy_flag_t;
+#define subvertpy_flag_test_and_set(f) (_InterlockedExchange((f), 1) != 0)
+#define subvertpy_flag_clear(f) ((void)_InterlockedExchange((f), 0))
+#define subvertpy_flag_is_set(f) (_InterlockedOr((f), 0) != 0)
+#elif defined(Py_GIL_DISABLED)
+typedef int subvertpy_flag_t;
+#define subvertpy_flag_test_and_set(f) \
+    (__atomic_exchange_n((f), 1, __ATOMIC_ACQ_REL) != 0)
+#define subvertpy_flag_clear(f) __atomic_store_n((f), 0, __ATOMIC_RELEASE)
+#define subvertpy_flag_is_set(f) (__atomic_load_n((f), __ATOMIC_ACQUIRE) != 0)
+#else
+typedef bool subvertpy_flag_t;
+#define subvertpy_flag_test_and_set(f) (*(f) || (*(f) = true, false))
+#define subvertpy_flag_clear(f) ((void)(*(f) = false))
+#define subvertpy_flag_is_set(f) (*(f))
+#endif
+
+/* Counters updated from libsvn callbacks, which run without the GIL and
+ * possibly on several threads at once, and read with the GIL. */
+#if defined(_MSC_VER)
+#include <intrin.h>
+typedef volatile __int64 subvertpy_counter_t;
+#define subvertpy_counter_add(c, n) \
+    ((void)_InterlockedExchangeAdd64((c), (n)))
+#define subvertpy_counter_exchange(c, n) _InterlockedExchange64((c), (n))
+#define subvertpy_counter_get(c) _InterlockedOr64((c), 0)
+#define subvertpy_counter_set(c, n) ((void)_InterlockedExchange64((c), (n)))
+#elif defined(__GNUC__)
+typedef apr_int64_t subvertpy_counter_t;
+#define subvertpy_counter_add(c, n) \
+    ((void)__atomic_fetch_add((c), (n), __ATOMIC_RELAXED))
+#define subvertpy_counter_exchange(c, n) \
+    __atomic_exchange_n((c), (n), __ATOMIC_RELAXED)
+#define subvertpy_counter_get(c) __atomic_load_n((c), __ATOMIC_RELAXED)
+#define subvertpy_counter_set(c, n) __atomic_store_n((c), (n), __ATOMIC_RELAXED)
+#else
+typedef apr_int64_t subvertpy_counter_t;
+#define subvertpy_counter_add(c, n) ((void)(*(c) += (n)))
+#define subvertpy_counter_exchange(c, n) subvertpy_counter_exchange_(c, n)
+static inline apr_int64_t subvertpy_counter_exchange_(
+    subvertpy_counter_t *c, apr_int64_t n)
+{
+    apr_int64_t old = *c;
+    *c = n;
+    return old;
+}
+#define subvertpy_counter_get(c) (*(c))
+#define subvertpy_counter_set(c, n) ((void)(*(c) = (n)))
+#endif
+
+/* Types are created per module, as heap types, so that every interpreter
+ * gets its own. Before Python 3.10 heap types can not be created with
+ * all the flags of the static definitions, so those are used directly. */
+#if PY_VERSION_HEX >= 0x030A0000
+#define SUBVERTPY_HEAP_TYPES
+#endif
+
+/* Identifiers of the types, as indexes into subvertpy_state_t.types. */
+enum {
+    PropDict_Type_ID,
+    Stream_Type_ID,
+    TxDeltaWindowHandler_Type_ID,
+    FileEditor_Type_ID,
+    DirectoryEditor_Type_ID,
+    Editor_Type_ID,
+    RangeList_Type_ID,
+    MergeInfo_Type_ID,
+    MergeInfoCatalog_Type_ID,
+    Reporter_Type_ID,
+    RemoteAccess_Type_ID,
+    AuthProvider_Type_ID,
+    CredentialsIter_Type_ID,
+    Auth_Type_ID,
+    LogIterator_Type_ID,
+    FileRevsIterator_Type_ID,
+    SegmentsIterator_Type_ID,
+    Config_Type_ID,
+    ConfigItem_Type_ID,
+    Info_Type_ID,
+    WCInfo_Type_ID,
+    Client_Type_ID,
+    FileSystem_Type_ID,
+    Repository_Type_ID,
+    FileSystemRoot_Type_ID,
+    CommittedQueue_Type_ID,
+    Context_Type_ID,
+    Status3_Type_ID,
+    Lock_Type_ID,
+    Adm_Type_ID,
+    Entry_Type_ID,
+    EntriesIterator_Type_ID,
+    Status2_Type_ID,
+    SUBVERTPY_NUM_TYPES
+};
+
+/* Module state. The same source files are linked into several extension
+ * modules, so they all share this layout; types that are not linked into
+ * a module are left NULL. */
+typedef struct {
+    PyTypeObject *types[SUBVERTPY_NUM_TYPES];
+    PyObject *busy_exc;
+    PyObject *async_complete_func;
+} subvertpy_state_t;
+
+/* Each module exports its state as a capsule under this name in its
+ * "_types" attribute, so that the other modules can recognise its
+ * objects by type identity; see subvertpy_module_type(). */
+#define SUBVERTPY_TYPES_CAPSULE "subvertpy._types"
+
+/* A type to create when a module is executed. tmpl is the static
+ * definition of the type; dict_subclass types derive from dict. */
+typedef struct {
+    int id;
+    PyTypeObject *tmpl;
+    bool dict_subclass;
+} subvertpy_type_def_t;
+
+#ifdef SUBVERTPY_HEAP_TYPES
+#define SUBVERTPY_TYPE(name) (subvertpy_state()->types[name##_ID])
+#define SUBVERTPY_STATE_SIZE ((Py_ssize_t)sizeof(subvertpy_state_t))
+#define subvertpy_in_main_interpreter() \
+    (PyInterpreterState_Get() == PyInterpreterState_Main())
+#else
+#define SUBVERTPY_TYPE(name) (&(name))
+#define SUBVERTPY_STATE_SIZE -1
+#define subvertpy_in_main_interpreter() true
+#endif
+
+/* Slots of every module definition, besides Py_mod_exec. Modules have
+ * no global state left that is not protected by a subvertpy_mutex_t, so
+ * they can run without the GIL, and with a GIL per interpreter once
+ * those locks are real. */
+#if PY_VERSION_HEX >= 0x030D0000
+#define SUBVERTPY_MODULE_SLOTS \
+    { Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED }, \
+    { Py_mod_gil, Py_MOD_GIL_NOT_USED },
+#elif defined(Py_mod_multiple_interpreters)
+#define SUBVERTPY_MODULE_SLOTS \
+    { Py_mod_multiple_interpreters, Py_MOD_MULTIPLE_INTERPRETERS_SUPPORTED },
+#else
+#define SUBVERTPY_MODULE_SLOTS
+#endif
+
+#if PY_VERSION_HEX >= 0x03090000
+#define subvertpy_current_interp() PyInterpreterState_Get()
+#else
+#define subvertpy_current_interp() (PyThreadState_Get()->interp)
+#endif
+
+/* Thread state attached to the calling thread, or NULL if it has none
+ * (for example because it released the GIL). */
+#if PY_VERSION_HEX >= 0x030D0000
+#define subvertpy_attached_tstate() PyThreadState_GetUnchecked()
+#elif PY_VERSION_HEX >= 0x03050200
+#define subvertpy_attached_tstate() _PyThreadState_UncheckedGet()
+#elif PY_MAJOR_VERSION >= 3
+#define subvertpy_attached_tstate() \
+    ((PyThreadState *)_Py_atomic_load_relaxed(&_PyThreadState_Current))
+#else
+#define subvertpy_attached_tstate() _PyThreadState_Current
+#endif
+
 #ifdef __GNUC__
 #pragma GCC visibility push(hidden)
 #endif
 
+subvertpy_state_t *subvertpy_state(void);
+int subvertpy_state_init(PyObject *mod);
+int subvertpy_state_traverse(PyObject *mod, visitproc visit, void *arg);
+int subvertpy_state_clear(PyObject *mod);
+void subvertpy_state_free(void *mod);
+int subvertpy_add_types(PyObject *mod, const subvertpy_type_def_t *defs);
+PyTypeObject *subvertpy_module_type(const char *name, int id);
+void py_object_del(void *obj);
+bool subvertpy_global_init(svn_error_t *(*init)(apr_pool_t *pool));
+PyThreadState *subvertpy_thread_attach(PyInterpreterState *interp);
+void subvertpy_thread_detach(PyThreadState *tstate);
+PyThreadState *subvertpy_thread_ensure(PyInterpreterState *interp);
+void subvertpy_thread_release(PyThreadState *tstate);
+extern const subvertpy_type_def_t util_types[];
+
 svn_error_t *py_cancel_check(void *cancel_baton);
 __attribute__((warn_unused_result)) apr_pool_t *Pool(apr_pool_t *parent);
+
+/* Scratch pool owned by a long-lived object; cleared and reused by
+ * successive calls rather than created and destroyed each time. */
+typedef struct {
+    apr_pool_t *pool;
+    subvertpy_flag_t in_use;
+} scratch_pool_t;
+
+void scratch_pool_init(scratch_pool_t *scratch);
+__attribute__((warn_unused_result)) apr_pool_t *scratch_pool_acquire(
+    scratch_pool_t *scratch, apr_pool_t *parent);
+void scratch_pool_release(scratch_pool_t *scratch, apr_pool_t *pool);
+PyObject *py_pool_stats(PyObject *self);
+void pool_stats_reset_peak(void);
+
+/* Progress reporting and transfer counters. Calls into Python are
+ * throttled to at most one per min_interval and min_bytes. */
+typedef struct {
+    PyObject *func;
+    apr_time_t min_interval;
+    apr_off_t min_bytes;
+    subvertpy_counter_t last_time;
+    subvertpy_counter_t last_reported;
+    subvertpy_counter_t last_progress;
+    subvertpy_counter_t bytes;
+    subvertpy_counter_t ticks;
+    subvertpy_counter_t calls;
+    subvertpy_counter_t requests;
+    subvertpy_counter_t elapsed;
+} progress_state_t;
+
+void progress_init(progress_state_t *progress, PyObject *func);
+void progress_set_func(progress_state_t *progress, PyObject *func);
+void py_progress_func(apr_off_t progress, apr_off_t total, void *baton,
+                      apr_pool_t *pool);
+PyObject *progress_get_interval(progress_state_t *progress);
+int progress_set_interval(progress_state_t *progress, PyObject *value);
+PyObject *progress_get_min_bytes(progress_state_t *progress);
+int progress_set_min_bytes(progress_state_t *progress, PyObject *value);
+PyObject *progress_counters(progress_state_t *progress);
 void handle_svn_error(svn_error_t *error);
 bool string_list_to_apr_array(apr_pool_t *pool, PyObject *l, apr_array_header_t **);
 bool relpath_list_to_apr_array(apr_pool_t *pool, PyObject *l, apr_array_header_t **);
 PyObject *prop_hash_to_dict(apr_hash_t *props);
+PyObject *prop_hash_to_propdict(apr_hash_t *props);
+PyObject *py_prop_name(const char *name, apr_ssize_t len);
+PyObject *py_path_string(const char *path, apr_ssize_t len);
+extern PyTypeObject PropDict_Type;
 apr_hash_t *prop_dict_to_hash(apr_pool_t *pool, PyObject *py_props);
 svn_error_t *py_svn_log_wrapper(
     void *baton, apr_hash_t *changed_paths, long revision, const char *author,
@@ -80,6 +326,20 @@ PyTypeObject *PyErr_GetSubversionExceptionTypeObject(void);
     } \
 }
 
+#define RUN_SVN_WITH_SCRATCH_POOL(scratch, pool, cmd) { \
+    svn_error_t *err; \
+    PyThreadState *_save; \
+    _save = PyEval_SaveThread(); \
+    err = (cmd); \
+    PyEval_RestoreThread(_save); \
+    if (err != NULL) { \
+        handle_svn_error(err); \
+        svn_error_clear(err); \
+        scratch_pool_release(scratch, pool); \
+        return NULL; \
+    } \
+}
+
 PyObject *wrap_lock(svn_lock_t *lock);
 apr_array_header_t *revnum_list_to_apr_array(apr_pool_t *pool, PyObject *l);
 svn_stream_t *new_py_stream(apr_pool_t *pool, PyObject *py);
@@ -17,6 +17,7 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
  */
 #include <Python.h>
+#include <pythread.h>
 #include <apr_general.h>
 #include <svn_wc.h>
 #include <svn_path.h>
@@ -29,7 +30,9 @@
 
 #include "util.h"
 #include "editor.h"
+#include "ra.h"
 #include "wc.h"
+#include "stats.h"
 
 #ifndef T_BOOL
 #define T_BOOL T_BYTE
@@ -45,9 +48,23 @@ typedef struct {
 typedef struct {
     PyObject_VAR_HEAD
     apr_pool_t *pool;
+    scratch_pool_t scratch;
     svn_wc_context_t *context;
+    /* Set while a committed queue is processed with this context, possibly
+     * in the background */
+    subvertpy_flag_t busy;
 } ContextObject;
 static PyTypeObject Context_Type;
+
+static bool context_check_busy(ContextObject *context_obj)
+{
+    if (subvertpy_flag_is_set(&context_obj->busy)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Working copy context is processing a committed queue");
+        return true;
+    }
+    return false;
+}
 #endif
 
 #if ONLY_BEFORE_SVN(1, 5)
@@ -118,11 +135,32 @@ typedef struct {
     PyObject_VAR_HEAD
     apr_pool_t *pool;
     svn_wc_committed_queue_t *queue;
+    /* Set while the queue is added to or processed, possibly in the
+     * background */
+    subvertpy_flag_t busy;
 } CommittedQueueObject;
 
+/**
+ * Claim the queue for the caller, who should hand it back with
+ * PyObject_ReleaseCommittedQueue() once done.
+ */
 svn_wc_committed_queue_t *PyObject_GetCommittedQueue(PyObject *obj)
 {
-    return ((CommittedQueueObject *)obj)->queue;
+    CommittedQueueObject *cqobj = (CommittedQueueObject *)obj;
+
+    if (subvertpy_flag_test_and_set(&cqobj->busy)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Committed queue is already in use");
+        return NULL;
+    }
+    return cqobj->queue;
+}
+
+void PyObject_ReleaseCommittedQueue(PyObject *obj)
+{
+    CommittedQueueObject *cqobj = (CommittedQueueObject *)obj;
+
+    subvertpy_flag_clear(&cqobj->busy);
 }
 
 #if ONLY_SINCE_SVN(1, 5)
@@ -269,6 +307,120 @@ const svn_ra_reporter2_t py_ra_reporter2 = {
     py_ra_report_abort,
 };
 
+#if ONLY_SINCE_SVN(1, 5)
+/*
+ * Reporters returned by RemoteAccess.do_update() and friends are driven
+ * directly rather than through their Python methods. The report baton is
+ * the ReporterObject, so that the session can be released once the report
+ * has been finished or aborted, as Reporter.finish() does.
+ */
+
+static svn_error_t *native_report_set_path(void *baton, const char *path,
+                                           svn_revnum_t revision,
+                                           svn_depth_t depth, int start_empty,
+                                           const char *lock_token, apr_pool_t *pool)
+{
+    ReporterObject *reporter = (ReporterObject *)baton;
+
+    return reporter->reporter->set_path(reporter->report_baton, path,
+                                        revision, depth, start_empty,
+                                        lock_token, pool);
+}
+
+static svn_error_t *native_report_delete_path(void *baton, const char *path,
+                                              apr_pool_t *pool)
+{
+    ReporterObject *reporter = (ReporterObject *)baton;
+
+    return reporter->reporter->delete_path(reporter->report_baton, path,
+                                           pool);
+}
+
+static svn_error_t *native_report_link_path(void *baton,
+                                            const char *path, const char *url,
+                                            svn_revnum_t revision,
+                                            svn_depth_t depth, int start_empty,
+                                            const char *lock_token, apr_pool_t *pool)
+{
+    ReporterObject *reporter = (ReporterObject *)baton;
+
+    return reporter->reporter->link_path(reporter->report_baton, path, url,
+                                         revision, depth, start_empty,
+                                         lock_token, pool);
+}
+
+static svn_error_t *native_report_done(ReporterObject *reporter,
+                                       svn_error_t *(*done)(void *, apr_pool_t *),
+                                       apr_pool_t *pool)
+{
+    PyGILState_STATE state;
+    svn_error_t *err;
+
+    /* The editor driven by the report may use the session again. */
+    state = PyGILState_Ensure();
+    subvertpy_flag_clear(&reporter->ra->busy);
+    PyGILState_Release(state);
+
+    err = done(reporter->report_baton, pool);
+    if (err != NULL)
+        return err;
+
+    state = PyGILState_Ensure();
+    apr_pool_destroy(reporter->pool);
+    Py_CLEAR(reporter->ra);
+    PyGILState_Release(state);
+    return NULL;
+}
+
+static svn_error_t *native_report_finish(void *baton, apr_pool_t *pool)
+{
+    ReporterObject *reporter = (ReporterObject *)baton;
+
+    return native_report_done(reporter, reporter->reporter->finish_report,
+                              pool);
+}
+
+static svn_error_t *native_report_abort(void *baton, apr_pool_t *pool)
+{
+    ReporterObject *reporter = (ReporterObject *)baton;
+
+    return native_report_done(reporter, reporter->reporter->abort_report,
+                              pool);
+}
+
+static const svn_ra_reporter3_t native_reporter3 = {
+    native_report_set_path,
+    native_report_delete_path,
+    native_report_link_path,
+    native_report_finish,
+    native_report_abort,
+};
+
+/**
+ * Obtain the reporter and report baton to hand to libsvn for obj.
+ *
+ * Unfinished reporters from the _ra module are driven natively; anything
+ * else goes through py_ra_reporter3. The _ra module is a separate
+ * extension, so its Reporter type is looked up through its "_types"
+ * capsule.
+ */
+void py_object_to_reporter(PyObject *obj,
+                           const svn_ra_reporter3_t **reporter,
+                           void **report_baton)
+{
+    PyTypeObject *type = Py_TYPE(obj);
+
+    if ((type == subvertpy_state()->types[Reporter_Type_ID] ||
+         type == subvertpy_module_type("subvertpy._ra", Reporter_Type_ID)) &&
+        ((ReporterObject *)obj)->ra != NULL) {
+        *reporter = &native_reporter3;
+    } else {
+        *reporter = &py_ra_reporter3;
+    }
+    *report_baton = obj;
+}
+#endif
+
 
 /**
  * Get runtime libsvn_wc version information.
@@ -643,7 +795,7 @@ static PyObject *get_pristine_contents(PyObject *self, PyObject *args)
 		Py_RETURN_NONE;
 	}
 
-	ret = PyObject_New(StreamObject, &Stream_Type);
+	ret = PyObject_New(StreamObject, SUBVERTPY_TYPE(Stream_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -841,6 +993,11 @@ static PyMethodDef wc_methods[] = {
     { "api_version", (PyCFunction)api_version, METH_NOARGS,
         "api_version() -> (major, minor, patch, tag)\n\n"
             "Version of libsvn_wc Subvertpy was compiled against." },
+    { "pool_stats", (PyCFunction)py_pool_stats, METH_NOARGS,
+        "pool_stats() -> dict\n\n"
+        "Counts of APR pools created, currently live, live at the same time\n"
+        "at most and reused as scratch pools by this module." },
+    STATS_METHODS,
     { "match_ignore_list", (PyCFunction)match_ignore_list, METH_VARARGS,
         "match_ignore_list(str, patterns) -> bool" },
     { "get_actual_target", (PyCFunction)get_actual_target, METH_VARARGS,
@@ -851,7 +1008,7 @@ static PyMethodDef wc_methods[] = {
 static void committed_queue_dealloc(PyObject *self)
 {
 	apr_pool_destroy(((CommittedQueueObject *)self)->pool);
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyObject *committed_queue_repr(PyObject *self)
@@ -869,7 +1026,7 @@ static PyObject *committed_queue_init(PyTypeObject *self, PyObject *args, PyObje
 	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwnames))
 		return NULL;
 
-	ret = PyObject_New(CommittedQueueObject, &CommittedQueue_Type);
+	ret = PyObject_New(CommittedQueueObject, SUBVERTPY_TYPE(CommittedQueue_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -877,8 +1034,9 @@ static PyObject *committed_queue_init(PyTypeObject *self, PyObject *args, PyObje
 	if (ret->pool == NULL)
 		return NULL;
 	ret->queue = svn_wc_committed_queue_create(ret->pool);
+	subvertpy_flag_clear(&ret->busy);
 	if (ret->queue == NULL) {
-		PyObject_Del(ret);
+		py_object_del(ret);
 		PyErr_NoMemory();
 		return NULL;
 	}
@@ -886,114 +1044,284 @@ static PyObject *committed_queue_init(PyTypeObject *self, PyObject *args, PyObje
 	return (PyObject *)ret;
 }
 
-static PyObject *committed_queue_queue(CommittedQueueObject *self, PyObject *args, PyObject *kwargs)
-{
+struct queued_commit {
 	const char *path;
+	svn_wc_adm_access_t *adm;
+#if ONLY_SINCE_SVN(1, 7)
+	svn_wc_context_t *context;
+#endif
+	svn_boolean_t recurse;
+	apr_array_header_t *wcprop_changes;
+	svn_boolean_t remove_lock;
+	svn_boolean_t remove_changelist;
+	const unsigned char *md5_digest;
+	const unsigned char *sha1_digest;
+};
+
+static char *committed_queue_kwnames[] = { "path", "adm", "recurse",
+	"wcprop_changes", "remove_lock", "remove_changelist", "md5_digest",
+	"sha1_digest", NULL };
+
+/**
+ * Convert the arguments to CommittedQueue.queue() into item.
+ *
+ * Everything that has to outlive the call is allocated in pool, which
+ * should live as long as the queue.
+ */
+static bool committed_queue_convert(apr_pool_t *pool,
+									PyObject *args, PyObject *kwargs,
+									struct queued_commit *item)
+{
 	PyObject *admobj;
 	PyObject *py_wcprop_changes = Py_None, *py_path;
-    svn_wc_adm_access_t *adm = NULL;
 	bool remove_lock = false, remove_changelist = false;
 	char *md5_digest = NULL, *sha1_digest = NULL;
 	bool recurse = false;
-	apr_array_header_t *wcprop_changes;
 	int md5_digest_len, sha1_digest_len;
-#if ONLY_SINCE_SVN(1, 7)
-	svn_wc_context_t *context = NULL;
-#endif
-	char *kwnames[] = { "path", "adm", "recurse", "wcprop_changes", "remove_lock", "remove_changelist", "md5_digest", "sha1_digest", NULL };
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|bObbz#z#", kwnames,
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|bObbz#z#",
+									 committed_queue_kwnames,
 									 &py_path, &admobj,
 						  &recurse, &py_wcprop_changes, &remove_lock,
 						  &remove_changelist, &md5_digest, &md5_digest_len,
 						  &sha1_digest, &sha1_digest_len))
-		return NULL;
+		return false;
 
-	if (!py_dict_to_wcprop_changes(py_wcprop_changes, self->pool, &wcprop_changes)) {
-		return NULL;
+	if (!py_dict_to_wcprop_changes(py_wcprop_changes, pool,
+								   &item->wcprop_changes)) {
+		return false;
 	}
 
-	path = py_object_to_svn_abspath(py_path, self->pool);
-	if (path == NULL) {
-		return NULL;
+	item->path = py_object_to_svn_abspath(py_path, pool);
+	if (item->path == NULL) {
+		return false;
 	}
 
 	if (md5_digest != NULL) {
 		if (md5_digest_len != APR_MD5_DIGESTSIZE) {
 			PyErr_SetString(PyExc_ValueError, "Invalid size for md5 digest");
-			return NULL;
+			return false;
 		}
+		item->md5_digest = apr_pmemdup(pool, md5_digest,
+									   APR_MD5_DIGESTSIZE);
+	} else {
+		item->md5_digest = NULL;
 	}
 
 	if (sha1_digest != NULL) {
 		if (sha1_digest_len != APR_SHA1_DIGESTSIZE) {
 			PyErr_SetString(PyExc_ValueError, "Invalid size for sha1 digest");
-			return NULL;
+			return false;
 		}
+		item->sha1_digest = apr_pmemdup(pool, sha1_digest,
+										APR_SHA1_DIGESTSIZE);
+	} else {
+		item->sha1_digest = NULL;
 	}
 
-	if (PyObject_IsInstance(admobj, (PyObject *)&Adm_Type)) {
-		adm = PyObject_GetAdmAccess(admobj);
+	item->adm = NULL;
+#if ONLY_SINCE_SVN(1, 7)
+	item->context = NULL;
+#endif
+	if (PyObject_IsInstance(admobj, (PyObject *)SUBVERTPY_TYPE(Adm_Type))) {
+		item->adm = PyObject_GetAdmAccess(admobj);
 #if ONLY_SINCE_SVN(1, 7)
-	} else if (PyObject_IsInstance(admobj, (PyObject *)&Context_Type)) {
-		context = ((ContextObject*)admobj)->context;
+	} else if (PyObject_IsInstance(admobj, (PyObject *)SUBVERTPY_TYPE(Context_Type))) {
+		if (context_check_busy((ContextObject *)admobj))
+			return false;
+		item->context = ((ContextObject*)admobj)->context;
 #endif
 	} else {
 		PyErr_SetString(PyExc_TypeError, "Second arguments needs to be Adm or Context");
-		return NULL;
+		return false;
 	}
 
-#if ONLY_SINCE_SVN(1, 7)
-	if (adm != NULL) {
-#endif
+	item->recurse = recurse?TRUE:FALSE;
+	item->remove_lock = remove_lock?TRUE:FALSE;
+	item->remove_changelist = remove_changelist?TRUE:FALSE;
+
+	return true;
+}
+
+/**
+ * Add a converted item to the queue. Does not need the GIL.
+ */
+static svn_error_t *committed_queue_push(CommittedQueueObject *self,
+										 const struct queued_commit *item)
+{
 #if ONLY_SINCE_SVN(1, 6)
-	{
 	svn_checksum_t *svn_checksum_p;
+#endif
 
-	if (md5_digest != NULL) {
-		svn_checksum_p  = apr_palloc(self->pool, sizeof(svn_checksum_t));
-        svn_checksum_p->digest = apr_pmemdup(
-            self->pool, (unsigned char *)md5_digest, APR_MD5_DIGESTSIZE);
+#if ONLY_SINCE_SVN(1, 7)
+	if (item->context != NULL) {
+		if (item->sha1_digest != NULL) {
+			svn_checksum_p = apr_palloc(self->pool, sizeof(svn_checksum_t));
+			svn_checksum_p->digest = item->sha1_digest;
+			svn_checksum_p->kind = svn_checksum_sha1;
+		} else {
+			svn_checksum_p = NULL;
+		}
+		return svn_wc_queue_committed3(self->queue, item->context, item->path,
+									   item->recurse, item->wcprop_changes,
+									   item->remove_lock,
+									   item->remove_changelist,
+									   svn_checksum_p, self->pool);
+	}
+#endif
+#if ONLY_SINCE_SVN(1, 6)
+	if (item->md5_digest != NULL) {
+		svn_checksum_p = apr_palloc(self->pool, sizeof(svn_checksum_t));
+		svn_checksum_p->digest = item->md5_digest;
 		svn_checksum_p->kind = svn_checksum_md5;
 	} else {
 		svn_checksum_p = NULL;
 	}
-	RUN_SVN(
-		svn_wc_queue_committed2(self->queue, path, adm, recurse?TRUE:FALSE,
-							   wcprop_changes, remove_lock?TRUE:FALSE, remove_changelist?TRUE:FALSE,
-							   svn_checksum_p, self->pool));
-	}
+	return svn_wc_queue_committed2(self->queue, item->path, item->adm,
+								   item->recurse, item->wcprop_changes,
+								   item->remove_lock, item->remove_changelist,
+								   svn_checksum_p, self->pool);
 #else
-	RUN_SVN(
-		svn_wc_queue_committed(&self->queue, path, adm, recurse?TRUE:FALSE,
-							   wcprop_changes, remove_lock?TRUE:FALSE, remove_changelist?TRUE:FALSE,
-							   (unsigned char *)md5_digest, self->pool));
+	return svn_wc_queue_committed(&self->queue, item->path, item->adm,
+								  item->recurse, item->wcprop_changes,
+								  item->remove_lock, item->remove_changelist,
+								  item->md5_digest, self->pool);
 #endif
-#if ONLY_SINCE_SVN(1, 7)
-	} else {
-		svn_checksum_t *svn_checksum_p;
+}
 
-		if (sha1_digest != NULL) {
-			svn_checksum_p  = apr_palloc(self->pool, sizeof(svn_checksum_t));
-			svn_checksum_p->digest = apr_pmemdup(
-				self->pool, (unsigned char *)sha1_digest, APR_SHA1_DIGESTSIZE);
-			svn_checksum_p->kind = svn_checksum_sha1;
+static PyObject *committed_queue_queue(CommittedQueueObject *self, PyObject *args, PyObject *kwargs)
+{
+	struct queued_commit item;
+	svn_error_t *err;
+
+	if (PyObject_GetCommittedQueue((PyObject *)self) == NULL)
+		return NULL;
+
+	if (!committed_queue_convert(self->pool, args, kwargs, &item)) {
+		PyObject_ReleaseCommittedQueue((PyObject *)self);
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	err = committed_queue_push(self, &item);
+	Py_END_ALLOW_THREADS
+
+	PyObject_ReleaseCommittedQueue((PyObject *)self);
+
+	if (err != NULL) {
+		handle_svn_error(err);
+		svn_error_clear(err);
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *committed_queue_queue_many(CommittedQueueObject *self, PyObject *args)
+{
+	PyObject *py_items, *seq, *empty;
+	struct queued_commit *items;
+	apr_pool_t *items_pool;
+	Py_ssize_t i, n;
+	svn_error_t *err = NULL;
+
+	if (!PyArg_ParseTuple(args, "O:queue_many", &py_items))
+		return NULL;
+
+	seq = PySequence_Fast(py_items, "items should be a sequence");
+	if (seq == NULL)
+		return NULL;
+
+	empty = PyTuple_New(0);
+	if (empty == NULL) {
+		Py_DECREF(seq);
+		return NULL;
+	}
+
+	/* Items are converted into a subpool of the queue, so it is claimed
+	 * before conversion starts. */
+	if (PyObject_GetCommittedQueue((PyObject *)self) == NULL) {
+		Py_DECREF(empty);
+		Py_DECREF(seq);
+		return NULL;
+	}
+
+	/* Convert everything first, so that a bad item leaves the queue
+	 * untouched and the GIL only has to be released once. */
+	n = PySequence_Fast_GET_SIZE(seq);
+	items = PyMem_Malloc(sizeof(struct queued_commit) * (n > 0 ? n : 1));
+	if (items == NULL) {
+		PyObject_ReleaseCommittedQueue((PyObject *)self);
+		Py_DECREF(empty);
+		Py_DECREF(seq);
+		return PyErr_NoMemory();
+	}
+
+	/* Once queued, the items live as long as the queue; until then they
+	 * are kept apart so a failed conversion can throw them away. */
+	items_pool = Pool(self->pool);
+	if (items_pool == NULL) {
+		PyObject_ReleaseCommittedQueue((PyObject *)self);
+		PyMem_Free(items);
+		Py_DECREF(empty);
+		Py_DECREF(seq);
+		return NULL;
+	}
+
+	for (i = 0; i < n; i++) {
+		PyObject *py_item = PySequence_Fast_GET_ITEM(seq, i);
+		bool ok;
+
+		if (PyDict_Check(py_item)) {
+			ok = committed_queue_convert(items_pool, empty, py_item,
+										 &items[i]);
+		} else if (PyTuple_Check(py_item)) {
+			ok = committed_queue_convert(items_pool, py_item, NULL,
+										 &items[i]);
 		} else {
-			svn_checksum_p = NULL;
+			PyErr_Format(PyExc_TypeError,
+						 "Expected tuple or dict for item %zd", i);
+			ok = false;
+		}
+		if (!ok) {
+			apr_pool_destroy(items_pool);
+			PyObject_ReleaseCommittedQueue((PyObject *)self);
+			PyMem_Free(items);
+			Py_DECREF(empty);
+			Py_DECREF(seq);
+			return NULL;
 		}
-		RUN_SVN(
-			svn_wc_queue_committed3(self->queue, context, path, recurse?TRUE:FALSE,
-								   wcprop_changes, remove_lock?TRUE:FALSE, remove_changelist?TRUE:FALSE,
-								   svn_checksum_p, self->pool));
 	}
-#endif
+
+	Py_DECREF(empty);
+
+	Py_BEGIN_ALLOW_THREADS
+	for (i = 0; i < n && err == NULL; i++) {
+		err = committed_queue_push(self, &items[i]);
+	}
+	Py_END_ALLOW_THREADS
+
+	PyObject_ReleaseCommittedQueue((PyObject *)self);
+	PyMem_Free(items);
+	Py_DECREF(seq);
+
+	if (err != NULL) {
+		handle_svn_error(err);
+		svn_error_clear(err);
+		return NULL;
+	}
 
 	Py_RETURN_NONE;
 }
 
 static PyMethodDef committed_queue_methods[] = {
 	{ "queue", (PyCFunction)committed_queue_queue, METH_VARARGS|METH_KEYWORDS,
-		"S.queue(path, adm, recurse=False, wcprop_changes=[], remove_lock=False, remove_changelist=False, digest=None)" },
+		"S.queue(path, adm, recurse=False, wcprop_changes=[], remove_lock=False, remove_changelist=False, md5_digest=None, sha1_digest=None)" },
+	{ "queue_many", (PyCFunction)committed_queue_queue_many, METH_VARARGS,
+		"S.queue_many(items)\n\n"
+		"Queue several paths at once. Each item is a tuple or dictionary "
+		"with the arguments to queue(). All items are converted before "
+		"any of them are queued." },
 	{ NULL }
 };
 
@@ -1070,7 +1398,7 @@ PyTypeObject CommittedQueue_Type = {
 svn_lock_t *py_object_to_svn_lock(PyObject *py_lock, apr_pool_t *pool)
 {
 	LockObject* lockobj = (LockObject *)py_lock;
-    if (!PyObject_IsInstance(py_lock, (PyObject *)&Lock_Type)) {
+    if (!PyObject_IsInstance(py_lock, (PyObject *)SUBVERTPY_TYPE(Lock_Type))) {
         PyErr_SetString(PyExc_TypeError, "Expected Lock object");
         return NULL;
     }
@@ -1082,6 +1410,7 @@ static PyTypeObject Context_Type;
 
 static PyObject *py_wc_context_locked(PyObject *self, PyObject *args)
 {
+    ContextObject *context_obj = (ContextObject *)self;
     PyObject* py_path;
     const char *path;
     apr_pool_t *pool;
@@ -1091,23 +1420,29 @@ static PyObject *py_wc_context_locked(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O", &py_path))
         return NULL;
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(pool, svn_wc_locked2(&locked_here, &locked, wc_context, path, pool));
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, pool,
+                              svn_wc_locked2(&locked_here, &locked, wc_context,
+                                             path, pool));
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
     return Py_BuildValue("(bb)", locked_here?true:false, locked?true:false);
 }
 
 static PyObject *py_wc_context_check_wc(PyObject *self, PyObject *args)
 {
+    ContextObject *context_obj = (ContextObject *)self;
     PyObject* py_path;
     const char *path;
     apr_pool_t *pool;
@@ -1117,17 +1452,21 @@ static PyObject *py_wc_context_check_wc(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O", &py_path))
         return NULL;
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(pool, svn_wc_check_wc2(&wc_format, wc_context, path, pool));
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, pool,
+                              svn_wc_check_wc2(&wc_format, wc_context, path, pool));
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
 #if PY_MAJOR_VERSION >= 3
     return PyLong_FromLong(wc_format);
@@ -1138,6 +1477,7 @@ static PyObject *py_wc_context_check_wc(PyObject *self, PyObject *args)
 
 static PyObject *py_wc_context_text_modified_p2(PyObject *self, PyObject *args)
 {
+    ContextObject *context_obj = (ContextObject *)self;
     PyObject* py_path;
     const char *path;
     apr_pool_t *pool;
@@ -1147,24 +1487,29 @@ static PyObject *py_wc_context_text_modified_p2(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O", &py_path))
         return NULL;
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(pool, svn_wc_text_modified_p2(&modified, wc_context,
-                                                    path, FALSE, pool));
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, pool,
+                              svn_wc_text_modified_p2(&modified, wc_context,
+                                                      path, FALSE, pool));
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
     return PyBool_FromLong(modified);
 }
 
 static PyObject *py_wc_context_props_modified_p2(PyObject *self, PyObject *args)
 {
+    ContextObject *context_obj = (ContextObject *)self;
     PyObject* py_path;
     const char *path;
     apr_pool_t *pool;
@@ -1174,24 +1519,29 @@ static PyObject *py_wc_context_props_modified_p2(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O", &py_path))
         return NULL;
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(pool, svn_wc_props_modified_p2(&modified, wc_context,
-                                                    path, pool));
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, pool,
+                              svn_wc_props_modified_p2(&modified, wc_context,
+                                                       path, pool));
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
     return PyBool_FromLong(modified);
 }
 
 static PyObject *py_wc_context_conflicted(PyObject *self, PyObject *args)
 {
+    ContextObject *context_obj = (ContextObject *)self;
     PyObject* py_path;
     const char *path;
     apr_pool_t *pool;
@@ -1201,19 +1551,22 @@ static PyObject *py_wc_context_conflicted(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O", &py_path))
         return NULL;
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(pool, svn_wc_conflicted_p3(
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, pool, svn_wc_conflicted_p3(
          &text_conflicted, &props_conflicted, &tree_conflicted, wc_context,
          path, pool));
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
     return Py_BuildValue("(bbb)", text_conflicted, props_conflicted, tree_conflicted);
 }
@@ -1222,6 +1575,8 @@ static PyObject *py_wc_context_crawl_revisions(PyObject *self, PyObject *args, P
 {
     PyObject* py_path, *py_reporter;
     const char *path;
+    const svn_ra_reporter3_t *reporter;
+    void *report_baton;
     apr_pool_t *pool;
     svn_wc_context_t *wc_context = ((ContextObject *)self)->context;
     char *kwnames[] = { "path", "reporter", "restore_files", "depth",
@@ -1242,6 +1597,9 @@ static PyObject *py_wc_context_crawl_revisions(PyObject *self, PyObject *args, P
         return NULL;
     }
 
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
     pool = Pool(NULL);
 
     path = py_object_to_svn_abspath(py_path, pool);
@@ -1250,8 +1608,10 @@ static PyObject *py_wc_context_crawl_revisions(PyObject *self, PyObject *args, P
         return NULL;
     }
 
+    py_object_to_reporter(py_reporter, &reporter, &report_baton);
+
     RUN_SVN_WITH_POOL(pool, svn_wc_crawl_revisions5(
-         wc_context, path, &py_ra_reporter3, py_reporter, restore_files,
+         wc_context, path, reporter, report_baton, restore_files,
          depth, honor_depth_exclude, depth_compatibility_trick,
          use_commit_times, py_cancel_check, NULL, py_wc_notify_func, notify, pool));
 
@@ -1312,6 +1672,9 @@ static PyObject *py_wc_context_get_update_editor(PyObject *self, PyObject *args,
         return NULL;
     }
 
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
     if (conflict_func != Py_None) {
         // TODO
         PyErr_SetString(PyExc_NotImplementedError,
@@ -1368,7 +1731,7 @@ static PyObject *py_wc_context_get_update_editor(PyObject *self, PyObject *args,
 
     /* TODO: Also return target_revision ? */
     Py_INCREF(self);
-    return new_editor_object(NULL, editor, edit_baton, result_pool, &Editor_Type,
+    return new_editor_object(NULL, editor, edit_baton, result_pool, SUBVERTPY_TYPE(Editor_Type),
                              context_done_handler, self, NULL);
 }
 
@@ -1393,6 +1756,9 @@ static PyObject *py_wc_context_ensure_adm(PyObject *self, PyObject *args,
         return NULL;
     }
 
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
     pool = Pool(NULL);
 
     RUN_SVN_WITH_POOL(pool, svn_wc_ensure_adm4(context_obj->context,
@@ -1416,7 +1782,7 @@ static void status_dealloc(PyObject *self)
     apr_pool_t *pool = ((Status3Object *)self)->pool;
     if (pool != NULL)
         apr_pool_destroy(pool);
-    PyObject_Del(self);
+    py_object_del(self);
 }
 
 static PyMemberDef status_members[] = {
@@ -1516,6 +1882,9 @@ static PyObject *py_wc_status(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
     result_pool = Pool(NULL);
     if (result_pool == NULL) {
         return NULL;
@@ -1538,7 +1907,7 @@ static PyObject *py_wc_status(PyObject *self, PyObject *args, PyObject *kwargs)
 
     apr_pool_destroy(scratch_pool);
 
-    ret = PyObject_New(Status3Object, &Status3_Type);
+    ret = PyObject_New(Status3Object, SUBVERTPY_TYPE(Status3_Type));
     if (ret == NULL) {
         apr_pool_destroy(result_pool);
         return NULL;
@@ -1553,7 +1922,7 @@ static svn_error_t *py_status_receiver(void *baton, const char *local_abspath,
                                        apr_pool_t *scratch_pool)
 {
     Status3Object *py_status;
-    PyObject *ret;
+    PyObject *ret, *py_path;
     PyGILState_STATE state;
 
     if (baton == Py_None)
@@ -1561,7 +1930,7 @@ static svn_error_t *py_status_receiver(void *baton, const char *local_abspath,
 
     state = PyGILState_Ensure();
 
-    py_status = PyObject_New(Status3Object, &Status3_Type);
+    py_status = PyObject_New(Status3Object, SUBVERTPY_TYPE(Status3_Type));
     if (py_status == NULL) {
         PyGILState_Release(state);
         return py_svn_error();
@@ -1569,7 +1938,15 @@ static svn_error_t *py_status_receiver(void *baton, const char *local_abspath,
     py_status->pool = Pool(NULL);
     py_status->status = *svn_wc_dup_status3(status, py_status->pool);
 
-    ret = PyObject_CallFunction((PyObject *)baton, "sO", local_abspath, py_status);
+    py_path = py_path_string(local_abspath, -1);
+    if (py_path == NULL) {
+        Py_DECREF(py_status);
+        PyGILState_Release(state);
+        return py_svn_error();
+    }
+
+    ret = PyObject_CallFunction((PyObject *)baton, "OO", py_path, py_status);
+    Py_DECREF(py_path);
     Py_DECREF(py_status);
 
     if (ret == NULL) {
@@ -1605,11 +1982,14 @@ static PyObject *py_wc_walk_status(PyObject *self, PyObject *args, PyObject *kwa
         return NULL;
     }
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
@@ -1617,19 +1997,19 @@ static PyObject *py_wc_walk_status(PyObject *self, PyObject *args, PyObject *kwa
         ignore_patterns = NULL;
     } else {
         if (!string_list_to_apr_array(pool, py_ignore_patterns, &ignore_patterns)) {
-            apr_pool_destroy(pool);
+            scratch_pool_release(&context_obj->scratch, pool);
             return NULL;
         }
     }
 
-    RUN_SVN_WITH_POOL(pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, pool,
                       svn_wc_walk_status(context_obj->context, path, depth,
                                          get_all, no_ignore, ignore_text_mode,
                                          ignore_patterns, py_status_receiver,
                                          status_func, py_cancel_check, NULL,
                                          pool));
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
     Py_RETURN_NONE;
 }
@@ -1643,32 +2023,35 @@ static PyObject *py_wc_add_lock(PyObject *self, PyObject *args, PyObject *kwargs
     const char *path;
     apr_pool_t *scratch_pool;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO!", kwnames, &py_path, &Lock_Type,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO!", kwnames, &py_path, SUBVERTPY_TYPE(Lock_Type),
                                      &py_lock)) {
         return NULL;
     }
 
-    scratch_pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    scratch_pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
     if (scratch_pool == NULL) {
         return NULL;
     }
 
     path = py_object_to_svn_abspath(py_path, scratch_pool);
     if (path == NULL) {
-        apr_pool_destroy(scratch_pool);
+        scratch_pool_release(&context_obj->scratch, scratch_pool);
         return NULL;
     }
 
     lock = py_object_to_svn_lock(py_lock, scratch_pool);
     if (lock == NULL) {
-        apr_pool_destroy(scratch_pool);
+        scratch_pool_release(&context_obj->scratch, scratch_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(scratch_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, scratch_pool,
                       svn_wc_add_lock2(context_obj->context, path, lock, scratch_pool));
 
-    apr_pool_destroy(scratch_pool);
+    scratch_pool_release(&context_obj->scratch, scratch_pool);
 
     Py_RETURN_NONE;
 }
@@ -1685,19 +2068,22 @@ static PyObject *py_wc_remove_lock(PyObject *self, PyObject *args, PyObject *kwa
         return NULL;
     }
 
-    scratch_pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    scratch_pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, scratch_pool);
     if (path == NULL) {
-        apr_pool_destroy(scratch_pool);
+        scratch_pool_release(&context_obj->scratch, scratch_pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(scratch_pool,
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, scratch_pool,
                       svn_wc_remove_lock2(context_obj->context, path,
                                           scratch_pool));
 
-    apr_pool_destroy(scratch_pool);
+    scratch_pool_release(&context_obj->scratch, scratch_pool);
     Py_RETURN_NONE;
 }
 
@@ -1718,14 +2104,17 @@ static PyObject *py_wc_add_from_disk(PyObject *self, PyObject *args, PyObject *k
         return NULL;
     }
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
     if (pool == NULL) {
         return NULL;
     }
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
@@ -1734,14 +2123,14 @@ static PyObject *py_wc_add_from_disk(PyObject *self, PyObject *args, PyObject *k
     } else {
         props = prop_dict_to_hash(pool, py_props);
         if (props == NULL) {
-            apr_pool_destroy(pool);
+            scratch_pool_release(&context_obj->scratch, pool);
             return NULL;
         }
     }
 
 #if ONLY_SINCE_SVN(1, 9)
-    RUN_SVN_WITH_POOL(
-            pool, svn_wc_add_from_disk3(
+    RUN_SVN_WITH_SCRATCH_POOL(
+            &context_obj->scratch, pool, svn_wc_add_from_disk3(
                     context_obj->context, path, props, skip_checks,
                     notify_func == Py_None?NULL:py_wc_notify_func,
                     notify_func, pool));
@@ -1749,24 +2138,24 @@ static PyObject *py_wc_add_from_disk(PyObject *self, PyObject *args, PyObject *k
     if (props != NULL) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "props argument only supported on svn >= 1.9");
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
     if (skip_checks) {
         PyErr_SetString(PyExc_NotImplementedError,
                         "skip_checks argument only supported on svn >= 1.9");
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
-    RUN_SVN_WITH_POOL(
-            pool, svn_wc_add_from_disk(
+    RUN_SVN_WITH_SCRATCH_POOL(
+            &context_obj->scratch, pool, svn_wc_add_from_disk(
                     context_obj->context, path,
                     notify_func == Py_None?NULL:py_wc_notify_func,
                     notify_func, pool));
 #endif
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
     Py_RETURN_NONE;
 }
@@ -1785,68 +2174,273 @@ static PyObject *py_wc_get_prop_diffs(PyObject *self, PyObject *args, PyObject *
         return NULL;
     }
 
-    pool = Pool(NULL);
+    if (context_check_busy((ContextObject *)self))
+        return NULL;
+
+    pool = scratch_pool_acquire(&context_obj->scratch, context_obj->pool);
 
     path = py_object_to_svn_abspath(py_path, pool);
     if (path == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
-    RUN_SVN_WITH_POOL(pool, svn_wc_get_prop_diffs2(&propchanges,
-                                                   &original_props,
-                                                   context_obj->context,
-                                                   path, pool, pool));
+    RUN_SVN_WITH_SCRATCH_POOL(&context_obj->scratch, pool,
+                              svn_wc_get_prop_diffs2(&propchanges,
+                                                     &original_props,
+                                                     context_obj->context,
+                                                     path, pool, pool));
 
     py_orig_props = prop_hash_to_dict(original_props);
     if (py_orig_props == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         return NULL;
     }
 
     py_propchanges = propchanges_to_list(propchanges);
     if (py_propchanges == NULL) {
-        apr_pool_destroy(pool);
+        scratch_pool_release(&context_obj->scratch, pool);
         Py_DECREF(py_propchanges);
         return NULL;
     }
 
-    apr_pool_destroy(pool);
+    scratch_pool_release(&context_obj->scratch, pool);
 
     return Py_BuildValue("NN", py_orig_props, py_propchanges);
 }
 
-static PyObject *py_wc_context_process_committed_queue(PyObject *self, PyObject *args)
+typedef struct {
+    ContextObject *context;
+    CommittedQueueObject *queue;
+    svn_revnum_t revnum;
+    const char *date, *author;
+    apr_pool_t *pool;
+    PyObject *future;
+    PyObject *notify;
+    apr_interval_time_t notify_interval;
+    apr_time_t last_notify;
+    long steps;
+    PyObject *exc_type, *exc_val, *exc_tb;
+    PyInterpreterState *interp;
+} ProcessQueueBaton;
+
+/**
+ * Cancellation callback for svn_wc_process_committed_queue2(), which is
+ * invoked as the queue is processed. Calls the notify function with the
+ * number of steps taken so far, at most once every notify_interval.
+ */
+static svn_error_t *process_queue_progress(void *baton)
+{
+    ProcessQueueBaton *b = baton;
+    PyGILState_STATE state;
+    PyObject *ret;
+    apr_time_t now;
+
+    b->steps++;
+    if (b->notify == Py_None)
+        return NULL;
+
+    now = apr_time_now();
+    if (now - b->last_notify < b->notify_interval)
+        return NULL;
+    b->last_notify = now;
+
+    state = PyGILState_Ensure();
+    ret = PyObject_CallFunction(b->notify, "l", b->steps);
+    if (ret == NULL) {
+        /* The thread state may not outlive this call, so hold on to the
+         * exception until processing has finished. */
+        PyErr_Fetch(&b->exc_type, &b->exc_val, &b->exc_tb);
+        PyGILState_Release(state);
+        return svn_error_create(SVN_ERR_CANCELLED, NULL,
+                                "Python exception raised");
+    }
+    Py_DECREF(ret);
+    PyGILState_Release(state);
+    return NULL;
+}
+
+static svn_error_t *process_queue_run(ProcessQueueBaton *b)
+{
+    return svn_wc_process_committed_queue2(b->queue->queue,
+                                           b->context->context,
+                                           b->revnum, b->date, b->author,
+                                           process_queue_progress, b,
+                                           b->pool);
+}
+
+/**
+ * Set the exception for the failed run, if any. Must be called with the
+ * GIL held; takes ownership of err.
+ */
+static bool process_queue_set_error(ProcessQueueBaton *b, svn_error_t *err)
+{
+    if (b->exc_type != NULL) {
+        PyErr_Restore(b->exc_type, b->exc_val, b->exc_tb);
+        b->exc_type = b->exc_val = b->exc_tb = NULL;
+    } else if (err != NULL) {
+        handle_svn_error(err);
+    }
+    svn_error_clear(err);
+    return PyErr_Occurred() != NULL;
+}
+
+static void process_queue_worker(void *baton)
+{
+    ProcessQueueBaton *b = baton;
+    apr_pool_t *pool = b->pool;
+    PyThreadState *tstate;
+    svn_error_t *err;
+    PyObject *ret, *exc_type, *exc_val, *exc_tb;
+
+    tstate = subvertpy_thread_attach(b->interp);
+    Py_BEGIN_ALLOW_THREADS
+    err = process_queue_run(b);
+    Py_END_ALLOW_THREADS
+
+    PyObject_ReleaseCommittedQueue((PyObject *)b->queue);
+    /* Release the context before the future completes, so that its
+     * callbacks can use it. */
+    subvertpy_flag_clear(&b->context->busy);
+    if (process_queue_set_error(b, err)) {
+        PyErr_Fetch(&exc_type, &exc_val, &exc_tb);
+        PyErr_NormalizeException(&exc_type, &exc_val, &exc_tb);
+        ret = PyObject_CallMethod(b->future, "set_exception", "O", exc_val);
+        Py_XDECREF(exc_type);
+        Py_XDECREF(exc_val);
+        Py_XDECREF(exc_tb);
+    } else {
+        ret = PyObject_CallMethod(b->future, "set_result", "O", Py_None);
+    }
+    if (ret == NULL)
+        PyErr_WriteUnraisable(b->future);
+    else
+        Py_DECREF(ret);
+
+    Py_DECREF(b->future);
+    Py_DECREF(b->notify);
+    Py_DECREF(b->queue);
+    Py_DECREF(b->context);
+    apr_pool_destroy(pool);
+    subvertpy_thread_detach(tstate);
+}
+
+static PyObject *py_wc_context_process_committed_queue(PyObject *self, PyObject *args, PyObject *kwargs)
 {
     apr_pool_t *temp_pool;
     ContextObject *contextobj = (ContextObject *)self;
     svn_revnum_t revnum;
     char *date, *author;
-    PyObject *py_queue;
+    PyObject *py_queue, *notify = Py_None, *futures, *ret;
+    bool background = false;
+    double notify_interval = 0.5;
+    ProcessQueueBaton *b;
+    svn_error_t *err;
+    char *kwnames[] = { "queue", "revnum", "date", "author", "background",
+                        "notify", "notify_interval", NULL };
 
-    if (!PyArg_ParseTuple(args, "O!lss", &CommittedQueue_Type, &py_queue,
-                          &revnum, &date, &author))
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!lss|bOd", kwnames,
+                                     SUBVERTPY_TYPE(CommittedQueue_Type), &py_queue,
+                                     &revnum, &date, &author, &background,
+                                     &notify, &notify_interval))
         return NULL;
 
-    temp_pool = Pool(NULL);
-    if (temp_pool == NULL)
+    if (notify != Py_None && !PyCallable_Check(notify)) {
+        PyErr_SetString(PyExc_TypeError, "notify should be callable");
         return NULL;
+    }
 
-    svn_wc_committed_queue_t *committed_queue = PyObject_GetCommittedQueue(py_queue);
+    if (subvertpy_flag_test_and_set(&contextobj->busy)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Working copy context is processing a committed queue");
+        return NULL;
+    }
 
-    RUN_SVN_WITH_POOL(temp_pool,
-                      svn_wc_process_committed_queue2(committed_queue,
-                                                      contextobj->context,
-                                                      revnum, date, author,
-                                                      py_cancel_check, NULL,
-                                                      temp_pool));
+    if (PyObject_GetCommittedQueue(py_queue) == NULL) {
+        subvertpy_flag_clear(&contextobj->busy);
+        return NULL;
+    }
 
-    apr_pool_destroy(temp_pool);
+    temp_pool = Pool(NULL);
+    if (temp_pool == NULL) {
+        PyObject_ReleaseCommittedQueue(py_queue);
+        subvertpy_flag_clear(&contextobj->busy);
+        return NULL;
+    }
 
-    Py_RETURN_NONE;
-}
+    b = apr_pcalloc(temp_pool, sizeof(ProcessQueueBaton));
+    b->context = contextobj;
+    b->queue = (CommittedQueueObject *)py_queue;
+    b->revnum = revnum;
+    b->date = apr_pstrdup(temp_pool, date);
+    b->author = apr_pstrdup(temp_pool, author);
+    b->pool = temp_pool;
+    b->notify = notify;
+    b->notify_interval = apr_time_from_sec(1) * notify_interval;
+    b->interp = subvertpy_current_interp();
+    b->last_notify = apr_time_now();
+
+    if (!background) {
+        Py_BEGIN_ALLOW_THREADS
+        err = process_queue_run(b);
+        Py_END_ALLOW_THREADS
+        PyObject_ReleaseCommittedQueue(py_queue);
+        subvertpy_flag_clear(&contextobj->busy);
+
+        if (process_queue_set_error(b, err)) {
+            apr_pool_destroy(temp_pool);
+            return NULL;
+        }
+        apr_pool_destroy(temp_pool);
+        Py_RETURN_NONE;
+    }
 
+    futures = PyImport_ImportModule("concurrent.futures");
+    if (futures == NULL) {
+        PyObject_ReleaseCommittedQueue(py_queue);
+        subvertpy_flag_clear(&contextobj->busy);
+        apr_pool_destroy(temp_pool);
+        return NULL;
+    }
+    b->future = PyObject_CallMethod(futures, "Future", NULL);
+    Py_DECREF(futures);
+    if (b->future == NULL) {
+        PyObject_ReleaseCommittedQueue(py_queue);
+        subvertpy_flag_clear(&contextobj->busy);
+        apr_pool_destroy(temp_pool);
+        return NULL;
+    }
+    ret = PyObject_CallMethod(b->future, "set_running_or_notify_cancel",
+                              NULL);
+    if (ret == NULL) {
+        Py_DECREF(b->future);
+        PyObject_ReleaseCommittedQueue(py_queue);
+        subvertpy_flag_clear(&contextobj->busy);
+        apr_pool_destroy(temp_pool);
+        return NULL;
+    }
+    Py_DECREF(ret);
 
+    Py_INCREF(b->context);
+    Py_INCREF(b->queue);
+    Py_INCREF(b->notify);
+    Py_INCREF(b->future);
+    /* The worker releases the queue and the context once it is done. */
+    if (PyThread_start_new_thread(process_queue_worker, b) == -1) {
+        PyObject_ReleaseCommittedQueue(py_queue);
+        subvertpy_flag_clear(&contextobj->busy);
+        Py_DECREF(b->context);
+        Py_DECREF(b->queue);
+        Py_DECREF(b->notify);
+        Py_DECREF(b->future);
+        Py_DECREF(b->future);
+        apr_pool_destroy(temp_pool);
+        PyErr_SetString(PyExc_RuntimeError, "Unable to start worker thread");
+        return NULL;
+    }
+
+    return b->future;
+}
 
 static PyMethodDef context_methods[] = {
     { "locked", py_wc_context_locked, METH_VARARGS,
@@ -1886,7 +2480,14 @@ static PyMethodDef context_methods[] = {
     { "process_committed_queue",
         (PyCFunction)py_wc_context_process_committed_queue,
         METH_VARARGS|METH_KEYWORDS,
-        "" },
+        "process_committed_queue(queue, revnum, date, author, background=False, "
+        "notify=None, notify_interval=0.5) -> None or future\n\n"
+        "Mark the queued paths as committed. notify is called with the "
+        "number of steps taken so far, at most once every notify_interval "
+        "seconds. With background=True the queue is processed on a "
+        "separate thread and a concurrent.futures.Future is returned; until "
+        "it is done, other calls on the context and the queue raise "
+        "RuntimeError." },
     { "status",
         (PyCFunction)py_wc_status,
         METH_VARARGS|METH_KEYWORDS,
@@ -1920,7 +2521,7 @@ static void context_dealloc(PyObject *self)
     ContextObject *context_obj = (ContextObject *)self;
     svn_wc_context_destroy(context_obj->context);
     apr_pool_destroy(context_obj->pool);
-    PyObject_Del(self);
+    py_object_del(self);
 }
 
 static PyObject *context_init(PyTypeObject *self, PyObject *args, PyObject *kwargs)
@@ -1933,10 +2534,12 @@ static PyObject *context_init(PyTypeObject *self, PyObject *args, PyObject *kwar
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwnames))
         return NULL;
 
-    ret = PyObject_New(ContextObject, &Context_Type);
+    ret = PyObject_New(ContextObject, SUBVERTPY_TYPE(Context_Type));
     if (ret == NULL)
         return NULL;
 
+    scratch_pool_init(&ret->scratch);
+    subvertpy_flag_clear(&ret->busy);
     ret->pool = Pool(NULL);
     if (ret->pool == NULL)
         return NULL;
@@ -2024,7 +2627,7 @@ static void lock_dealloc(PyObject *self)
 
 	apr_pool_destroy(lockself->pool);
 
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyObject *lock_init(PyTypeObject *type, PyObject *args, PyObject *kwargs)
@@ -2036,7 +2639,7 @@ static PyObject *lock_init(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|z", kwnames, &token))
 		return NULL;
 
-	ret = PyObject_New(LockObject, &Lock_Type);
+	ret = PyObject_New(LockObject, SUBVERTPY_TYPE(Lock_Type));
 	if (ret == NULL)
 		return NULL;
 
@@ -2125,71 +2728,36 @@ PyTypeObject Lock_Type = {
     .tp_getset = lock_getsetters,
 };
 
-static PyObject *
-moduleinit(void)
-{
-	PyObject *mod;
-
-	if (PyType_Ready(&Entry_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&Status2_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&Adm_Type) < 0)
-		return NULL;
-
+const subvertpy_type_def_t wc_types[] = {
+	{ CommittedQueue_Type_ID, &CommittedQueue_Type },
 #if ONLY_SINCE_SVN(1, 7)
-	if (PyType_Ready(&Context_Type) < 0)
-		return NULL;
+	{ Context_Type_ID, &Context_Type },
+	{ Status3_Type_ID, &Status3_Type },
 #endif
+	{ Lock_Type_ID, &Lock_Type },
+	{ 0, NULL }
+};
 
-	if (PyType_Ready(&Editor_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&FileEditor_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&DirectoryEditor_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&TxDeltaWindowHandler_Type) < 0)
-		return NULL;
-
-	if (PyType_Ready(&Stream_Type) < 0)
-		return NULL;
+static int wc_exec(PyObject *mod)
+{
+	if (subvertpy_state_init(mod) < 0)
+		return -1;
 
-	if (PyType_Ready(&CommittedQueue_Type) < 0)
-		return NULL;
+	if (subvertpy_add_types(mod, util_types) < 0)
+		return -1;
 
-#if ONLY_SINCE_SVN(1, 7)
-	if (PyType_Ready(&Status3_Type) < 0)
-		return NULL;
-#endif
+	if (subvertpy_add_types(mod, editor_types) < 0)
+		return -1;
 
-	if (PyType_Ready(&Lock_Type) < 0)
-		return NULL;
+	if (subvertpy_add_types(mod, wc_types) < 0)
+		return -1;
 
-	apr_initialize();
+	if (subvertpy_add_types(mod, wc_adm_types) < 0)
+		return -1;
 
-#if PY_MAJOR_VERSION >= 3
-	static struct PyModuleDef moduledef = {
-	  PyModuleDef_HEAD_INIT,
-	  "wc",         /* m_name */
-	  "Working Copies", /* m_doc */
-	  -1,              /* m_size */
-	  wc_methods, /* m_methods */
-	  NULL,            /* m_reload */
-	  NULL,            /* m_traverse */
-	  NULL,            /* m_clear*/
-	  NULL,            /* m_free */
-	};
-	mod = PyModule_Create(&moduledef);
-#else
-	mod = Py_InitModule3("wc", wc_methods, "Working Copies");
-#endif
-	if (mod == NULL)
-		return NULL;
+	if (!subvertpy_global_init(NULL))
+		return -1;
+	PyEval_InitThreads();
 
 	PyModule_AddIntConstant(mod, "SCHEDULE_NORMAL", 0);
 	PyModule_AddIntConstant(mod, "SCHEDULE_ADD", 1);
@@ -2245,33 +2813,70 @@ moduleinit(void)
 	PyModule_AddIntConstant(mod, "CONFLICT_CHOOSE_MERGED", svn_wc_conflict_choose_merged);
 #endif
 
-	PyModule_AddObject(mod, "Adm", (PyObject *)&Adm_Type);
-	Py_INCREF(&Adm_Type);
+	PyModule_AddObject(mod, "Adm", (PyObject *)SUBVERTPY_TYPE(Adm_Type));
+	Py_INCREF(SUBVERTPY_TYPE(Adm_Type));
 
-	PyModule_AddObject(mod, "Lock", (PyObject *)&Lock_Type);
-	Py_INCREF(&Lock_Type);
+	PyModule_AddObject(mod, "Lock", (PyObject *)SUBVERTPY_TYPE(Lock_Type));
+	Py_INCREF(SUBVERTPY_TYPE(Lock_Type));
 
-	PyModule_AddObject(mod, "CommittedQueue", (PyObject *)&CommittedQueue_Type);
-	Py_INCREF(&CommittedQueue_Type);
+	PyModule_AddObject(mod, "CommittedQueue", (PyObject *)SUBVERTPY_TYPE(CommittedQueue_Type));
+	Py_INCREF(SUBVERTPY_TYPE(CommittedQueue_Type));
 
 #if ONLY_SINCE_SVN(1, 7)
-	PyModule_AddObject(mod, "Context", (PyObject *)&Context_Type);
-	Py_INCREF(&Context_Type);
+	PyModule_AddObject(mod, "Context", (PyObject *)SUBVERTPY_TYPE(Context_Type));
+	Py_INCREF(SUBVERTPY_TYPE(Context_Type));
 #endif
 
-	return mod;
+	return 0;
 }
 
+#if PY_VERSION_HEX >= 0x03050000
+static PyModuleDef_Slot wc_module_slots[] = {
+	{ Py_mod_exec, wc_exec },
+	SUBVERTPY_MODULE_SLOTS
+	{ 0, NULL }
+};
+#endif
+
 #if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef moduledef = {
+	PyModuleDef_HEAD_INIT,
+	"wc",         /* m_name */
+	"Working Copies", /* m_doc */
+	SUBVERTPY_STATE_SIZE,              /* m_size */
+	wc_methods, /* m_methods */
+#if PY_VERSION_HEX >= 0x03050000
+	wc_module_slots, /* m_slots */
+#else
+	NULL,            /* m_reload */
+#endif
+	subvertpy_state_traverse, /* m_traverse */
+	subvertpy_state_clear, /* m_clear*/
+	subvertpy_state_free, /* m_free */
+};
+#endif
+
+#if PY_VERSION_HEX >= 0x03050000
 PyMODINIT_FUNC
 PyInit_wc(void)
 {
-	return moduleinit();
+	return PyModuleDef_Init(&moduledef);
+}
+#elif PY_MAJOR_VERSION >= 3
+PyMODINIT_FUNC
+PyInit_wc(void)
+{
+	PyObject *mod = PyModule_Create(&moduledef);
+	if (mod != NULL && wc_exec(mod) < 0)
+		Py_CLEAR(mod);
+	return mod;
 }
 #else
 PyMODINIT_FUNC
 initwc(void)
 {
-	moduleinit();
+	PyObject *mod = Py_InitModule3("wc", wc_methods, "Working Copies");
+	if (mod != NULL)
+		wc_exec(mod);
 }
 #endif
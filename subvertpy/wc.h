@@ -29,6 +29,9 @@ void py_wc_notify_func(void *baton, const svn_wc_notify_t *notify, apr_pool_t *p
 PyObject *py_wc_status2(svn_wc_status2_t *status);
 #if ONLY_SINCE_SVN(1, 5)
 extern const svn_ra_reporter3_t py_ra_reporter3;
+void py_object_to_reporter(PyObject *obj,
+                           const svn_ra_reporter3_t **reporter,
+                           void **report_baton);
 #endif
 extern const svn_ra_reporter2_t py_ra_reporter2;
 
@@ -37,15 +40,19 @@ svn_error_t *wc_validator3(void *baton, const char *uuid, const char *url, const
 #endif
 svn_error_t *wc_validator2(void *baton, const char *uuid, const char *url, svn_boolean_t root, apr_pool_t *pool);
 svn_wc_committed_queue_t *PyObject_GetCommittedQueue(PyObject *obj);
+void PyObject_ReleaseCommittedQueue(PyObject *obj);
 extern PyTypeObject CommittedQueue_Type;
 svn_lock_t *py_object_to_svn_lock(PyObject *py_lock, apr_pool_t *pool);
 
 /* Provided by wc_adm.h */
 extern PyTypeObject Adm_Type;
 extern PyTypeObject Entry_Type;
+extern PyTypeObject EntriesIterator_Type;
 extern PyTypeObject Status2_Type;
 svn_wc_adm_access_t *PyObject_GetAdmAccess(PyObject *obj);
 extern PyTypeObject Lock_Type;
+extern const subvertpy_type_def_t wc_types[];
+extern const subvertpy_type_def_t wc_adm_types[];
 
 #ifdef __GNUC__
 #pragma GCC visibility pop
@@ -38,6 +38,8 @@
 
 static svn_wc_entry_callbacks2_t py_wc_entry_callbacks2;
 static PyObject *py_entry(const svn_wc_entry_t *entry);
+static PyObject *py_entry_shared(const svn_wc_entry_t *entry, PyObject *owner,
+                                 unsigned int fields);
 
 typedef struct {
     PyObject_VAR_HEAD
@@ -47,10 +49,49 @@ typedef struct {
 
 typedef struct {
 	PyObject_VAR_HEAD
+	/* Pool the entry was copied into; only set if there is no owner */
 	apr_pool_t *pool;
-	svn_wc_entry_t entry;
+	/* Object that keeps the pool with the entry alive, if shared */
+	PyObject *owner;
+	const svn_wc_entry_t *entry;
+	/* Mask of the fields that were copied */
+	unsigned int fields;
 } EntryObject;
 
+#define ENTRY_FIELDS_ALL (~0U)
+
+/* Set of entries copied into a single pool, and iterator over them.
+ *
+ * Iterators returned by Adm.iter_entries() walk one directory at a time:
+ * the entries of each directory go into a separate batch, which is
+ * itself an EntriesIteratorObject, and the subdirectories are kept on a
+ * stack to be walked once the batch has been consumed. */
+struct entries_item {
+	const char *path;
+	const svn_wc_entry_t *entry;
+};
+
+typedef struct EntriesIteratorObject {
+	PyObject_VAR_HEAD
+	apr_pool_t *pool;
+	apr_array_header_t *items;
+	int index;
+	unsigned int fields;
+	/* Walk state; adm is NULL for batches */
+	PyObject *adm;
+	struct EntriesIteratorObject *batch;
+	apr_array_header_t *dirs;
+	svn_depth_t depth;
+	bool show_hidden;
+} EntriesIteratorObject;
+
+static EntriesIteratorObject *entries_iter_new(unsigned int fields);
+static svn_wc_entry_t *entry_dup_fields(const svn_wc_entry_t *entry,
+                                        unsigned int fields,
+                                        apr_pool_t *pool);
+static bool py_entry_fields(PyObject *py_fields, unsigned int *fields,
+                            apr_pool_t *pool);
+
 svn_wc_adm_access_t *Adm_GetAdmAccess(PyObject *obj) {
     AdmObject *adm_obj = (AdmObject *)obj;
     return adm_obj->adm;
@@ -82,7 +123,7 @@ static PyObject *adm_init(PyTypeObject *self, PyObject *args, PyObject *kwargs)
                                      &associated, &py_path, &write_lock, &depth))
         return NULL;
 
-    ret = PyObject_New(AdmObject, &Adm_Type);
+    ret = PyObject_New(AdmObject, SUBVERTPY_TYPE(Adm_Type));
     if (ret == NULL)
         return NULL;
 
@@ -227,6 +268,7 @@ static PyObject *adm_entries_read(PyObject *self, PyObject *args)
     apr_ssize_t klen;
     svn_wc_entry_t *entry;
     PyObject *py_entries, *obj;
+    EntriesIteratorObject *owner;
 
     if (!PyArg_ParseTuple(args, "|b", &show_hidden))
         return NULL;
@@ -243,6 +285,14 @@ static PyObject *adm_entries_read(PyObject *self, PyObject *args)
         apr_pool_destroy(temp_pool);
         return NULL;
     }
+    /* The entries may be cached in the access baton, so copy them; they all
+     * share a single pool, which lives as long as any of them. */
+    owner = entries_iter_new(ENTRY_FIELDS_ALL);
+    if (owner == NULL) {
+        Py_DECREF(py_entries);
+        apr_pool_destroy(temp_pool);
+        return NULL;
+    }
     idx = apr_hash_first(temp_pool, entries);
     while (idx != NULL) {
         apr_hash_this(idx, (const void **)&key, &klen, (void **)&entry);
@@ -250,12 +300,20 @@ static PyObject *adm_entries_read(PyObject *self, PyObject *args)
             obj = Py_None;
             Py_INCREF(obj);
         } else {
-            obj = py_entry(entry);
+            obj = py_entry_shared(svn_wc_entry_dup(entry, owner->pool),
+                                  (PyObject *)owner, ENTRY_FIELDS_ALL);
+        }
+        if (obj == NULL || PyDict_SetItemString(py_entries, key, obj) != 0) {
+            Py_XDECREF(obj);
+            Py_DECREF(py_entries);
+            Py_DECREF(owner);
+            apr_pool_destroy(temp_pool);
+            return NULL;
         }
-        PyDict_SetItemString(py_entries, key, obj);
         Py_DECREF(obj);
         idx = apr_hash_next(idx);
     }
+    Py_DECREF(owner);
     apr_pool_destroy(temp_pool);
     return py_entries;
 }
@@ -310,6 +368,199 @@ static PyObject *adm_walk_entries(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+struct entries_walk {
+    EntriesIteratorObject *iter;
+    EntriesIteratorObject *batch;
+    const char *dir;
+    /* Whether the entry of dir was already found in its parent */
+    bool skip_dir;
+    /* Whether subdirectories are pushed onto the stack to be walked */
+    bool recurse;
+};
+
+static svn_error_t *entries_iter_found_entry(const char *path,
+                                             const svn_wc_entry_t *entry,
+                                             void *walk_baton,
+                                             apr_pool_t *pool)
+{
+    struct entries_walk *walk = walk_baton;
+    EntriesIteratorObject *batch = walk->batch;
+    struct entries_item *item;
+    bool is_dir = !strcmp(path, walk->dir);
+
+    if (is_dir && walk->skip_dir)
+        return NULL;
+
+    /* Subdirectories are found twice: in their parent, and as their own
+     * entry right after that. */
+    if (!is_dir && walk->recurse && entry->kind == svn_node_dir &&
+        (walk->iter->dirs->nelts == 0 ||
+         strcmp(APR_ARRAY_IDX(walk->iter->dirs, walk->iter->dirs->nelts - 1,
+                              const char *), path))) {
+        APR_ARRAY_PUSH(walk->iter->dirs, const char *) =
+            apr_pstrdup(walk->iter->pool, path);
+    }
+
+    item = apr_array_push(batch->items);
+    item->path = apr_pstrdup(batch->pool, path);
+    item->entry = entry_dup_fields(entry, batch->fields, batch->pool);
+    return NULL;
+}
+
+#if ONLY_SINCE_SVN(1, 5)
+static svn_error_t *entries_iter_handle_error(const char *path,
+                                             svn_error_t *err,
+                                             void *walk_baton,
+                                             apr_pool_t *pool)
+{
+    return err;
+}
+
+static const svn_wc_entry_callbacks2_t entries_iter_callbacks2 = {
+    entries_iter_found_entry,
+    entries_iter_handle_error,
+};
+#else
+static const svn_wc_entry_callbacks_t entries_iter_callbacks = {
+    entries_iter_found_entry
+};
+#endif
+
+/**
+ * Walk the next directory on the stack of an entries iterator into a new
+ * batch.
+ *
+ * The first directory is walked to the depth that was asked for, or just
+ * its immediate children for DEPTH_INFINITY; the subdirectories found are
+ * then walked the same way, one per batch. Their entries were already
+ * found in their parent, unless they are missing, in which case only the
+ * entry in the parent is found, as for svn_wc_walk_entries3().
+ */
+static bool entries_iter_walk_next(EntriesIteratorObject *iter)
+{
+    AdmObject *admobj = (AdmObject *)iter->adm;
+    struct entries_walk walk;
+    apr_pool_t *temp_pool;
+    svn_error_t *err;
+    bool first;
+
+    if (admobj->adm == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "WorkingCopy instance already closed");
+        return false;
+    }
+
+    first = (iter->batch == NULL);
+    walk.iter = iter;
+    walk.dir = APR_ARRAY_IDX(iter->dirs, iter->dirs->nelts - 1, const char *);
+    apr_array_pop(iter->dirs);
+    walk.skip_dir = !first;
+    walk.recurse = (iter->depth == svn_depth_infinity);
+    walk.batch = entries_iter_new(iter->fields);
+    if (walk.batch == NULL)
+        return false;
+
+    temp_pool = Pool(NULL);
+    if (temp_pool == NULL) {
+        Py_DECREF(walk.batch);
+        return false;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+#if ONLY_SINCE_SVN(1, 5)
+    err = svn_wc_walk_entries3(walk.dir, admobj->adm,
+                               &entries_iter_callbacks2, &walk,
+                               walk.recurse?svn_depth_immediates:iter->depth,
+                               iter->show_hidden, NULL, NULL, temp_pool);
+#else
+    err = svn_wc_walk_entries2(walk.dir, admobj->adm,
+                               &entries_iter_callbacks, &walk,
+                               iter->show_hidden, NULL, NULL, temp_pool);
+#endif
+    Py_END_ALLOW_THREADS
+    apr_pool_destroy(temp_pool);
+
+    if (err != NULL && !first &&
+        (err->apr_err == SVN_ERR_WC_NOT_DIRECTORY ||
+         err->apr_err == SVN_ERR_WC_NOT_LOCKED ||
+         err->apr_err == SVN_ERR_WC_PATH_NOT_FOUND)) {
+        /* Missing directory */
+        svn_error_clear(err);
+        err = NULL;
+    }
+    if (err != NULL) {
+        handle_svn_error(err);
+        svn_error_clear(err);
+        Py_DECREF(walk.batch);
+        return false;
+    }
+
+    /* Entries from the previous batch keep it alive as long as needed. */
+    Py_XDECREF(iter->batch);
+    iter->batch = walk.batch;
+    return true;
+}
+
+static PyObject *adm_iter_entries(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    const char *path;
+    bool show_hidden=false;
+    AdmObject *admobj = (AdmObject *)self;
+    svn_depth_t depth = svn_depth_infinity;
+    PyObject *py_path, *py_fields = Py_None;
+    unsigned int fields;
+    EntriesIteratorObject *iter;
+    char *kwnames[] = { "path", "show_hidden", "depth", "fields", NULL };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|biO", kwnames, &py_path,
+                                     &show_hidden, &depth, &py_fields))
+        return NULL;
+
+    ADM_CHECK_CLOSED(admobj);
+
+#if ONLY_BEFORE_SVN(1, 5)
+    if (depth != svn_depth_infinity) {
+        PyErr_SetString(PyExc_NotImplementedError,
+                        "depth != infinity not supported for svn < 1.5");
+        return NULL;
+    }
+    /* There is no way to walk a single level; walk it all at once. */
+    depth = svn_depth_unknown;
+#endif
+
+    iter = entries_iter_new(ENTRY_FIELDS_ALL);
+    if (iter == NULL)
+        return NULL;
+
+    if (!py_entry_fields(py_fields, &fields, iter->pool)) {
+        Py_DECREF(iter);
+        return NULL;
+    }
+
+    path = py_object_to_svn_abspath(py_path, iter->pool);
+    if (path == NULL) {
+        Py_DECREF(iter);
+        return NULL;
+    }
+
+    iter->fields = fields;
+    iter->depth = depth;
+    iter->show_hidden = show_hidden;
+    iter->dirs = apr_array_make(iter->pool, 16, sizeof(const char *));
+    APR_ARRAY_PUSH(iter->dirs, const char *) = path;
+    Py_INCREF(self);
+    iter->adm = self;
+
+    /* The first directory is walked right away, so that errors such as
+     * a path that is not in the working copy are raised here. Entries are
+     * only wrapped once they are consumed. */
+    if (!entries_iter_walk_next(iter)) {
+        Py_DECREF(iter);
+        return NULL;
+    }
+
+    return (PyObject *)iter;
+}
+
 static PyObject *adm_entry(PyObject *self, PyObject *args)
 {
     const char *path;
@@ -535,6 +786,10 @@ static PyObject *adm_crawl_revisions(PyObject *self, PyObject *args, PyObject *k
 {
     const char *path;
     PyObject *reporter;
+#if ONLY_SINCE_SVN(1, 5)
+    const svn_ra_reporter3_t *ra_reporter;
+    void *report_baton;
+#endif
     bool restore_files=true, recurse=true, use_commit_times=true;
     PyObject *notify_func=Py_None;
     apr_pool_t *temp_pool;
@@ -565,9 +820,12 @@ static PyObject *adm_crawl_revisions(PyObject *self, PyObject *args, PyObject *k
         return NULL;
     }
     traversal_info = svn_wc_init_traversal_info(temp_pool);
+#if ONLY_SINCE_SVN(1, 5)
+    py_object_to_reporter(reporter, &ra_reporter, &report_baton);
+#endif
 #if ONLY_SINCE_SVN(1, 6)
     RUN_SVN_WITH_POOL(temp_pool, svn_wc_crawl_revisions4(path, admobj->adm,
-                                                         &py_ra_reporter3, (void *)reporter,
+                                                         ra_reporter, report_baton,
                                                          restore_files, recurse?svn_depth_infinity:svn_depth_files,
                                                          honor_depth_exclude?TRUE:FALSE,
                                                          depth_compatibility_trick?TRUE:FALSE, use_commit_times,
@@ -575,7 +833,7 @@ static PyObject *adm_crawl_revisions(PyObject *self, PyObject *args, PyObject *k
                                                          traversal_info, temp_pool));
 #elif ONLY_SINCE_SVN(1, 5)
     RUN_SVN_WITH_POOL(temp_pool, svn_wc_crawl_revisions3(path, admobj->adm,
-                                                         &py_ra_reporter3, (void *)reporter,
+                                                         ra_reporter, report_baton,
                                                          restore_files, recurse?svn_depth_infinity:svn_depth_files,
                                                          depth_compatibility_trick, use_commit_times,
                                                          py_wc_notify_func, (void *)notify_func,
@@ -685,7 +943,7 @@ static PyObject *adm_get_switch_editor(PyObject *self, PyObject *args, PyObject
             return NULL;
         }
     Py_INCREF(admobj);
-    return new_editor_object(NULL, editor, edit_baton, pool, &Editor_Type,
+    return new_editor_object(NULL, editor, edit_baton, pool, SUBVERTPY_TYPE(Editor_Type),
                              wc_done_handler, admobj, NULL);
 }
 
@@ -768,7 +1026,7 @@ static PyObject *adm_get_update_editor(PyObject *self, PyObject *args, PyObject
             return NULL;
         }
     Py_INCREF(admobj);
-    return new_editor_object(NULL, editor, edit_baton, pool, &Editor_Type,
+    return new_editor_object(NULL, editor, edit_baton, pool, SUBVERTPY_TYPE(Editor_Type),
                              wc_done_handler, admobj, NULL);
 }
 
@@ -889,7 +1147,7 @@ static PyObject *adm_close(PyObject *self)
 static void adm_dealloc(PyObject *self)
 {
     apr_pool_destroy(((AdmObject *)self)->pool);
-    PyObject_Del(self);
+    py_object_del(self);
 }
 
 static PyObject *adm_repr(PyObject *self)
@@ -1208,7 +1466,7 @@ static PyObject *translated_stream(PyObject *self, PyObject *args)
                       svn_wc_translated_stream(&stream, path, versioned_file, admobj->adm,
                                                flags, stream_pool));
 
-    ret = PyObject_New(StreamObject, &Stream_Type);
+    ret = PyObject_New(StreamObject, SUBVERTPY_TYPE(Stream_Type));
     if (ret == NULL)
         return NULL;
 
@@ -1297,36 +1555,51 @@ static PyObject *adm_process_committed_queue(PyObject *self, PyObject *args)
     svn_revnum_t revnum;
     char *date, *author;
     PyObject *py_queue;
+    svn_error_t *err;
 
-    if (!PyArg_ParseTuple(args, "O!lss", &CommittedQueue_Type, &py_queue,
+    if (!PyArg_ParseTuple(args, "O!lss", SUBVERTPY_TYPE(CommittedQueue_Type), &py_queue,
                           &revnum, &date, &author))
         return NULL;
 
     ADM_CHECK_CLOSED(admobj);
 
-    temp_pool = Pool(NULL);
-    if (temp_pool == NULL)
+    svn_wc_committed_queue_t *committed_queue = PyObject_GetCommittedQueue(py_queue);
+    if (committed_queue == NULL)
         return NULL;
 
-    svn_wc_committed_queue_t *committed_queue = PyObject_GetCommittedQueue(py_queue);
+    temp_pool = Pool(NULL);
+    if (temp_pool == NULL) {
+        PyObject_ReleaseCommittedQueue(py_queue);
+        return NULL;
+    }
 
+    Py_BEGIN_ALLOW_THREADS
 #if ONLY_SINCE_SVN(1, 5)
-    RUN_SVN_WITH_POOL(temp_pool, svn_wc_process_committed_queue(committed_queue, admobj->adm, revnum, date, author, temp_pool));
+    err = svn_wc_process_committed_queue(committed_queue, admobj->adm, revnum, date, author, temp_pool);
 #else
     {
         int i;
-        for (i = 0; i < py_queue->queue->queue->nelts; i++) {
+        err = NULL;
+        for (i = 0; err == NULL && i < committed_queue->queue->nelts; i++) {
             committed_queue_item_t *cqi = APR_ARRAY_IDX(committed_queue->queue, i,
                                                         committed_queue_item_t *);
 
-            RUN_SVN_WITH_POOL(temp_pool, svn_wc_process_committed3(cqi->path, admobj->adm,
-                                                                   cqi->recurse, revnum, date, author, cqi->wcprop_changes,
-                                                                   cqi->remove_lock, cqi->digest, temp_pool));
+            err = svn_wc_process_committed3(cqi->path, admobj->adm,
+                                            cqi->recurse, revnum, date, author, cqi->wcprop_changes,
+                                            cqi->remove_lock, cqi->digest, temp_pool);
         }
     }
 #endif
+    Py_END_ALLOW_THREADS
+    PyObject_ReleaseCommittedQueue(py_queue);
     apr_pool_destroy(temp_pool);
 
+    if (err != NULL) {
+        handle_svn_error(err);
+        svn_error_clear(err);
+        return NULL;
+    }
+
     Py_RETURN_NONE;
 }
 
@@ -1423,11 +1696,17 @@ static PyObject *transmit_prop_deltas(PyObject *self, PyObject *args)
     PyObject *py_path;
     EntryObject *py_entry;
 
-    if (!PyArg_ParseTuple(args, "OO!O", &py_path, &Entry_Type, &py_entry, &editor_obj))
+    if (!PyArg_ParseTuple(args, "OO!O", &py_path, SUBVERTPY_TYPE(Entry_Type), &py_entry, &editor_obj))
         return NULL;
 
     ADM_CHECK_CLOSED(admobj);
 
+    if (py_entry->fields != ENTRY_FIELDS_ALL) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Entry was loaded with a subset of its fields");
+        return NULL;
+    }
+
     temp_pool = Pool(NULL);
     if (temp_pool == NULL) {
         return NULL;
@@ -1443,7 +1722,7 @@ static PyObject *transmit_prop_deltas(PyObject *self, PyObject *args)
 
     RUN_SVN_WITH_POOL(temp_pool,
                       svn_wc_transmit_prop_deltas(path,
-                                                  admobj->adm, &(py_entry->entry), &py_editor, editor_obj, NULL, temp_pool));
+                                                  admobj->adm, py_entry->entry, &py_editor, editor_obj, NULL, temp_pool));
 
     apr_pool_destroy(temp_pool);
 
@@ -1476,7 +1755,7 @@ static PyObject *retrieve(PyObject *self, PyObject *args)
     RUN_SVN_WITH_POOL(pool, svn_wc_adm_retrieve(&result, admobj->adm,
                                                 path, pool));
 
-    ret = PyObject_New(AdmObject, &Adm_Type);
+    ret = PyObject_New(AdmObject, SUBVERTPY_TYPE(Adm_Type));
     if (ret == NULL)
         return NULL;
 
@@ -1513,7 +1792,7 @@ static PyObject *probe_retrieve(PyObject *self, PyObject *args)
     RUN_SVN_WITH_POOL(pool, svn_wc_adm_probe_retrieve(&result, admobj->adm,
                                                       path, pool));
 
-    ret = PyObject_New(AdmObject, &Adm_Type);
+    ret = PyObject_New(AdmObject, SUBVERTPY_TYPE(Adm_Type));
     if (ret == NULL)
         return NULL;
 
@@ -1558,7 +1837,7 @@ static PyObject *probe_try(PyObject *self, PyObject *args)
         Py_RETURN_NONE;
     }
 
-    ret = PyObject_New(AdmObject, &Adm_Type);
+    ret = PyObject_New(AdmObject, SUBVERTPY_TYPE(Adm_Type));
     if (ret == NULL)
         return NULL;
 
@@ -1752,7 +2031,7 @@ static PyObject *wc_add_lock(PyObject *self, PyObject *args)
     svn_lock_t *lock;
     PyObject *py_path, *py_lock;
 
-    if (!PyArg_ParseTuple(args, "OO!", &py_path, &Lock_Type, &py_lock))
+    if (!PyArg_ParseTuple(args, "OO!", &py_path, SUBVERTPY_TYPE(Lock_Type), &py_lock))
         return NULL;
 
     ADM_CHECK_CLOSED(admobj);
@@ -1813,6 +2092,13 @@ static PyMethodDef adm_methods[] = {
     { "walk_entries", adm_walk_entries, METH_VARARGS,
         "S.walk_entries(path, callback, show_hidden=False)\n"
             "callback should be a function that takes a path and a wc entry" },
+    { "iter_entries", (PyCFunction)adm_iter_entries, METH_VARARGS|METH_KEYWORDS,
+        "S.iter_entries(path, show_hidden=False, depth=DEPTH_INFINITY, fields=None) -> iterator\n"
+            "Walk the entries below path, yielding (path, entry) tuples. "
+            "Directories are walked one at a time, as the iterator is "
+            "consumed. fields is a list of the entry attributes to load, or "
+            "None for all of them; accessing other attributes raises "
+            "AttributeError." },
     { "locked", (PyCFunction)adm_locked, METH_NOARGS,
         "S.locked() -> bool" },
     { "get_prop_diffs", adm_get_prop_diffs, METH_VARARGS,
@@ -1946,37 +2232,198 @@ PyTypeObject Adm_Type = {
 
 static void entry_dealloc(PyObject *self)
 {
-	apr_pool_destroy(((EntryObject *)self)->pool);
-	PyObject_Del(self);
-}
-
-static PyMemberDef entry_members[] = {
-	{ "name", T_STRING, offsetof(EntryObject, entry.name), READONLY,
-		"Name of the file"},
-	{ "copyfrom_url", T_STRING, offsetof(EntryObject, entry.copyfrom_url), READONLY,
-		"Copyfrom location" },
-	{ "copyfrom_rev", T_LONG, offsetof(EntryObject, entry.copyfrom_rev), READONLY,
-		"Copyfrom revision" },
-	{ "uuid", T_STRING, offsetof(EntryObject, entry.uuid), READONLY,
-		"UUID of repository" },
-	{ "url", T_STRING, offsetof(EntryObject, entry.url), READONLY,
-		"URL in repository" },
-	{ "repos", T_STRING, offsetof(EntryObject, entry.repos), READONLY,
-		"Canonical repository URL" },
-	{ "schedule", T_INT, offsetof(EntryObject, entry.schedule), READONLY,
-		"Scheduling (add, replace, delete, etc)" },
-	{ "kind", T_INT, offsetof(EntryObject, entry.kind), READONLY,
-		"Kind of file (file, dir, etc)" },
-	{ "revision", T_LONG, offsetof(EntryObject, entry.revision), READONLY,
-		"Base revision", },
-	{ "cmt_rev", T_LONG, offsetof(EntryObject, entry.cmt_rev), READONLY,
-		"Last revision this was changed" },
-	{ "checksum", T_STRING, offsetof(EntryObject, entry.checksum), READONLY,
-		"Hex MD5 checksum for the untranslated text base file" },
-	{ "cmt_date", T_LONG, offsetof(EntryObject, entry.cmt_date), READONLY,
-		"Last date this was changed" },
-	{ "cmt_author", T_STRING, offsetof(EntryObject, entry.cmt_author), READONLY,
-		"Last commit author of this item" },
+	EntryObject *entry = (EntryObject *)self;
+
+	if (entry->owner != NULL)
+		Py_DECREF(entry->owner);
+	else
+		apr_pool_destroy(entry->pool);
+	py_object_del(self);
+}
+
+enum entry_field_kind {
+	ENTRY_FIELD_STRING,
+	ENTRY_FIELD_REVNUM,
+	ENTRY_FIELD_INT,
+	ENTRY_FIELD_TIME,
+};
+
+struct entry_field {
+	const char *name;
+	enum entry_field_kind kind;
+	size_t offset;
+};
+
+/* Order matters: the index is the bit in the field mask */
+static const struct entry_field entry_fields[] = {
+	{ "name", ENTRY_FIELD_STRING, offsetof(svn_wc_entry_t, name) },
+	{ "copyfrom_url", ENTRY_FIELD_STRING, offsetof(svn_wc_entry_t, copyfrom_url) },
+	{ "copyfrom_rev", ENTRY_FIELD_REVNUM, offsetof(svn_wc_entry_t, copyfrom_rev) },
+	{ "uuid", ENTRY_FIELD_STRING, offsetof(svn_wc_entry_t, uuid) },
+	{ "url", ENTRY_FIELD_STRING, offsetof(svn_wc_entry_t, url) },
+	{ "repos", ENTRY_FIELD_STRING, offsetof(svn_wc_entry_t, repos) },
+	{ "schedule", ENTRY_FIELD_INT, offsetof(svn_wc_entry_t, schedule) },
+	{ "kind", ENTRY_FIELD_INT, offsetof(svn_wc_entry_t, kind) },
+	{ "revision", ENTRY_FIELD_REVNUM, offsetof(svn_wc_entry_t, revision) },
+	{ "cmt_rev", ENTRY_FIELD_REVNUM, offsetof(svn_wc_entry_t, cmt_rev) },
+	{ "checksum", ENTRY_FIELD_STRING, offsetof(svn_wc_entry_t, checksum) },
+	{ "cmt_date", ENTRY_FIELD_TIME, offsetof(svn_wc_entry_t, cmt_date) },
+	{ "cmt_author", ENTRY_FIELD_STRING, offsetof(svn_wc_entry_t, cmt_author) },
+};
+
+#define ENTRY_FIELD_COUNT (sizeof(entry_fields) / sizeof(entry_fields[0]))
+
+/**
+ * Convert a list of attribute names (or None, for all) to a field mask.
+ */
+static bool py_entry_fields(PyObject *py_fields, unsigned int *fields,
+							apr_pool_t *pool)
+{
+	PyObject *iterator, *item;
+	size_t i;
+
+	if (py_fields == Py_None) {
+		*fields = ENTRY_FIELDS_ALL;
+		return true;
+	}
+
+	iterator = PyObject_GetIter(py_fields);
+	if (iterator == NULL)
+		return false;
+
+	*fields = 0;
+	while ((item = PyIter_Next(iterator))) {
+		const char *name = py_object_to_svn_string(item, pool);
+		if (name == NULL) {
+			Py_DECREF(item);
+			Py_DECREF(iterator);
+			return false;
+		}
+		for (i = 0; i < ENTRY_FIELD_COUNT; i++) {
+			if (!strcmp(entry_fields[i].name, name))
+				break;
+		}
+		if (i == ENTRY_FIELD_COUNT) {
+			PyErr_Format(PyExc_ValueError, "Unknown entry field '%s'", name);
+			Py_DECREF(item);
+			Py_DECREF(iterator);
+			return false;
+		}
+		*fields |= 1U << i;
+		Py_DECREF(item);
+	}
+	Py_DECREF(iterator);
+
+	/* Listing every field is the same as asking for all of them, which
+	 * gets a complete copy. */
+	if (*fields == (1U << ENTRY_FIELD_COUNT) - 1)
+		*fields = ENTRY_FIELDS_ALL;
+
+	return !PyErr_Occurred();
+}
+
+/**
+ * Copy the fields in the mask of an entry. Entries with all fields are
+ * complete copies that can be passed back to Subversion.
+ */
+static svn_wc_entry_t *entry_dup_fields(const svn_wc_entry_t *entry,
+										unsigned int fields,
+										apr_pool_t *pool)
+{
+	svn_wc_entry_t *ret;
+	size_t i;
+
+	if (fields == ENTRY_FIELDS_ALL)
+		return svn_wc_entry_dup(entry, pool);
+
+	ret = apr_pcalloc(pool, sizeof(svn_wc_entry_t));
+	for (i = 0; i < ENTRY_FIELD_COUNT; i++) {
+		const struct entry_field *field = &entry_fields[i];
+		const char *src = (const char *)entry + field->offset;
+		char *dest = (char *)ret + field->offset;
+
+		if (!(fields & (1U << i)))
+			continue;
+
+		switch (field->kind) {
+			case ENTRY_FIELD_STRING:
+				if (*(const char * const *)src != NULL)
+					*(const char **)dest = apr_pstrdup(pool, *(const char * const *)src);
+				break;
+			case ENTRY_FIELD_REVNUM:
+				*(svn_revnum_t *)dest = *(const svn_revnum_t *)src;
+				break;
+			case ENTRY_FIELD_INT:
+				*(int *)dest = *(const int *)src;
+				break;
+			case ENTRY_FIELD_TIME:
+				*(apr_time_t *)dest = *(const apr_time_t *)src;
+				break;
+		}
+	}
+	return ret;
+}
+
+static PyObject *entry_get_field(PyObject *self, void *closure)
+{
+	EntryObject *entry = (EntryObject *)self;
+	const struct entry_field *field = closure;
+	const char *src = (const char *)entry->entry + field->offset;
+
+	if (!(entry->fields & (1U << (field - entry_fields)))) {
+		PyErr_Format(PyExc_AttributeError, "Entry field '%s' was not loaded",
+					 field->name);
+		return NULL;
+	}
+
+	switch (field->kind) {
+		case ENTRY_FIELD_STRING:
+			if (*(const char * const *)src == NULL)
+				Py_RETURN_NONE;
+#if PY_MAJOR_VERSION >= 3
+			return PyUnicode_FromString(*(const char * const *)src);
+#else
+			return PyString_FromString(*(const char * const *)src);
+#endif
+		case ENTRY_FIELD_REVNUM:
+			return PyLong_FromLong(*(const svn_revnum_t *)src);
+		case ENTRY_FIELD_INT:
+			return PyLong_FromLong(*(const int *)src);
+		case ENTRY_FIELD_TIME:
+			return PyLong_FromLongLong(*(const apr_time_t *)src);
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyGetSetDef entry_getsetters[] = {
+	{ "name", entry_get_field, NULL,
+		"Name of the file", (void *)&entry_fields[0] },
+	{ "copyfrom_url", entry_get_field, NULL,
+		"Copyfrom location", (void *)&entry_fields[1] },
+	{ "copyfrom_rev", entry_get_field, NULL,
+		"Copyfrom revision", (void *)&entry_fields[2] },
+	{ "uuid", entry_get_field, NULL,
+		"UUID of repository", (void *)&entry_fields[3] },
+	{ "url", entry_get_field, NULL,
+		"URL in repository", (void *)&entry_fields[4] },
+	{ "repos", entry_get_field, NULL,
+		"Canonical repository URL", (void *)&entry_fields[5] },
+	{ "schedule", entry_get_field, NULL,
+		"Scheduling (add, replace, delete, etc)", (void *)&entry_fields[6] },
+	{ "kind", entry_get_field, NULL,
+		"Kind of file (file, dir, etc)", (void *)&entry_fields[7] },
+	{ "revision", entry_get_field, NULL,
+		"Base revision", (void *)&entry_fields[8] },
+	{ "cmt_rev", entry_get_field, NULL,
+		"Last revision this was changed", (void *)&entry_fields[9] },
+	{ "checksum", entry_get_field, NULL,
+		"Hex MD5 checksum for the untranslated text base file",
+		(void *)&entry_fields[10] },
+	{ "cmt_date", entry_get_field, NULL,
+		"Last date this was changed", (void *)&entry_fields[11] },
+	{ "cmt_author", entry_get_field, NULL,
+		"Last commit author of this item", (void *)&entry_fields[12] },
 	{ NULL, }
 };
 
@@ -2038,7 +2485,8 @@ PyTypeObject Entry_Type = {
 
 	/* Attribute descriptor and subclassing stuff */
 	NULL, /*	struct PyMethodDef *tp_methods;	*/
-	entry_members, /*	struct PyMemberDef *tp_members;	*/
+	NULL, /*	struct PyMemberDef *tp_members;	*/
+	entry_getsetters, /*	struct PyGetSetDef *tp_getset;	*/
 
 };
 
@@ -2050,17 +2498,124 @@ static PyObject *py_entry(const svn_wc_entry_t *entry)
 		Py_RETURN_NONE;
 	}
 
-	ret = PyObject_New(EntryObject, &Entry_Type);
+	ret = PyObject_New(EntryObject, SUBVERTPY_TYPE(Entry_Type));
 	if (ret == NULL)
 		return NULL;
 
+	ret->owner = NULL;
 	ret->pool = Pool(NULL);
-	if (ret->pool == NULL)
+	if (ret->pool == NULL) {
+		py_object_del(ret);
+		return NULL;
+	}
+	ret->entry = svn_wc_entry_dup(entry, ret->pool);
+	ret->fields = ENTRY_FIELDS_ALL;
+	return (PyObject *)ret;
+}
+
+/**
+ * Wrap an entry that lives in a pool kept alive by owner.
+ */
+static PyObject *py_entry_shared(const svn_wc_entry_t *entry, PyObject *owner,
+								 unsigned int fields)
+{
+	EntryObject *ret;
+
+	ret = PyObject_New(EntryObject, SUBVERTPY_TYPE(Entry_Type));
+	if (ret == NULL)
 		return NULL;
-	ret->entry = *svn_wc_entry_dup(entry, ret->pool);
+
+	ret->pool = NULL;
+	ret->owner = owner;
+	Py_INCREF(owner);
+	ret->entry = entry;
+	ret->fields = fields;
 	return (PyObject *)ret;
 }
 
+static void entries_iter_dealloc(PyObject *self)
+{
+	EntriesIteratorObject *iter = (EntriesIteratorObject *)self;
+
+	Py_XDECREF(iter->batch);
+	Py_XDECREF(iter->adm);
+	apr_pool_destroy(iter->pool);
+	py_object_del(self);
+}
+
+static PyObject *entries_iter_next(PyObject *self)
+{
+	EntriesIteratorObject *iter = (EntriesIteratorObject *)self;
+	EntriesIteratorObject *batch = iter;
+	struct entries_item *item;
+	PyObject *py_path, *py_entry, *ret;
+
+	if (iter->adm != NULL) {
+		while (iter->batch->index >= iter->batch->items->nelts) {
+			if (iter->dirs->nelts == 0)
+				return NULL;
+			if (!entries_iter_walk_next(iter))
+				return NULL;
+		}
+		batch = iter->batch;
+	}
+
+	if (batch->index >= batch->items->nelts)
+		return NULL;
+
+	item = &APR_ARRAY_IDX(batch->items, batch->index, struct entries_item);
+	batch->index++;
+
+	py_path = py_path_string(item->path, -1);
+	if (py_path == NULL)
+		return NULL;
+
+	py_entry = py_entry_shared(item->entry, (PyObject *)batch, batch->fields);
+	if (py_entry == NULL) {
+		Py_DECREF(py_path);
+		return NULL;
+	}
+
+	ret = Py_BuildValue("(OO)", py_path, py_entry);
+	Py_DECREF(py_path);
+	Py_DECREF(py_entry);
+	return ret;
+}
+
+PyTypeObject EntriesIterator_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "wc.EntriesIterator",
+	.tp_basicsize = sizeof(EntriesIteratorObject),
+	.tp_dealloc = entries_iter_dealloc,
+#if PY_MAJOR_VERSION < 3
+	.tp_flags = Py_TPFLAGS_HAVE_ITER,
+#endif
+	.tp_iter = PyObject_SelfIter,
+	.tp_iternext = entries_iter_next,
+};
+
+static EntriesIteratorObject *entries_iter_new(unsigned int fields)
+{
+	EntriesIteratorObject *ret;
+
+	ret = PyObject_New(EntriesIteratorObject, SUBVERTPY_TYPE(EntriesIterator_Type));
+	if (ret == NULL)
+		return NULL;
+
+	ret->pool = Pool(NULL);
+	if (ret->pool == NULL) {
+		py_object_del(ret);
+		return NULL;
+	}
+	ret->items = apr_array_make(ret->pool, 16, sizeof(struct entries_item));
+	ret->index = 0;
+	ret->fields = fields;
+	ret->adm = NULL;
+	ret->batch = NULL;
+	ret->dirs = NULL;
+	return ret;
+}
+
 typedef struct {
 	PyObject_VAR_HEAD
 	apr_pool_t *pool;
@@ -2072,7 +2627,7 @@ static void status_dealloc(PyObject *self)
 {
 	apr_pool_destroy(((Status2Object *)self)->pool);
 	Py_XDECREF(((Status2Object *)self)->entry);
-	PyObject_Del(self);
+	py_object_del(self);
 }
 
 static PyMemberDef status_members[] = {
@@ -2157,18 +2712,26 @@ PyTypeObject Status2_Type = {
 
 };
 
+const subvertpy_type_def_t wc_adm_types[] = {
+	{ Adm_Type_ID, &Adm_Type },
+	{ Entry_Type_ID, &Entry_Type },
+	{ EntriesIterator_Type_ID, &EntriesIterator_Type },
+	{ Status2_Type_ID, &Status2_Type },
+	{ 0, NULL }
+};
+
 PyObject *py_wc_status2(svn_wc_status2_t *status)
 {
 	Status2Object *ret;
 	svn_wc_status2_t *dup_status;
 
-	ret = PyObject_New(Status2Object, &Status2_Type);
+	ret = PyObject_New(Status2Object, SUBVERTPY_TYPE(Status2_Type));
 	if (ret == NULL)
 		return NULL;
 
 	ret->pool = Pool(NULL);
 	if (ret->pool == NULL) {
-		PyObject_Del(ret);
+		py_object_del(ret);
 		return NULL;
 	}
 
@@ -2186,7 +2749,7 @@ PyObject *py_wc_status2(svn_wc_status2_t *status)
 
 static svn_error_t *py_wc_found_entry(const char *path, const svn_wc_entry_t *entry, void *walk_baton, apr_pool_t *pool)
 {
-	PyObject *fn, *ret;
+	PyObject *fn, *ret, *py_path, *py_entry_obj;
 	PyObject *callbacks = (PyObject *)walk_baton;
 	PyGILState_STATE state = PyGILState_Ensure();
 	if (PyTuple_Check(callbacks)) {
@@ -2194,7 +2757,17 @@ static svn_error_t *py_wc_found_entry(const char *path, const svn_wc_entry_t *en
 	} else {
 		fn = (PyObject *)walk_baton;
 	}
-	ret = PyObject_CallFunction(fn, "sO", path, py_entry(entry));
+	py_path = py_path_string(path, -1);
+	py_entry_obj = py_entry(entry);
+	if (py_path == NULL || py_entry_obj == NULL) {
+		Py_XDECREF(py_path);
+		Py_XDECREF(py_entry_obj);
+		PyGILState_Release(state);
+		return py_svn_error();
+	}
+	ret = PyObject_CallFunction(fn, "OO", py_path, py_entry_obj);
+	Py_DECREF(py_path);
+	Py_DECREF(py_entry_obj);
 	CB_CHECK_PYRETVAL(ret);
 	Py_DECREF(ret);
 	PyGILState_Release(state);